@@ -43,9 +43,10 @@
  *   BUF_Peek
  *   BUF_PeekAt
  *   BUF_PeekAtCB
+ *   BUF_PeekChunk
  *   BUF_Read
  *   BUF_Erase
- *   BUF_Splice
+ *   BUF_Splice[Ex]
  *   BUF_Destroy
  *
  */
@@ -228,6 +229,22 @@ extern NCBI_XCONNECT_EXPORT size_t BUF_PeekAtCB
  );
 
 
+/*!
+ * Iterate over the data chunks of "buf" without copying any data:  point
+ * "*data" to the unread data of the next chunk, and return its size.  Return 0
+ * (and set "*data" to NULL) when there are no more chunks (or "buf" is NULL).
+ * "*cursor" must be NULL on the first call, and is then used to keep track of
+ * the iteration (its value must not be altered by the caller).
+ * NOTE: the returned pointers (and "*cursor") remain valid only until "buf"
+ *       gets modified.
+ */
+extern NCBI_XCONNECT_EXPORT size_t BUF_PeekChunk
+(BUF          buf,
+ void**       cursor,
+ const void** data
+ );
+
+
 /*!
  * Copy up to "size" bytes stored in "buf" to "data" and remove the copied
  * data from the "buf".
@@ -260,6 +277,18 @@ extern NCBI_XCONNECT_EXPORT void BUF_Erase(BUF buf);
 extern NCBI_XCONNECT_EXPORT int/*bool*/ BUF_Splice(BUF* dst, BUF src);
 
 
+/*!
+ * Move up to "size" bytes from the beginning of the source buffer "src" to
+ * the end of the destination buffer "*dst" (creating the buffer as necessary
+ * if "dst" is NULL).  Return the number of bytes moved, which can only be less
+ * than both "size" and BUF_Size(src) in case of an error.
+ * NOTE: chunks that have to be moved entirely get re-linked without copying
+ *       their data;  only the part of a chunk at the "size" boundary (if any)
+ *       gets copied.
+ */
+extern NCBI_XCONNECT_EXPORT size_t BUF_SpliceEx(BUF* dst, BUF src, size_t size);
+
+
 /*!
  * Destroy all buffer data.
  * NOTE: do nothing if "buf" == NULL.
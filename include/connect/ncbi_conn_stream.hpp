@@ -627,6 +627,24 @@ public:
      const STimeout*     timeout  = kDefaultTimeout,
      size_t              buf_size = kConn_DefaultBufSize,
      TConn_Flags         flags    = 0);
+
+    /// Write scattered data directly to the underlying socket, bypassing the
+    /// stream buffer (which gets flushed first).
+    /// @sa
+    ///   SOCK_WriteV, CSocket::WriteV
+    EIO_Status WriteV(const SSOCK_IOVec* iov,
+                      size_t             n,
+                      size_t*            n_written = 0,
+                      EIO_WriteMethod    how = eIO_WritePersist);
+
+    /// Send a portion of an open file directly to the underlying socket,
+    /// bypassing the stream buffer (which gets flushed first).
+    /// @sa
+    ///   SOCK_SendFile, CSocket::SendFile
+    EIO_Status SendFile(int     fd,
+                        Uint8   offset,
+                        size_t  size,
+                        size_t* n_written = 0);
 };
 
 
@@ -743,17 +761,21 @@ public:
      size_t              buf_size     = kConn_DefaultBufSize
      );
 
+    /// @param pool
+    ///   Keep-alive connection pool hooks (copied), see
+    ///   HTTP_CreatePooledConnector() in <connect/ncbi_http_connector.h>.
     CConn_HttpStream
-    (const string&       url,
-     const SConnNetInfo* net_info,
-     const string&       user_header  = kEmptyStr,
-     FHTTP_ParseHeader   parse_header = 0,
-     void*               user_data    = 0,
-     FHTTP_Adjust        adjust       = 0,
-     FHTTP_Cleanup       cleanup      = 0,
-     THTTP_Flags         flags        = fHTTP_AutoReconnect,
-     const STimeout*     timeout      = kDefaultTimeout,
-     size_t              buf_size     = kConn_DefaultBufSize
+    (const string&         url,
+     const SConnNetInfo*   net_info,
+     const string&         user_header  = kEmptyStr,
+     FHTTP_ParseHeader     parse_header = 0,
+     void*                 user_data    = 0,
+     FHTTP_Adjust          adjust       = 0,
+     FHTTP_Cleanup         cleanup      = 0,
+     THTTP_Flags           flags        = fHTTP_AutoReconnect,
+     const STimeout*       timeout      = kDefaultTimeout,
+     size_t                buf_size     = kConn_DefaultBufSize,
+     const SHTTP_ConnPool* pool         = 0
      );
 
     CConn_HttpStream
@@ -32,6 +32,9 @@
 
 #include "ncbi_http_session.hpp"
 
+#include <functional>
+#include <future>
+
 
 BEGIN_NCBI_SCOPE
 
@@ -60,6 +63,89 @@ private:
 };
 
 
+/// Request to be executed by CHttpAsyncSession.
+struct SHttpAsyncRequest
+{
+    CUrl                              url;
+    CHttpSession_Base::ERequestMethod method;
+    CHttpHeaders::THeaders            headers;
+    string                            body;
+
+    /// Time allowed for the whole request, including the time spent
+    /// waiting for its turn to start. Infinite by default.
+    /// The stream of a request still running at the deadline is reset.
+    CTimeout                          deadline;
+
+    SHttpAsyncRequest(const CUrl& u = CUrl(),
+                      CHttpSession_Base::ERequestMethod m = CHttpSession_Base::eGet) :
+        url(u),
+        method(m),
+        deadline(CTimeout::eInfinite)
+    {}
+};
+
+
+/// Result of a request executed by CHttpAsyncSession.
+struct SHttpAsyncResponse
+{
+    enum EStatus {
+        eSuccess,   ///< Response received (with any HTTP status code)
+        eFailed,    ///< Request could not be sent or response could not be read
+        eTimedOut,  ///< Request deadline expired
+        eCancelled  ///< Session was destroyed before the request completed
+    };
+
+    EStatus                status = eFailed;
+    int                    status_code = 0;
+    CHttpHeaders::THeaders headers;
+    string                 body;
+    string                 error;  ///< What went wrong, unless eSuccess
+};
+
+
+struct SH2S_AsyncSession;
+
+/// Executes HTTP/2 requests without blocking the calling threads.
+///
+/// Requests are multiplexed by a single thread on the I/O loop used
+/// by CHttp2Session, so thousands of them can be outstanding at once.
+/// HTTP/1.x is not supported, use CHttpSession for it.
+///
+/// Requests exceeding the concurrency limit wait in a queue in the order
+/// of submission. The callbacks are called from the internal thread and
+/// must not block. Cookies are not stored nor sent.
+class NCBI_XXCONNECT2_EXPORT CHttpAsyncSession
+{
+public:
+    using TCallback = function<void(SHttpAsyncResponse)>;
+
+    /// @param max_active
+    ///   Max number of requests being executed at a time.
+    CHttpAsyncSession(size_t max_active = 1000);
+
+    /// Requests not completed yet are reported as eCancelled.
+    ~CHttpAsyncSession();
+
+    /// Start request, the callback is called once it is complete.
+    void Execute(SHttpAsyncRequest request, TCallback callback);
+
+    /// Start request, the future becomes ready once it is complete.
+    future<SHttpAsyncResponse> Execute(SHttpAsyncRequest request);
+
+    /// Number of requests submitted but not completed yet.
+    size_t GetPendingCount() const;
+
+    /// Wait until all submitted requests are complete.
+    void WaitAll();
+
+private:
+    CHttpAsyncSession(const CHttpAsyncSession&) = delete;
+    CHttpAsyncSession& operator=(const CHttpAsyncSession&) = delete;
+
+    unique_ptr<SH2S_AsyncSession> m_Impl;
+};
+
+
 
 
 END_NCBI_SCOPE
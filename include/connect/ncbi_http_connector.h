@@ -332,6 +332,63 @@ extern NCBI_XCONNECT_EXPORT CONNECTOR HTTP_CreateConnectorEx
  );
 
 
+/** Keep-alive connection pool hooks.
+ *
+ * - FHTTP_GetConnection() gets called before a new direct (i.e. not proxied)
+ *   connection to "net_info->host:net_info->port" is made;  it may return an
+ *   idle connection previously returned to the pool, which then gets used to
+ *   send the request as if it was kept open by the connector itself (so if it
+ *   turns out to be stale, the request is re-tried with a new connection
+ *   unless its body has already been streamed out, see fHTTP_WriteThru).
+ *   Return NULL to make a new connection.
+ *
+ * - FHTTP_PutConnection() gets called when the connector is being closed and
+ *   its connection is still good for another request (the response has been
+ *   read completely, and the server agreed to keep the connection alive).
+ *   Return non-zero (true) if the pool took the ownership of "sock";  a zero
+ *   (false) return value makes the connector close the socket as usual.
+ *
+ * Both hooks are passed "net_info" as currently stored within the connector.
+ * The pool "data" must outlive the connector (it can be released in the
+ * connector's cleanup callback, which is called after the last use of the
+ * pool).
+ */
+typedef SOCK        (*FHTTP_GetConnection)
+(void*               data,          /**< pool data                           */
+ const SConnNetInfo* net_info       /**< where the connection is to go       */
+ );
+
+typedef int/*bool*/ (*FHTTP_PutConnection)
+(void*               data,          /**< pool data                           */
+ const SConnNetInfo* net_info,      /**< where the connection went           */
+ SOCK                sock           /**< idle connection to keep             */
+ );
+
+typedef struct {
+    void*               data;       /**< pool data passed to the hooks       */
+    FHTTP_GetConnection get;        /**< may be NULL                         */
+    FHTTP_PutConnection put;        /**< may be NULL                         */
+} SHTTP_ConnPool;
+
+
+/** Same as HTTP_CreateConnectorEx() but connections are taken from and
+ * returned to the connection pool specified by "pool" (may be NULL, which
+ * makes the call equivalent to HTTP_CreateConnectorEx()).  The contents of
+ * "pool" are copied into the connector.
+ * @sa
+ *  HTTP_CreateConnectorEx, SHTTP_ConnPool
+ */
+extern NCBI_XCONNECT_EXPORT CONNECTOR HTTP_CreatePooledConnector
+(const SConnNetInfo*   net_info,
+ THTTP_Flags           flags,
+ FHTTP_ParseHeader     parse_header,  /**< may be NULL                       */
+ void*                 user_data,     /**< user data for HTTP CBs            */
+ FHTTP_Adjust          adjust,        /**< may be NULL                       */
+ FHTTP_Cleanup         cleanup,       /**< may be NULL                       */
+ const SHTTP_ConnPool* pool           /**< may be NULL                       */
+ );
+
+
 /** Create a tunnel to "net_info->host:net_info->port" via an HTTP proxy server
  * located at "net_info->http_proxy_host:net_info->http_proxy_port".  Return
  * the tunnel as a socket via the last parameter.  For compatibility with
@@ -468,6 +468,7 @@ public:
 
 class CHttpRequest;
 class CHttpSession_Base;
+class CHttpConnPool;
 
 
 /// HTTP response
@@ -789,6 +790,28 @@ public:
 
     void SetProxy(const CHttpProxy& proxy) { m_Proxy = proxy; }
     const CHttpProxy& GetProxy(void) const { return m_Proxy; }
+
+    /// Set limits of the keep-alive connection pool.
+    /// HTTP/1.x connections which the server agreed to keep alive are
+    /// returned to the pool after the response has been read completely,
+    /// and reused by subsequent requests to the same scheme, host and port.
+    /// Connections via a proxy or with TLS credentials are never pooled.
+    /// The defaults come from [CONN] HTTP_POOL_MAX_PER_HOST,
+    /// HTTP_POOL_MAX_TOTAL and HTTP_POOL_IDLE_TIMEOUT parameters.
+    /// @param max_per_host
+    ///   Max number of idle connections kept for a single host and port,
+    ///   zero disables connection reuse.
+    /// @param max_total
+    ///   Max number of idle connections kept for all hosts,
+    ///   the least recently used ones get closed first.
+    /// @param idle_timeout
+    ///   How long an idle connection is kept in the pool.
+    void SetConnectionPool(unsigned        max_per_host,
+                           unsigned        max_total,
+                           const CTimeout& idle_timeout);
+    /// Close all idle connections kept in the pool.
+    void ClearConnectionPool(void);
+
 private:
     friend class CHttpRequest;
     friend class CHttpResponse;
@@ -807,6 +830,7 @@ private:
     CHttpCookies m_Cookies;
     shared_ptr<CTlsCertCredentials> m_Credentials;
     CHttpProxy   m_Proxy;
+    shared_ptr<CHttpConnPool> m_ConnPool;
 };
 
 
@@ -78,6 +78,8 @@
  *  SOCK_Pushback
  *  SOCK_Status
  *  SOCK_Write
+ *  SOCK_WriteV
+ *  SOCK_SendFile
  *  SOCK_Abort
  *  SOCK_GetLocalPort[Ex]
  *  SOCK_GetRemotePort
@@ -136,6 +138,14 @@
  *  POLLABLE_ToLSOCK
  *  POLLABLE_ToTrigger
  *
+ * Persistent POLLSET API:
+ *
+ *  POLLSET_Create
+ *  POLLSET_Close
+ *  POLLSET_Arm
+ *  POLLSET_Remove
+ *  POLLSET_Wait
+ *
  * Auxiliary:
  *
  *  SOCK_ntoa
@@ -1269,6 +1279,73 @@ extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_Write
  );
 
 
+/** A piece of data for SOCK_WriteV() */
+typedef struct {
+    const void* data;
+    size_t      size;
+} SSOCK_IOVec;
+
+
+/** Write "n" pieces of data described by "iov" to "sock" (in that order), as
+ * if they were a single contiguous block.  Stream sockets without TLS send
+ * the pieces with a single system call (when possible), avoiding both the
+ * copying into one buffer and the extra calls otherwise.
+ * @param sock
+ *  [in]  socket handle
+ * @param iov
+ *  [in]  array of the pieces of data to write
+ * @param n
+ *  [in]  # of elements in "iov"
+ * @param n_written
+ *  [out] total # of written bytes (can be NULL)
+ * @param how
+ *  [in]  either eIO_WritePlain or eIO_WritePersist
+ * @return
+ *  Same as SOCK_Write() would for the entire data.
+ * @sa
+ *  SOCK_Write
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_WriteV
+(SOCK               sock,
+ const SSOCK_IOVec  iov[],
+ size_t             n,
+ size_t*            n_written,
+ EIO_WriteMethod    how
+ );
+
+
+/** Write "size" bytes from the file open as "fd", starting at file position
+ * "offset", to "sock" (the file position of "fd" is not changed).  On Linux,
+ * when the socket has no TLS, the data are sent by the kernel directly from
+ * the page cache (sendfile(2)), otherwise they are read into a temporary
+ * buffer first.  All data pending in the socket are sent prior to the file.
+ * @param sock
+ *  [in]  socket handle (stream socket)
+ * @param fd
+ *  [in]  open file descriptor
+ * @param offset
+ *  [in]  starting position in the file
+ * @param size
+ *  [in]  # of bytes to send
+ * @param n_written
+ *  [out] # of bytes sent (can be NULL)
+ * @return
+ *  eIO_Success if all "size" bytes have been sent;  otherwise, an error code
+ *  (like SOCK_Write() with eIO_WritePersist does), and "*n_written" tells
+ *  how much was sent.  A premature end of the file is reported as eIO_Closed.
+ *  eIO_NotSupported on platforms where file descriptors are not available.
+ * @sa
+ *  SOCK_Write
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status SOCK_SendFile
+(SOCK            sock,
+ int             fd,
+ TNCBI_BigCount  offset,
+ size_t          size,
+ size_t*         n_written
+ );
+
+
 /** If there is outstanding connection or output data pending, cancel it.
  * Mark the socket as if it has been shut down for both reading and writing.
  * Break actual connection if any was established.
@@ -2024,6 +2101,120 @@ extern NCBI_XCONNECT_EXPORT TRIGGER  POLLABLE_ToTRIGGER(POLLABLE);
 
 
 
+/******************************************************************************
+ *  PERSISTENT POLL SET
+ *
+ *  Unlike POLLABLE_Poll(), which passes the entire array of handles to the
+ *  system on each call, a POLLSET keeps its handles registered with the
+ *  system between the waits, so the cost of a wait does not depend on how
+ *  many idle handles are in the set.  The implementation is based on epoll(7)
+ *  and is only available on Linux;  elsewhere, POLLSET_Create() returns
+ *  eIO_NotSupported, and POLLABLE_Poll() should be used instead.
+ *
+ *  Each handle is armed "one-shot":  once it has been reported ready, it
+ *  gets disarmed until POLLSET_Arm() is called for it again.
+ *
+ *  Handles can be armed and removed by other threads while a thread waits
+ *  on the set (one waiting thread at a time);  a handle found ready at the
+ *  time of such arming is reported by the following POLLSET_Wait().
+ */
+
+
+/*fwdecl; opaque*/
+struct SPOLLSET_tag;
+typedef struct SPOLLSET_tag* POLLSET;
+
+typedef struct {
+    void*     data;    /* user data as passed to POLLSET_Arm()               */
+    EIO_Event revent;  /* eIO_Read, eIO_Write, eIO_ReadWrite, or eIO_Close   */
+} SPOLLSET_Event;
+
+
+/** Create a new empty poll set.
+ * @param pollset
+ *  [out] handle of the new poll set (0 on error)
+ * @return
+ *  eIO_NotSupported if persistent poll sets are not available on the
+ *  current platform.
+ * @sa
+ *  POLLSET_Close
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status POLLSET_Create
+(POLLSET* pollset
+ );
+
+
+/** Close the poll set.  Handles in the set are not affected. */
+extern NCBI_XCONNECT_EXPORT EIO_Status POLLSET_Close
+(POLLSET pollset
+ );
+
+
+/** Arm (adding to the set if necessary) a handle for a single readiness
+ * report of the requested event.  Re-arming an armed handle replaces both the
+ * event and the data.  A handle that is already known to be ready (e.g. a
+ * socket with data buffered internally, or a trigger that is set) gets
+ * reported by the next POLLSET_Wait() right away.
+ * @param pollset
+ *  [in]  poll set handle
+ * @param poll
+ *  [in]  socket, listening socket, or trigger
+ * @param event
+ *  [in]  eIO_Read, eIO_Write, or eIO_ReadWrite
+ * @param data
+ *  [in]  user data to return with the event from POLLSET_Wait()
+ * @note  Pending output of the socket (if any) is not flushed by the wait,
+ *        unlike it is with POLLABLE_Poll().
+ * @sa
+ *  POLLSET_Remove, POLLSET_Wait
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status POLLSET_Arm
+(POLLSET   pollset,
+ POLLABLE  poll,
+ EIO_Event event,
+ void*     data
+ );
+
+
+/** Remove the handle from the set.  This must be done before the handle is
+ * closed (or destroyed) while still armed, so that no readiness is reported
+ * for it afterwards.  Removing a handle that is not in the set is no error.
+ * @sa
+ *  POLLSET_Arm
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status POLLSET_Remove
+(POLLSET  pollset,
+ POLLABLE poll
+ );
+
+
+/** Wait for at least one armed handle to get ready.
+ * @param pollset
+ *  [in]  poll set handle
+ * @param events
+ *  [out] array to receive up to "n" ready events
+ * @param n
+ *  [in]  size of the "events" array
+ * @param timeout
+ *  [in]  how long to wait (NULL means infinite)
+ * @param n_ready
+ *  [out] how many elements of "events" have been filled
+ * @return
+ *  eIO_Success if at least one event has been returned, eIO_Timeout if none
+ *  and the timeout had expired, other error code otherwise.
+ * @sa
+ *  POLLSET_Arm, POLLABLE_Poll
+ */
+extern NCBI_XCONNECT_EXPORT EIO_Status POLLSET_Wait
+(POLLSET         pollset,
+ SPOLLSET_Event  events[],
+ size_t          n,
+ const STimeout* timeout,
+ size_t*         n_ready
+ );
+
+
+
 /******************************************************************************
  *  AUXILIARY NETWORK-SPECIFIC FUNCTIONS (added for the portability reasons)
  */
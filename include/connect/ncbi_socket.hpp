@@ -349,6 +349,38 @@ public:
                      size_t*         n_written = 0,
                      EIO_WriteMethod how = eIO_WritePersist);
 
+    /// Write scattered data (as a whole) to socket.
+    /// @param iov
+    ///  Pieces of data to write, in order
+    /// @param n
+    ///  Number of the pieces
+    /// @param n_written
+    ///
+    /// @param how
+    ///  Either eIO_WritePlain or eIO_WritePersist
+    /// @sa
+    ///  SOCK_WriteV, Write
+    EIO_Status WriteV(const SSOCK_IOVec* iov,
+                      size_t             n,
+                      size_t*            n_written = 0,
+                      EIO_WriteMethod    how = eIO_WritePersist);
+
+    /// Send a portion of an open file to socket.
+    /// @param fd
+    ///  File descriptor to read from (its file position is not used)
+    /// @param offset
+    ///  Position in the file to start at
+    /// @param size
+    ///  Number of bytes to send
+    /// @param n_written
+    ///
+    /// @sa
+    ///  SOCK_SendFile
+    EIO_Status SendFile(int     fd,
+                        Uint8   offset,
+                        size_t  size,
+                        size_t* n_written = 0);
+
     /// Abort socket connection.
     /// @sa
     ///  SOCK_Abort
@@ -92,6 +92,11 @@ class CNetCacheServer;
 /// ShutdownRequested) or process data in main thread on timeout (override
 /// ProcessTimeout and set parameter accept_timeout to non-zero value).
 ///
+/// With [server] Use_Poll_Set (environment CSERVER_USE_POLL_SET) enabled,
+/// the connections are kept in a persistent poll set (epoll on Linux), so
+/// that the cost of serving an event does not depend on the number of idle
+/// connections.  Other platforms fall back to polling all connections.
+///
 
 class NCBI_XCONNECT_EXPORT CServer : protected CConnIniter
 {
@@ -525,6 +525,25 @@ public:
     CRef<CSeq_loc>   Map(const CSeq_loc& src_loc);
     /// Take the total range from the location and run it through the mapper.
     CRef<CSeq_loc>   MapTotalRange(const CSeq_loc& seq_loc);
+
+    typedef vector< CConstRef<CSeq_loc> > TSrcLocs;
+    typedef vector< CRef<CSeq_loc> >      TMappedLocs;
+    /// Map a batch of seq-locs. Each mapped_locs[i] is the same as the
+    /// result of Map(*src_locs[i]), null source locations are mapped
+    /// to null references.
+    /// The locations are processed in order of their source ids and
+    /// starts, so the mapping ranges of each source id are found by
+    /// a forward sweep over the sorted ranges rather than by a separate
+    /// search for every interval. This is much faster when a lot of
+    /// locations are mapped through the same mapper, e.g. when all
+    /// features of an annotation are remapped to another assembly.
+    /// If arena is not null, the mapped locations are allocated from it
+    /// instead of the heap. The arena may be released before the mapped
+    /// locations, the memory is freed when all of them are destroyed.
+    /// NOTE: LastIsPartial() is not meaningful after batch mapping.
+    void Map(const TSrcLocs&    src_locs,
+             TMappedLocs&       mapped_locs,
+             CObjectMemoryPool* arena = 0);
     /// Map the whole alignment. Searches all rows for ranges
     /// which can be mapped.
     CRef<CSeq_align> Map(const CSeq_align& src_align);
@@ -949,6 +968,12 @@ private:
     // Map each primary seq-id to sequence length.
     mutable TLengthMap   m_LengthMap;
 
+    // Sorted mapping ranges used while mapping a batch of locations.
+    class CBatchMappingIndex;
+    CBatchMappingIndex*  m_BatchIndex = nullptr;
+    // Memory pool for the mapped locations, if any.
+    CObjectMemoryPool*   m_Arena = nullptr;
+
 protected:
     // Storage for sequence types.
     mutable TSeqTypeById m_SeqTypes;
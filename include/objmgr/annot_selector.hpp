@@ -758,6 +758,26 @@ struct NCBI_XOBJMGR_EXPORT SAnnotSelector : public SAnnotTypeSelector
             return *this;
         }
 
+    /// Load chunks of split blobs before collecting annotations.
+    /// Each resolve level is scanned twice: the first scan only finds
+    /// chunks that are necessary for the search and not loaded yet,
+    /// then all found chunks are requested from their data loaders at
+    /// once, in several concurrent requests, and the second scan collects
+    /// annotations from already loaded data.
+    /// This greatly reduces search time on sequences with many segments
+    /// that have their annotations in split blobs.
+    /// The number of concurrent requests is configured by parameter
+    /// [OBJMGR] PREFETCH_CHUNKS_THREADS.
+    SAnnotSelector& SetPrefetchChunks(bool value = true)
+        {
+            m_PrefetchChunks = value;
+            return *this;
+        }
+    bool GetPrefetchChunks(void) const
+        {
+            return m_PrefetchChunks;
+        }
+
     /// Ignore strand when testing for range overlap
     SAnnotSelector& SetIgnoreStrand(bool value = true)
         {
@@ -873,6 +893,7 @@ protected:
     bool                  m_CollectTypes;
     bool                  m_CollectNames;
     bool                  m_CollectCostOfLoading;
+    bool                  m_PrefetchChunks;
     bool                  m_IgnoreStrand;
     bool                  m_HasWildcardInAnnotsNames;
     TAdaptiveTriggers     m_AdaptiveTriggers;
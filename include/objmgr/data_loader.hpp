@@ -467,8 +467,32 @@ public:
     virtual double EstimateLoadSeconds(const CTSE_Chunk_Info& chunk, Uint4 bytes) const;
 
     virtual unsigned GetDefaultBlobCacheSizeLimit() const;
+    /// Default limit of estimated memory of unlocked blobs kept in cache,
+    /// 0 - means unlimited
+    virtual size_t GetDefaultBlobCacheMemoryLimit() const;
     virtual bool GetTrackSplitSeq() const;
 
+    /// Statistics of unlocked blobs cache
+    struct SBlobCacheStatistics {
+        SBlobCacheStatistics(void)
+            : m_Blobs(0), m_BlobsLimit(0),
+              m_Memory(0), m_MemoryLimit(0),
+              m_EvictedBlobs(0), m_EvictedMemory(0)
+            {
+            }
+        /// Number of blobs in cache
+        size_t m_Blobs;
+        size_t m_BlobsLimit;
+        /// Estimated memory of blobs in cache, limit 0 - means unlimited
+        size_t m_Memory;
+        size_t m_MemoryLimit;
+        /// Total number and estimated memory of blobs evicted from cache
+        Uint8  m_EvictedBlobs;
+        Uint8  m_EvictedMemory;
+    };
+    /// Get current statistics of the blob cache of this loader
+    SBlobCacheStatistics GetBlobCacheStatistics(void) const;
+
 protected:
     /// Register the loader only if the name is not yet
     /// registered in the object manager
@@ -74,6 +74,7 @@ class CAnnot_CI;
 class CSeqMap_CI;
 class CGraphRanges;
 class CIdRangeMap;
+class CTSE_Chunk_Info;
 
 class NCBI_XOBJMGR_EXPORT CAnnotMapping_Info
 {
@@ -502,6 +503,18 @@ private:
     Uint8 x_GetCostOfLoadingInBytes(void) const;
     double x_GetCostOfLoadingInSeconds(void) const;
 
+    // Chunks prefetching, see SAnnotSelector::SetPrefetchChunks().
+    // While the guard is active the search only collects not loaded
+    // chunks instead of loading them and collecting annotations.
+    class CPrefetchChunksGuard;
+    friend class CPrefetchChunksGuard;
+    typedef vector< CConstRef<CTSE_Chunk_Info> > TChunksToLoad;
+
+    bool x_NeedPrefetchChunks(void) const;
+    // true if only chunk stubs are of interest: either the cost of
+    // loading is collected, or the chunks are collected for prefetching
+    bool x_CollectStubsOnly(void) const;
+
     void x_StopSearchLimits(void);
     bool x_MaxSearchSegmentsLimitIsReached(void) const
         {
@@ -536,6 +549,8 @@ private:
     SAnnotSelector::EMaxSearchSegmentsAction m_SearchSegmentsAction;
     bool                    m_FromOtherTSE;
     mutable TAnnotTypes     m_AnnotTypes2;
+    // not loaded chunks collected by the prefetch pass
+    TChunksToLoad*          m_ChunksToLoad;
 
     friend class CAnnotTypes_CI;
     friend class CMappedFeat;
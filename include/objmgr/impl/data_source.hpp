@@ -37,6 +37,7 @@
 
 #include <objects/seq/Seq_inst.hpp>
 #include <objmgr/data_loader.hpp>
+#include <objmgr/objmgr_statistics.hpp>
 
 #include <corelib/ncbimtx.hpp>
 
@@ -296,6 +297,15 @@ public:
     void SetDefaultPriority(TPriority priority);
 
     static unsigned GetDefaultBlobCacheSizeLimit();
+    static size_t GetDefaultBlobCacheMemoryLimit();
+
+    // estimated memory limit of unlocked blobs in cache, 0 - unlimited
+    size_t GetBlobCacheMemoryLimit(void) const;
+    typedef CDataLoader::SBlobCacheStatistics TBlobCacheStatistics;
+    TBlobCacheStatistics GetBlobCacheStatistics(void) const;
+
+    // statistics group of the data loader, or "objmgr" without loader
+    CObjMgrStatGroup& GetStatistics(void) const;
 
     // get locks
     enum FLockFlags {
@@ -541,12 +551,17 @@ private:
     mutable TBlob_Cache   m_Blob_Cache;     // unlocked blobs
     mutable unsigned      m_Blob_Cache_Size;// list<>::size() is slow
     unsigned              m_Blob_Cache_Size_Limit;
+    mutable size_t        m_Blob_Cache_Memory;// estimated memory of blobs
+    size_t                m_Blob_Cache_Memory_Limit;
+    Uint8                 m_Blob_Cache_Evicted;
+    Uint8                 m_Blob_Cache_Evicted_Memory;
 
     // Prefetching thread and lock, used when initializing the thread
     CRef<CPrefetchThreadOld> m_PrefetchThread;
     CFastMutex            m_PrefetchLock;
     unsigned              m_StaticBlobCounter;
     bool                  m_TrackSplitSeq;
+    CObjMgrStatGroup*     m_Statistics;
 
     // hide copy constructor
     CDataSource(const CDataSource&);
@@ -590,6 +605,13 @@ CDataLoader* CDataSource::GetDataLoader(void) const
 }
 
 
+inline
+CObjMgrStatGroup& CDataSource::GetStatistics(void) const
+{
+    return *m_Statistics;
+}
+
+
 inline
 const CConstRef<CObject>& CDataSource::GetSharedObject(void) const
 {
@@ -639,6 +661,13 @@ void CDataSource::SetDefaultPriority(TPriority priority)
 }
 
 
+inline
+size_t CDataSource::GetBlobCacheMemoryLimit(void) const
+{
+    return m_Blob_Cache_Memory_Limit;
+}
+
+
 END_SCOPE(objects)
 END_NCBI_SCOPE
 
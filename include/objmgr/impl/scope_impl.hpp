@@ -642,8 +642,11 @@ private:
     CInitMutexPool       m_MutexPool;
 
     typedef CRWLock                     TConfLock;
-    typedef TConfLock::TReadLockGuard   TConfReadLockGuard;
-    typedef TConfLock::TWriteLockGuard  TConfWriteLockGuard;
+    // contended waits are reported to object manager statistics
+    typedef CGuard<TConfLock, SObjMgrStatReadLock<TConfLock> >
+                                        TConfReadLockGuard;
+    typedef CGuard<TConfLock, SObjMgrStatWriteLock<TConfLock> >
+                                        TConfWriteLockGuard;
     typedef CFastMutex                  TSeq_idMapLock;
 
     mutable TConfLock       m_ConfLock;
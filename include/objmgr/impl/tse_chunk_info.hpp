@@ -299,6 +299,10 @@ protected:
 
     void x_InitObjectIndexList(void);
 
+    // track not loaded chunks which may add annotations to the TSE
+    void x_SetAnnotsPending(void);
+    void x_ResetAnnotsPending(void);
+
 private:
     friend class CTSE_Info;
     friend class CTSE_Split_Info;
@@ -316,6 +320,7 @@ private:
     float            m_LoadSeconds;
 
     bool             m_ExplicitFeatIds;
+    atomic<bool>     m_AnnotsPending;
 
     TDescInfos       m_DescInfos;
     TPlaces          m_AnnotPlaces;
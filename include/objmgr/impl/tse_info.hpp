@@ -45,6 +45,7 @@
 #include <objects/seq/seq_id_handle.hpp>
 
 #include <util/rangemap.hpp>
+#include <util/static_rangemap.hpp>
 #include <corelib/ncbiobj.hpp>
 #include <corelib/ncbimtx.hpp>
 #include <objmgr/impl/annot_object_index.hpp>
@@ -102,9 +103,60 @@ struct NCBI_XOBJMGR_EXPORT SIdAnnotObjs
     
     typedef CRange<TSeqPos>                                  TRange;
     typedef CRangeMultimap<SAnnotObject_Index, TSeqPos>      TRangeMap;
+    typedef CStaticRangeMultimap<SAnnotObject_Index, TSeqPos> TStaticRangeMap;
     typedef vector<TRangeMap*>                               TAnnotSet;
+    typedef vector<TStaticRangeMap*>                         TStaticAnnotSet;
     typedef vector<CConstRef<CSeq_annot_SNP_Info> >          TSNPSet;
 
+    // Iterator over annotation objects of either CRangeMultimap
+    // or compact CStaticRangeMultimap index
+    class CRangeIterator
+    {
+    public:
+        typedef TRangeMap::value_type value_type;
+
+        CRangeIterator(void)
+            : m_Static(false)
+            {
+            }
+
+        bool Valid(void) const
+            {
+                return m_Static? m_StaticIter.Valid(): m_Iter.Valid();
+            }
+        DECLARE_OPERATOR_BOOL(Valid());
+
+        TRange GetInterval(void) const
+            {
+                return m_Static? m_StaticIter.GetInterval(): m_Iter.GetInterval();
+            }
+        const value_type& operator*(void) const
+            {
+                return m_Static? *m_StaticIter: *m_Iter;
+            }
+        const value_type* operator->(void) const
+            {
+                return &**this;
+            }
+        CRangeIterator& operator++(void)
+            {
+                if ( m_Static ) {
+                    ++m_StaticIter;
+                }
+                else {
+                    ++m_Iter;
+                }
+                return *this;
+            }
+
+    private:
+        friend struct SIdAnnotObjs;
+
+        bool                             m_Static;
+        TRangeMap::const_iterator        m_Iter;
+        TStaticRangeMap::const_iterator  m_StaticIter;
+    };
+
     size_t x_GetRangeMapCount(void) const
         {
             return m_AnnotSet.size();
@@ -112,22 +164,41 @@ struct NCBI_XOBJMGR_EXPORT SIdAnnotObjs
     bool x_RangeMapIsEmpty(size_t index) const
         {
             _ASSERT(index < x_GetRangeMapCount());
+            if ( TStaticRangeMap* slot = x_GetStaticSlot(index) ) {
+                return slot->empty();
+            }
             TRangeMap* slot = m_AnnotSet[index];
             return !slot || slot->empty();
         }
-    const TRangeMap& x_GetRangeMap(size_t index) const
+    bool x_RangeMapIsStatic(size_t index) const
         {
-            _ASSERT(!x_RangeMapIsEmpty(index));
-            return *m_AnnotSet[index];
+            return x_GetStaticSlot(index) != 0;
         }
-
-    TRangeMap& x_GetRangeMap(size_t index);
+    // iterate objects intersecting with the range
+    CRangeIterator x_BeginRange(size_t index, const TRange& range) const;
+    // iterate objects starting with the range
+    CRangeIterator x_FindRange(size_t index, const TRange& range) const;
+
+    // Modifiable range map, compact index is converted back if necessary.
+    // Returns number of entries moved from compact index in 'thawed'.
+    TRangeMap& x_GetRangeMap(size_t index, size_t* thawed = 0);
     bool x_CleanRangeMaps(void);
 
-    TAnnotSet m_AnnotSet;
-    TSNPSet   m_SNPSet;
+    // Convert range maps with at least min_size entries into compact
+    // read-only index. Returns number of converted entries.
+    size_t x_FreezeRangeMaps(size_t min_size);
+
+    TAnnotSet       m_AnnotSet;
+    TStaticAnnotSet m_StaticAnnotSet;
+    TSNPSet         m_SNPSet;
 
 private:
+    TStaticRangeMap* x_GetStaticSlot(size_t index) const
+        {
+            return index < m_StaticAnnotSet.size()?
+                m_StaticAnnotSet[index]: 0;
+        }
+
     const SIdAnnotObjs& operator=(const SIdAnnotObjs& objs);
 };
 
@@ -283,6 +354,18 @@ public:
     void SetUsedMemory(size_t size);
     void AddUsedMemory(size_t size);
 
+    // Estimation of memory used by the parsed objects, 0 - means unknown
+    size_t GetObjectMemory(void) const;
+    // Estimation of memory used by the annotation index
+    size_t GetAnnotIndexMemory(void) const;
+    // Total estimation of memory used by this TSE, used for cache limits
+    size_t GetEstimatedMemory(void) const;
+    // Add estimation of the serial object to the parsed object memory,
+    // does nothing if the data source doesn't limit cache memory
+    void AddObjectMemory(const CSerialObject& obj);
+    // Estimate memory used by the serial object and all its sub-objects
+    static size_t EstimateObjectMemory(const CSerialObject& obj);
+
     // Annot index access
     bool HasAnnot(const CAnnotName& name) const;
     bool HasUnnamedAnnot(void) const;
@@ -555,6 +638,8 @@ private:
                           const CSeq_id_Handle& key,
                           const CSeq_annot_SNP_Info& snp_info);
 
+    TRangeMap& x_SetRangeMap(SIdAnnotObjs& objs, size_t index);
+    void x_FreezeAnnotIndex(void);
     void x_MapAnnotObject(TRangeMap& rangeMap,
                           const SAnnotObject_Key& key,
                           const SAnnotObject_Index& index);
@@ -696,6 +781,9 @@ private:
 
     // estimations of memory useage, 0 - means unknown
     size_t                 m_UsedMemory;
+    // updated by chunk loads running in parallel with the cache cleanup
+    atomic<size_t>         m_ObjectMemory;
+    atomic<size_t>         m_AnnotIndexMemory;
 
     //////////////////////////////////////////////////////////////////
     // Runtime state within object manager
@@ -714,6 +802,8 @@ private:
     
     typedef list< CRef<CTSE_Info> > TTSE_Cache;
     mutable TTSE_Cache::iterator   m_CachePosition;
+    // estimated memory accounted in data source cache
+    mutable size_t                 m_CacheMemory;
 
     // lock counter for garbage collector
     mutable CAtomicCounter_WithAutoInit m_LockCounter;
@@ -903,6 +993,27 @@ size_t CTSE_Info::GetUsedMemory(void) const
 }
 
 
+inline
+size_t CTSE_Info::GetObjectMemory(void) const
+{
+    return m_ObjectMemory.load(memory_order_relaxed);
+}
+
+
+inline
+size_t CTSE_Info::GetAnnotIndexMemory(void) const
+{
+    return m_AnnotIndexMemory.load(memory_order_relaxed);
+}
+
+
+inline
+size_t CTSE_Info::GetEstimatedMemory(void) const
+{
+    return max(m_UsedMemory, GetObjectMemory()) + GetAnnotIndexMemory();
+}
+
+
 inline
 const CTSE_Info::TBlobId& CTSE_Info::GetBlobId(void) const
 {
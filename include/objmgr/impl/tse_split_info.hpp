@@ -53,6 +53,7 @@ class CBioseq_Info;
 class CSeq_entry_Info;
 class CDataSource;
 class CDataLoader;
+class CObjMgrStatGroup;
 class CTSE_SetObjectInfo;
 
 class ITSE_Assigner;
@@ -92,6 +93,7 @@ public:
     void SetSplitVersion(TSplitVersion version);
     CInitMutexPool& GetMutexPool(void);
     CDataLoader& GetDataLoader(void) const;
+    CObjMgrStatGroup& GetStatistics(void) const;
 
     // TSE connection
     void x_DSAttach(CDataSource& ds);
@@ -132,6 +134,15 @@ public:
 
     void x_UpdateAnnotIndex(void);
     void x_UpdateAnnotIndex(CTSE_Chunk_Info& chunk);
+    // chunks with annotations that are not loaded yet
+    bool x_HasPendingAnnotChunks(void) const
+        {
+            return m_PendingAnnotChunks.load(memory_order_acquire) != 0;
+        }
+    void x_AddPendingAnnotChunks(int delta)
+        {
+            m_PendingAnnotChunks.fetch_add(delta, memory_order_acq_rel);
+        }
     void x_UpdateFeatIdIndex(CSeqFeatData::E_Choice type,
                              EFeatIdType id_type);
     void x_UpdateFeatIdIndex(CSeqFeatData::ESubtype subtype,
@@ -165,6 +176,7 @@ public:
 
     // update in-memory size
     void x_AddUsedMemory(size_t size);
+    void x_AddObjectMemory(const CSerialObject& obj);
 
     void x_SetBioseqUpdater(CRef<CBioseqUpdater> updater);
 
@@ -188,6 +200,7 @@ private:
     mutable CMutex         m_ChunksMutex;
     TChunks                m_Chunks;
     TChunkId               m_BioseqChunkId;
+    atomic<int>            m_PendingAnnotChunks;
 
     // loading
     CInitMutexPool         m_MutexPool;
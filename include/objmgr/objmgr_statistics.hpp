@@ -0,0 +1,291 @@
+#ifndef OBJECTS_OBJMGR___OBJMGR_STATISTICS__HPP
+#define OBJECTS_OBJMGR___OBJMGR_STATISTICS__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Object manager statistics: counters and call time histograms
+ *
+ */
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbitime.hpp>
+#include <atomic>
+#include <memory>
+
+BEGIN_NCBI_SCOPE
+
+class CPerfLogger;
+
+BEGIN_SCOPE(objects)
+
+/** @addtogroup ObjectManagerCore
+ *
+ * @{
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjMgrStatHistogram --
+///
+///  Lock-free histogram of call times.
+///  Bucket N counts calls that took less than 2^N microseconds
+///  (and not less than 2^(N-1)), the last bucket counts all longer calls.
+
+class NCBI_XOBJMGR_EXPORT CObjMgrStatHistogram
+{
+public:
+    enum {
+        kBucketCount = 28
+    };
+
+    CObjMgrStatHistogram(void);
+
+    void Add(double seconds);
+
+    Uint8 GetCount(void) const
+        {
+            return m_Count.load(memory_order_relaxed);
+        }
+    /// Total time of all calls in seconds
+    double GetTotalTime(void) const
+        {
+            return m_TotalTime.load(memory_order_relaxed)*1e-6;
+        }
+    /// Time of the longest call in seconds
+    double GetMaxTime(void) const
+        {
+            return m_MaxTime.load(memory_order_relaxed)*1e-6;
+        }
+    Uint8 GetBucketCount(size_t bucket) const
+        {
+            _ASSERT(bucket < kBucketCount);
+            return m_Buckets[bucket].load(memory_order_relaxed);
+        }
+    /// Exclusive upper limit of bucket's call time in seconds
+    static double GetBucketLimit(size_t bucket);
+
+    void Reset(void);
+
+private:
+    atomic<Uint8> m_Count;
+    atomic<Uint8> m_TotalTime; // microseconds
+    atomic<Uint8> m_MaxTime; // microseconds
+    atomic<Uint8> m_Buckets[kBucketCount];
+
+private:
+    CObjMgrStatHistogram(const CObjMgrStatHistogram&);
+    void operator=(const CObjMgrStatHistogram&);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjMgrStatGroup --
+///
+///  Named set of counters and call histograms.
+///  Each data source reports into the group named after its data loader,
+///  the process wide object manager events go into the group "objmgr".
+
+class NCBI_XOBJMGR_EXPORT CObjMgrStatGroup
+{
+public:
+    enum ECounter {
+        eCounter_TSE_Loaded,     ///< TSEs loaded by data loader
+        eCounter_TSE_Found,      ///< TSE requests satisfied by loaded TSEs
+        eCounter_TSE_NotFound,   ///< TSE requests that required loading
+        eCounter_TSE_Evicted,    ///< TSEs dropped from the released TSE cache
+        eCounter_Chunk_Loaded,   ///< split chunks loaded by data loader
+        eCounter_TSE_Info_Live,  ///< currently existing CTSE_Info objects
+        eCounter_Count
+    };
+    enum ECall {
+        eCall_GetRecords,
+        eCall_GetBlobs,
+        eCall_GetBlobById,
+        eCall_GetAnnotRecords,
+        eCall_GetIds,
+        eCall_GetSequenceInfo,   ///< single id acc, gi, label, length etc.
+        eCall_GetBulkInfo,       ///< bulk id requests
+        eCall_GetChunk,
+        eCall_GetChunks,
+        eCall_LockWait,          ///< contended scope lock acquisition
+        eCall_Count
+    };
+
+    explicit CObjMgrStatGroup(const string& name);
+
+    const string& GetName(void) const
+        {
+            return m_Name;
+        }
+
+    void Add(ECounter counter, Int8 value = 1)
+        {
+            m_Counters[counter].fetch_add(value, memory_order_relaxed);
+        }
+    Int8 GetCounter(ECounter counter) const
+        {
+            return m_Counters[counter].load(memory_order_relaxed);
+        }
+
+    void AddCall(ECall call, double seconds)
+        {
+            m_Calls[call].Add(seconds);
+        }
+    const CObjMgrStatHistogram& GetCall(ECall call) const
+        {
+            return m_Calls[call];
+        }
+
+    static const char* GetCounterName(ECounter counter);
+    static const char* GetCallName(ECall call);
+
+    /// Print non-zero counters and histograms in text form.
+    /// @param print_histograms
+    ///   Print bucket counts of call histograms too.
+    void Print(CNcbiOstream& out, bool print_histograms = false) const;
+
+    /// Reset all event counters, the gauge of live objects is kept.
+    void Reset(void);
+
+private:
+    string                m_Name;
+    atomic<Int8>          m_Counters[eCounter_Count];
+    CObjMgrStatHistogram  m_Calls[eCall_Count];
+
+private:
+    CObjMgrStatGroup(const CObjMgrStatGroup&);
+    void operator=(const CObjMgrStatGroup&);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjMgrStatistics --
+///
+///  Process wide registry of statistics groups.
+///  Groups are never deleted, so references to them stay valid
+///  until the program exits.
+
+class NCBI_XOBJMGR_EXPORT CObjMgrStatistics
+{
+public:
+    /// Get or create group by name.
+    static CObjMgrStatGroup& GetGroup(const string& name);
+    /// Group of process wide object manager events.
+    static CObjMgrStatGroup& GetObjMgrGroup(void);
+
+    typedef vector<CObjMgrStatGroup*> TGroups;
+    /// Get all groups sorted by name.
+    static TGroups GetGroups(void);
+
+    /// Print all groups.
+    static void Print(CNcbiOstream& out, bool print_histograms = false);
+    /// Reset all groups.
+    static void Reset(void);
+
+    /// Check if individual loader calls are posted through CPerfLogger.
+    /// Enabled by [OBJMGR] STATISTICS_PERF_LOG configuration parameter
+    /// and requires performance logging to be on.
+    static bool IsPerfLogEnabled(void);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjMgrStatCallGuard --
+///
+///  Measure time of a call and add it to the group's histogram.
+///  When enabled, the call is also posted through CPerfLogger.
+
+class NCBI_XOBJMGR_EXPORT CObjMgrStatCallGuard
+{
+public:
+    CObjMgrStatCallGuard(CObjMgrStatGroup& group,
+                         CObjMgrStatGroup::ECall call);
+    ~CObjMgrStatCallGuard(void);
+
+private:
+    CObjMgrStatGroup&         m_Group;
+    CObjMgrStatGroup::ECall   m_Call;
+    CStopWatch                m_Timer;
+    unique_ptr<CPerfLogger>   m_PerfLogger;
+    int                       m_UncaughtExceptions;
+
+private:
+    CObjMgrStatCallGuard(const CObjMgrStatCallGuard&);
+    void operator=(const CObjMgrStatCallGuard&);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  SObjMgrStatReadLock, SObjMgrStatWriteLock --
+///
+///  Lock functors for CGuard<> adding contended lock wait time
+///  to the object manager group.  Uncontended locks are not timed.
+
+template<class Class>
+struct SObjMgrStatReadLock
+{
+    void operator()(Class& inst) const
+    {
+        if ( !inst.TryReadLock() ) {
+            CStopWatch timer(CStopWatch::eStart);
+            inst.ReadLock();
+            CObjMgrStatistics::GetObjMgrGroup()
+                .AddCall(CObjMgrStatGroup::eCall_LockWait, timer.Elapsed());
+        }
+    }
+};
+
+
+template<class Class>
+struct SObjMgrStatWriteLock
+{
+    void operator()(Class& inst) const
+    {
+        if ( !inst.TryWriteLock() ) {
+            CStopWatch timer(CStopWatch::eStart);
+            inst.WriteLock();
+            CObjMgrStatistics::GetObjMgrGroup()
+                .AddCall(CObjMgrStatGroup::eCall_LockWait, timer.Elapsed());
+        }
+    }
+};
+
+
+/* @} */
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif // OBJECTS_OBJMGR___OBJMGR_STATISTICS__HPP
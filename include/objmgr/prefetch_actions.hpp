@@ -86,6 +86,8 @@ public:
                     const CSeq_id_Handle& id);
 
     virtual bool Execute(CRef<CPrefetchRequest> token);
+    virtual size_t GetResultMemory(void) const;
+    virtual void ReleaseResult(void);
 
     const CSeq_id_Handle& GetSeq_id(void) const
         {
@@ -133,6 +135,8 @@ public:
                      const SAnnotSelector& selector);
 
     virtual bool Execute(CRef<CPrefetchRequest> token);
+    virtual size_t GetResultMemory(void) const;
+    virtual void ReleaseResult(void);
 
     const SAnnotSelector& GetSelector(void) const
         {
@@ -180,6 +184,10 @@ public:
             m_Result = m_Handle.GetCompleteObject();
             return m_Result;
         }
+    virtual void ReleaseResult(void)
+        {
+            m_Result.Reset();
+        }
 
     const THandle GetHandle(void) const
         {
@@ -211,6 +219,7 @@ public:
                       const CSeq_id_Handle& seq_id);
 
     virtual bool Execute(CRef<CPrefetchRequest> token);
+    virtual void ReleaseResult(void);
 
     const THandle GetHandle(void) const
         {
@@ -77,6 +77,13 @@ public:
     virtual ~IPrefetchAction(void);
     
     virtual bool Execute(CRef<CPrefetchRequest> token) = 0;
+
+    /// Estimated memory in bytes held by the result of the executed action.
+    /// It's used by memory limited CPrefetchSequence, 0 means unknown.
+    virtual size_t GetResultMemory(void) const;
+
+    /// Release the result, and TSE locks held by it, after it's consumed.
+    virtual void ReleaseResult(void);
 };
 
 
@@ -163,19 +170,46 @@ public:
     CPrefetchSequence(CPrefetchManager& manager,
                       IPrefetchActionSource* source,
                       size_t active_size = 10);
+    /// Bounded sequence for streaming processing.
+    /// No more than max_active actions are queued, running, or finished but
+    /// not consumed yet, and no new actions are started while the estimated
+    /// memory of results ahead of the consumer reaches max_memory bytes.
+    /// The result of each token is released by the next GetNextToken() call,
+    /// so the consumer must not use it after advancing.
+    CPrefetchSequence(CPrefetchManager& manager,
+                      IPrefetchActionSource* source,
+                      size_t max_active,
+                      size_t max_memory);
     ~CPrefetchSequence(void);
     
     /// Returns next action waiting for its result if necessary
     CRef<CPrefetchRequest> GetNextToken(void);
 
+    /// Estimated memory of finished but not consumed results,
+    /// including the current token in bounded mode.
+    size_t GetPrefetchedMemory(void) const;
+    /// Number of actions in the sequence ahead of the consumer
+    size_t GetActiveCount(void) const;
+
 protected:
     void EnqueNextAction(void);
+    void x_EnqueActions(void);
+    size_t x_GetPrefetchedMemory(size_t* completed_count = 0,
+                                 size_t* running_count = 0) const;
+    void x_ReleaseCurrentToken(void);
 
 private:
     CRef<CPrefetchManager>          m_Manager;
     CIRef<IPrefetchActionSource>    m_Source;
-    CMutex                          m_Mutex;
+    mutable CMutex                  m_Mutex;
     list< CRef<CPrefetchRequest> >  m_ActiveTokens;
+    size_t                          m_MaxActive;
+    size_t                          m_MaxMemory;
+    bool                            m_ReleaseConsumed;
+    CRef<CPrefetchRequest>          m_CurrentToken;
+    // statistics of consumed results for estimation of running actions
+    size_t                          m_ConsumedCount;
+    size_t                          m_ConsumedMemory;
 };
 
 
@@ -177,6 +177,7 @@ private:
 
     friend class CBioseq_Handle;
     friend class CSeqVector_CI;
+    friend class CSeqVector_SpanCI;
 
     void x_InitSequenceType(void);
 
@@ -210,6 +211,74 @@ private:
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CSeqVector_SpanCI --
+///
+///  Iterate read-only views of the Seq-data literals covering a range of
+///  CSeqVector, without copying or converting the data.
+///  Each span is a run of residues stored contiguously in one Seq-data
+///  in its original coding (GetCoding() of the span, not of CSeqVector).
+///  Gaps are reported as spans without data.
+///  For packed codings (ncbi2na, ncbi4na) the first residue of the span
+///  is at GetDataOffset() within the first byte of GetData().
+///  If GetStrand() is eNa_strand_minus the stored residues must be read
+///  from the last one back and complemented to get the CSeqVector order.
+///  The data pointer is valid until the iterator is advanced or destroyed.
+
+class NCBI_XOBJMGR_EXPORT CSeqVector_SpanCI : public CSeqVectorTypes
+{
+public:
+    CSeqVector_SpanCI(void);
+    /// Iterate over the interval [start, stop) of the vector.
+    explicit
+    CSeqVector_SpanCI(const CSeqVector& seq_vector,
+                      TSeqPos start = 0,
+                      TSeqPos stop = kInvalidSeqPos);
+    ~CSeqVector_SpanCI(void);
+
+    bool IsValid(void) const;
+    DECLARE_OPERATOR_BOOL(IsValid());
+
+    CSeqVector_SpanCI& operator++(void);
+
+    /// Position of the span in CSeqVector coordinates
+    TSeqPos GetPos(void) const;
+    TSeqPos GetEndPos(void) const;
+    /// Number of residues in the span
+    TSeqPos GetLength(void) const;
+
+    /// true if the span is a gap, there is no data then
+    bool IsInGap(void) const;
+
+    /// Coding of the stored data
+    TCoding GetCoding(void) const;
+    /// Pointer to the byte containing the first stored residue of the span
+    const char* GetData(void) const;
+    /// Index of the first stored residue within the first byte,
+    /// always 0 for unpacked codings
+    TSeqPos GetDataOffset(void) const;
+    /// Number of bytes covering the stored residues
+    size_t GetDataSize(void) const;
+    /// eNa_strand_minus if the data is reverse complement of the vector
+    ENa_strand GetStrand(void) const;
+
+    const CSeqMap_CI& GetCurrentSeqMap_CI(void) const;
+
+private:
+    void x_Update(void);
+
+    CSeqMap_CI  m_Seg;
+    TSeqPos     m_Stop;
+    TSeqPos     m_Pos;
+    TSeqPos     m_Length;
+    TCoding     m_DataCoding;
+    const char* m_Data;
+    TSeqPos     m_DataOffset;
+    ENa_strand  m_DataStrand;
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 ///
 ///  CNcbi2naRandomizer --
@@ -377,6 +446,76 @@ void CSeqVector::GetSeqData(const const_iterator& start,
 }
 
 
+inline
+bool CSeqVector_SpanCI::IsValid(void) const
+{
+    return m_Pos < m_Stop;
+}
+
+
+inline
+TSeqPos CSeqVector_SpanCI::GetPos(void) const
+{
+    return m_Pos;
+}
+
+
+inline
+TSeqPos CSeqVector_SpanCI::GetEndPos(void) const
+{
+    return m_Pos + m_Length;
+}
+
+
+inline
+TSeqPos CSeqVector_SpanCI::GetLength(void) const
+{
+    return m_Length;
+}
+
+
+inline
+bool CSeqVector_SpanCI::IsInGap(void) const
+{
+    return !m_Data;
+}
+
+
+inline
+CSeqVector_SpanCI::TCoding CSeqVector_SpanCI::GetCoding(void) const
+{
+    return m_DataCoding;
+}
+
+
+inline
+const char* CSeqVector_SpanCI::GetData(void) const
+{
+    return m_Data;
+}
+
+
+inline
+TSeqPos CSeqVector_SpanCI::GetDataOffset(void) const
+{
+    return m_DataOffset;
+}
+
+
+inline
+ENa_strand CSeqVector_SpanCI::GetStrand(void) const
+{
+    return m_DataStrand;
+}
+
+
+inline
+const CSeqMap_CI& CSeqVector_SpanCI::GetCurrentSeqMap_CI(void) const
+{
+    return m_Seg;
+}
+
+
 /* @} */
 
 
@@ -105,6 +105,8 @@ public:
     typedef map<CID2S_Chunk_Id, CRef<CID2S_Chunk> > TID2Chunks;
     typedef vector< CRef<CAnnotPieces> > TPieces;
     typedef CSeqsRange::TRange TRange;
+    typedef map<CConstRef<CSeq_annot>,
+                CSeq_annot_SplitInfo::SSizes> TAnnotSizes;
 
     bool Split(const CSeq_entry& entry);
 
@@ -128,6 +130,13 @@ public:
                       TSeqPos seq_length,
                       CSeq_inst& dst, const CSeq_inst& src);
     bool CopyAnnot(CPlace_SplitInfo& place_info, const CSeq_annot& annot);
+    bool CanSplitAnnot(const CSeq_annot& annot) const;
+
+    // estimate sizes of all splittable Seq-annots in parallel threads
+    void CollectAnnotSizes(const CSeq_entry& entry);
+    // sizes estimated by CollectAnnotSizes(), or null
+    const CSeq_annot_SplitInfo::SSizes*
+    GetAnnotSizes(const CSeq_annot& annot) const;
 
     bool CanSplitBioseq(const CBioseq& bioseq) const;
     bool SplitBioseq(CPlace_SplitInfo& place_info, const CBioseq& bioseq);
@@ -209,6 +218,8 @@ private:
 
     TEntries m_Entries;
 
+    TAnnotSizes m_AnnotSizes;
+
     TPieces m_Pieces;
 
     TChunks m_Chunks;
@@ -76,6 +76,10 @@ struct NCBI_ID2_SPLIT_EXPORT SSplitterParams
     bool         m_JoinSmallChunks;
     bool         m_SplitWholeBioseqs;
     bool         m_SplitNonFeatureSeqTables;
+
+    /// Number of threads used for size estimation of annotations.
+    /// The split result does not depend on it.
+    unsigned     m_ThreadCount;
 };
 
 
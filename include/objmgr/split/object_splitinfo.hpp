@@ -78,6 +78,7 @@ class CID2S_Chunk_Id;
 class CID2S_Chunk;
 class CBlobSplitter;
 class CBlobSplitterImpl;
+class CAsnSizer;
 struct SSplitterParams;
 
 
@@ -103,16 +104,16 @@ public:
         }
     CAnnotObject_SplitInfo(const CSeq_feat& obj,
                            const CBlobSplitterImpl& impl,
-                           CSize::TSizeRatio ratio);
+                           const CSize& size);
     CAnnotObject_SplitInfo(const CSeq_align& obj,
                            const CBlobSplitterImpl& impl,
-                           CSize::TSizeRatio ratio);
+                           const CSize& size);
     CAnnotObject_SplitInfo(const CSeq_graph& obj,
                            const CBlobSplitterImpl& impl,
-                           CSize::TSizeRatio ratio);
+                           const CSize& size);
     CAnnotObject_SplitInfo(const CSeq_table& obj,
                            const CBlobSplitterImpl& impl,
-                           CSize::TSizeRatio ratio);
+                           const CSize& size);
 
     TAnnotPriority GetPriority(void) const;
     TAnnotPriority CalcPriority(void) const;
@@ -182,6 +183,21 @@ public:
 
     CSeq_annot_SplitInfo(void);
 
+    // sizes of the whole Seq-annot and of each of its objects
+    struct SSizes
+    {
+        typedef vector<CSize> TObjectSizes;
+
+        CSize        m_Size;
+        TObjectSizes m_ObjectSizes;
+    };
+    // calculate sizes without touching any shared state,
+    // so it can be done in parallel for different Seq-annots
+    static void CalcSizes(SSizes& sizes,
+                          const CSeq_annot& annot,
+                          const SSplitterParams& params,
+                          CAsnSizer& sizer);
+
     void SetSeq_annot(const CSeq_annot& annot,
                       const SSplitterParams& params,
                       const CBlobSplitterImpl& impl);
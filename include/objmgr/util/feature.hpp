@@ -246,6 +246,15 @@ public:
         return m_SNPStrandMode;
     }
     void SetSNPStrandMode(ESNPStrandMode mode);
+
+    /// Number of threads used to match features to parent candidates
+    /// by overlap, 1 by default.
+    /// The matching is split only for large sets of features, and the
+    /// resulting tree doesn't depend on the number of threads.
+    unsigned GetThreadCount(void) const {
+        return m_ThreadCount;
+    }
+    void SetThreadCount(unsigned count);
     
     /// Add all features collected by a CFeat_CI to the tree.
     void AddFeatures(CFeat_CI it);
@@ -423,6 +432,7 @@ protected:
     EGeneCheckMode m_GeneCheckMode;
     bool m_IgnoreMissingGeneXref;
     ESNPStrandMode m_SNPStrandMode;
+    unsigned m_ThreadCount;
     CRef<CFeatTreeIndex> m_Index;
 };
 
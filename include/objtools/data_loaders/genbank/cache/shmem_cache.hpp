@@ -0,0 +1,208 @@
+#ifndef SHMEM_CACHE__HPP_INCLUDED
+#define SHMEM_CACHE__HPP_INCLUDED
+
+/*  $Id$
+* ===========================================================================
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+* ===========================================================================
+*
+*  Author:  agent
+*
+*  File Description: ICache implementation in a memory mapped file
+*                    shared by all processes on the same host
+*
+*/
+
+#include <corelib/ncbifile.hpp>
+#include <util/cache/icache.hpp>
+
+#include <memory>
+
+BEGIN_NCBI_SCOPE
+
+/// Name of the shared memory ICache driver
+#define NCBI_GBLOADER_SHMEM_CACHE_DRIVER_NAME "shmem"
+
+/// ICache implementation in a memory mapped file.
+///
+/// The file consists of a small header, a fixed open addressing hash
+/// table of entry slots, and a data area used as a ring buffer of
+/// serialized records.  Several processes on one host may open the same
+/// file, so data loaded by one of the worker processes becomes
+/// available to all others without downloading and storing it again.
+///
+/// Readers do not take any lock: slots are protected by sequence
+/// counters, and a record is accepted only if the ring writer did not
+/// pass over it while it was being copied.  Writers are serialized by
+/// an inter-process spin lock in the file header.  Eviction is implicit:
+/// new records overwrite the oldest ones in the ring, and slots of the
+/// overwritten records are reused.
+///
+/// Blob versions are kept separately, the most recently stored or
+/// explicitly set version of each key/subkey is the current one.
+/// Blobs larger than a quarter of the data area are not cached.
+class NCBI_XREADER_CACHE_EXPORT CSharedMemoryCache : public ICache
+{
+public:
+    /// Create cache object without file, it will not store anything.
+    CSharedMemoryCache(void);
+    /// Open or create the cache file.
+    /// @param file_name
+    ///   Name of memory mapped file.
+    /// @param data_size
+    ///   Size of the data area, used only when the file is created.
+    /// @param slot_count
+    ///   Number of entry slots, used only when the file is created,
+    ///   0 means derive it from the data size.
+    CSharedMemoryCache(const string& file_name,
+                       Uint8 data_size,
+                       size_t slot_count = 0);
+    ~CSharedMemoryCache(void);
+
+    const string& GetFileName(void) const
+        {
+            return m_FileName;
+        }
+
+    // ICache interface
+    virtual TFlags GetFlags(void);
+    virtual void SetFlags(TFlags flags);
+
+    virtual void SetTimeStampPolicy(TTimeStampFlags policy,
+                                    unsigned int    timeout,
+                                    unsigned int    max_timeout = 0);
+    virtual TTimeStampFlags GetTimeStampPolicy(void) const;
+    virtual int GetTimeout(void) const;
+    virtual bool IsOpen(void) const;
+
+    virtual void SetVersionRetention(EKeepVersions policy);
+    virtual EKeepVersions GetVersionRetention(void) const;
+
+    virtual void Store(const string&  key,
+                       TBlobVersion   version,
+                       const string&  subkey,
+                       const void*    data,
+                       size_t         size,
+                       unsigned int   time_to_live = 0,
+                       const string&  owner = kEmptyStr);
+    virtual size_t GetSize(const string&  key,
+                           TBlobVersion   version,
+                           const string&  subkey);
+    virtual void GetBlobOwner(const string&  key,
+                              TBlobVersion   version,
+                              const string&  subkey,
+                              string*        owner);
+    virtual bool Read(const string& key,
+                      TBlobVersion  version,
+                      const string& subkey,
+                      void*         buf,
+                      size_t        buf_size);
+    virtual IReader* GetReadStream(const string&  key,
+                                   TBlobVersion   version,
+                                   const string&  subkey);
+    virtual IReader* GetReadStream(const string&         key,
+                                   const string&         subkey,
+                                   TBlobVersion*         version,
+                                   EBlobVersionValidity* validity);
+    virtual void SetBlobVersionAsCurrent(const string&  key,
+                                         const string&  subkey,
+                                         TBlobVersion   version);
+    virtual void GetBlobAccess(const string&     key,
+                               TBlobVersion      version,
+                               const string&     subkey,
+                               SBlobAccessDescr* blob_descr);
+    virtual IWriter* GetWriteStream(const string&  key,
+                                    TBlobVersion   version,
+                                    const string&  subkey,
+                                    unsigned int   time_to_live = 0,
+                                    const string&  owner = kEmptyStr);
+    virtual void Remove(const string&  key,
+                        TBlobVersion   version,
+                        const string&  subkey);
+    virtual time_t GetAccessTime(const string&  key,
+                                 TBlobVersion   version,
+                                 const string&  subkey);
+    virtual bool HasBlobs(const string&  key,
+                          const string&  subkey);
+    virtual void Purge(time_t access_timeout);
+    virtual void Purge(const string&  key,
+                       const string&  subkey,
+                       time_t         access_timeout);
+
+    virtual bool SameCacheParams(const TCacheParams* params) const;
+    virtual string GetCacheName(void) const;
+
+    struct SHeader;
+    struct SSlot;
+
+private:
+    friend class CSharedMemoryCache_WriterGuard;
+
+    struct SEntry;
+
+    bool x_Find(const string& key, TBlobVersion version,
+                const string& subkey, SEntry& entry,
+                bool get_data = true);
+    bool x_FindCurrentVersion(const string& key, const string& subkey,
+                              TBlobVersion& version, unsigned& age);
+    void x_Store(const string& key, TBlobVersion version,
+                 const string& subkey, const void* data, size_t size);
+    bool x_Remove(const string& key, TBlobVersion version,
+                  const string& subkey);
+
+    void x_LockWriter(void);
+    void x_UnlockWriter(void);
+
+    char* x_GetData(void) const;
+    SSlot* x_GetSlots(void) const;
+    bool x_IsExpired(unsigned age) const;
+
+    string                  m_FileName;
+    unique_ptr<CMemoryFile> m_File;
+    SHeader*                m_Header;
+    TFlags                  m_Flags;
+    TTimeStampFlags         m_TimeStampFlags;
+    unsigned                m_Timeout;
+    EKeepVersions           m_VersionRetention;
+
+private:
+    CSharedMemoryCache(const CSharedMemoryCache&);
+    void operator=(const CSharedMemoryCache&);
+};
+
+
+extern "C"
+{
+
+NCBI_XREADER_CACHE_EXPORT
+void NCBI_EntryPoint_xcache_shmem(
+     CPluginManager<ICache>::TDriverInfoList&   info_list,
+     CPluginManager<ICache>::EEntryPointRequest method);
+
+NCBI_XREADER_CACHE_EXPORT
+void Cache_RegisterDriver_SharedMemory(void);
+
+} // extern C
+
+
+END_NCBI_SCOPE
+
+#endif // SHMEM_CACHE__HPP_INCLUDED
@@ -140,6 +140,22 @@ public:
     void ExtendReadHooks(t_more_hooks hooks);
     void ResetTopEntry();
 
+    // Persistent sidecar index.
+    // WriteIndex() scans the whole file and saves the bioseq and bioseq-set
+    // records of every blob (Seq-ids, file offsets, lengths, parent sets,
+    // descriptors) into a memory-mappable file. After a successful
+    // OpenIndex() GetNextBlob() restores the records from the index instead
+    // of scanning the blob. The index is rejected if the size or the
+    // modification time of the file has changed since it was written,
+    // or if any of its records points outside of the index file.
+    // Only the data collected by the reader's own hooks is saved, so the
+    // index is not suitable for readers relying on ExtendReadHooks().
+    static string GetIndexName(const string& filename);
+    void WriteIndex(const string& index_name) const;
+    bool OpenIndex(const string& index_name);
+    void CloseIndex();
+    bool HasIndex() const { return m_index.get() != nullptr; }
+
 protected:
     // temporary structure for indexing
     struct TBioseqInfoRec
@@ -167,8 +183,13 @@ protected:
 
 
 private:
+    struct SIndexBlob;
+
     void x_ResetIndex();
     void x_IndexNextAsn1();
+    void x_WriteBlobIndex(CNcbiOstream& out, SIndexBlob& blob) const;
+    const SIndexBlob* x_FindIndexedBlob(TFileSize pos) const;
+    void x_LoadIndexedBlob(const SIndexBlob& blob);
     void x_ThrowDuplicateId(
         const TBioseqSetInfo& existingInfo,const TBioseqSetInfo& newInfo, const CSeq_id& duplicateId);
 
@@ -180,6 +201,7 @@ private:
     TStreamPos              m_current_pos      = 0; // points to current blob in concatenated ASN.1 file
     CHugeFile*              m_file             = nullptr;
     std::list<t_more_hooks> m_more_hooks;
+    unique_ptr<CMemoryFile> m_index;
 
 // global lists, readonly after indexing
 protected:
@@ -69,6 +69,13 @@ public:
     void OpenFile(const string& file_name, const set<TTypeInfo>* types);
     void OpenReader();
 
+    /// Write the sidecar index of the open file, by default next to it.
+    /// See CHugeAsnReader::WriteIndex().
+    void WriteIndex(const string& index_name = kEmptyStr);
+    /// Make the reader use a previously written sidecar index.
+    /// Returns false if there is no index or it is out of date.
+    bool OpenIndex(const string& index_name = kEmptyStr);
+
     using THandler    = std::function<void(CConstRef<CSubmit_block>, CRef<CSeq_entry>)>;
     using THandlerIds = std::function<bool(CHugeAsnReader*, const std::list<CConstRef<CSeq_id>>&)>;
     using THandlerBlobs   = std::function<bool(CHugeFileProcess&)>;
@@ -147,6 +147,21 @@ public:
     /// Read multiple sequences (by default, as many as are available.)
     CRef<CSeq_entry> ReadSet(int max_seqs = kMax_Int, ILineErrorListener* pMessageListener = nullptr);
 
+    /// Read all remaining sequences, parsing batches of records on a pool
+    /// of worker threads while this thread splits the input at deflines.
+    /// The result is the same as that of ReadSet(), and records and
+    /// messages are delivered in input order.  With fUniqueIDs, IDs are
+    /// checked in input order as batches are merged, so duplicates are
+    /// reported as ReadSet() reports them.  A batch with records that
+    /// need generated IDs is parsed again when it is merged, so these
+    /// IDs are also the same as with ReadSet().
+    /// Subclasses, fOneSeq, fNoParseID, masks and postponed mods are
+    /// handled by falling back to ReadSet().
+    /// @param num_threads
+    ///   Number of worker threads; 0 means one per CPU.
+    CRef<CSeq_entry> ReadSetParallel(unsigned int num_threads = 0,
+                                     ILineErrorListener* pMessageListener = nullptr);
+
     /// Read as many sequences as are available, and interpret them as
     /// an alignment, with hyphens marking relative deletions.
     /// @param reference_row
@@ -333,6 +348,22 @@ private:
 
     void x_SetDeflineParseInfo(SDefLineParseInfo& info);
 
+    void x_CheckUniqueIDs(const CBioseq::TId& ids, Uint8 line_number,
+                          ILineErrorListener* pMessageListener);
+
+    bool x_CanReadInParallel(void) const;
+    // A reader over one batch of records, sharing this one's settings
+    // and ID tracker.
+    unique_ptr<CFastaReader> x_CreateBatchReader(ILineReader& reader) const;
+
+    // IDs of a batch reader's records, to be checked for uniqueness
+    // when the batch is merged; set for batch readers only.
+    struct SDeferredIDs;
+    vector<SDeferredIDs>* m_DeferredIDs = nullptr;
+    // A batch reader met a record without IDs, see GenerateID().
+    bool m_NeedsGeneratedID = false;
+    friend class CFastaBatchTask;
+
     bool m_bModifiedMaxIdLength=false;
 
 protected:
@@ -488,6 +519,68 @@ void NCBI_XOBJREAD_EXPORT ScanFastaFile(IFastaEntryScan* scanner,
                                         CFastaReader::TFlags fread_flags);
 
 
+/// Lightweight sequential access to the records of a FASTA file, for
+/// callers that need only the raw defline and residues of each record
+/// (indexing, k-mer counting and the like).  No Seq-ids are parsed and
+/// no Seq-entry is built; the views returned remain valid only until the
+/// iterator is advanced.  Comment lines and gap lines (">?...") are
+/// skipped, and no residue validation is done.  As with CFastaReader,
+/// ">?_" starts a defline rather than a gap.
+///
+/// @code
+/// for (CFastaRecordIterator it(*line_reader);  it;  ++it) {
+///     Process(it.GetId(), it.GetSequence());
+/// }
+/// @endcode
+///
+/// @sa CFastaReader, ScanFastaFile
+class NCBI_XOBJREAD_EXPORT CFastaRecordIterator
+{
+public:
+    enum EPacking {
+        ePacking_None,  ///< Residues as they appear in the input
+        ePacking_2na,   ///< ncbi2na; ambiguous residues are not preserved
+        ePacking_4na    ///< ncbi4na
+    };
+
+    /// Position on the first record of the input.
+    CFastaRecordIterator(ILineReader& reader,
+                         EPacking packing = ePacking_None);
+
+    DECLARE_OPERATOR_BOOL(m_Valid);
+
+    /// Advance to the next record.
+    CFastaRecordIterator& operator++(void);
+
+    /// First word of the defline, which normally holds the ID(s).
+    CTempString GetId(void) const
+        { return CTempString(m_Defline, m_IdPos, m_IdLength); }
+    /// Whole defline, without the leading '>'.
+    CTempString GetDefline(void) const { return m_Defline; }
+    /// Residues, or packed data if packing was requested.
+    CTempString GetSequence(void) const;
+    /// Number of residues in the record.
+    TSeqPos GetLength(void) const { return TSeqPos(m_Residues.size()); }
+    EPacking GetPacking(void) const { return m_Packing; }
+    /// Line number of the defline.
+    Uint8 GetLineNumber(void) const { return m_LineNumber; }
+
+private:
+    void x_Read(void);
+
+    CRef<ILineReader> m_Reader;
+    EPacking          m_Packing;
+    bool              m_Valid;
+    Uint8             m_LineNumber;
+    string            m_Defline;
+    size_t            m_IdPos;
+    size_t            m_IdLength;
+    string            m_Residues;
+    string            m_Packed;
+};
+
+
+
 /////////////////// CFastaReader inline methods
 
 
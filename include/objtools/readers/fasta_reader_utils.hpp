@@ -31,6 +31,7 @@
 */
 
 #include <corelib/ncbicntr.hpp>
+#include <corelib/ncbimtx.hpp>
 
 #include <objects/seqloc/Seq_id.hpp>
 #include <objects/seq/seq_id_handle.hpp>
@@ -207,24 +208,43 @@ public:
     virtual CRef<CSeq_id> GenerateID(const string& defline, bool unique_id=true);
 
 
+    // The cache of seen ids is split into independently locked shards,
+    // so that readers parsing records in parallel can share one handler.
     void ClearIdCache(void) {
-        m_PreviousIdHandles.clear();
+        for (auto& shard : m_PreviousIdHandles) {
+            CFastMutexGuard guard(shard.m_Mutex);
+            shard.m_Ids.clear();
+        }
     }
 
     bool CacheIdHandle(CSeq_id_Handle idh) {
-        return m_PreviousIdHandles.insert(idh).second;
+        SIdCacheShard& shard = x_GetShard(idh);
+        CFastMutexGuard guard(shard.m_Mutex);
+        return shard.m_Ids.insert(idh).second;
     }
 
 protected:
 
     bool x_IsUniqueIdHandle(CSeq_id_Handle idh) {
-        return (m_PreviousIdHandles.find(idh) == m_PreviousIdHandles.end());
+        SIdCacheShard& shard = x_GetShard(idh);
+        CFastMutexGuard guard(shard.m_Mutex);
+        return (shard.m_Ids.find(idh) == shard.m_Ids.end());
     }
 
 
     using TIdHandleCache = set<CSeq_id_Handle>;
+    struct SIdCacheShard {
+        CFastMutex     m_Mutex;
+        TIdHandleCache m_Ids;
+    };
+    enum { kIdCacheShards = 16 };
+
+    SIdCacheShard& x_GetShard(const CSeq_id_Handle& idh) {
+        return m_PreviousIdHandles[idh.GetHash() % kIdCacheShards];
+    }
+
     CRef<CSeqIdGenerator> mp_IdGenerator;
-    TIdHandleCache m_PreviousIdHandles;
+    SIdCacheShard m_PreviousIdHandles[kIdCacheShards];
 };
 
 
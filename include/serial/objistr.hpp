@@ -810,8 +810,24 @@ public:
         {
             return m_MemoryPool;
         }
+    /// Scope of the memory pool created by UseMemoryPool()
+    enum EMemoryPoolScope {
+        /// One pool for all objects read from the stream
+        eMemoryPool_Stream,
+        /// Separate pool (arena) for each top-level object, so that memory
+        /// chunks of one object graph are never shared with the next one,
+        /// and are all released when the graph is destroyed
+        eMemoryPool_Object
+    };
     // create and set new memory pool
     void UseMemoryPool(void);
+    /// Create and set new memory pool
+    /// @param scope
+    ///   Objects of which reads share the pool
+    /// @param chunk_size
+    ///   Size of memory chunks; if zero, use the CObjectMemoryPool default
+    ///   for eMemoryPool_Stream, and a larger one for eMemoryPool_Object
+    void UseMemoryPool(EMemoryPoolScope scope, size_t chunk_size = 0);
 
     // internal reader
     void ReadExternalObject(TObjectPtr object, TTypeInfo typeInfo);
@@ -1083,6 +1099,7 @@ private:
     CStreamPathHook<CVariantInfo*,CSkipChoiceVariantHook*> m_PathSkipVariantHooks;
 
     CRef<CObjectMemoryPool> m_MemoryPool;
+    EMemoryPoolScope m_MemoryPoolScope;
 
     TTypeInfo m_MonitorType;
     vector<TTypeInfo> m_ReqMonitorType;
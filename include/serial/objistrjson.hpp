@@ -222,6 +222,8 @@ private:
     int ReadEscapedChar(bool* encoded=0);
     char ReadEncodedChar(EStringType type, bool& encoded);
     TUnicodeSymbol ReadUtf8Char(char c);
+    bool x_NeedsConversion(EStringType type) const;
+    void x_ReadEncodedChar(string& str, EStringType type);
     string x_ReadString(EStringType type);
     void x_ReadData(string& data, EStringType type = eStringTypeUTF8);
     bool x_ReadDataAndCheck(string& data, EStringType type = eStringTypeUTF8);
@@ -234,6 +236,7 @@ private:
     bool NextElement(void);
 
     TMemberIndex FindDeep(const CItemsInfo& items, const CTempString& name, bool& deep) const;
+    TMemberIndex x_FindDeep(const CItemsInfo& items, const CTempString& name, bool& deep) const;
     size_t ReadCustomBytes(ByteBlock& block, char* buffer, size_t count);
     size_t ReadBase64Bytes(ByteBlock& block, char* buffer, size_t count);
     size_t ReadHexBytes(ByteBlock& block, char* buffer, size_t count);
@@ -249,6 +252,9 @@ private:
     EBinaryDataFormat m_BinaryFormat;
     CStringUTF8 m_Utf8Buf;
     CStringUTF8::const_iterator m_Utf8Pos;
+    typedef map< pair<const CItemsInfo*, string>,
+                 pair<TMemberIndex, bool> > TMemberCache;
+    mutable TMemberCache m_MemberCache;
 };
 
 /* @} */
@@ -38,6 +38,9 @@
 #include <corelib/ncbithr.hpp>
 #include <serial/objistr.hpp>
 #include <serial/objectio.hpp>
+#include <serial/impl/classinfo.hpp>
+#include <serial/impl/continfo.hpp>
+#include <serial/impl/ptrinfo.hpp>
 
 #include <queue>
 #include <future>
@@ -351,7 +354,9 @@ public:
             , m_MaxParserThreads (16)
             , m_MaxTotalRawSize  (16 * 1024 * 1024)
             , m_MinRawBufferSize (128 * 1024)
-            , m_SameThread(false) {
+            , m_SameThread(false)
+            , m_PreScanIndex(kInvalidMember)
+            , m_PreScanRoot(nullptr) {
         }
 
         /// Filter by member index
@@ -395,12 +400,41 @@ public:
             m_SameThread = same_thread;  return *this;
         }
 
+        /// Pre-scan the given container member of the top-level TRoot
+        /// objects (CObjectIStreamAsyncIterator<TRoot,TChild> only).
+        /// Instead of skipping whole TRoot objects, the reader descends
+        /// into each of them, skips the other members, and cuts raw data
+        /// buffers at the boundaries of the container elements, so that
+        /// a single huge TRoot (e.g. Bioseq-set.seq-set) is split between
+        /// the parsing threads.
+        /// @note
+        ///  Only the binary ASN.1 format is pre-scanned, and only when the
+        ///  member is a SEQUENCE/SET OF TChild; otherwise the parameter is
+        ///  ignored. TChild objects found outside of the pre-scanned
+        ///  container are not reported. The raw data is always read in
+        ///  a separate thread in this mode.
+        CParams& PreScanContainer(TMemberIndex index) {
+            m_PreScanIndex = index;  m_PreScanName.clear();  return *this;
+        }
+
+        /// Pre-scan the container member given by name
+        CParams& PreScanContainer(const string& mem_name) {
+            m_PreScanIndex = kInvalidMember;  m_PreScanName = mem_name;  return *this;
+        }
+
     private:
-        launch    m_ThreadPolicy;
-        unsigned  m_MaxParserThreads;
-        size_t    m_MaxTotalRawSize;
-        size_t    m_MinRawBufferSize;
-        bool      m_SameThread;
+        CParams& x_SetPreScanRoot(TTypeInfo root) {
+            m_PreScanRoot = root;  return *this;
+        }
+
+        launch       m_ThreadPolicy;
+        unsigned     m_MaxParserThreads;
+        size_t       m_MaxTotalRawSize;
+        size_t       m_MinRawBufferSize;
+        bool         m_SameThread;
+        TMemberIndex m_PreScanIndex;
+        string       m_PreScanName;
+        TTypeInfo    m_PreScanRoot;
 
         template<typename...> friend class CObjectIStreamAsyncIterator;
     };
@@ -1217,6 +1251,9 @@ private:
         void x_UpdateFuturesQueue();
         CRef< CByteSource > x_GetNextData(void);
         void x_ReaderThread(void);
+        void x_InitPreScan(void);
+        bool x_PreScanObject(void);
+        bool x_PushReaderData(CRef< CByteSource > data, size_t size);
 
         TObjectsQueue m_ObjectsQueue; // current queue of objects
         TObjectsQueue m_GarbageQueue; // popped so-far from objects-queue
@@ -1232,12 +1269,14 @@ private:
         launch          m_Policy;
         bool            m_EndOfData;
         CParams         m_Params;
+        TMemberIndex    m_PreScanIndex;
 
         mutex                        m_ReaderMutex;
         condition_variable           m_ReaderCv;
         thread                       m_Reader;
         queue< CRef< CByteSource > > m_ReaderData;
         queue< size_t >              m_ReaderDataSize;
+        exception_ptr                m_ReaderExpt;
     };
     shared_ptr<CData> m_Data;
 };
@@ -1437,7 +1476,9 @@ CObjectIStreamAsyncIterator<TRoot>::CData::CData(
     , m_Policy(params.m_ThreadPolicy)
     , m_EndOfData(m_Istr->EndOfData())
     , m_Params(params)
+    , m_PreScanIndex(kInvalidMember)
 {
+    x_InitPreScan();
     if (m_MaxRawSize != 0 && !m_EndOfData) {
         m_Reader = thread([this](){x_ReaderThread();});
     }
@@ -1506,6 +1547,12 @@ CObjectIStreamAsyncIterator<TRoot>::CData::x_UpdateFuturesQueue()
     CRef< CByteSource > data = x_GetNextData();
     if (data.IsNull()) {
         m_EndOfData = true;
+        if (m_ReaderExpt) {
+            // report the failure after the objects read before it
+            promise<TObjectsQueue> failed;
+            failed.set_exception(m_ReaderExpt);
+            m_FuturesQueue.push(failed.get_future());
+        }
         return;
     }
 
@@ -1569,35 +1616,36 @@ template<typename TRoot>
 void
 CObjectIStreamAsyncIterator<TRoot>::CData::x_ReaderThread(void)
 {
-    // Skip over some objects in stream without parsing, up to buffer_size.
-    while (!m_Istr->EndOfData()) {
-        const CNcbiStreampos startpos = m_Istr->GetStreamPos();
-        const CNcbiStreampos endpos = 
-            startpos  + (CNcbiStreampos)(m_RawBufferSize);
-
-        CStreamDelayBufferGuard guard(*(m_Istr));
+    if (m_PreScanIndex != kInvalidMember) {
         try {
-            do {
-                m_Istr->SkipAnyContentObject();
-            } while( !m_Istr->EndOfData() && m_Istr->GetStreamPos() < endpos);
+            while (!m_Istr->EndOfData() && x_PreScanObject())
+                ;
         } catch (...) {
+            // the buffer being filled is dropped, it may end mid-element
+            if (!m_EndOfData) {
+                m_ReaderExpt = current_exception();
+            }
         }
-
-        size_t this_buffer_size = m_Istr->GetStreamPos() - startpos;
-        CRef< CByteSource > data = guard.EndDelayBuffer();
-        {
-            unique_lock<mutex> lck(m_ReaderMutex);
-            // make sure we do not consume too much memory
-            while (!m_EndOfData && m_CurrentRawSize >= m_MaxRawSize) {
-                m_ReaderCv.wait(lck);
+    }
+    else {
+        // Skip over some objects in stream without parsing, up to buffer_size.
+        while (!m_Istr->EndOfData()) {
+            const CNcbiStreampos startpos = m_Istr->GetStreamPos();
+            const CNcbiStreampos endpos = 
+                startpos  + (CNcbiStreampos)(m_RawBufferSize);
+
+            CStreamDelayBufferGuard guard(*(m_Istr));
+            try {
+                do {
+                    m_Istr->SkipAnyContentObject();
+                } while( !m_Istr->EndOfData() && m_Istr->GetStreamPos() < endpos);
+            } catch (...) {
             }
-            if (m_EndOfData) {
+
+            size_t this_buffer_size = m_Istr->GetStreamPos() - startpos;
+            if (!x_PushReaderData(guard.EndDelayBuffer(), this_buffer_size)) {
                 break;
             }
-            m_ReaderData.push( data);
-            m_ReaderDataSize.push( this_buffer_size);
-            m_CurrentRawSize += this_buffer_size;
-            m_ReaderCv.notify_one();
         }
     }
     CRef< CByteSource > data;
@@ -1608,6 +1656,108 @@ CObjectIStreamAsyncIterator<TRoot>::CData::x_ReaderThread(void)
     m_ReaderCv.notify_one();
 }
 
+template<typename TRoot>
+bool
+CObjectIStreamAsyncIterator<TRoot>::CData::x_PushReaderData(
+    CRef< CByteSource > data, size_t size)
+{
+    unique_lock<mutex> lck(m_ReaderMutex);
+    // make sure we do not consume too much memory
+    while (!m_EndOfData && m_CurrentRawSize >= m_MaxRawSize) {
+        m_ReaderCv.wait(lck);
+    }
+    if (m_EndOfData) {
+        return false;
+    }
+    m_ReaderData.push( data);
+    m_ReaderDataSize.push( size);
+    m_CurrentRawSize += size;
+    m_ReaderCv.notify_one();
+    return true;
+}
+
+template<typename TRoot>
+void
+CObjectIStreamAsyncIterator<TRoot>::CData::x_InitPreScan(void)
+{
+    TTypeInfo root = m_Params.m_PreScanRoot;
+    m_Params.m_PreScanRoot = nullptr;
+    if (!root || root->GetTypeFamily() != eTypeFamilyClass ||
+        m_Istr->GetDataFormat() != eSerial_AsnBinary) {
+        return;
+    }
+    const CClassTypeInfo* classType =
+        CTypeConverter<CClassTypeInfo>::SafeCast(root);
+    const CItemsInfo& members = classType->GetMembers();
+    TMemberIndex index = m_Params.m_PreScanName.empty() ?
+        m_Params.m_PreScanIndex : members.Find(m_Params.m_PreScanName);
+    if (index < members.FirstIndex() || index > members.LastIndex()) {
+        return;
+    }
+    TTypeInfo memberType = members.GetItemInfo(index)->GetTypeInfo();
+    if (memberType->GetTypeFamily() != eTypeFamilyContainer) {
+        return;
+    }
+    TTypeInfo elementType = CTypeConverter<CContainerTypeInfo>::SafeCast(
+        memberType)->GetElementType();
+    if (elementType->GetTypeFamily() == eTypeFamilyPointer) {
+        elementType = CTypeConverter<CPointerTypeInfo>::SafeCast(
+            elementType)->GetPointedType();
+    }
+    if (elementType != ns_ObjectIStreamFilterIterator::xxx_GetTypeInfo<TRoot>()) {
+        return;
+    }
+    // tell the parser that raw data buffers hold child objects only
+    m_Params.m_PreScanRoot = root;
+    m_PreScanIndex = index;
+    if (m_MaxRawSize == 0) {
+        m_MaxRawSize = m_Params.m_MaxTotalRawSize;
+    }
+}
+
+// Read one top-level object, cutting raw data buffers at the element
+// boundaries of the pre-scanned container. The closing end-of-contents
+// octets are consumed only after the buffer is done with, so that each
+// buffer holds nothing but complete child objects.
+template<typename TRoot>
+bool
+CObjectIStreamAsyncIterator<TRoot>::CData::x_PreScanObject(void)
+{
+    CObjectTypeInfo rootType(m_Params.m_PreScanRoot);
+    for (CIStreamClassMemberIterator m(*m_Istr, rootType); m; ++m) {
+        if ((*m).GetMemberIndex() != m_PreScanIndex) {
+            m.SkipClassMember();
+            continue;
+        }
+        CIStreamContainerIterator c(*m_Istr, (*m).GetMemberType());
+        TTypeInfo elementType = c.GetElementType().GetTypeInfo();
+        while (c) {
+            const CNcbiStreampos startpos = m_Istr->GetStreamPos();
+            const CNcbiStreampos endpos =
+                startpos  + (CNcbiStreampos)(m_RawBufferSize);
+
+            CStreamDelayBufferGuard guard(*(m_Istr));
+            for (;;) {
+                m_Istr->SkipAnyContentObject();
+                // in binary ASN.1 this only peeks at the next tag
+                if (!m_Istr->BeginContainerElement(elementType) ||
+                    m_Istr->GetStreamPos() >= endpos) {
+                    break;
+                }
+                c.NextElement();
+                ++c;
+            }
+            size_t this_buffer_size = m_Istr->GetStreamPos() - startpos;
+            if (!x_PushReaderData(guard.EndDelayBuffer(), this_buffer_size)) {
+                return false;
+            }
+            c.NextElement();
+            ++c;
+        }
+    }
+    return true;
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 ///  CObjectIStreamAsyncIterator<TRoot,TChild> implementation
@@ -1623,7 +1773,9 @@ CObjectIStreamAsyncIterator<TRoot, TChild>::CObjectIStreamAsyncIterator(
         CObjectIStream& istr, EOwnership deleteInStream,
         const CParams& params)
     : CParent(istr, deleteInStream,
-        &CObjectIStreamAsyncIterator<TRoot, TChild>::sx_ClearGarbageAndParse, params)
+        &CObjectIStreamAsyncIterator<TRoot, TChild>::sx_ClearGarbageAndParse,
+        CParams(params).x_SetPreScanRoot(
+            ns_ObjectIStreamFilterIterator::xxx_GetTypeInfo<TRoot>()))
 {
 }
 
@@ -1687,6 +1839,13 @@ CObjectIStreamAsyncIterator<TRoot, TChild>::sx_ClearGarbageAndParse(
     // deserialize objects from bytesource
     unique_ptr<CObjectIStream> istr { CObjectIStream::Create(format, *bytesource) };
     TObjectsQueue queue;
+    if (params.m_PreScanRoot) {
+        // pre-scanned container elements
+        for (TChild& object : CObjectIStreamIterator<TChild, TChild>( *istr, eNoOwnership, params)) {
+            queue.push( CRef<TChild>(&object));
+        }
+        return queue;
+    }
     for (TChild& object : CObjectIStreamIterator<TRoot, TChild>( *istr, eNoOwnership, params)) {
         queue.push( CRef<TChild>(&object));
     }
@@ -240,11 +240,22 @@ public:
     CBufferedLineReader(CNcbiIstream& is,
                         EOwnership ownership = eNoOwnership);
 
+    /// How to access a named file
+    enum EFileMapping {
+        eFileMapping_Never, ///< always read through a buffer
+        eFileMapping_Auto   ///< memory-map non-empty regular files
+    };
+
     /// read from the file, "-" (but not "./-") means standard input
     ///
+    /// Regular files are memory-mapped by default, and the lines are
+    /// then returned as views of the mapping, without copying.
+    /// Reading falls back to the buffered mode if mapping fails.
+    ///
     /// As always with ILineReader, an explicit call to operator++ or
     /// ReadLine() will be necessary to fetch the first line.
-    CBufferedLineReader(const string& filename);
+    CBufferedLineReader(const string& filename,
+                        EFileMapping mapping = eFileMapping_Auto);
 
     virtual ~CBufferedLineReader();
 
@@ -256,19 +267,26 @@ public:
     CT_POS_TYPE         GetPosition(void) const;
     Uint8               GetLineNumber(void) const;
 
+    /// true if the whole input is memory-mapped
+    bool IsMemoryMapped(void) const { return m_MemFile.get() != 0; }
+
 private:
     CBufferedLineReader(const CBufferedLineReader&);
     CBufferedLineReader& operator=(const CBufferedLineReader&);
 private:
     void x_LoadLong();
     bool x_ReadBuffer();
+    bool x_MapFile(const string& filename);
+    void x_NextMappedLine(void);
 private:
     AutoPtr<IReader> m_Reader;
+    AutoPtr<CMemoryFile> m_MemFile;
     bool          m_Eof;
     bool          m_UngetLine;
     SIZE_TYPE     m_LastReadSize;
     size_t        m_BufferSize;
     AutoArray<char> m_Buffer;
+    const char*   m_Start;
     const char*   m_Pos;
     const char*   m_End;
     CTempString   m_Line;
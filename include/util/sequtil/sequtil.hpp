@@ -69,6 +69,24 @@ public:
     typedef ECodingType  TCodingType;
 
     static ECodingType GetCodingType(TCoding coding);
+
+    // Vectorized kernels used by CSeqConvert and CSeqManip for bulk
+    // conversions between ncbi2na, ncbi4na and iupacna, and for reverse
+    // complement of these codings. The table-driven code is always used
+    // for unaligned heads and tails, so the results do not depend on the
+    // selected level. By default the best level supported by the CPU
+    // is used.
+    enum ESimdLevel {
+        eSimd_None,    // table-driven code only
+        eSimd_SSE,     // SSSE3/SSE4.1 kernels
+        eSimd_AVX2,    // AVX2 kernels
+        eSimd_Best     // best level supported by the CPU and the build
+    };
+
+    // Select kernels; the level is capped by what the CPU and the build
+    // support. Return the level actually in effect.
+    static ESimdLevel SetSimdLevel(ESimdLevel level);
+    static ESimdLevel GetSimdLevel(void);
 };
 
 
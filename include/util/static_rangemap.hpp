@@ -0,0 +1,455 @@
+#ifndef UTIL___STATIC_RANGEMAP__HPP
+#define UTIL___STATIC_RANGEMAP__HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* Author:  agent
+*
+* File Description:
+*   Immutable compact multimap with range as key
+*
+* ===========================================================================
+*/
+
+#include <corelib/ncbistd.hpp>
+#include <util/range.hpp>
+#include <vector>
+#include <algorithm>
+
+
+/** @addtogroup RangeSupport
+ *
+ * @{
+ */
+
+
+BEGIN_NCBI_SCOPE
+
+template<typename Mapped, typename Position> class CStaticRangeMultimap;
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/// CStaticRangeMultimapIterator --
+///
+/// Iterator over entries of CStaticRangeMultimap intersecting with
+/// the range to search. The entries are returned in order of their
+/// starting positions.
+
+template<typename Mapped, typename Position>
+class CStaticRangeMultimapIterator
+{
+public:
+    typedef CStaticRangeMultimap<Mapped, Position> TRangeMap;
+    typedef typename TRangeMap::position_type position_type;
+    typedef typename TRangeMap::range_type range_type;
+    typedef typename TRangeMap::value_type value_type;
+    typedef const value_type& reference;
+    typedef const value_type* pointer;
+
+    CStaticRangeMultimapIterator(void)
+        : m_Map(0),
+          m_Range(range_type::GetEmpty()),
+          m_Current(0),
+          m_ScanPos(0),
+          m_ScanEnd(0),
+          m_StackSize(0)
+        {
+        }
+
+    // get range to search
+    const range_type& GetRange(void) const
+        {
+            return m_Range;
+        }
+
+    // check state
+    bool Valid(void) const
+        {
+            return m_Map && m_Current < m_Map->size();
+        }
+    DECLARE_OPERATOR_BOOL(Valid());
+
+    // dereference
+    range_type GetInterval(void) const
+        {
+            return m_Map->x_GetValue(m_Current).first;
+        }
+    reference operator*(void) const
+        {
+            return m_Map->x_GetValue(m_Current);
+        }
+    pointer operator->(void) const
+        {
+            return &m_Map->x_GetValue(m_Current);
+        }
+
+    // move
+    CStaticRangeMultimapIterator& operator++(void)
+        {
+            x_Next();
+            return *this;
+        }
+
+private:
+    friend class CStaticRangeMultimap<Mapped, Position>;
+
+    // search subtree node, see CStaticRangeMultimap for the tree layout
+    struct SNode {
+        size_t m_Index;
+        Uint1  m_Level;
+        bool   m_LeftDone;
+    };
+    enum {
+        // subtrees of this or lower level are scanned sequentially
+        kScanLevel = 3,
+        // enough for any tree with size_t index
+        kMaxStackSize = 2*sizeof(size_t)*8
+    };
+
+    void x_Push(size_t index, Uint1 level, bool left_done)
+        {
+            _ASSERT(m_StackSize < kMaxStackSize);
+            SNode& node = m_Stack[m_StackSize++];
+            node.m_Index = index;
+            node.m_Level = level;
+            node.m_LeftDone = left_done;
+        }
+
+    // start search of all entries intersecting with the range
+    void x_SetBegin(const TRangeMap& map, const range_type& range)
+        {
+            m_Map = &map;
+            m_Range = range;
+            m_Current = m_ScanPos = m_ScanEnd = map.size();
+            m_StackSize = 0;
+            if ( !range.Empty() && !map.empty() ) {
+                Uint1 level = map.x_GetRootLevel();
+                x_Push((size_t(1) << level) - 1, level, false);
+                x_Next();
+            }
+        }
+    // start sequential scan of all entries from the index
+    void x_SetScan(const TRangeMap& map, size_t index)
+        {
+            m_Map = &map;
+            m_Range = range_type::GetWhole();
+            m_Current = index;
+            m_ScanPos = index + 1;
+            m_ScanEnd = map.size();
+            m_StackSize = 0;
+        }
+
+    bool x_Intersects(size_t index) const
+        {
+            const range_type& range = m_Map->x_GetValue(index).first;
+            return range.GetFrom() < m_Range.GetToOpen() &&
+                range.GetToOpen() > m_Range.GetFrom();
+        }
+    bool x_StartsAfter(size_t index) const
+        {
+            return
+                m_Map->x_GetValue(index).first.GetFrom() >= m_Range.GetToOpen();
+        }
+
+    void x_Next(void)
+        {
+            size_t size = m_Map->size();
+            for ( ;; ) {
+                // continue sequential scan of a small subtree
+                while ( m_ScanPos < m_ScanEnd ) {
+                    size_t index = m_ScanPos++;
+                    if ( x_StartsAfter(index) ) {
+                        m_ScanPos = m_ScanEnd;
+                        break;
+                    }
+                    if ( x_Intersects(index) ) {
+                        m_Current = index;
+                        return;
+                    }
+                }
+                if ( !m_StackSize ) {
+                    m_Current = size;
+                    return;
+                }
+                SNode node = m_Stack[--m_StackSize];
+                if ( node.m_Level <= kScanLevel ) {
+                    // scan the whole subtree
+                    size_t first = node.m_Index >> node.m_Level << node.m_Level;
+                    m_ScanPos = first;
+                    m_ScanEnd = min(size,
+                                    first + (size_t(2) << node.m_Level) - 1);
+                }
+                else if ( !node.m_LeftDone ) {
+                    // left subtree first, the node itself and right subtree
+                    // will be processed after it
+                    size_t left =
+                        node.m_Index - (size_t(1) << (node.m_Level-1));
+                    x_Push(node.m_Index, node.m_Level, true);
+                    if ( left >= size ||
+                         m_Map->x_GetMaxToOpen(left) > m_Range.GetFrom() ) {
+                        x_Push(left, Uint1(node.m_Level-1), false);
+                    }
+                }
+                else if ( node.m_Index < size && !x_StartsAfter(node.m_Index) ) {
+                    x_Push(node.m_Index + (size_t(1) << (node.m_Level-1)),
+                           Uint1(node.m_Level-1), false);
+                    if ( x_Intersects(node.m_Index) ) {
+                        m_Current = node.m_Index;
+                        return;
+                    }
+                }
+            }
+        }
+
+    const TRangeMap* m_Map;
+    range_type       m_Range;     // range to search
+    size_t           m_Current;   // current entry, size() if none
+    size_t           m_ScanPos;   // next entry of sequential scan
+    size_t           m_ScanEnd;   // end of sequential scan
+    size_t           m_StackSize;
+    SNode            m_Stack[kMaxStackSize];
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/// CStaticRangeMultimap --
+///
+/// Read-only counterpart of CRangeMultimap<> built at once from a set of
+/// entries. All entries are kept in a single array sorted by range, which
+/// is used as an implicit balanced binary tree (node at index i on level k
+/// has i's k lowest bits set, and its children are i -/+ 2^(k-1)),
+/// augmented with maximal range end in each subtree.
+/// Compared to CRangeMultimap<> it has much smaller memory overhead
+/// per entry (one position) and better locality of search.
+
+template<typename Mapped, typename Position = int>
+class CStaticRangeMultimap
+{
+public:
+    typedef size_t size_type;
+    typedef Position position_type;
+    typedef CRange<position_type> range_type;
+    typedef Mapped mapped_type;
+    typedef pair<const range_type, mapped_type> value_type;
+    typedef range_type key_type;
+
+    typedef CStaticRangeMultimapIterator<Mapped, Position> const_iterator;
+
+    CStaticRangeMultimap(void)
+        : m_RootLevel(0)
+        {
+        }
+    /// Build index from a sequence of value_type entries,
+    /// e.g. from CRangeMultimap<Mapped, Position>
+    template<class TIterator>
+    CStaticRangeMultimap(TIterator begin, TIterator end)
+        : m_RootLevel(0)
+        {
+            assign(begin, end);
+        }
+
+    template<class TIterator>
+    void assign(TIterator begin, TIterator end)
+        {
+            clear();
+            vector<const value_type*> refs;
+            for ( TIterator it = begin; it != end; ++it ) {
+                refs.push_back(&*it);
+            }
+            sort(refs.begin(), refs.end(), PLessRange());
+            m_Values.reserve(refs.size());
+            ITERATE ( typename vector<const value_type*>, it, refs ) {
+                m_Values.push_back(**it);
+            }
+            x_BuildIndex();
+        }
+
+    void clear(void)
+        {
+            TValues().swap(m_Values);
+            TPositions().swap(m_MaxToOpen);
+            m_RootLevel = 0;
+        }
+    void swap(CStaticRangeMultimap& map)
+        {
+            m_Values.swap(map.m_Values);
+            m_MaxToOpen.swap(map.m_MaxToOpen);
+            std::swap(m_RootLevel, map.m_RootLevel);
+        }
+
+    // capacity
+    bool empty(void) const
+        {
+            return m_Values.empty();
+        }
+    size_type size(void) const
+        {
+            return m_Values.size();
+        }
+    /// Memory used by entries and index, excluding heap memory
+    /// used by mapped values
+    size_t GetMemoryUsage(void) const
+        {
+            return sizeof(*this) +
+                m_Values.capacity()*sizeof(value_type) +
+                m_MaxToOpen.capacity()*sizeof(position_type);
+        }
+
+    // iterators
+    const_iterator end(void) const
+        {
+            const_iterator iter;
+            iter.x_SetScan(*this, size());
+            return iter;
+        }
+    const_iterator begin(void) const
+        {
+            const_iterator iter;
+            iter.x_SetScan(*this, 0);
+            return iter;
+        }
+    const_iterator begin(const range_type& range) const
+        {
+            const_iterator iter;
+            iter.x_SetBegin(*this, range);
+            return iter;
+        }
+
+    // element search, iteration continues over all following entries
+    // in order of their ranges as in CRangeMultimap<>::find()
+    const_iterator find(const key_type& key) const
+        {
+            typename TValues::const_iterator it =
+                lower_bound(m_Values.begin(), m_Values.end(), key,
+                            PLessRange());
+            const_iterator iter;
+            if ( it != m_Values.end() && it->first == key && !key.Empty() ) {
+                iter.x_SetScan(*this, it - m_Values.begin());
+            }
+            else {
+                iter.x_SetScan(*this, size());
+            }
+            return iter;
+        }
+
+protected:
+    friend class CStaticRangeMultimapIterator<Mapped, Position>;
+
+    typedef vector<value_type> TValues;
+    typedef vector<position_type> TPositions;
+
+    struct PLessRange {
+        static bool x_Less(const range_type& r1, const range_type& r2)
+            {
+                return r1.GetFrom() < r2.GetFrom() ||
+                    (r1.GetFrom() == r2.GetFrom() &&
+                     r1.GetToOpen() < r2.GetToOpen());
+            }
+        bool operator()(const value_type* v1, const value_type* v2) const
+            {
+                return x_Less(v1->first, v2->first);
+            }
+        bool operator()(const value_type& v, const range_type& r) const
+            {
+                return x_Less(v.first, r);
+            }
+    };
+
+    const value_type& x_GetValue(size_t index) const
+        {
+            return m_Values[index];
+        }
+    position_type x_GetMaxToOpen(size_t index) const
+        {
+            return m_MaxToOpen[index];
+        }
+    Uint1 x_GetRootLevel(void) const
+        {
+            return m_RootLevel;
+        }
+
+    // Calculate maximal range end in subtree of the node at the index,
+    // the subtree may be only partially filled.
+    // Return false if the subtree has no entries.
+    bool x_BuildIndex(size_t index, Uint1 level, position_type& max_to_open)
+        {
+            size_t size = m_Values.size();
+            bool found = false;
+            if ( index < size ) {
+                max_to_open = m_Values[index].first.GetToOpen();
+                found = true;
+            }
+            if ( level > 0 ) {
+                size_t delta = size_t(1) << (level-1);
+                position_type child_max = position_type();
+                if ( x_BuildIndex(index - delta, Uint1(level-1), child_max) ) {
+                    if ( !found || child_max > max_to_open ) {
+                        max_to_open = child_max;
+                    }
+                    found = true;
+                }
+                if ( index + 1 < size &&
+                     x_BuildIndex(index + delta, Uint1(level-1), child_max) ) {
+                    if ( !found || child_max > max_to_open ) {
+                        max_to_open = child_max;
+                    }
+                    found = true;
+                }
+            }
+            if ( index < size ) {
+                m_MaxToOpen[index] = max_to_open;
+            }
+            return found;
+        }
+    void x_BuildIndex(void)
+        {
+            size_t size = m_Values.size();
+            m_MaxToOpen.assign(size, position_type());
+            m_RootLevel = 0;
+            if ( size ) {
+                while ( (size_t(2) << m_RootLevel) <= size ) {
+                    ++m_RootLevel;
+                }
+                position_type max_to_open = position_type();
+                x_BuildIndex((size_t(1) << m_RootLevel) - 1, m_RootLevel,
+                             max_to_open);
+            }
+        }
+
+private:
+    TValues    m_Values;    // entries sorted by range
+    TPositions m_MaxToOpen; // maximal range end in subtree of each entry
+    Uint1      m_RootLevel;
+};
+
+
+END_NCBI_SCOPE
+
+/* @} */
+
+#endif // UTIL___STATIC_RANGEMAP__HPP
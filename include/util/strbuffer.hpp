@@ -115,6 +115,14 @@ public:
     // find specified symbol and set position on it
     void FindChar(char c)
         THROWS1((CIOException));
+    // find first char which is one of 'count' (at most 8) 'chars',
+    // or any char with the high bit set if 'stop8bit' is true,
+    // and set position on it; the chars passed over are appended to 'str'
+    // unless it is null
+    // return: the char found (not extracted)
+    char FindAnyChar(const char* chars, size_t count,
+                     string* str = 0, bool stop8bit = false)
+        THROWS1((CIOException));
     // find specified symbol without skipping
     // limit - search by 'limit' symbols
     // return relative offset of symbol from current position
@@ -207,6 +207,23 @@ private:
 class NCBI_XUTIL_EXPORT CThreadPool
 {
 public:
+    /// How tasks waiting for execution are kept in the pool
+    enum EQueueMode {
+        /// One priority queue shared by all threads
+        eSingleQueue,
+        /// The queue is split into several priority queues (shards), each
+        /// with its own lock and each preferred by some of the threads.
+        /// Tasks added from the pool's own threads go to the shard of the
+        /// adding thread, other tasks are spread over all shards. A thread
+        /// takes the task with the smallest priority among the heads of all
+        /// shards, its own shard winning the ties, so that threads executing
+        /// many short tasks rarely contend for the same lock.
+        /// @note This is not work stealing: to keep the priority order,
+        ///   taking a task looks at the head of every shard, and tasks of
+        ///   the same priority come out in FIFO order.
+        eShardedQueues
+    };
+
     /// Constructor
     /// @param queue_size
     ///   Maximum number of tasks waiting in the queue. If 0 then tasks
@@ -224,12 +241,15 @@ public:
     /// @param threads_mode
     ///   Running mode of all threads in thread pool. Values fRunDetached and
     ///   fRunAllowST are ignored.
+    /// @param queue_mode
+    ///   How the queued tasks are distributed between the threads.
     ///
-    /// @sa AddTask()
+    /// @sa AddTask(), EQueueMode
     CThreadPool(unsigned int      queue_size,
                 unsigned int      max_threads,
                 unsigned int      min_threads = 2,
-                CThread::TRunMode threads_mode = CThread::fRunDefault);
+                CThread::TRunMode threads_mode = CThread::fRunDefault,
+                EQueueMode        queue_mode = eSingleQueue);
 
     /// Add task to the pool for execution.
     /// @note
@@ -303,9 +323,12 @@ public:
     /// @param threads_mode
     ///   Running mode of all threads in thread pool. Values fRunDetached and
     ///   fRunAllowST are ignored.
+    /// @param queue_mode
+    ///   How the queued tasks are distributed between the threads.
     CThreadPool(unsigned int            queue_size,
                 CThreadPool_Controller* controller,
-                CThread::TRunMode       threads_mode = CThread::fRunDefault);
+                CThread::TRunMode       threads_mode = CThread::fRunDefault,
+                EQueueMode              queue_mode = eSingleQueue);
 
     /// Set timeout to wait for all threads to finish before the pool
     /// should be able to destroy.
@@ -398,6 +398,9 @@ void CAsn2Asn::Init(void)
                       CArgDescriptions::eInteger);
     d->AddFlag("P",
                "Use memory pool for deserialization");
+    d->AddFlag("PO",
+               "Use separate memory pool for each deserialized object");
+    d->SetDependency("P", CArgDescriptions::eExcludes, "PO");
     d->AddOptionalKey("l", "logFile",
                       "log errors to <logFile>",
                       CArgDescriptions::eOutputFile);
@@ -926,6 +929,7 @@ void CAsn2Asn::RunAsn2Asn(const string& outFileSuffix)
     bool readHook = args["ih"];
     bool writeHook = args["oh"];
     bool usePool = args["P"];
+    bool useObjectPool = args["PO"];
 
     bool quiet = args["q"];
     bool multi = args["m"];
@@ -943,6 +947,9 @@ void CAsn2Asn::RunAsn2Asn(const string& outFileSuffix)
         if ( usePool ) {
             in->UseMemoryPool();
         }
+        else if ( useObjectPool ) {
+            in->UseMemoryPool(CObjectIStream::eMemoryPool_Object);
+        }
         unique_ptr<CObjectOStream> out(!haveOutput? 0:
                                      CObjectOStream::Open(outFormat, outFile,
                                                           eSerial_StdWhenAny));
@@ -53,4 +53,9 @@ for i in "set.bin -b" "set.ent" "set.xml -X"; do
     do_test "$i -e -x" set.xml
 done
 
+# the same round trip, timed without and with the deserialization memory pools
+for p in "" "-P" "-PO"; do
+    do_test "set.bin -b -e -s -c 10 -q $p" set.bin
+done
+
 echo "Done!"
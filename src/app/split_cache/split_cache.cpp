@@ -41,6 +41,7 @@
 #include <corelib/ncbitime.hpp>
 #include <corelib/ncbiargs.hpp>
 #include <corelib/ncbistre.hpp>
+#include <corelib/ncbithr.hpp>
 #include <serial/objistr.hpp>
 #include <serial/objostr.hpp>
 #include <serial/serial.hpp>
@@ -96,6 +97,9 @@
 #include <objmgr/split/blob_splitter.hpp>
 #include <objmgr/split/id2_compress.hpp>
 
+#include <atomic>
+#include <exception>
+
 
 #define NCBI_USE_ERRCODE_X   Objtools_SplitCache
 
@@ -270,6 +274,10 @@ void CSplitCacheApp::Init(void)
 
     arg_desc->AddFlag("resplit",
                       "resplit already split data");
+    arg_desc->AddDefaultKey("threads", "Threads",
+                            "number of threads for size estimation "
+                            "and compression of chunks",
+                            CArgDescriptions::eInteger, "1");
 
     // debug parameters
     arg_desc->AddFlag("dump",
@@ -513,6 +521,160 @@ private:
 };
 
 
+typedef vector< AutoPtr<CSplitDataMaker> > TChunkDataMakers;
+
+
+struct SChunkDataTasks
+{
+    typedef vector<const CID2S_Chunk*> TChunks;
+
+    SChunkDataTasks(const SSplitterParams& params,
+                    const TChunks& chunks)
+        : m_Params(params),
+          m_Chunks(chunks),
+          m_Data(chunks.size()),
+          m_NextTask(0)
+        {
+        }
+
+    void Process(void)
+        {
+            for ( ;; ) {
+                size_t index = m_NextTask.fetch_add(1);
+                if ( index >= m_Chunks.size() ) {
+                    break;
+                }
+                try {
+                    m_Data[index].reset
+                        (new CSplitDataMaker(m_Params,
+                                             CID2_Reply_Data::eData_type_id2s_chunk));
+                    *m_Data[index] << *m_Chunks[index];
+                }
+                catch ( ... ) {
+                    CFastMutexGuard guard(m_ErrorMutex);
+                    if ( !m_Error ) {
+                        m_Error = current_exception();
+                    }
+                }
+            }
+        }
+
+    const SSplitterParams& m_Params;
+    const TChunks& m_Chunks;
+    TChunkDataMakers m_Data;
+    atomic<size_t> m_NextTask;
+    CFastMutex m_ErrorMutex;
+    exception_ptr m_Error;
+};
+
+
+#if defined(NCBI_THREADS)
+class CChunkDataThread : public CThread
+{
+public:
+    explicit CChunkDataThread(SChunkDataTasks& tasks)
+        : m_Tasks(tasks)
+        {
+        }
+
+protected:
+    virtual void* Main(void)
+        {
+            m_Tasks.Process();
+            return 0;
+        }
+
+private:
+    SChunkDataTasks& m_Tasks;
+};
+#endif
+
+
+// Serializes and compresses the chunks of a blob in bounded batches, the
+// chunks of a batch in parallel; only the data of the current batch are kept
+// in memory, and they are returned in the order of chunk ids.
+class CChunkDataBatches
+{
+public:
+    typedef CSplitBlob::TChunks::const_iterator TChunkIter;
+
+    // number of chunks in a batch per thread
+    enum { kBatchChunksPerThread = 4 };
+
+    CChunkDataBatches(const SSplitterParams& params,
+                      const CSplitBlob& blob)
+        : m_Params(params),
+          m_BatchSize(max(params.m_ThreadCount, 1u) * kBatchChunksPerThread),
+          m_Next(0)
+        {
+            for ( TChunkIter it = blob.GetChunks().begin();
+                  it != blob.GetChunks().end(); ++it ) {
+                m_Chunks.push_back(it);
+            }
+        }
+
+    // data of the next chunk (and the chunk itself in "it"),
+    // or null after the last chunk
+    const CSplitDataMaker* GetNext(TChunkIter& it)
+        {
+            if ( m_Next >= m_Chunks.size() ) {
+                m_Batch.clear();
+                return 0;
+            }
+            size_t index = m_Next % m_BatchSize;
+            if ( index == 0 ) {
+                x_MakeBatch(m_Next, min(m_Next+m_BatchSize, m_Chunks.size()));
+            }
+            it = m_Chunks[m_Next++];
+            return m_Batch[index].get();
+        }
+
+private:
+    void x_MakeBatch(size_t begin, size_t end);
+
+    const SSplitterParams& m_Params;
+    size_t m_BatchSize;
+    vector<TChunkIter> m_Chunks;
+    size_t m_Next;
+    TChunkDataMakers m_Batch;
+};
+
+
+void CChunkDataBatches::x_MakeBatch(size_t begin, size_t end)
+{
+    // release the previous batch first
+    m_Batch.clear();
+
+    SChunkDataTasks::TChunks chunks;
+    for ( size_t i = begin; i < end; ++i ) {
+        chunks.push_back(m_Chunks[i]->second.GetPointer());
+    }
+    SChunkDataTasks tasks(m_Params, chunks);
+#if defined(NCBI_THREADS)
+    size_t thread_count = min(size_t(m_Params.m_ThreadCount), chunks.size());
+    vector< CRef<CChunkDataThread> > threads;
+    for ( size_t i = 1; i < thread_count; ++i ) {
+        CRef<CChunkDataThread> thr(new CChunkDataThread(tasks));
+        if ( !thr->Run() ) {
+            break;
+        }
+        threads.push_back(thr);
+    }
+#endif
+    // the current thread works too
+    tasks.Process();
+#if defined(NCBI_THREADS)
+    NON_CONST_ITERATE ( vector< CRef<CChunkDataThread> >, it, threads ) {
+        (*it)->Join();
+    }
+#endif
+    if ( tasks.m_Error ) {
+        rethrow_exception(tasks.m_Error);
+    }
+    m_Batch.swap(tasks.m_Data);
+}
+
+
 string CSplitCacheApp::GetFileName(const string& key,
                                    const string& suffix,
                                    const string& ext)
@@ -548,6 +710,7 @@ void CSplitCacheApp::Process(void)
         args["non_feature_seq_tables"].AsInteger();
     m_SplitterParams.SetChunkSize(int(args["chunk_size"].AsDouble()*1024+.5));
     m_SplitterParams.m_MinChunkCount = args["min_chunk_count"].AsInteger();
+    m_SplitterParams.m_ThreadCount = max(args["threads"].AsInteger(), 1);
 
     if ( args["gi"] ) {
         ProcessGi(args["gi"].AsInteger());
@@ -1003,17 +1166,16 @@ void CSplitCacheApp::ProcessBlob(const CSeq_id_Handle& idh,
         {{
             const CProcessor_ID2& proc = dynamic_cast<const CProcessor_ID2&>(
                 disp.GetProcessor(CProcessor::eType_ID2));
-            ITERATE ( CSplitBlob::TChunks, it, blob.GetChunks() ) {
-                CSplitDataMaker data(GetParams(),
-                                     CID2_Reply_Data::eData_type_id2s_chunk);
-                data << *it->second;
+            CChunkDataBatches chunk_data(GetParams(), blob);
+            CChunkDataBatches::TChunkIter it;
+            while ( const CSplitDataMaker* data = chunk_data.GetNext(it) ) {
                 WAIT_LINE << "Storing chunk "<<it->first;
                 proc.SaveData(result,
                               blob_id,
                               0,
                               it->first,
                               disp.GetWriter(result, CWriter::eBlobWriter),
-                              data.GetData());
+                              data->GetData());
             }
         }}
     }
@@ -1151,17 +1313,16 @@ void CSplitCacheApp::ProcessEntry(const CSeq_entry& entry, const string& key)
         {{
             const CProcessor_ID2& proc = dynamic_cast<const CProcessor_ID2&>(
                 disp.GetProcessor(CProcessor::eType_ID2));
-            ITERATE ( CSplitBlob::TChunks, it, blob.GetChunks() ) {
-                CSplitDataMaker data(GetParams(),
-                                     CID2_Reply_Data::eData_type_id2s_chunk);
-                data << *it->second;
+            CChunkDataBatches chunk_data(GetParams(), blob);
+            CChunkDataBatches::TChunkIter it;
+            while ( const CSplitDataMaker* data = chunk_data.GetNext(it) ) {
                 WAIT_LINE << "Storing chunk "<<it->first;
                 proc.SaveData(result,
                               blob_id,
                               0,
                               it->first,
                               disp.GetWriter(result, CWriter::eBlobWriter),
-                              data.GetData());
+                              data->GetData());
             }
         }}
     }
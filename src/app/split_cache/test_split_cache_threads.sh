@@ -0,0 +1,56 @@
+#! /bin/sh
+#$Id$
+
+# Split the same generated entry with one and with several threads,
+# the dumped split data must be byte-identical.
+
+n_seqs=20
+n_feats=300
+threads=4
+
+dir="split_cache_threads.$$"
+trap 'rm -rf "$dir"' 0 1 2 15
+mkdir "$dir" "$dir/1" "$dir/$threads"  ||  exit 1
+
+# a set of sequences, each one with a table of features
+awk -v n_seqs=$n_seqs -v n_feats=$n_feats 'BEGIN {
+    print "Seq-entry ::= set {"
+    print "  class genbank,"
+    print "  seq-set {"
+    for (s = 1;  s <= n_seqs;  s++) {
+        id = "local str \"seq" s "\""
+        print "    seq {"
+        print "      id { " id " },"
+        print "      inst { repr virtual, mol dna, length 100000 },"
+        print "      annot { { data ftable {"
+        for (f = 1;  f <= n_feats;  f++) {
+            from = (f * 331 + s * 17) % 99000
+            print "        { data region \"region " s "." f "\","
+            printf "          location int { from %d, to %d, id %s } }%s\n",
+                from, from + f % 500, id, f < n_feats ? "," : ""
+        }
+        print "      } } }"
+        print "    }" (s < n_seqs ? "," : "")
+    }
+    print "  }"
+    print "}"
+}' > "$dir/entry.asn"  ||  exit 1
+
+for t in 1 $threads; do
+    (cd "$dir/$t"  &&
+     $CHECK_EXEC split_cache -in ../entry.asn -bdump -compress \
+         -chunk_size 4 -threads $t)
+    error=$?
+    if test $error -ne 0; then
+        echo "split_cache -threads $t failed: $error"
+        exit $error
+    fi
+done
+
+if diff -r "$dir/1/dump" "$dir/$threads/dump"; then
+    echo "Split data are the same with 1 and $threads threads"
+else
+    echo "Split data differ between 1 and $threads threads"
+    exit 1
+fi
+exit 0
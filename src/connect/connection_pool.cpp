@@ -56,13 +56,95 @@ std::string g_ServerConnTypeToString(enum EServerConnType  conn_type)
 }
 
 
+/// Selects connections with the earliest alarm time, or all connections
+/// whose alarm time has already come.
+class CServer_AlarmCollector
+{
+public:
+    CServer_AlarmCollector(vector<IServer_ConnectionBase*>& timer_requests)
+        : m_TimerRequests(timer_requests),
+          m_MinAlarmTime(NULL),
+          m_AlarmTimeDefined(false),
+          m_CurrentTime(CTime::eEmpty)
+    {}
+
+    void Add(IServer_ConnectionBase* conn_base, const CTime* alarm_time);
+
+    /// @return
+    ///  true if there are any alarms, and set the time left to the earliest
+    bool GetTimeout(STimeout* timer_timeout) const;
+
+private:
+    vector<IServer_ConnectionBase*>& m_TimerRequests;
+    const CTime*                     m_MinAlarmTime;
+    bool                             m_AlarmTimeDefined;
+    CTime                            m_CurrentTime;
+};
+
+
+void CServer_AlarmCollector::Add(IServer_ConnectionBase* conn_base,
+                                 const CTime* alarm_time)
+{
+    if (alarm_time == NULL)
+        return;
+    if (!m_AlarmTimeDefined) {
+        m_AlarmTimeDefined = true;
+        m_CurrentTime = GetFastLocalTime();
+        m_MinAlarmTime = *alarm_time > m_CurrentTime? alarm_time: NULL;
+        m_TimerRequests.clear();
+        m_TimerRequests.push_back(conn_base);
+    } else if (m_MinAlarmTime == NULL) {
+        if (*alarm_time <= m_CurrentTime)
+            m_TimerRequests.push_back(conn_base);
+    } else if (*alarm_time <= *m_MinAlarmTime) {
+        if (*alarm_time != *m_MinAlarmTime) {
+            m_MinAlarmTime = *alarm_time > m_CurrentTime? alarm_time: NULL;
+            m_TimerRequests.clear();
+        }
+        m_TimerRequests.push_back(conn_base);
+    }
+}
+
+
+static void s_SetTimerTimeout(STimeout* timer_timeout,
+                              const CTime& alarm_time,
+                              const CTime& current_time)
+{
+    CTimeSpan span(alarm_time.DiffTimeSpan(current_time));
+    if (span.GetCompleteSeconds() < 0 ||
+        span.GetNanoSecondsAfterSecond() < 0)
+    {
+        timer_timeout->usec = timer_timeout->sec = 0;
+    }
+    else {
+        timer_timeout->sec = (unsigned) span.GetCompleteSeconds();
+        timer_timeout->usec = span.GetNanoSecondsAfterSecond() / 1000;
+    }
+}
+
+
+bool CServer_AlarmCollector::GetTimeout(STimeout* timer_timeout) const
+{
+    if (!m_AlarmTimeDefined)
+        return false;
+    if (m_MinAlarmTime == NULL)
+        timer_timeout->usec = timer_timeout->sec = 0;
+    else
+        s_SetTimerTimeout(timer_timeout, *m_MinAlarmTime, m_CurrentTime);
+    return true;
+}
+
+
 CServer_ConnectionPool::CServer_ConnectionPool(unsigned max_connections) :
-    m_MaxConnections(max_connections), m_ListeningStarted(false)
+    m_MaxConnections(max_connections), m_ListeningStarted(false),
+    m_PollSet(0)
 {}
 
 CServer_ConnectionPool::~CServer_ConnectionPool()
 {
     Erase();
+    if (m_PollSet)
+        POLLSET_Close(m_PollSet);
 }
 
 void CServer_ConnectionPool::Erase(void)
@@ -75,9 +157,12 @@ void CServer_ConnectionPool::Erase(void)
         else
             (*it)->OnTimeout();
 
+        if (m_PollSet)
+            x_RemoveFromPollSet(*it);
         delete *it;
     }
     m_Data.clear();
+    m_DeferredConns.clear();
 }
 
 void CServer_ConnectionPool::x_UpdateExpiration(TConnBase* conn)
@@ -114,6 +199,9 @@ bool CServer_ConnectionPool::Add(TConnBase* conn, EServerConnType type)
         m_Data.insert(conn);
     }}
 
+    if (m_PollSet  &&  type != eActiveSocket)
+        x_QueueForPollSet(conn);
+
     if (type == eListener)
         if (m_ListeningStarted)
             // That's a new listener which should be activated right away
@@ -128,6 +216,10 @@ bool CServer_ConnectionPool::Add(TConnBase* conn, EServerConnType type)
 void CServer_ConnectionPool::Remove(TConnBase* conn)
 {
     CMutexGuard guard(m_Mutex);
+    // The caller is about to delete the connection, the poll set must not
+    // report events for it anymore
+    if (m_PollSet)
+        x_RemoveFromPollSet(conn);
     m_Data.erase(conn);
 }
 
@@ -195,8 +287,11 @@ void CServer_ConnectionPool::SetConnType(TConnBase* conn, EServerConnType type)
 
     // Signal poll cycle to re-read poll vector by sending
     // byte to control socket
-    if (type == eInactiveSocket)
+    if (type == eInactiveSocket) {
+        if (m_PollSet)
+            x_QueueForPollSet(conn);
         PingControlConnection();
+    }
 }
 
 void CServer_ConnectionPool::PingControlConnection(void)
@@ -238,16 +333,21 @@ bool CServer_ConnectionPool::GetPollAndTimerVec(
                              vector<IServer_ConnectionBase*>& to_close_conns,
                              vector<IServer_ConnectionBase*>& to_delete_conns)
 {
+    if (m_PollSet) {
+        polls.clear();
+        return x_GetPollSetAndTimerVec(timer_requests, timer_timeout,
+                                       revived_conns, to_close_conns,
+                                       to_delete_conns);
+    }
+
     CTime now = GetFastLocalTime();
     polls.clear();
     revived_conns.clear();
     to_close_conns.clear();
     to_delete_conns.clear();
 
-    const CTime *   alarm_time = NULL;
-    const CTime *   min_alarm_time = NULL;
-    bool            alarm_time_defined = false;
-    CTime           current_time(CTime::eEmpty);
+    const CTime *           alarm_time = NULL;
+    CServer_AlarmCollector  alarms(timer_requests);
 
     CMutexGuard     guard(m_Mutex);
 
@@ -265,23 +365,11 @@ bool CServer_ConnectionPool::GetPollAndTimerVec(
         EServerConnType conn_type = conn_base->type;
 
         // There might be a request to delete a listener
-        if (conn_type == eListener) {
-            CServer_Listener *  listener = dynamic_cast<CServer_Listener *>(
-                                                                    conn_base);
-            if (listener) {
-                unsigned short  port = listener->GetPort();
-
-                vector<unsigned short>::iterator    port_it = 
-                        std::find(m_ListenerPortsToStop.begin(),
-                                  m_ListenerPortsToStop.end(), port);
-                if (port_it != m_ListenerPortsToStop.end()) {
-                    conn_base->type_lock.Unlock();
-                    m_ListenerPortsToStop.erase(port_it);
-                    delete conn_base;
-                    m_Data.erase(it);
-                    continue;
-                }
-            }
+        if (conn_type == eListener  &&  x_IsListenerToStop(conn_base)) {
+            conn_base->type_lock.Unlock();
+            delete conn_base;
+            m_Data.erase(it);
+            continue;
         }
 
 
@@ -308,26 +396,8 @@ bool CServer_ConnectionPool::GetPollAndTimerVec(
             _ASSERT(pollable);
             polls.push_back(CSocketAPI::SPoll(pollable,
                             conn_base->GetEventsToPollFor(&alarm_time)));
-            if (alarm_time != NULL) {
-                if (!alarm_time_defined) {
-                    alarm_time_defined = true;
-                    current_time = GetFastLocalTime();
-                    min_alarm_time = *alarm_time > current_time? alarm_time: NULL;
-                    timer_requests.clear();
-                    timer_requests.push_back(conn_base);
-                } else if (min_alarm_time == NULL) {
-                    if (*alarm_time <= current_time)
-                        timer_requests.push_back(conn_base);
-                } else if (*alarm_time <= *min_alarm_time) {
-                    if (*alarm_time != *min_alarm_time) {
-                        min_alarm_time = *alarm_time > current_time? alarm_time
-                                                                   : NULL;
-                        timer_requests.clear();
-                    }
-                    timer_requests.push_back(conn_base);
-                }
-                alarm_time = NULL;
-            }
+            alarms.Add(conn_base, alarm_time);
+            alarm_time = NULL;
         }
         else if (conn_type == eDeferredSocket  &&  conn_base->IsReadyToProcess())
         {
@@ -338,24 +408,276 @@ bool CServer_ConnectionPool::GetPollAndTimerVec(
     }
     guard.Release();
 
-    if (alarm_time_defined) {
-        if (min_alarm_time == NULL)
-            timer_timeout->usec = timer_timeout->sec = 0;
-        else {
-            CTimeSpan span(min_alarm_time->DiffTimeSpan(current_time));
-            if (span.GetCompleteSeconds() < 0 ||
-                span.GetNanoSecondsAfterSecond() < 0)
-            {
-                timer_timeout->usec = timer_timeout->sec = 0;
-            }
-            else {
-                timer_timeout->sec = (unsigned) span.GetCompleteSeconds();
-                timer_timeout->usec = span.GetNanoSecondsAfterSecond() / 1000;
-            }
+    return alarms.GetTimeout(timer_timeout);
+}
+
+
+bool CServer_ConnectionPool::x_IsListenerToStop(TConnBase* conn_base)
+{
+    CServer_Listener *  listener = dynamic_cast<CServer_Listener *>(conn_base);
+    if (!listener)
+        return false;
+
+    vector<unsigned short>::iterator    port_it =
+            std::find(m_ListenerPortsToStop.begin(),
+                      m_ListenerPortsToStop.end(), listener->GetPort());
+    if (port_it == m_ListenerPortsToStop.end())
+        return false;
+    m_ListenerPortsToStop.erase(port_it);
+    return true;
+}
+
+
+bool CServer_ConnectionPool::EnablePollSet(void)
+{
+    if (m_PollSet)
+        return true;
+    EIO_Status status = POLLSET_Create(&m_PollSet);
+    if (status != eIO_Success) {
+        if (status != eIO_NotSupported) {
+            ERR_POST_X(12, Warning << "Failed to create poll set: "
+                       << IO_StatusStr(status));
+        }
+        m_PollSet = 0;
+        return false;
+    }
+
+    // Everything that is already in the pool has to be armed
+    CMutexGuard guard(m_Mutex);
+    CFastMutexGuard queue_guard(m_PollSetMutex);
+    m_PollSetQueue.assign(m_Data.begin(), m_Data.end());
+    return true;
+}
+
+
+void CServer_ConnectionPool::x_QueueForPollSet(TConnBase* conn)
+{
+    CFastMutexGuard guard(m_PollSetMutex);
+    m_PollSetQueue.push_back(conn);
+}
+
+
+void CServer_ConnectionPool::x_ArmPollSet(CPollable* pollable, EIO_Event event)
+{
+    POLLABLE poll = 0;
+    if (CSocket* sock = dynamic_cast<CSocket*>(pollable))
+        poll = POLLABLE_FromSOCK(sock->GetSOCK());
+    else if (CListeningSocket* lsock = dynamic_cast<CListeningSocket*>(pollable))
+        poll = POLLABLE_FromLSOCK(lsock->GetLSOCK());
+    else if (CTrigger* trigger = dynamic_cast<CTrigger*>(pollable))
+        poll = POLLABLE_FromTRIGGER(trigger->GetTRIGGER());
+    if (!poll)
+        return;
+
+    EIO_Status status = POLLSET_Arm(m_PollSet, poll, event, pollable);
+    if (status != eIO_Success) {
+        ERR_POST_X(13, Critical << "Failed to arm poll set: "
+                   << IO_StatusStr(status));
+    }
+}
+
+
+void CServer_ConnectionPool::x_RemoveFromPollSet(CPollable* pollable)
+{
+    POLLABLE poll = 0;
+    if (CSocket* sock = dynamic_cast<CSocket*>(pollable))
+        poll = POLLABLE_FromSOCK(sock->GetSOCK());
+    else if (CListeningSocket* lsock = dynamic_cast<CListeningSocket*>(pollable))
+        poll = POLLABLE_FromLSOCK(lsock->GetLSOCK());
+    if (poll)
+        POLLSET_Remove(m_PollSet, poll);
+}
+
+
+void CServer_ConnectionPool::x_RemoveFromPollSet(TConnBase* conn)
+{
+    x_RemoveFromPollSet(dynamic_cast<CPollable*>(conn));
+}
+
+
+void CServer_ConnectionPool::x_UpdateNextTimes(TConnBase* conn,
+                                               EServerConnType conn_type,
+                                               const CTime* alarm_time,
+                                               const CTime& now)
+{
+    if (alarm_time != NULL  &&
+        (m_NextAlarm.IsEmpty()  ||  *alarm_time < m_NextAlarm)) {
+        m_NextAlarm = *alarm_time;
+    }
+    if (conn_type == eInactiveSocket) {
+        // Connections without expiration are closed on the next scan,
+        // see GetPollAndTimerVec()
+        const CTime& expiration =
+            conn->expiration.IsEmpty()? now: conn->expiration;
+        if (m_NextExpiration.IsEmpty()  ||  expiration < m_NextExpiration)
+            m_NextExpiration = expiration;
+    }
+}
+
+
+bool CServer_ConnectionPool::x_GetPollSetAndTimerVec(
+                             vector<IServer_ConnectionBase*>& timer_requests,
+                             STimeout* timer_timeout,
+                             vector<IServer_ConnectionBase*>& revived_conns,
+                             vector<IServer_ConnectionBase*>& to_close_conns,
+                             vector<IServer_ConnectionBase*>& to_delete_conns)
+{
+    CTime now = GetFastLocalTime();
+    revived_conns.clear();
+    to_close_conns.clear();
+    to_delete_conns.clear();
+
+    vector<TConnBase*>  queue;
+    {{
+        CFastMutexGuard queue_guard(m_PollSetMutex);
+        queue.swap(m_PollSetQueue);
+    }}
+    // The same connection could have been queued more than once
+    sort(queue.begin(), queue.end());
+    queue.erase(unique(queue.begin(), queue.end()), queue.end());
+
+    CMutexGuard     guard(m_Mutex);
+
+    // The control trigger gets disarmed each time it fires
+    x_ArmPollSet(&m_ControlTrigger, eIO_Read);
+
+    // Only the connections which changed their state since the previous
+    // iteration need to be (re-)armed
+    ITERATE(vector<TConnBase*>, it, queue) {
+        TConnBase* conn_base = *it;
+        TData::iterator data_it = m_Data.find(conn_base);
+        if (data_it == m_Data.end())
+            continue; // removed from the pool in the meantime
+
+        conn_base->type_lock.Lock();
+        EServerConnType conn_type = conn_base->type;
+        if (conn_type == eClosedSocket
+            ||  (conn_type == eInactiveSocket  &&  !conn_base->IsOpen()))
+        {
+            x_RemoveFromPollSet(conn_base);
+            to_delete_conns.push_back(conn_base);
+            m_Data.erase(data_it);
         }
+        else if (conn_type == eDeferredSocket)
+        {
+            m_DeferredConns.push_back(conn_base);
+        }
+        else if ((conn_type == eInactiveSocket  ||  conn_type == eListener)
+                 &&  conn_base->IsOpen())
+        {
+            const CTime* alarm_time = NULL;
+            x_ArmPollSet(dynamic_cast<CPollable*>(conn_base),
+                         conn_base->GetEventsToPollFor(&alarm_time));
+            x_UpdateNextTimes(conn_base, conn_type, alarm_time, now);
+        }
+        conn_base->type_lock.Unlock();
+    }
+
+    // Deferred connections are not polled, so check them every time
+    size_t deferred_count = 0;
+    ITERATE(vector<TConnBase*>, it, m_DeferredConns) {
+        TConnBase* conn_base = *it;
+        if (m_Data.find(conn_base) == m_Data.end())
+            continue;
+
+        bool still_deferred = false;
+        conn_base->type_lock.Lock();
+        if (conn_base->type == eDeferredSocket) {
+            if (conn_base->IsReadyToProcess()) {
+                conn_base->type = eActiveSocket;
+                revived_conns.push_back(conn_base);
+            } else
+                still_deferred = true;
+        }
+        conn_base->type_lock.Unlock();
+        if (still_deferred)
+            m_DeferredConns[deferred_count++] = conn_base;
+    }
+    m_DeferredConns.resize(deferred_count);
+
+    // The rest of the pool only needs to be looked at when an alarm or
+    // an inactivity timeout is due, or a listener is to be removed
+    if (m_ListenerPortsToStop.empty()
+        &&  (m_NextAlarm.IsEmpty()  ||  now < m_NextAlarm)
+        &&  (m_NextExpiration.IsEmpty()  ||  now < m_NextExpiration))
+    {
+        guard.Release();
+        timer_requests.clear();
+        if (m_NextAlarm.IsEmpty())
+            return false;
+        // Wake up in time to scan for the alarm
+        s_SetTimerTimeout(timer_timeout, m_NextAlarm, now);
         return true;
     }
-    return false;
+
+    CServer_AlarmCollector  alarms(timer_requests);
+    m_NextAlarm.Clear();
+    m_NextExpiration.Clear();
+
+    ERASE_ITERATE(TData, it, m_Data) {
+        TConnBase* conn_base = *it;
+        conn_base->type_lock.Lock();
+        EServerConnType conn_type = conn_base->type;
+
+        if (conn_type == eListener  &&  x_IsListenerToStop(conn_base)) {
+            conn_base->type_lock.Unlock();
+            x_RemoveFromPollSet(conn_base);
+            delete conn_base;
+            m_Data.erase(it);
+            continue;
+        }
+
+        if (conn_type == eClosedSocket
+            ||  (conn_type == eInactiveSocket  &&  !conn_base->IsOpen()))
+        {
+            x_RemoveFromPollSet(conn_base);
+            to_delete_conns.push_back(conn_base);
+            m_Data.erase(it);
+        }
+        else if (conn_type == eInactiveSocket  &&  conn_base->expiration <= now)
+        {
+            x_RemoveFromPollSet(conn_base);
+            to_close_conns.push_back(conn_base);
+            m_Data.erase(it);
+        }
+        else if ((conn_type == eInactiveSocket  ||  conn_type == eListener)
+                 &&  conn_base->IsOpen())
+        {
+            // Already armed, only collect the times
+            const CTime* alarm_time = NULL;
+            conn_base->GetEventsToPollFor(&alarm_time);
+            alarms.Add(conn_base, alarm_time);
+            x_UpdateNextTimes(conn_base, conn_type, alarm_time, now);
+        }
+        conn_base->type_lock.Unlock();
+    }
+    guard.Release();
+
+    return alarms.GetTimeout(timer_timeout);
+}
+
+
+EIO_Status CServer_ConnectionPool::Poll(vector<CSocketAPI::SPoll>& polls,
+                                        const STimeout* timeout,
+                                        size_t* n_ready)
+{
+    if (!m_PollSet)
+        return CSocketAPI::Poll(polls, timeout, n_ready);
+
+    if (m_PollSetEvents.empty())
+        m_PollSetEvents.resize(256);
+    size_t count = 0;
+    EIO_Status status = POLLSET_Wait(m_PollSet, &m_PollSetEvents[0],
+                                     m_PollSetEvents.size(), timeout, &count);
+    polls.clear();
+    for (size_t i = 0;  i < count;  ++i) {
+        CSocketAPI::SPoll poll(static_cast<CPollable*>(m_PollSetEvents[i].data),
+                               m_PollSetEvents[i].revent);
+        poll.m_REvent = m_PollSetEvents[i].revent;
+        polls.push_back(poll);
+    }
+    *n_ready = count;
+    return status;
 }
 
 void CServer_ConnectionPool::SetAllActive(const vector<CSocketAPI::SPoll>& polls)
@@ -376,6 +698,9 @@ void CServer_ConnectionPool::SetAllActive(const vector<CSocketAPI::SPoll>& polls
             conn_base->type = eActiveSocket;
         else if (conn_base->type != eListener)
             abort();
+        else if (m_PollSet)
+            // Listeners accept in the poll cycle, so can be re-armed at once
+            x_QueueForPollSet(conn_base);
         conn_base->type_lock.Unlock();
     }
 }
@@ -389,6 +714,10 @@ void CServer_ConnectionPool::SetAllActive(const vector<IServer_ConnectionBase*>&
             abort();
         conn_base->type = eActiveSocket;
         conn_base->type_lock.Unlock();
+        if (m_PollSet) {
+            // Still armed for I/O, which must not be reported while active
+            x_RemoveFromPollSet(conn_base);
+        }
     }
 }
 
@@ -85,6 +85,23 @@ public:
                             vector<IServer_ConnectionBase*>& to_close_conns,
                             vector<IServer_ConnectionBase*>& to_delete_conns);
 
+    /// Switch to a persistent poll set (epoll on Linux): connections stay
+    /// registered with the system between the iterations, and only those
+    /// which changed their state get re-armed, so the cost of an iteration
+    /// does not grow with the number of idle connections.
+    /// Must be called before the poll cycle is started.
+    /// @return
+    ///  false if the poll set is not supported on this platform
+    bool EnablePollSet(void);
+    bool IsPollSetEnabled(void) const { return m_PollSet != 0; }
+
+    /// Wait for I/O readiness of the vector prepared by GetPollAndTimerVec()
+    /// or, if the poll set is enabled, of all armed connections.  In the
+    /// latter case the ready connections are returned in "polls".
+    EIO_Status Poll(vector<CSocketAPI::SPoll>& polls,
+                    const STimeout* timeout,
+                    size_t* n_ready);
+
     void StartListening(void);
     void StopListening(void);
 
@@ -95,6 +112,20 @@ public:
 
 private:
     void x_UpdateExpiration(TConnBase* conn);
+    bool x_IsListenerToStop(TConnBase* conn);
+
+    bool x_GetPollSetAndTimerVec(
+                            vector<IServer_ConnectionBase*>& timer_requests,
+                            STimeout* timer_timeout,
+                            vector<IServer_ConnectionBase*>& revived_conns,
+                            vector<IServer_ConnectionBase*>& to_close_conns,
+                            vector<IServer_ConnectionBase*>& to_delete_conns);
+    void x_QueueForPollSet(TConnBase* conn);
+    void x_ArmPollSet(CPollable* pollable, EIO_Event event);
+    void x_RemoveFromPollSet(CPollable* pollable);
+    void x_RemoveFromPollSet(TConnBase* conn);
+    void x_UpdateNextTimes(TConnBase* conn, EServerConnType conn_type,
+                           const CTime* alarm_time, const CTime& now);
 
 
     typedef set<TConnBase*> TData;
@@ -112,6 +143,23 @@ private:
     // The access to the container is protected with m_Mutex
     vector<unsigned short>  m_ListenerPortsToStop;
     bool                    m_ListeningStarted;
+
+private:
+    // Poll set mode: the set itself (NULL when polling the whole vector)
+    // and the connections to (re-)arm in it on the next iteration.
+    // The queue is filled by the worker threads, and is protected with
+    // m_PollSetMutex;  the rest is only accessed by the poll cycle.
+    // The poll set is locked internally, so the worker threads can remove
+    // connections from it (see Remove()) while the poll cycle waits on it.
+    POLLSET                 m_PollSet;
+    CFastMutex              m_PollSetMutex;
+    vector<TConnBase*>      m_PollSetQueue;
+    vector<TConnBase*>      m_DeferredConns;
+    vector<SPOLLSET_Event>  m_PollSetEvents;
+    // Earliest alarm and inactivity expiration times of the armed
+    // connections;  the whole pool is only scanned when one of them is due.
+    CTime                   m_NextAlarm;
+    CTime                   m_NextExpiration;
 };
 
 
@@ -411,6 +411,31 @@ extern size_t BUF_Peek(BUF buf, void* dst, size_t size)
 }
 
 
+extern size_t BUF_PeekChunk(BUF buf, void** cursor, const void** data)
+{
+    SBufChunk* chunk;
+
+    assert(!buf  ||  (!buf->list == !buf->last
+                      &&  !buf->size == !(buf->list  ||  buf->last)));
+
+    if (!buf)
+        chunk = 0;
+    else if (!*cursor)
+        chunk = buf->list;
+    else
+        chunk = ((SBufChunk*)(*cursor))->next;
+    if (!chunk) {
+        *data = 0;
+        return 0/*no more*/;
+    }
+    /* NB: no empty chunks allowed within the list */
+    assert(chunk->size > chunk->skip);
+    *cursor = chunk;
+    *data   = chunk->data + chunk->skip;
+    return chunk->size - chunk->skip;
+}
+
+
 extern size_t BUF_Read(BUF buf, void* dst, size_t size)
 {
     size_t todo = size;
@@ -497,6 +522,55 @@ extern int/*bool*/ BUF_Splice(BUF* dst, BUF src)
 }
 
 
+extern size_t BUF_SpliceEx(BUF* dst, BUF src, size_t size)
+{
+    size_t moved;
+
+    if (!src  ||  !src->size  ||  !size)
+        return 0/*nothing*/;
+    assert(src->list  &&  src->last);
+    if (size >= src->size) {
+        moved = src->size;
+        return BUF_Splice(dst, src) ? moved : 0;
+    }
+    /* init the buffer internals, if not init'd yet */
+    if (!*dst  &&  !BUF_SetChunkSize(dst, 0))
+        return 0/*failure*/;
+    assert(!(*dst)->list == !(*dst)->last
+           &&  !(*dst)->size == !((*dst)->list  ||  (*dst)->last));
+
+    /* re-link the leading chunks that fit in entirely */
+    for (moved = 0;  ;  ) {
+        SBufChunk* head  = src->list;
+        size_t     avail = head->size - head->skip;
+        assert(head->size > head->skip);
+        if (avail > size - moved)
+            break;
+        assert(head != src->last);
+        src->list  = head->next;
+        src->size -= avail;
+        head->next = 0;
+        if ((*dst)->last)
+            (*dst)->last->next = head;
+        else
+            (*dst)->list       = head;
+        (*dst)->last  = head;
+        (*dst)->size += avail;
+        if ((moved += avail) == size)
+            return moved;
+    }
+
+    /* copy the rest from the head chunk of the source */
+    if (BUF_Write(dst, src->list->data + src->list->skip, size - moved)) {
+        src->list->skip += size - moved;
+        src->size       -= size - moved;
+        moved = size;
+    }
+    assert(src->size  &&  src->list  &&  src->last);
+    return moved;
+}
+
+
 extern void BUF_Destroy(BUF buf)
 {
     if (buf) {
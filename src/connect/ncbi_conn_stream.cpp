@@ -483,6 +483,57 @@ CConn_SocketStream::CConn_SocketStream(const SConnNetInfo& net_info,
 }
 
 
+// Flush the stream and return its socket ready for a direct write:  the
+// stream's write timeout gets applied to the socket (just as the socket
+// connector does on every write of its own).
+static SOCK x_GetWriteSOCK(CConn_SocketStream& stream, EIO_Status* status)
+{
+    if (!stream.flush()) {
+        *status = stream.Status(eIO_Write);
+        if (*status == eIO_Success)
+            *status  = eIO_Unknown;
+        return 0;
+    }
+    SOCK sock = stream.GetSOCK();
+    if (!sock) {
+        *status = eIO_Closed;
+        return 0;
+    }
+    const STimeout* timeout = stream.GetTimeout(eIO_Write);
+    if (timeout == kDefaultTimeout)
+        timeout  = kInfiniteTimeout;  // the socket connector's default
+    _VERIFY(SOCK_SetTimeout(sock, eIO_Write, timeout) == eIO_Success);
+    *status = eIO_Success;
+    return sock;
+}
+
+
+EIO_Status CConn_SocketStream::WriteV(const SSOCK_IOVec* iov,
+                                      size_t             n,
+                                      size_t*            n_written,
+                                      EIO_WriteMethod    how)
+{
+    if ( n_written )
+        *n_written = 0;
+    EIO_Status status;
+    SOCK sock = x_GetWriteSOCK(*this, &status);
+    return sock ? SOCK_WriteV(sock, iov, n, n_written, how) : status;
+}
+
+
+EIO_Status CConn_SocketStream::SendFile(int     fd,
+                                        Uint8   offset,
+                                        size_t  size,
+                                        size_t* n_written)
+{
+    if ( n_written )
+        *n_written = 0;
+    EIO_Status status;
+    SOCK sock = x_GetWriteSOCK(*this, &status);
+    return sock ? SOCK_SendFile(sock, fd, offset, size, n_written) : status;
+}
+
+
 //
 // WARNING: All sx_ callbacks that operate on data members of non-primitive
 //          types MUST NOT be indirectly called before the respective stream's
@@ -538,7 +589,8 @@ s_HttpConnectorBuilder(const SConnNetInfo* net_info,
                        void**              user_data_ptr,
                        FHTTP_Cleanup*      user_cleanup_ptr,
                        void*               user_data    = 0,
-                       FHTTP_Cleanup       user_cleanup = 0)
+                       FHTTP_Cleanup       user_cleanup = 0,
+                       const SHTTP_ConnPool* pool       = 0)
 {
     EReqMethod x_req_method;
     AutoPtr<SConnNetInfo> x_net_info(net_info
@@ -603,12 +655,13 @@ s_HttpConnectorBuilder(const SConnNetInfo* net_info,
     // NB: Must init these two here just in case of early CONNECTOR->destroy()
     *user_data_ptr    = user_data;
     *user_cleanup_ptr = user_cleanup;
-    CONNECTOR c = HTTP_CreateConnectorEx(x_net_info.get(),
-                                         flgs,
-                                         x_parse_header,
-                                         x_data,
-                                         x_adjust,
-                                         x_cleanup);
+    CONNECTOR c = HTTP_CreatePooledConnector(x_net_info.get(),
+                                             flgs,
+                                             x_parse_header,
+                                             x_data,
+                                             x_adjust,
+                                             x_cleanup,
+                                             pool);
     return CConn_IOStream::TConnector(c);
 }
 
@@ -709,7 +762,8 @@ CConn_HttpStream::CConn_HttpStream(const string&       url,
                                    FHTTP_Cleanup       cleanup,
                                    THTTP_Flags         flgs,
                                    const STimeout*     timeout,
-                                   size_t              buf_size)
+                                   size_t              buf_size,
+                                   const SHTTP_ConnPool* pool)
     : CConn_HttpStream_Base(s_HttpConnectorBuilder(net_info,
                                                    eReqMethod_Any,
                                                    url.c_str(),
@@ -727,7 +781,8 @@ CConn_HttpStream::CConn_HttpStream(const string&       url,
                                                    &m_UserData,
                                                    &m_UserCleanup,
                                                    user_data,
-                                                   cleanup),
+                                                   cleanup,
+                                                   pool),
                             timeout, buf_size),
       m_UserAdjust(adjust), m_UserParseHeader(parse_header)
 {
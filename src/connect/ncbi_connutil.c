@@ -3029,6 +3029,13 @@ extern EIO_Status SOCK_StripToPattern
  BUF*        discard,
  size_t*     n_discarded)
 {
+    if (sock  &&  pattern  &&  pattern_size) {
+        /* search the socket's buffered data in place, if possible */
+        EIO_Status status = SOCK_StripToPatternInternal
+            (sock, pattern, pattern_size, discard, n_discarded);
+        if (status != eIO_NotSupported)
+            return status;
+    }
     return s_StripToPattern
         (sock, s_SOCK_IO, pattern, pattern_size, discard, n_discarded);
 }
@@ -403,6 +403,21 @@ bool SH2S_Session::Event(TH2S_RequestEvent& event, TFunc f)
     return false;
 }
 
+bool SH2S_Session::Cancel(TH2S_RequestEvent& event)
+{
+    auto& response_queue = event.response_queue;
+    auto it = Find(response_queue);
+
+    // The stream is forgotten in OnStreamClose, once nghttp2 is done with it
+    if ((it != m_Streams.end()) && !m_Session.Cancel(it->stream_id)) {
+        H2S_SESSION_TRACE(this << '/' << response_queue << " cancel for " << event);
+        return Send();
+    }
+
+    H2S_SESSION_TRACE(this << '/' << response_queue << " fail to cancel for " << event);
+    return false;
+}
+
 int SH2S_Session::OnData(nghttp2_session*, uint8_t, int32_t stream_id, const uint8_t* data, size_t len)
 {
     auto it = Find(stream_id);
@@ -417,21 +432,20 @@ int SH2S_Session::OnData(nghttp2_session*, uint8_t, int32_t stream_id, const uin
 
 int SH2S_Session::OnStreamClose(nghttp2_session*, int32_t stream_id, uint32_t error_code)
 {
-    // Everything is good, nothing to do (Eof is sent in OnFrameRecv)
-    if (!error_code) {
-        return 0;
-    }
-
     auto it = Find(stream_id);
 
     if (it != m_Streams.end()) {
         auto response_queue = it->response_queue;
-        H2S_SESSION_TRACE(this << '/' << response_queue << " stream closed with " << SUvNgHttp2_Error::NgHttp2Str(error_code));
         m_SessionsByQueues.erase(response_queue);
         m_StreamsByQueues.erase(response_queue);
         m_StreamsByIds.erase(stream_id);
         m_Streams.erase(it);
-        Push(response_queue, TH2S_ResponseEvent::eError);
+
+        // Everything is good, only forget the stream (Eof is sent in OnFrameRecv)
+        if (error_code) {
+            H2S_SESSION_TRACE(this << '/' << response_queue << " stream closed with " << SUvNgHttp2_Error::NgHttp2Str(error_code));
+            Push(response_queue, TH2S_ResponseEvent::eError);
+        }
     }
 
     return 0;
@@ -585,8 +599,13 @@ void SH2S_IoCoordinator::Process(TH2S_RequestQueue& request_queue)
                 break;
 
             case TH2S_RequestEvent::eError:
-                // No need to report incoming error back
+                // No need to report incoming error back, just cancel the stream (if it is still there)
                 H2S_IOC_TRACE(response_queue << " pop " << outgoing);
+
+                if (!new_request) {
+                    session->second.get().Cancel(outgoing);
+                }
+
                 continue;
         }
 
@@ -645,7 +664,7 @@ CHttp2Session::TApiLock CHttp2Session::GetApiLock()
     return SH2S_Io::GetInstance();
 }
 
-void CHttp2Session::UpdateResponse(CHttpRequest& req, CHttpHeaders::THeaders headers)
+static int s_ExtractStatusCode(CHttpHeaders::THeaders& headers)
 {
     int status_code = 0;
     auto status = headers.find(":status");
@@ -655,6 +674,12 @@ void CHttp2Session::UpdateResponse(CHttpRequest& req, CHttpHeaders::THeaders hea
         headers.erase(status);
     }
 
+    return status_code;
+}
+
+void CHttp2Session::UpdateResponse(CHttpRequest& req, CHttpHeaders::THeaders headers)
+{
+    auto status_code = s_ExtractStatusCode(headers);
     req.x_UpdateResponse(std::move(headers), status_code, {});
 }
 
@@ -692,5 +717,250 @@ bool CHttp2Session::x_Downgrade(CHttpResponse& resp, CHttpSession_Base::EProtoco
     return true;
 }
 
+SH2S_AsyncSession::SH2S_AsyncSession(size_t max_active) :
+    m_MaxActive(max(max_active, size_t(1))),
+    m_Io(SH2S_Io::GetInstance()),
+    m_Thread(&SH2S_AsyncSession::Run, this)
+{
+}
+
+SH2S_AsyncSession::~SH2S_AsyncSession()
+{
+    {
+        unique_lock<mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+
+    m_Submitted.notify_all();
+
+    m_Thread.join();
+
+    // Nobody is going to start these
+    TRequests cancelled;
+
+    for (auto& request : m_Queue) {
+        request->Fail(SHttpAsyncResponse::eCancelled, "Session is destroyed");
+        cancelled.emplace_back(std::move(request));
+    }
+
+    m_Queue.clear();
+    Complete(cancelled);
+}
+
+void SH2S_AsyncSession::Execute(TRequest request)
+{
+    {
+        unique_lock<mutex> lock(m_Mutex);
+        m_Queue.emplace_back(std::move(request));
+        ++m_Pending;
+    }
+
+    m_Submitted.notify_one();
+}
+
+size_t SH2S_AsyncSession::GetPendingCount() const
+{
+    unique_lock<mutex> lock(m_Mutex);
+    return m_Pending;
+}
+
+void SH2S_AsyncSession::WaitAll()
+{
+    unique_lock<mutex> lock(m_Mutex);
+    m_Completed.wait(lock, [&]() { return !m_Pending; });
+}
+
+// Neither the I/O loop nor the request queue can wake us up, so poll them
+constexpr auto kAsyncPollPeriod = chrono::milliseconds(1);
+
+void SH2S_AsyncSession::Run()
+{
+    TRequests active;
+
+    for (;;) {
+        TRequests done;
+        unique_lock<mutex> lock(m_Mutex);
+
+        if (active.empty()) {
+            m_Submitted.wait(lock, [&]() { return m_Stop || !m_Queue.empty(); });
+        }
+
+        if (m_Stop) {
+            break;
+        }
+
+        // Start as many queued requests as allowed, in the order of submission
+        while (!m_Queue.empty() && (active.size() < m_MaxActive)) {
+            auto request = std::move(m_Queue.front());
+            m_Queue.pop_front();
+
+            if (request->deadline.IsExpired()) {
+                request->Fail(SHttpAsyncResponse::eTimedOut, "Deadline expired before the request was started");
+                done.emplace_back(std::move(request));
+            } else {
+                Start(*request);
+                active.emplace_back(std::move(request));
+            }
+        }
+
+        lock.unlock();
+
+        m_Io->coordinator.GetLock()->Process(m_Io->request_queue);
+
+        for (auto it = active.begin(); it != active.end(); ) {
+            if (Receive(**it)) {
+                done.splice(done.end(), active, it++);
+            } else {
+                ++it;
+            }
+        }
+
+        if (!done.empty()) {
+            Complete(done);
+        } else if (!active.empty()) {
+            lock.lock();
+
+            if (!m_Stop && (m_Queue.empty() || (active.size() >= m_MaxActive))) {
+                m_Submitted.wait_for(lock, kAsyncPollPeriod);
+            }
+        }
+    }
+
+    for (auto& request : active) {
+        Cancel(*request);
+        request->Fail(SHttpAsyncResponse::eCancelled, "Session is destroyed");
+    }
+
+    if (!active.empty()) {
+        m_Io->coordinator.GetLock()->Process(m_Io->request_queue);
+        Complete(active);
+    }
+}
+
+void SH2S_AsyncSession::Start(SH2S_AsyncRequest& request)
+{
+    auto& r = request.request;
+    request.response_queue = make_shared<TH2S_ResponseQueue>();
+
+    auto& response_queue = request.response_queue;
+    auto queue_locked = m_Io->request_queue.GetLock();
+
+    queue_locked->emplace(SH2S_Request::SStart(EReqMethod(r.method), r.url, SUvNgHttp2_Tls::TCred(), r.headers), response_queue);
+
+    if (!r.body.empty()) {
+        queue_locked->emplace(TH2S_Data(r.body.begin(), r.body.end()), response_queue);
+    }
+
+    queue_locked->emplace(TH2S_RequestEvent::eEof, response_queue);
+}
+
+bool SH2S_AsyncSession::Receive(SH2S_AsyncRequest& request)
+{
+    auto& response = request.response;
+
+    for (;;) {
+        auto queue_locked = request.response_queue->GetLock();
+
+        if (queue_locked->empty()) {
+            break;
+        }
+
+        TH2S_ResponseEvent incoming(std::move(queue_locked->front()));
+        queue_locked->pop();
+        queue_locked.Unlock();
+
+        switch (incoming.GetType()) {
+            case TH2S_ResponseEvent::eStart:
+                response.headers = std::move(incoming.GetStart());
+                response.status_code = s_ExtractStatusCode(response.headers);
+                break;
+
+            case TH2S_ResponseEvent::eData: {
+                auto& data = incoming.GetData();
+                response.body.append(data.data(), data.size());
+                break;
+            }
+
+            case TH2S_ResponseEvent::eEof:
+                response.status = SHttpAsyncResponse::eSuccess;
+                return true;
+
+            case TH2S_ResponseEvent::eError:
+                request.Fail(SHttpAsyncResponse::eFailed, "Request failed");
+                return true;
+        }
+    }
+
+    if (request.deadline.IsExpired()) {
+        Cancel(request);
+        request.Fail(SHttpAsyncResponse::eTimedOut, "Deadline expired");
+        return true;
+    }
+
+    return false;
+}
+
+void SH2S_AsyncSession::Cancel(SH2S_AsyncRequest& request)
+{
+    m_Io->request_queue.GetLock()->emplace(TH2S_RequestEvent::eError, request.response_queue);
+}
+
+void SH2S_AsyncSession::Complete(TRequests& requests)
+{
+    if (requests.empty()) {
+        return;
+    }
+
+    for (auto& request : requests) {
+        try {
+            request->callback(std::move(request->response));
+        }
+        NCBI_CATCH_ALL("CHttpAsyncSession callback");
+    }
+
+    auto completed = requests.size();
+    requests.clear();
+
+    unique_lock<mutex> lock(m_Mutex);
+    m_Pending -= completed;
+
+    if (!m_Pending) {
+        m_Completed.notify_all();
+    }
+}
+
+CHttpAsyncSession::CHttpAsyncSession(size_t max_active) :
+    m_Impl(new SH2S_AsyncSession(max_active))
+{
+}
+
+CHttpAsyncSession::~CHttpAsyncSession()
+{
+}
+
+void CHttpAsyncSession::Execute(SHttpAsyncRequest request, TCallback callback)
+{
+    _ASSERT(callback);
+    m_Impl->Execute(SH2S_AsyncSession::TRequest(new SH2S_AsyncRequest(std::move(request), std::move(callback))));
+}
+
+future<SHttpAsyncResponse> CHttpAsyncSession::Execute(SHttpAsyncRequest request)
+{
+    auto p = make_shared<promise<SHttpAsyncResponse>>();
+    auto rv = p->get_future();
+    Execute(std::move(request), [p](SHttpAsyncResponse response) { p->set_value(std::move(response)); });
+    return rv;
+}
+
+size_t CHttpAsyncSession::GetPendingCount() const
+{
+    return m_Impl->GetPendingCount();
+}
+
+void CHttpAsyncSession::WaitAll()
+{
+    m_Impl->WaitAll();
+}
+
 
 END_NCBI_SCOPE
@@ -35,8 +35,11 @@
 
 #include <corelib/reader_writer.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <queue>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -174,6 +177,8 @@ struct SH2S_Session : SUvNgHttp2_SessionBase
     template <class TFunc>
     bool Event(TH2S_RequestEvent& event, TFunc f);
 
+    bool Cancel(TH2S_RequestEvent& event);
+
     bool IsFull() const { return m_Session.GetMaxStreams() <= m_Streams.size(); }
 
 protected:
@@ -312,6 +317,58 @@ private:
     EState m_State = eWriting;
 };
 
+struct SH2S_AsyncRequest
+{
+    SHttpAsyncRequest request;
+    CHttpAsyncSession::TCallback callback;
+    CDeadline deadline;
+    SHttpAsyncResponse response;
+    shared_ptr<TH2S_ResponseQueue> response_queue;
+
+    SH2S_AsyncRequest(SHttpAsyncRequest r, CHttpAsyncSession::TCallback c) :
+        request(std::move(r)),
+        callback(std::move(c)),
+        deadline(request.deadline)
+    {}
+
+    void Fail(SHttpAsyncResponse::EStatus status, string error)
+    {
+        response.status = status;
+        response.error = std::move(error);
+    }
+};
+
+struct SH2S_AsyncSession
+{
+    using TRequest = unique_ptr<SH2S_AsyncRequest>;
+    using TRequests = list<TRequest>;
+
+    SH2S_AsyncSession(size_t max_active);
+    ~SH2S_AsyncSession();
+
+    void Execute(TRequest request);
+    size_t GetPendingCount() const;
+    void WaitAll();
+
+private:
+    void Run();
+
+    void Start(SH2S_AsyncRequest& request);
+    bool Receive(SH2S_AsyncRequest& request);
+    void Cancel(SH2S_AsyncRequest& request);
+    void Complete(TRequests& requests);
+
+    const size_t m_MaxActive;
+    mutable mutex m_Mutex;
+    condition_variable m_Submitted;
+    condition_variable m_Completed;
+    deque<TRequest> m_Queue;
+    size_t m_Pending = 0;
+    bool m_Stop = false;
+    shared_ptr<SH2S_Io> m_Io;
+    thread m_Thread;
+};
+
 
 END_NCBI_SCOPE
 
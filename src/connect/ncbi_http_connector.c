@@ -37,6 +37,7 @@
 #include "ncbi_comm.h"
 #include "ncbi_priv.h"
 #include "ncbi_servicep.h"
+#include "ncbi_socketp.h"
 #include <connect/ncbi_base64.h>
 #include <connect/ncbi_http_connector.h>
 #include <ctype.h>
@@ -124,6 +125,7 @@ typedef struct {
     void*             user_data;      /* user data handle for callbacks (CB) */
     FHTTP_Adjust      adjust;         /* on-the-fly net_info adjustment CB   */
     FHTTP_Cleanup     cleanup;        /* cleanup callback                    */
+    SHTTP_ConnPool    pool;           /* keep-alive connection pool hooks    */
 
     THTTP_Flags       flags;          /* as passed to constructor            */
     EBSwitch          unsafe_redir:2; /* if unsafe redirects are allowed     */
@@ -824,6 +826,15 @@ static int s_TunnelAdjust(SConnNetInfo* net_info, void* data, unsigned int arg)
  * is non-zero.  If unsuccessful, try to adjust uuu->net_info with s_Adjust(),
  * and then re-try the connection attempt.
  */
+/* Whether the connection can be taken from / returned to the pool */
+static int/*bool*/ x_IsPooled(const SHttpConnector* uuu)
+{
+    const SConnNetInfo* net_info = uuu->net_info;
+    return net_info->req_method != eReqMethod_Connect
+        &&  (!net_info->http_proxy_host[0]  ||  !net_info->http_proxy_port);
+}
+
+
 static EIO_Status s_Connect(SHttpConnector* uuu,
                             const STimeout* timeout,
                             EExtractMode    extract)
@@ -1062,6 +1073,14 @@ static EIO_Status s_Connect(SHttpConnector* uuu,
                                 CORE_GetLOG());
                 CORE_UNLOCK;
             }
+            /* pick up an idle connection from the pool, if any, but not
+             * when re-trying after a failure of a re-used connection */
+            if (!sock  &&  !uuu->retry  &&  uuu->pool.get
+                &&  x_IsPooled(uuu)
+                &&  (sock = uuu->pool.get(uuu->pool.data,
+                                          uuu->net_info)) != 0) {
+                uuu->reused = 1/*true*/;
+            }
             uuu->retry = 0;
 
             /* connect & send HTTP header */
@@ -1478,6 +1497,9 @@ static EIO_Status s_ReadData(SHttpConnector* uuu,
             if (size > HTTP_SOAK_READ_SIZE)
                 size = HTTP_SOAK_READ_SIZE;
             xxx = (BUF*) buf;
+            /* input already buffered in the socket moves over w/o copying */
+            if ((*n_read = SOCK_SpliceInternal(uuu->sock, xxx, size)) != 0)
+                return eIO_Success;
             if (!(buf = (void*) malloc(size))) {
                 int error = errno;
                 char* url = ConnNetInfo_URL(uuu->net_info);
@@ -1579,28 +1601,10 @@ static EIO_Status s_ReadHeader(SHttpConnector* uuu,
     for (;;) {
         /* do we have full header yet? */
         if ((size = BUF_Size(uuu->http)) >= 4) {
-            if (!(hdr = (char*) malloc(size + 1))) {
-                int error = errno;
-                assert(!url);
-                url = ConnNetInfo_URL(uuu->net_info);
-                CORE_LOGF_ERRNO_X(7, eLOG_Error, error,
-                                  ("[HTTP%s%s]  Cannot allocate header"
-                                   " (%lu bytes)",
-                                   url ? "; " : "",
-                                   url ? url  : "",
-                                   (unsigned long) size));
-                if (url)
-                    free(url);
-                uuu->reused = 0;
-                return eIO_Unknown;
-            }
-            verify(BUF_Peek(uuu->http, hdr, size) == size);
-            if (memcmp(&hdr[size - 4], "\r\n\r\n", 4) == 0) {
-                /* full header captured */
-                hdr[size] = '\0';
-                break;
-            }
-            free(hdr);
+            char tail[4];
+            verify(BUF_PeekAt(uuu->http, size - 4, tail, 4) == 4);
+            if (memcmp(tail, "\r\n\r\n", 4) == 0)
+                break/*full header captured*/;
         }
 
         status = SOCK_StripToPattern(uuu->sock, "\r\n", 2, &uuu->http, &n);
@@ -1637,10 +1641,26 @@ static EIO_Status s_ReadHeader(SHttpConnector* uuu,
         }
     }
     /* the entire header has been read in */
+    if (!(hdr = (char*) malloc(size + 1))) {
+        int error = errno;
+        assert(!url);
+        url = ConnNetInfo_URL(uuu->net_info);
+        CORE_LOGF_ERRNO_X(7, eLOG_Error, error,
+                          ("[HTTP%s%s]  Cannot allocate header"
+                           " (%lu bytes)",
+                           url ? "; " : "",
+                           url ? url  : "",
+                           (unsigned long) size));
+        if (url)
+            free(url);
+        uuu->reused = 0;
+        return eIO_Unknown;
+    }
+    verify(BUF_Peek(uuu->http, hdr, size) == size);
+    hdr[size] = '\0';
     uuu->conn_state = eCS_ReadBody;
     BUF_Erase(uuu->http);
     uuu->reused = 0;
-    assert(hdr);
 
     /* HTTP status must come on the first line of the response */
     fatal = 0/*false*/;
@@ -2698,6 +2718,14 @@ static EIO_Status s_VT_Close
         /* "WRITE" mode and data (or just flag) is still pending */
         s_PreRead(uuu, timeout, eEM_Drop);
     }
+    /* return a completed keep-alive connection to the pool */
+    if (uuu->sock  &&  uuu->keepalive  &&  uuu->pool.put  &&  x_IsPooled(uuu)
+        &&  (uuu->conn_state == eCS_Eom
+             ||  (uuu->conn_state == eCS_DoneBody  &&  !uuu->chunked))
+        &&  uuu->pool.put(uuu->pool.data, uuu->net_info, uuu->sock)) {
+        uuu->sock = 0;
+        uuu->conn_state = eCS_Eom;
+    }
     s_Disconnect(uuu, timeout, eEM_Drop);
     assert(!uuu->sock);
 
@@ -2885,6 +2913,7 @@ static EIO_Status s_CreateHttpConnector
     uuu->user_data    = user_data;
     uuu->adjust       = adjust;
     uuu->cleanup      = 0;
+    memset(&uuu->pool, 0, sizeof(uuu->pool));
 
     sid = flags & fHTTP_NoAutomagicSID ? 1 : tunnel;
     uuu->vhost        = x_FixupUserHeader(xxx, ref, &sid);
@@ -2916,13 +2945,14 @@ static EIO_Status s_CreateHttpConnector
 
 
 static CONNECTOR s_CreateConnector
-(const SConnNetInfo* net_info,
- const char*         user_header,
- THTTP_Flags         flags,
- FHTTP_ParseHeader   parse_header,
- void*               user_data,
- FHTTP_Adjust        adjust,
- FHTTP_Cleanup       cleanup)
+(const SConnNetInfo*   net_info,
+ const char*           user_header,
+ THTTP_Flags           flags,
+ FHTTP_ParseHeader     parse_header,
+ void*                 user_data,
+ FHTTP_Adjust          adjust,
+ FHTTP_Cleanup         cleanup,
+ const SHTTP_ConnPool* pool)
 {
     SHttpConnector* uuu;
     CONNECTOR       ccc;
@@ -2942,6 +2972,8 @@ static CONNECTOR s_CreateConnector
     /* initialize additional internal data structure */
     uuu->parse_header = parse_header;
     uuu->cleanup      = cleanup;
+    if (pool)
+        uuu->pool     = *pool;
 
     /* enable an override from outside */
     if (!uuu->unsafe_redir)
@@ -2967,7 +2999,7 @@ extern CONNECTOR HTTP_CreateConnector
  const char*         user_header,
  THTTP_Flags         flags)
 {
-    return s_CreateConnector(net_info, user_header, flags, 0, 0, 0, 0);
+    return s_CreateConnector(net_info, user_header, flags, 0, 0, 0, 0, 0);
 }
 
 
@@ -2980,7 +3012,21 @@ extern CONNECTOR HTTP_CreateConnectorEx
  FHTTP_Cleanup       cleanup)
 {
     return s_CreateConnector(net_info, 0/*user_header*/, flags,
-                             parse_header, user_data, adjust, cleanup);
+                             parse_header, user_data, adjust, cleanup, 0);
+}
+
+
+extern CONNECTOR HTTP_CreatePooledConnector
+(const SConnNetInfo*   net_info,
+ THTTP_Flags           flags,
+ FHTTP_ParseHeader     parse_header,
+ void*                 user_data,
+ FHTTP_Adjust          adjust,
+ FHTTP_Cleanup         cleanup,
+ const SHTTP_ConnPool* pool)
+{
+    return s_CreateConnector(net_info, 0/*user_header*/, flags,
+                             parse_header, user_data, adjust, cleanup, pool);
 }
 
 
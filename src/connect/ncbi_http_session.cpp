@@ -38,6 +38,7 @@
 #include <corelib/request_ctx.hpp>
 #include <corelib/ncbimtx.hpp>
 #include <corelib/ncbistr.hpp>
+#include <corelib/ncbi_param.hpp>
 #include <connect/ncbi_http_session.hpp>
 #include <stdlib.h>
 
@@ -821,10 +822,238 @@ void CHttpRequest::x_SetProxy(SConnNetInfo& net_info)
 }
 
 
+///////////////////////////////////////////////////////
+//  CHttpConnPool::
+//
+
+NCBI_PARAM_DECL(unsigned, CONN, HTTP_POOL_MAX_PER_HOST);
+NCBI_PARAM_DEF_EX(unsigned, CONN, HTTP_POOL_MAX_PER_HOST, 4,
+                  eParam_NoThread, CONN_HTTP_POOL_MAX_PER_HOST);
+
+NCBI_PARAM_DECL(unsigned, CONN, HTTP_POOL_MAX_TOTAL);
+NCBI_PARAM_DEF_EX(unsigned, CONN, HTTP_POOL_MAX_TOTAL, 64,
+                  eParam_NoThread, CONN_HTTP_POOL_MAX_TOTAL);
+
+// Seconds, should be less than the servers' keep-alive timeouts
+NCBI_PARAM_DECL(double, CONN, HTTP_POOL_IDLE_TIMEOUT);
+NCBI_PARAM_DEF_EX(double, CONN, HTTP_POOL_IDLE_TIMEOUT, 4.0,
+                  eParam_NoThread, CONN_HTTP_POOL_IDLE_TIMEOUT);
+
+
+// Idle keep-alive connections of a session keyed by scheme, host and port.
+// Shared by the session with its connectors, so it stays alive until the
+// last connector using it has been closed.
+class CHttpConnPool
+{
+public:
+    CHttpConnPool(void);
+    ~CHttpConnPool(void) { Clear(); }
+
+    void SetLimits(unsigned        max_per_host,
+                   unsigned        max_total,
+                   const CTimeout& idle_timeout);
+    void Clear(void);
+
+    // Get a live idle connection, or NULL if there is none.
+    SOCK Get(const SConnNetInfo& net_info);
+    // Keep an idle connection, return false if it was not taken.
+    bool Put(const SConnNetInfo& net_info, SOCK sock);
+
+private:
+    struct SIdleConn {
+        SOCK      m_Sock;
+        CDeadline m_Expires;
+
+        SIdleConn(SOCK sock, const CTimeout& timeout)
+            : m_Sock(sock), m_Expires(timeout)
+        { }
+    };
+    typedef deque<SIdleConn>        TIdleConns;  // least recently used first
+    typedef map<string, TIdleConns> TIdleMap;
+    typedef vector<SOCK>            TSockets;
+
+    static string x_GetKey(const SConnNetInfo& net_info);
+    static void x_Close(const TSockets& socks);
+    // Move expired connections to "socks".
+    void x_DropExpired(TSockets& socks);
+
+    CFastMutex m_Mutex;
+    TIdleMap   m_Idle;
+    size_t     m_Count;
+    unsigned   m_MaxPerHost;
+    unsigned   m_MaxTotal;
+    CTimeout   m_IdleTimeout;
+};
+
+
+CHttpConnPool::CHttpConnPool(void)
+    : m_Count(0),
+      m_MaxPerHost(NCBI_PARAM_TYPE(CONN, HTTP_POOL_MAX_PER_HOST)::GetDefault()),
+      m_MaxTotal(NCBI_PARAM_TYPE(CONN, HTTP_POOL_MAX_TOTAL)::GetDefault()),
+      m_IdleTimeout(NCBI_PARAM_TYPE(CONN, HTTP_POOL_IDLE_TIMEOUT)::GetDefault())
+{
+}
+
+
+void CHttpConnPool::SetLimits(unsigned        max_per_host,
+                              unsigned        max_total,
+                              const CTimeout& idle_timeout)
+{
+    {{
+        CFastMutexGuard guard(m_Mutex);
+        m_MaxPerHost = max_per_host;
+        m_MaxTotal = max_total;
+        m_IdleTimeout = idle_timeout;
+    }}
+    // Connections kept under the old limits are not worth re-checking
+    Clear();
+}
+
+
+void CHttpConnPool::Clear(void)
+{
+    TSockets socks;
+    {{
+        CFastMutexGuard guard(m_Mutex);
+        ITERATE(TIdleMap, it, m_Idle) {
+            ITERATE(TIdleConns, conn, it->second) {
+                socks.push_back(conn->m_Sock);
+            }
+        }
+        m_Idle.clear();
+        m_Count = 0;
+    }}
+    x_Close(socks);
+}
+
+
+string CHttpConnPool::x_GetKey(const SConnNetInfo& net_info)
+{
+    bool secure = net_info.scheme == eURL_Https;
+    unsigned short port = net_info.port;
+    if ( !port ) {
+        port = secure ? CONN_PORT_HTTPS : CONN_PORT_HTTP;
+    }
+    string key(secure ? "https://" : "http://");
+    key += net_info.host;
+    NStr::ToLower(key);
+    key += ':';
+    key += NStr::UIntToString(port);
+    return key;
+}
+
+
+void CHttpConnPool::x_Close(const TSockets& socks)
+{
+    static const STimeout kZeroTimeout = { 0, 0 };
+    ITERATE(TSockets, it, socks) {
+        SOCK_SetTimeout(*it, eIO_Close, &kZeroTimeout);
+        SOCK_Destroy(*it);
+    }
+}
+
+
+void CHttpConnPool::x_DropExpired(TSockets& socks)
+{
+    for (TIdleMap::iterator it = m_Idle.begin();  it != m_Idle.end(); ) {
+        TIdleConns& conns = it->second;
+        while ( !conns.empty()  &&  conns.front().m_Expires.IsExpired() ) {
+            socks.push_back(conns.front().m_Sock);
+            conns.pop_front();
+            --m_Count;
+        }
+        if ( conns.empty() ) {
+            m_Idle.erase(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+
+SOCK CHttpConnPool::Get(const SConnNetInfo& net_info)
+{
+    static const STimeout kZeroTimeout = { 0, 0 };
+    if ( net_info.credentials ) return 0;
+    string key = x_GetKey(net_info);
+    TSockets socks;
+    SOCK sock = 0;
+    for (;;) {
+        {{
+            CFastMutexGuard guard(m_Mutex);
+            x_DropExpired(socks);
+            TIdleMap::iterator it = m_Idle.find(key);
+            if (it == m_Idle.end()) break;
+            // The most recently used connection is the most likely alive
+            sock = it->second.back().m_Sock;
+            it->second.pop_back();
+            --m_Count;
+            if ( it->second.empty() ) {
+                m_Idle.erase(it);
+            }
+        }}
+        // An idle connection must have nothing to read: any data or EOF
+        // there means the server has either closed it or gone astray.
+        if (SOCK_Wait(sock, eIO_Read, &kZeroTimeout) == eIO_Timeout) break;
+        socks.push_back(sock);
+        sock = 0;
+    }
+    x_Close(socks);
+    return sock;
+}
+
+
+bool CHttpConnPool::Put(const SConnNetInfo& net_info, SOCK sock)
+{
+    if ( net_info.credentials ) return false;
+    string key = x_GetKey(net_info);
+    TSockets socks;
+    bool taken = false;
+    {{
+        CFastMutexGuard guard(m_Mutex);
+        if (m_MaxPerHost  &&  m_MaxTotal) {
+            x_DropExpired(socks);
+            TIdleConns& conns = m_Idle[key];
+            if (conns.size() >= m_MaxPerHost) {
+                socks.push_back(conns.front().m_Sock);
+                conns.pop_front();
+                --m_Count;
+            }
+            else if (m_Count >= m_MaxTotal) {
+                // Close the least recently used connection of all hosts
+                TIdleMap::iterator lru = m_Idle.end();
+                NON_CONST_ITERATE(TIdleMap, it, m_Idle) {
+                    if ( !it->second.empty()  &&
+                         (lru == m_Idle.end()  ||
+                          it->second.front().m_Expires <
+                          lru->second.front().m_Expires) ) {
+                        lru = it;
+                    }
+                }
+                _ASSERT(lru != m_Idle.end());
+                socks.push_back(lru->second.front().m_Sock);
+                lru->second.pop_front();
+                --m_Count;
+                if (lru->second.empty()  &&  lru->first != key) {
+                    m_Idle.erase(lru);
+                }
+            }
+            conns.push_back(SIdleConn(sock, m_IdleTimeout));
+            ++m_Count;
+            taken = true;
+        }
+    }}
+    x_Close(socks);
+    return taken;
+}
+
+
 // Interface for the HTTP connector's adjust callback
 struct SAdjustData {
     CHttpRequest* m_Request;  // NB: don't use after request has been sent!
     bool          m_IsService;
+    shared_ptr<CHttpConnPool> m_ConnPool;
 
     SAdjustData(CHttpRequest* request = 0)
         : m_Request(request), m_IsService(false)
@@ -839,6 +1068,31 @@ static void s_Cleanup(void* user_data)
 }
 
 
+// data must contain SAdjustData* with the session's connection pool.
+static SOCK s_GetConnection(void* data, const SConnNetInfo* net_info)
+{
+    SAdjustData* adj = reinterpret_cast<SAdjustData*>(data);
+    try {
+        return adj->m_ConnPool->Get(*net_info);
+    }
+    NCBI_CATCH_ALL("CHttpConnPool::Get()");
+    return 0;
+}
+
+
+static int/*bool*/ s_PutConnection(void*               data,
+                                   const SConnNetInfo* net_info,
+                                   SOCK                sock)
+{
+    SAdjustData* adj = reinterpret_cast<SAdjustData*>(data);
+    try {
+        return adj->m_ConnPool->Put(*net_info, sock) ? 1 : 0;
+    }
+    NCBI_CATCH_ALL("CHttpConnPool::Put()");
+    return 0;
+}
+
+
 void CHttpRequest::x_InitConnection(bool use_form_data)
 {
     bool is_service = m_Url.IsService();
@@ -886,7 +1140,12 @@ void CHttpRequest::x_InitConnection(bool use_form_data)
     m_Response.Reset(new CHttpResponse(*m_Session, m_Url));
     unique_ptr<SAdjustData> adjust_data(new SAdjustData(this));
     if ( !is_service ) {
-        // Connect using HTTP.
+        // Connect using HTTP, reusing idle connections of the session.
+        adjust_data->m_ConnPool = m_Session->m_ConnPool;
+        SHTTP_ConnPool pool;
+        pool.data = adjust_data.get();
+        pool.get = s_GetConnection;
+        pool.put = s_PutConnection;
         m_Stream.reset(new CConn_HttpStream(
             m_Url.ComposeUrl(CUrlArgs::eAmp_Char),
             net_info.get(),
@@ -896,7 +1155,10 @@ void CHttpRequest::x_InitConnection(bool use_form_data)
             sx_Adjust,
             s_Cleanup,
             // Always set AdjustOnRedirect flag - to send correct cookies.
-            m_Session->GetHttpFlags() | fHTTP_AdjustOnRedirect));
+            m_Session->GetHttpFlags() | fHTTP_AdjustOnRedirect,
+            kDefaultTimeout,
+            kConn_DefaultBufSize,
+            &pool));
     }
     else {
         // Try to resolve service name.
@@ -1133,8 +1395,23 @@ void CHttpRequest::SetParam(const CHttpParam& param)
 
 CHttpSession_Base::CHttpSession_Base(EProtocol protocol)
     : m_Protocol(protocol),
-      m_HttpFlags(0)
+      m_HttpFlags(0),
+      m_ConnPool(new CHttpConnPool)
+{
+}
+
+
+void CHttpSession_Base::SetConnectionPool(unsigned        max_per_host,
+                                          unsigned        max_total,
+                                          const CTimeout& idle_timeout)
+{
+    m_ConnPool->SetLimits(max_per_host, max_total, idle_timeout);
+}
+
+
+void CHttpSession_Base::ClearConnectionPool(void)
 {
+    m_ConnPool->Clear();
 }
 
 
@@ -128,6 +128,14 @@
 #  endif /*HAVE_SYS_RESOURCE_H*/
 #  include <sys/stat.h>
 #  include <sys/un.h>
+#  include <sys/uio.h>
+#  if defined(NCBI_OS_LINUX)  &&  defined(HAVE_SYS_EPOLL_H)
+#    include <sys/epoll.h>
+#    define SOCK_HAVE_POLLSET  1
+#  endif /*NCBI_OS_LINUX && HAVE_SYS_EPOLL_H*/
+#  ifdef NCBI_OS_LINUX
+#    include <sys/sendfile.h>
+#  endif /*NCBI_OS_LINUX*/
 #endif /*NCBI_OS_UNIX*/
 
 /* Portable standard C headers
@@ -7324,6 +7332,134 @@ extern EIO_Status SOCK_Read(SOCK           sock,
 #define s_Pushback(s, d, n)  BUF_Pushback(&(s)->r_buf, d, n)
 
 
+static size_t x_CompareCB(void* cbdata, const void* data, size_t size)
+{
+    const char** pattern = (const char**) cbdata;
+    if (memcmp(*pattern, data, size) != 0)
+        return 0;
+    *pattern += size;
+    return size;
+}
+
+
+/* Return the position of "pattern" in "buf", or BUF_Size(buf) if not found */
+static size_t x_FindPattern(BUF buf, const char* pattern, size_t pattern_size)
+{
+    void*       cursor = 0;
+    size_t      pos = 0, size;
+    const void* data;
+
+    assert(pattern_size);
+    while ((size = BUF_PeekChunk(buf, &cursor, &data)) != 0) {
+        const char* end = (const char*) data + size;
+        const char* p   = (const char*) data;
+        while ((p = (const char*) memchr(p, *pattern, (size_t)(end - p))) !=0){
+            size_t      at = pos + (size_t)(p - (const char*) data);
+            const char* x_pattern = pattern + 1;
+            if ((size_t)(end - p) >= pattern_size) {
+                if (memcmp(p + 1, x_pattern, pattern_size - 1) == 0)
+                    return at;
+            } else if (BUF_PeekAtCB(buf, at + 1, x_CompareCB, &x_pattern,
+                                    pattern_size - 1) == pattern_size - 1) {
+                /* the pattern spans over the chunk boundary */
+                return at;
+            }
+            ++p;
+        }
+        pos += size;
+    }
+    return pos;
+}
+
+
+static int/*bool*/ x_StripBuffered(SOCK    sock,
+                                   size_t  size,
+                                   BUF*    discard,
+                                   size_t* n_discarded)
+{
+    size_t n = discard
+        ? BUF_SpliceEx(discard, sock->r_buf, size)
+        : BUF_Read(sock->r_buf, 0, size);
+    *n_discarded += n;
+    return n == size;
+}
+
+
+extern EIO_Status SOCK_StripToPatternInternal(SOCK        sock,
+                                              const void* pattern,
+                                              size_t      pattern_size,
+                                              BUF*        discard,
+                                              size_t*     n_discarded)
+{
+    size_t x_discarded = 0;
+    EIO_Status status;
+    char _id[MAXIDLEN];
+
+    assert(pattern  &&  pattern_size);
+
+    if (sock->sock == SOCK_INVALID) {
+        CORE_LOGF_X(177, eLOG_Error,
+                    ("%s[SOCK::StripToPattern] "
+                     " Invalid socket",
+                     s_ID(sock, _id)));
+        status = eIO_Unknown;
+    } else if (sock->type != eSOCK_Socket) {
+        status = eIO_NotSupported;
+    } else for (;;) {
+        size_t avail = BUF_Size(sock->r_buf);
+        size_t x_read;
+
+        if (avail >= pattern_size) {
+            size_t pos = x_FindPattern(sock->r_buf,
+                                       (const char*) pattern, pattern_size);
+            if (pos < avail) {
+                /* pattern found */
+                status = x_StripBuffered(sock, pos + pattern_size,
+                                         discard, &x_discarded)
+                    ? eIO_Success : eIO_Unknown;
+                break;
+            }
+            /* keep only the tail that can start the pattern */
+            if (!x_StripBuffered(sock, avail - pattern_size + 1,
+                                 discard, &x_discarded)) {
+                status = eIO_Unknown;
+                break;
+            }
+            avail = pattern_size - 1;
+        }
+
+        /* get more data into the read buffer */
+        status = s_Read(sock, 0, avail + 1, &x_read, 1/*peek*/);
+        if (x_read <= avail) {
+            if (status == eIO_Success) {
+                status  = sock->eof
+                    ? eIO_Closed : (EIO_Status) sock->r_status;
+                if (status == eIO_Success)
+                    status  = eIO_Unknown;
+            }
+            /* pattern not found: strip the rest */
+            if (avail  &&  !x_StripBuffered(sock, avail,
+                                            discard, &x_discarded)) {
+                status = eIO_Unknown;
+            }
+            break;
+        }
+    }
+
+    if ( n_discarded )
+        *n_discarded = x_discarded;
+    return status;
+}
+
+
+extern size_t SOCK_SpliceInternal(SOCK sock, BUF* buf, size_t size)
+{
+    if (sock->sock == SOCK_INVALID  ||  sock->type != eSOCK_Socket)
+        return 0;
+    return BUF_SpliceEx(buf, sock->r_buf, size);
+}
+
+
 extern EIO_Status SOCK_ReadLine(SOCK    sock,
                                 char*   line,
                                 size_t  size,
@@ -7552,6 +7688,352 @@ extern EIO_Status SOCK_Write(SOCK            sock,
 }
 
 
+#ifdef NCBI_OS_UNIX
+
+/* Max # of pieces passed to the system at once */
+#  if defined(IOV_MAX)  &&  IOV_MAX < 64
+#    define SOCK_IOV_MAX  IOV_MAX
+#  else
+#    define SOCK_IOV_MAX  64
+#  endif
+
+
+/* Handle a failure of sendmsg() / sendfile() the same way s_Send() does for
+ * send():  return eIO_Success if the call can be retried, or an error code.
+ */
+static EIO_Status x_SendFailed(SOCK sock, int error, const char* what)
+{
+    char _id[MAXIDLEN];
+
+    if (error == SOCK_EWOULDBLOCK  ||  error == SOCK_EAGAIN) {
+        SSOCK_Poll poll;
+        EIO_Status status;
+        if (sock->w_tv_set  &&  !(sock->w_tv.tv_sec | sock->w_tv.tv_usec)) {
+            sock->w_status = eIO_Timeout;
+            return eIO_Timeout;
+        }
+        poll.sock   = sock;
+        poll.event  = eIO_Write;
+        poll.revent = eIO_Open;
+        status = s_SelectStallsafe(1, &poll, SOCK_GET_TIMEOUT(sock, w), 0);
+        if (status == eIO_Timeout)
+            sock->w_status = eIO_Timeout;
+        else if (status == eIO_Success  &&  poll.revent == eIO_Close)
+            status = eIO_Unknown;
+        return status;
+    }
+    if (error == SOCK_EPIPE         ||
+        error == SOCK_ENOTCONN      ||
+        error == SOCK_ETIMEDOUT     ||
+        error == SOCK_ENETRESET     ||
+        error == SOCK_ECONNRESET    ||
+        error == SOCK_ECONNABORTED) {
+        if (error != SOCK_EPIPE)
+            sock->r_status = eIO_Closed;
+        sock->w_status = eIO_Closed;
+        return eIO_Closed;
+    }
+    if (error == SOCK_EINTR) {
+        if (sock->i_on_sig == eOn
+            ||  (sock->i_on_sig == eDefault  &&  s_InterruptOnSignal == eOn)) {
+            sock->w_status = eIO_Interrupt;
+            return eIO_Interrupt;
+        }
+        return eIO_Success;
+    } else {
+        const char* strerr = SOCK_STRERROR(error);
+        CORE_LOGF_ERRNO_EXX(171, eLOG_Trace,
+                            error, strerr ? strerr : "",
+                            ("%s[SOCK::Send] "
+                             " Failed %s()",
+                             s_ID(sock, _id), what));
+        UTIL_ReleaseBuffer(strerr);
+    }
+    sock->w_status = eIO_Unknown;
+    return eIO_Unknown;
+}
+
+
+/* Send the pieces with as few sendmsg() calls as possible.  Return
+ * eIO_Success if some data (all data if "persist") have been sent.
+ */
+static EIO_Status s_SendV(SOCK               sock,
+                          const SSOCK_IOVec* iov,
+                          size_t             n,
+                          size_t*            n_written,
+                          int/*bool*/        persist)
+{
+    struct iovec x_iov[SOCK_IOV_MAX];
+    size_t       skip = 0/*bytes of iov[0] already sent*/;
+
+    assert(sock->type == eSOCK_Socket  &&  !sock->sslctx  &&  !*n_written);
+
+    while (n) {
+        struct msghdr msg;
+        ssize_t       x_written;
+        size_t        m;
+
+        if (iov->size == skip) {
+            ++iov, --n;
+            skip = 0;
+            continue;
+        }
+        for (m = 0;  m < n  &&  m < SOCK_IOV_MAX;  ++m) {
+            x_iov[m].iov_base = (char*) iov[m].data + (m ? 0 : skip);
+            x_iov[m].iov_len  =         iov[m].size - (m ? 0 : skip);
+        }
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov    = x_iov;
+        msg.msg_iovlen = m;
+
+        x_written = sendmsg(sock->sock, &msg,
+#ifdef MSG_NOSIGNAL
+                            s_AllowSigPipe ? 0 : MSG_NOSIGNAL
+#else
+                            0
+#endif /*MSG_NOSIGNAL*/
+                            );
+        if (x_written <= 0) {
+            EIO_Status status = x_written < 0
+                ? x_SendFailed(sock, SOCK_ERRNO, "sendmsg")
+                : eIO_Unknown;
+            if (status == eIO_Success)
+                continue;
+            return *n_written  &&  !persist ? eIO_Success : status;
+        }
+
+        sock->n_written += (TNCBI_BigCount) x_written;
+        *n_written      += (size_t)         x_written;
+        sock->w_status   = eIO_Success;
+        do {
+            size_t x_size = iov->size - skip;
+            if ((size_t) x_written < x_size)
+                x_size = (size_t) x_written;
+            /* statistics & logging */
+            if (sock->log == eOn  ||  (sock->log == eDefault && s_Log == eOn))
+                s_DoLog(eLOG_Note, sock, eIO_Write,
+                        (const char*) iov->data + skip, x_size, 0);
+            x_written -= (ssize_t) x_size;
+            if ((skip += x_size) == iov->size) {
+                ++iov, --n;
+                skip = 0;
+            }
+        } while (x_written);
+
+        if (!persist)
+            break;
+    }
+    return eIO_Success;
+}
+
+
+/* Send file contents read into a temporary buffer (for TLS, or when the
+ * kernel cannot send from the file directly)
+ */
+static EIO_Status s_SendFileRead(SOCK           sock,
+                                 int            fd,
+                                 TNCBI_BigCount offset,
+                                 size_t         size,
+                                 size_t*        n_written)
+{
+    size_t     buf_size = size < 4 * SOCK_BUF_CHUNK_SIZE
+        ? size : 4 * SOCK_BUF_CHUNK_SIZE;
+    EIO_Status status = eIO_Success;
+    char*      buf;
+
+    if (!(buf = (char*) malloc(buf_size)))
+        return eIO_Unknown;
+    while (*n_written < size) {
+        size_t  x_todo = size - *n_written;
+        size_t  x_written;
+        ssize_t x_read = pread(fd, buf, x_todo < buf_size ? x_todo : buf_size,
+                               (off_t)(offset + *n_written));
+        if (x_read < 0) {
+            int error = errno;
+            if (error == EINTR)
+                continue;
+            CORE_LOGF_ERRNO_X(172, eLOG_Error, error,
+                              ("[SOCK::SendFile] "
+                               " Cannot read file descriptor %d", fd));
+            status = eIO_Unknown;
+            break;
+        }
+        if (!x_read) {
+            status = eIO_Closed;
+            break;
+        }
+        status = SOCK_Write(sock, buf, (size_t) x_read, &x_written,
+                            eIO_WritePersist);
+        *n_written += x_written;
+        if (status != eIO_Success)
+            break;
+    }
+    free(buf);
+    return status;
+}
+
+
+#  ifdef NCBI_OS_LINUX
+static EIO_Status s_SendFile(SOCK           sock,
+                             int            fd,
+                             TNCBI_BigCount offset,
+                             size_t         size,
+                             size_t*        n_written)
+{
+    off_t pos = (off_t) offset;
+
+    assert(sock->type == eSOCK_Socket  &&  !sock->sslctx  &&  !*n_written);
+
+    while (*n_written < size) {
+        size_t  x_todo = size - *n_written;
+        ssize_t x_written = sendfile(sock->sock, fd, &pos,
+                                     x_todo < 0x7FFFF000 ? x_todo : 0x7FFFF000);
+        if (x_written < 0) {
+            EIO_Status status;
+            int error = errno;
+            if (!*n_written  &&  (error == EINVAL  ||  error == ENOSYS)) {
+                /* the file cannot be sent by the kernel directly */
+                return s_SendFileRead(sock, fd, offset, size, n_written);
+            }
+            if ((status = x_SendFailed(sock, error, "sendfile")) != eIO_Success)
+                return status;
+            continue;
+        }
+        if (!x_written)
+            return eIO_Closed/*premature EOF*/;
+        sock->n_written += (TNCBI_BigCount) x_written;
+        *n_written      += (size_t)         x_written;
+        sock->w_status   = eIO_Success;
+    }
+    return eIO_Success;
+}
+#  endif /*NCBI_OS_LINUX*/
+
+#endif /*NCBI_OS_UNIX*/
+
+
+extern EIO_Status SOCK_WriteV(SOCK              sock,
+                              const SSOCK_IOVec iov[],
+                              size_t            n,
+                              size_t*           n_written,
+                              EIO_WriteMethod   how)
+{
+    EIO_Status status;
+    size_t     x_written = 0;
+    char       _id[MAXIDLEN];
+    size_t     i;
+
+    for (i = 0;  i < n;  ++i) {
+        if (iov[i].size  &&  !iov[i].data) {
+            if ( n_written )
+                *n_written = 0;
+            assert(0);
+            return eIO_InvalidArg;
+        }
+    }
+    if (how != eIO_WritePlain  &&  how != eIO_WritePersist) {
+        CORE_LOGF_X(173, eLOG_Error,
+                    ("%s[SOCK::WriteV] "
+                     " Unsupported write method #%u",
+                     s_ID(sock, _id), (unsigned int) how));
+        status = eIO_NotSupported;
+    } else if (sock->sock == SOCK_INVALID) {
+        CORE_LOGF_X(174, eLOG_Error,
+                    ("%s[SOCK::WriteV] "
+                     " Invalid socket",
+                     s_ID(sock, _id)));
+        status = eIO_Closed;
+    }
+#ifdef NCBI_OS_UNIX
+    else if (sock->type == eSOCK_Socket  &&  !sock->sslctx) {
+        if (sock->w_status == eIO_Closed)
+            status = eIO_Closed;
+        else if ((status = s_WritePending(sock, SOCK_GET_TIMEOUT(sock, w),
+                                          0, 0)) == eIO_Success) {
+            status = s_SendV(sock, iov, n, &x_written,
+                             how == eIO_WritePersist);
+        }
+    }
+#endif /*NCBI_OS_UNIX*/
+    else {
+        /* piece by piece */
+        status = eIO_Success;
+        for (i = 0;  i < n;  ++i) {
+            size_t xx_written;
+            if (!iov[i].size)
+                continue;
+            status = SOCK_Write(sock, iov[i].data, iov[i].size,
+                                &xx_written, how);
+            x_written += xx_written;
+            if (status != eIO_Success  ||  xx_written < iov[i].size)
+                break;
+        }
+        if (how == eIO_WritePlain  &&  x_written)
+            status = eIO_Success;
+    }
+
+    if ( n_written )
+        *n_written = x_written;
+    return status;
+}
+
+
+extern EIO_Status SOCK_SendFile(SOCK           sock,
+                                int            fd,
+                                TNCBI_BigCount offset,
+                                size_t         size,
+                                size_t*        n_written)
+{
+#ifdef NCBI_OS_UNIX
+    EIO_Status status;
+    size_t     x_written = 0;
+    char       _id[MAXIDLEN];
+
+    if (fd < 0) {
+        status = eIO_InvalidArg;
+    } else if (sock->sock == SOCK_INVALID) {
+        CORE_LOGF_X(175, eLOG_Error,
+                    ("%s[SOCK::SendFile] "
+                     " Invalid socket",
+                     s_ID(sock, _id)));
+        status = eIO_Closed;
+    } else if (sock->type != eSOCK_Socket) {
+        CORE_LOGF_X(170, eLOG_Error,
+                    ("%s[SOCK::SendFile] "
+                     " Not a stream socket",
+                     s_ID(sock, _id)));
+        status = eIO_NotSupported;
+    } else if (sock->w_status == eIO_Closed) {
+        status = eIO_Closed;
+    } else if ((status = s_WritePending(sock, SOCK_GET_TIMEOUT(sock, w),
+                                        0, 0)) == eIO_Success) {
+#  ifdef NCBI_OS_LINUX
+        if (!sock->sslctx)
+            status = s_SendFile(sock, fd, offset, size, &x_written);
+        else
+#  endif /*NCBI_OS_LINUX*/
+            status = s_SendFileRead(sock, fd, offset, size, &x_written);
+        if (x_written
+            &&  (sock->log == eOn  ||  (sock->log == eDefault && s_Log == eOn))) {
+            CORE_LOGF_X(176, eLOG_Note,
+                        ("%s[SOCK::SendFile] "
+                         " %lu byte%s sent from file descriptor %d",
+                         s_ID(sock, _id), (unsigned long) x_written,
+                         &"s"[x_written == 1], fd));
+        }
+    }
+
+    if ( n_written )
+        *n_written = x_written;
+    return status;
+#else
+    if ( n_written )
+        *n_written = 0;
+    return eIO_NotSupported;
+#endif /*NCBI_OS_UNIX*/
+}
+
+
 extern EIO_Status SOCK_Abort(SOCK sock)
 {
     char _id[MAXIDLEN];
@@ -8651,6 +9133,301 @@ extern SOCK  POLLABLE_ToSOCK(POLLABLE poll)
 
 
 
+/******************************************************************************
+ *  PERSISTENT POLL SET
+ */
+
+#ifdef SOCK_HAVE_POLLSET
+
+/* Max number of events to fetch from the system at once */
+#  define POLLSET_MAXEVENTS  256
+
+
+typedef struct {
+    POLLABLE  poll;
+    void*     data;
+    EIO_Event revent;
+} SPOLLSET_Ready;
+
+
+/* The ready list is guarded with the CORE lock, so that handles can be armed
+ * and removed by other threads while one is waiting on the set.  The lock is
+ * never held across epoll_wait() or while logging. */
+struct SPOLLSET_tag {
+    int             fd;       /* epoll descriptor                            */
+    size_t          n_ready;  /* handles found ready at the time of arming   */
+    size_t          n_alloc;
+    SPOLLSET_Ready* ready;
+};
+
+
+static void x_PollSetUnready(POLLSET pollset, POLLABLE poll)
+{
+    size_t i = 0;
+    while (i < pollset->n_ready) {
+        if (pollset->ready[i].poll == poll) {
+            memmove(pollset->ready + i, pollset->ready + i + 1,
+                    (--pollset->n_ready - i) * sizeof(*pollset->ready));
+        } else
+            ++i;
+    }
+}
+
+
+/* Same pre-checks as done by SOCK_Poll() for things not visible to the OS */
+static EIO_Event x_PollSetPreReady(SOCK sock, EIO_Event event)
+{
+    if (sock->type == eSOCK_Trigger)
+        return ((TRIGGER) sock)->isset.ptr ? event : eIO_Open;
+    if (!(sock->type & eSOCK_Socket))
+        return eIO_Open;
+    if (sock->sock == SOCK_INVALID)
+        return eIO_Close;
+    if ((event & eIO_Read)  &&  BUF_Size(sock->r_buf) != 0)
+        return eIO_Read;
+    if (sock->type != eSOCK_Socket)
+        return eIO_Open;
+    if ((event == eIO_Read
+         &&  (sock->r_status == eIO_Closed  ||  sock->eof))  ||
+        (event == eIO_Write
+         &&   sock->w_status == eIO_Closed)) {
+        return eIO_Close;
+    }
+    return eIO_Open;
+}
+
+
+static EIO_Event x_PollSetEvent(unsigned int events)
+{
+    int revent = eIO_Open;
+    if (events & (EPOLLIN | EPOLLRDHUP))
+        revent |= eIO_Read;
+    if (events & EPOLLOUT)
+        revent |= eIO_Write;
+    if (!revent  &&  (events & (EPOLLERR | EPOLLHUP)))
+        return eIO_Close;
+    return (EIO_Event) revent;
+}
+
+#endif /*SOCK_HAVE_POLLSET*/
+
+
+extern EIO_Status POLLSET_Create(POLLSET* pollset)
+{
+#ifdef SOCK_HAVE_POLLSET
+    POLLSET x_pollset;
+    int     fd;
+
+    *pollset = 0;
+    if ((fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        int error = errno;
+        CORE_LOGF_ERRNO_X(167, eLOG_Error, error,
+                          ("[POLLSET::Create] "
+                           " Cannot create epoll descriptor"));
+        return eIO_Unknown;
+    }
+    if (!(x_pollset = (POLLSET) calloc(1, sizeof(*x_pollset)))) {
+        close(fd);
+        return eIO_Unknown;
+    }
+    x_pollset->fd = fd;
+    *pollset = x_pollset;
+    return eIO_Success;
+#else
+    *pollset = 0;
+    return eIO_NotSupported;
+#endif /*SOCK_HAVE_POLLSET*/
+}
+
+
+extern EIO_Status POLLSET_Close(POLLSET pollset)
+{
+#ifdef SOCK_HAVE_POLLSET
+    if (!pollset)
+        return eIO_InvalidArg;
+    close(pollset->fd);
+    if (pollset->ready)
+        free(pollset->ready);
+    free(pollset);
+    return eIO_Success;
+#else
+    return pollset ? eIO_NotSupported : eIO_InvalidArg;
+#endif /*SOCK_HAVE_POLLSET*/
+}
+
+
+extern EIO_Status POLLSET_Arm(POLLSET   pollset,
+                              POLLABLE  poll,
+                              EIO_Event event,
+                              void*     data)
+{
+#ifdef SOCK_HAVE_POLLSET
+    struct epoll_event ev;
+    EIO_Event  revent;
+    SOCK       sock = (SOCK) poll;
+
+    if (!pollset  ||  !sock  ||  !event
+        ||  (event | eIO_ReadWrite) != eIO_ReadWrite) {
+        return eIO_InvalidArg;
+    }
+    CORE_LOCK_WRITE;
+    x_PollSetUnready(pollset, poll);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.data.ptr = data;
+    if ((revent = x_PollSetPreReady(sock, event)) != eIO_Open) {
+        if (pollset->n_ready == pollset->n_alloc) {
+            size_t n_alloc = pollset->n_alloc ? pollset->n_alloc << 1 : 16;
+            SPOLLSET_Ready* ready = (SPOLLSET_Ready*)
+                realloc(pollset->ready, n_alloc * sizeof(*ready));
+            if (!ready) {
+                CORE_UNLOCK;
+                return eIO_Unknown;
+            }
+            pollset->ready   = ready;
+            pollset->n_alloc = n_alloc;
+        }
+        pollset->ready[pollset->n_ready].poll   = poll;
+        pollset->ready[pollset->n_ready].data   = data;
+        pollset->ready[pollset->n_ready].revent = revent;
+        pollset->n_ready++;
+        /* keep registered yet disarmed */
+        ev.events = EPOLLONESHOT;
+        if (sock->sock != SOCK_INVALID)
+            epoll_ctl(pollset->fd, EPOLL_CTL_MOD, sock->sock, &ev);
+        CORE_UNLOCK;
+        return eIO_Success;
+    }
+    CORE_UNLOCK;
+
+    ev.events = EPOLLONESHOT;
+    if (event & eIO_Read)
+        ev.events |= EPOLLIN | EPOLLRDHUP;
+    if (event & eIO_Write)
+        ev.events |= EPOLLOUT;
+    if (epoll_ctl(pollset->fd, EPOLL_CTL_MOD, sock->sock, &ev) != 0) {
+        int error = errno;
+        if (error == ENOENT
+            &&  epoll_ctl(pollset->fd, EPOLL_CTL_ADD, sock->sock, &ev) == 0) {
+            return eIO_Success;
+        }
+        error = errno;
+        CORE_LOGF_ERRNO_X(168, eLOG_Error, error,
+                          ("[POLLSET::Arm] "
+                           " Cannot arm handle %d", (int) sock->sock));
+        return error == EPERM ? eIO_NotSupported : eIO_Unknown;
+    }
+    return eIO_Success;
+#else
+    return pollset ? eIO_NotSupported : eIO_InvalidArg;
+#endif /*SOCK_HAVE_POLLSET*/
+}
+
+
+extern EIO_Status POLLSET_Remove(POLLSET pollset, POLLABLE poll)
+{
+#ifdef SOCK_HAVE_POLLSET
+    SOCK sock = (SOCK) poll;
+
+    if (!pollset  ||  !sock)
+        return eIO_InvalidArg;
+    CORE_LOCK_WRITE;
+    x_PollSetUnready(pollset, poll);
+    if (sock->sock != SOCK_INVALID) {
+        /* NB: a handle not in the set (ENOENT) is not an error */
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        epoll_ctl(pollset->fd, EPOLL_CTL_DEL, sock->sock, &ev);
+    }
+    CORE_UNLOCK;
+    return eIO_Success;
+#else
+    return pollset ? eIO_NotSupported : eIO_InvalidArg;
+#endif /*SOCK_HAVE_POLLSET*/
+}
+
+
+extern EIO_Status POLLSET_Wait(POLLSET         pollset,
+                               SPOLLSET_Event  events[],
+                               size_t          n,
+                               const STimeout* timeout,
+                               size_t*         n_ready)
+{
+#ifdef SOCK_HAVE_POLLSET
+    struct epoll_event x_ev[POLLSET_MAXEVENTS];
+    struct timeval     tv;
+    size_t             count = 0;
+    int                wait;
+
+    if (n_ready)
+        *n_ready = 0;
+    if (!pollset  ||  !events  ||  !n)
+        return eIO_InvalidArg;
+
+    /* pre-ready handles go first */
+    CORE_LOCK_WRITE;
+    if (pollset->n_ready) {
+        size_t i;
+        count = pollset->n_ready < n ? pollset->n_ready : n;
+        for (i = 0;  i < count;  ++i) {
+            events[i].data   = pollset->ready[i].data;
+            events[i].revent = pollset->ready[i].revent;
+        }
+        memmove(pollset->ready, pollset->ready + count,
+                (pollset->n_ready -= count) * sizeof(*pollset->ready));
+    }
+    CORE_UNLOCK;
+    if (count) {
+        if (count == n) {
+            if (n_ready)
+                *n_ready = count;
+            return eIO_Success;
+        }
+        wait = 0;
+    } else if (s_to2tv(timeout, &tv)) {
+        wait = (int)(tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000);
+    } else
+        wait = -1;
+
+    for (;;) {
+        int m = (int)(n - count < POLLSET_MAXEVENTS
+                      ? n - count : POLLSET_MAXEVENTS);
+        int x_ready = epoll_wait(pollset->fd, x_ev, m, wait);
+        if (x_ready >= 0) {
+            int i;
+            for (i = 0;  i < x_ready;  ++i) {
+                events[count].data   = x_ev[i].data.ptr;
+                events[count].revent = x_PollSetEvent(x_ev[i].events);
+                ++count;
+            }
+            break;
+        }
+        if ((x_ready = errno) != EINTR) {
+            if (count)
+                break;
+            CORE_LOGF_ERRNO_X(169, eLOG_Error, x_ready,
+                              ("[POLLSET::Wait] "
+                               " Failed epoll_wait()"));
+            return eIO_Unknown;
+        }
+        if (count)
+            break;
+        if (s_InterruptOnSignal == eOn)
+            return eIO_Interrupt;
+    }
+
+    if (n_ready)
+        *n_ready = count;
+    return count ? eIO_Success : eIO_Timeout;
+#else
+    if (n_ready)
+        *n_ready = 0;
+    return pollset ? eIO_NotSupported : eIO_InvalidArg;
+#endif /*SOCK_HAVE_POLLSET*/
+}
+
+
+
 /******************************************************************************
  *  BSD-LIKE INTERFACE
  */
@@ -386,6 +386,32 @@ EIO_Status CSocket::Write(const void*     buf,
 }
 
 
+EIO_Status CSocket::WriteV(const SSOCK_IOVec* iov,
+                           size_t             n,
+                           size_t*            n_written,
+                           EIO_WriteMethod    how)
+{
+    if ( m_Socket )
+        return SOCK_WriteV(m_Socket, iov, n, n_written, how);
+    if ( n_written )
+        *n_written = 0;
+    return eIO_Closed;
+}
+
+
+EIO_Status CSocket::SendFile(int     fd,
+                             Uint8   offset,
+                             size_t  size,
+                             size_t* n_written)
+{
+    if ( m_Socket )
+        return SOCK_SendFile(m_Socket, fd, offset, size, n_written);
+    if ( n_written )
+        *n_written = 0;
+    return eIO_Closed;
+}
+
+
 void CSocket::GetPeerAddress(unsigned int*   host,
                              unsigned short* port,
                              ENH_ByteOrder   byte_order) const
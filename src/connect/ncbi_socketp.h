@@ -389,6 +389,27 @@ size_t SOCK_HostPortToStringEx(unsigned int   host,
                                int/*bool*/    flag);
 
 
+/* Addtl socket API for internal use:  SOCK_StripToPattern() for a non-NULL
+ * "pattern" of non-zero size, done by searching the data in the socket's read
+ * buffer in place, and by moving (rather than copying) the stripped data to
+ * "discard".  Return eIO_NotSupported (and strip nothing) for sockets other
+ * than stream ones.
+ */
+EIO_Status SOCK_StripToPatternInternal(SOCK        sock,
+                                       const void* pattern,
+                                       size_t      pattern_size,
+                                       BUF*        discard,
+                                       size_t*     n_discarded);
+
+
+/* Addtl socket API for internal use:  move up to "size" bytes of input, which
+ * has already been read from a stream socket and is kept in its read buffer,
+ * to the end of "*buf" (whole chunks get re-linked rather than copied).
+ * Return the number of bytes moved (0 if nothing was buffered).  No I/O.
+ */
+size_t SOCK_SpliceInternal(SOCK sock, BUF* buf, size_t size);
+
+
 /* See: SOCK_SetupSSL[Ex] */
 void SOCK_SetupSSLInternal(FSSLSetup setup, int/*bool*/ init);
 
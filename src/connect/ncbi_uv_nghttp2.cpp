@@ -536,6 +536,21 @@ int SNgHttp2_Session::Resume(int32_t stream_id)
     return x_DelOnError(rv);
 }
 
+int SNgHttp2_Session::Cancel(int32_t stream_id)
+{
+    if (auto rv = Init()) return rv;
+
+    auto rv = nghttp2_submit_rst_stream(m_Session, NGHTTP2_FLAG_NONE, stream_id, NGHTTP2_CANCEL);
+
+    if (rv < 0) {
+        NCBI_NGHTTP2_SESSION_TRACE(this << " cancel failed: " << SUvNgHttp2_Error::NgHttp2Str(rv));
+    } else {
+        NCBI_NGHTTP2_SESSION_TRACE(this << " cancelled");
+    }
+
+    return x_DelOnError(rv);
+}
+
 ssize_t SNgHttp2_Session::Send(vector<char>& buffer)
 {
     if (auto rv = Init()) return rv;
@@ -49,6 +49,11 @@ NCBI_PARAM_DEF_EX(bool, server, Catch_Unhandled_Exceptions, true, 0,
 typedef NCBI_PARAM_TYPE(server, Catch_Unhandled_Exceptions) TParamServerCatchExceptions;
 static CSafeStatic<TParamServerCatchExceptions> s_ServerCatchExceptions;
 
+NCBI_PARAM_DECL(bool, server, Use_Poll_Set);
+NCBI_PARAM_DEF_EX(bool, server, Use_Poll_Set, false, 0,
+                  CSERVER_USE_POLL_SET);
+typedef NCBI_PARAM_TYPE(server, Use_Poll_Set) TParamServerUsePollSet;
+
 
 /////////////////////////////////////////////////////////////////////////////
 // IServer_MessageHandler implementation
@@ -659,6 +664,12 @@ void CServer::x_DoRun(void)
 
     Init();
 
+    if (TParamServerUsePollSet::GetDefault()
+        &&  !m_ConnectionPool->EnablePollSet()) {
+        ERR_POST(Warning << "Poll set is not supported on this platform, "
+                            "polling all connections on each iteration");
+    }
+
     vector<CSocketAPI::SPoll> polls;
     size_t     count;
     typedef vector<IServer_ConnectionBase*> TConnsList;
@@ -707,7 +718,7 @@ void CServer::x_DoRun(void)
             timeout = &timer_timeout;
         }
 
-        EIO_Status status = CSocketAPI::Poll(polls, timeout, &count);
+        EIO_Status status = m_ConnectionPool->Poll(polls, timeout, &count);
 
         if (status != eIO_Success  &&  status != eIO_Timeout) {
             int x_errno = errno;
@@ -78,6 +78,41 @@ extern int main(void)
         buf = 0;
     }}
 
+    /* chunk iteration and moving */
+    {{
+        char        charbuf[128];
+        void*       cursor = 0;
+        const void* data;
+        size_t      size, pos, n;
+        BUF         dst = 0;
+        char*       heap = (char*) malloc(6);
+        assert(heap);
+        memcpy(heap, "Heap! ", 6);
+        assert(BUF_Append(&buf, "Hello ", 6));
+        assert(BUF_AppendEx(&buf, heap, 6, heap, 6));
+        assert(BUF_Write(&buf, "World", 5));
+        assert(BUF_Read(buf, 0, 2) == 2);
+        for (n = pos = 0;  (size = BUF_PeekChunk(buf, &cursor, &data)) != 0;
+             ++n, pos += size) {
+            memcpy(charbuf + pos, data, size);
+        }
+        assert(n == 3  &&  pos == 15  &&  !data);
+        assert(memcmp(charbuf, "llo Heap! World", 15) == 0);
+        cursor = 0;
+        assert(!BUF_PeekChunk(0, &cursor, &data)  &&  !data);
+        assert(BUF_SpliceEx(&dst, buf, 0) == 0);
+        assert(BUF_SpliceEx(&dst, buf, 7) == 7);
+        assert(BUF_Size(buf) == 8  &&  BUF_Size(dst) == 7);
+        assert(BUF_SpliceEx(&dst, buf, 4) == 4);
+        assert(BUF_SpliceEx(&dst, buf, 100) == 4);
+        assert(!BUF_Size(buf)  &&  BUF_Size(dst) == 15);
+        assert(BUF_Read(dst, charbuf, sizeof(charbuf)) == 15);
+        assert(memcmp(charbuf, "llo Heap! World", 15) == 0);
+        BUF_Destroy(dst);
+        BUF_Destroy(buf);
+        buf = 0;
+    }}
+
     /* usage */
     fprintf(stderr, "Waiting for the data in STDIN...\n");
 
@@ -0,0 +1,584 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   CHttpAsyncSession test: bounded concurrency, deadlines, cancellation
+ *   (checked against a local HTTP/2 server), or many outstanding requests
+ *   to a URL
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbiapp.hpp>
+#include <connect/ncbi_http2_session.hpp>
+#include <connect/ncbi_socket.hpp>
+
+#include <nghttp2/nghttp2.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "test_assert.h"  // This header must go last
+
+
+USING_NCBI_SCOPE;
+
+
+/// Local HTTP/2 server (cleartext, with prior knowledge) for the checks.
+///
+/// Requests are "/?id=ID&delay=MS", responses (200) are sent after MS
+/// milliseconds and have ID as their body.
+class CTestServer
+{
+public:
+    enum { kMaxStreams = 100 };  ///< HTTP/2 streams allowed per connection
+
+    CTestServer();
+    ~CTestServer();
+
+    string GetUrl(size_t id, unsigned delay_ms = 0) const;
+
+    /// Max number of requests being served at a time so far
+    size_t GetMaxActive() const;
+
+    /// Wait (for up to 5 seconds) until the counter reaches the value
+    static bool WaitFor(const atomic_size_t& counter, size_t value);
+
+    atomic_size_t connections{0};  ///< Connections accepted
+    atomic_size_t requests{0};     ///< Requests received
+    atomic_size_t cancelled{0};    ///< HTTP/2 streams reset by the client
+
+private:
+    struct SRequest
+    {
+        unsigned delay_ms = 0;
+        string   body;
+    };
+
+    static SRequest Parse(const string& path);
+
+    void Run();
+    void Serve(CSocket& sock);
+    void Started();
+    void Finished();
+
+    CListeningSocket m_Listener;
+    atomic_bool      m_Stop{false};
+    mutable mutex    m_Mutex;
+    size_t           m_Active = 0;
+    size_t           m_MaxActive = 0;
+    thread           m_Thread;
+};
+
+
+// Server sockets are polled, so that they notice the server is stopping
+static const STimeout kPollTimeout = { 0, 10000 };
+
+
+CTestServer::CTestServer()
+{
+    _VERIFY(m_Listener.Listen(0) == eIO_Success);
+    m_Thread = thread(&CTestServer::Run, this);
+}
+
+CTestServer::~CTestServer()
+{
+    m_Stop = true;
+    m_Thread.join();
+}
+
+string CTestServer::GetUrl(size_t id, unsigned delay_ms) const
+{
+    return "http://127.0.0.1:" + NStr::NumericToString(m_Listener.GetPort(eNH_HostByteOrder)) +
+        "/?id=" + NStr::NumericToString(id) + "&delay=" + NStr::NumericToString(delay_ms);
+}
+
+size_t CTestServer::GetMaxActive() const
+{
+    lock_guard<mutex> lock(m_Mutex);
+    return m_MaxActive;
+}
+
+bool CTestServer::WaitFor(const atomic_size_t& counter, size_t value)
+{
+    for (CDeadline deadline(CTimeout(5.0)); counter < value; this_thread::sleep_for(chrono::milliseconds(1))) {
+        if (deadline.IsExpired()) return false;
+    }
+
+    return true;
+}
+
+CTestServer::SRequest CTestServer::Parse(const string& path)
+{
+    string ignored, query;
+    NStr::SplitInTwo(path, "?", ignored, query);
+    CUrlArgs args(query);
+
+    SRequest request;
+    request.delay_ms = NStr::StringToUInt(args.GetValue("delay"), NStr::fConvErr_NoThrow);
+    request.body = args.GetValue("id");
+    return request;
+}
+
+void CTestServer::Started()
+{
+    ++requests;
+    lock_guard<mutex> lock(m_Mutex);
+    m_MaxActive = max(m_MaxActive, ++m_Active);
+}
+
+void CTestServer::Finished()
+{
+    lock_guard<mutex> lock(m_Mutex);
+    --m_Active;
+}
+
+void CTestServer::Run()
+{
+    vector<thread> threads;
+
+    while (!m_Stop) {
+        CSocket* sock = nullptr;
+
+        if (m_Listener.Accept(sock, &kPollTimeout) != eIO_Success) {
+            continue;
+        }
+
+        ++connections;
+        threads.emplace_back([this, sock]() {
+            unique_ptr<CSocket> guard(sock);
+            sock->SetTimeout(eIO_Read, &kPollTimeout);
+            Serve(*sock);
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void CTestServer::Serve(CSocket& sock)
+{
+    struct SStream
+    {
+        SRequest request;
+        unique_ptr<CDeadline> due;  // Set once the request is received
+        bool active = false;
+        size_t sent = 0;
+    };
+
+    struct SContext
+    {
+        CTestServer* server;
+        map<int32_t, SStream> streams;
+    }
+    context{this, {}};
+
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+
+    nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks,
+            [](nghttp2_session*, const nghttp2_frame* frame, void* user_data) {
+                static_cast<SContext*>(user_data)->streams[frame->hd.stream_id];
+                return 0;
+            });
+
+    nghttp2_session_callbacks_set_on_header_callback(callbacks,
+            [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* name, size_t namelen,
+                    const uint8_t* value, size_t valuelen, uint8_t, void* user_data) {
+                if (string(reinterpret_cast<const char*>(name), namelen) == ":path") {
+                    auto& stream = static_cast<SContext*>(user_data)->streams[frame->hd.stream_id];
+                    stream.request = Parse(string(reinterpret_cast<const char*>(value), valuelen));
+                }
+
+                return 0;
+            });
+
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+            [](nghttp2_session*, const nghttp2_frame* frame, void* user_data) {
+                auto context = static_cast<SContext*>(user_data);
+                auto it = context->streams.find(frame->hd.stream_id);
+
+                if ((frame->hd.flags & NGHTTP2_FLAG_END_STREAM) && (it != context->streams.end())) {
+                    auto& stream = it->second;
+                    stream.due.reset(new CDeadline(CTimeout(stream.request.delay_ms / 1000.0)));
+                    stream.active = true;
+                    context->server->Started();
+                }
+
+                return 0;
+            });
+
+    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks,
+            [](nghttp2_session*, int32_t stream_id, uint32_t error_code, void* user_data) {
+                auto context = static_cast<SContext*>(user_data);
+                auto it = context->streams.find(stream_id);
+
+                if (it != context->streams.end()) {
+                    if (it->second.active) {
+                        context->server->Finished();
+                    }
+
+                    if (error_code == NGHTTP2_CANCEL) {
+                        ++context->server->cancelled;
+                    }
+
+                    context->streams.erase(it);
+                }
+
+                return 0;
+            });
+
+    nghttp2_session* session;
+    _VERIFY(!nghttp2_session_server_new(&session, callbacks, &context));
+    nghttp2_session_callbacks_del(callbacks);
+
+    nghttp2_settings_entry settings[] = { { NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, kMaxStreams } };
+    _VERIFY(!nghttp2_submit_settings(session, NGHTTP2_FLAG_NONE, settings, 1));
+
+    nghttp2_data_provider data_prd;
+    data_prd.read_callback = [](nghttp2_session*, int32_t, uint8_t* buf, size_t length,
+            uint32_t* data_flags, nghttp2_data_source* source, void*) -> ssize_t {
+        auto& stream = *static_cast<SStream*>(source->ptr);
+        auto& body = stream.request.body;
+        auto n = min(length, body.size() - stream.sent);
+        memcpy(buf, body.data() + stream.sent, n);
+        stream.sent += n;
+
+        if (stream.sent == body.size()) {
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+        }
+
+        return n;
+    };
+
+    auto nv = [](const string& name, const string& value) {
+        nghttp2_nv rv;
+        rv.name = (uint8_t*)name.data();
+        rv.namelen = name.size();
+        rv.value = (uint8_t*)value.data();
+        rv.valuelen = value.size();
+        rv.flags = NGHTTP2_NV_FLAG_NONE;
+        return rv;
+    };
+
+    const string status_name(":status"), status("200"), length_name("content-length");
+    char buf[16384];
+
+    while (!m_Stop) {
+        // Respond to the requests that have been delayed enough
+        for (auto& s : context.streams) {
+            auto& stream = s.second;
+
+            if (stream.active && stream.due->IsExpired()) {
+                // Not active any more once the client can get the response
+                stream.active = false;
+                Finished();
+
+                const string length(NStr::NumericToString(stream.request.body.size()));
+                nghttp2_nv nva[] = { nv(status_name, status), nv(length_name, length) };
+                data_prd.source.ptr = &stream;
+                _VERIFY(!nghttp2_submit_response(session, s.first, nva, 2, &data_prd));
+            }
+        }
+
+        const uint8_t* data;
+        ssize_t n;
+        bool ok = true;
+
+        while (ok && ((n = nghttp2_session_mem_send(session, &data)) > 0)) {
+            ok = sock.Write(data, n) == eIO_Success;
+        }
+
+        if (!ok || (n < 0) || (!nghttp2_session_want_read(session) && !nghttp2_session_want_write(session))) {
+            break;
+        }
+
+        size_t n_read = 0;
+        auto read_status = sock.Read(buf, sizeof(buf), &n_read);
+
+        if (n_read && (nghttp2_session_mem_recv(session, reinterpret_cast<const uint8_t*>(buf), n_read) < 0)) {
+            break;
+        }
+
+        if ((read_status != eIO_Success) && (read_status != eIO_Timeout)) {
+            break;
+        }
+    }
+
+    nghttp2_session_del(session);
+}
+
+
+class CNCBITestHttpAsyncApp : public CNcbiApplication
+{
+    void Init(void);
+    int  Run (void);
+
+    int  RunLoad(const CArgs& args);
+
+    void TestConcurrency();
+    void TestDeadline();
+    void TestDestruction();
+    void TestStreams();
+};
+
+
+void CNCBITestHttpAsyncApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CHttpAsyncSession test");
+
+    arg_desc->AddOptionalKey("url", "URL",
+                             "URL to send requests to "
+                             "(instead of the checks against a local server)",
+                             CArgDescriptions::eString);
+
+    arg_desc->AddDefaultKey("requests", "N",
+                            "Number of requests to submit at once (for -url)",
+                            CArgDescriptions::eInteger, "1000");
+    arg_desc->SetConstraint("requests", new CArgAllow_Integers(1, kMax_Int));
+
+    arg_desc->AddDefaultKey("active", "N",
+                            "Max number of requests executed at a time (for -url)",
+                            CArgDescriptions::eInteger, "1000");
+    arg_desc->SetConstraint("active", new CArgAllow_Integers(1, kMax_Int));
+
+    arg_desc->AddOptionalKey("deadline", "SECONDS",
+                             "Deadline for each request (for -url)",
+                             CArgDescriptions::eDouble);
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+int CNCBITestHttpAsyncApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    if (args["url"].HasValue()) {
+        return RunLoad(args);
+    }
+
+    TestConcurrency();
+    TestDeadline();
+    TestDestruction();
+    TestStreams();
+
+    NcbiCout << "All checks passed" << NcbiEndl;
+    return 0;
+}
+
+
+// No more than the max number of requests are served at a time
+void CNCBITestHttpAsyncApp::TestConcurrency()
+{
+    const size_t kRequests = 40;
+    const size_t kMaxActive = 4;
+
+    CTestServer server;
+    vector<future<SHttpAsyncResponse>> responses;
+
+    {
+        CHttpAsyncSession session(kMaxActive);
+
+        for (size_t i = 0; i < kRequests; ++i) {
+            responses.emplace_back(session.Execute(SHttpAsyncRequest(CUrl(server.GetUrl(i, 20)))));
+        }
+
+        session.WaitAll();
+        _ASSERT(!session.GetPendingCount());
+    }
+
+    for (size_t i = 0; i < kRequests; ++i) {
+        auto response = responses[i].get();
+        _ASSERT(response.status == SHttpAsyncResponse::eSuccess);
+        _ASSERT(response.status_code == 200);
+        _ASSERT(response.body == NStr::NumericToString(i));
+    }
+
+    _ASSERT(server.requests == kRequests);
+    _ASSERT(server.GetMaxActive() <= kMaxActive);
+    _ASSERT(server.GetMaxActive() > 1);
+
+    NcbiCout << "Concurrency: " << kRequests << " requests, "
+             << server.GetMaxActive() << " (max " << kMaxActive << ") at a time" << NcbiEndl;
+}
+
+
+// Requests time out, whether running or waiting in the queue
+void CNCBITestHttpAsyncApp::TestDeadline()
+{
+    CTestServer server;
+    CHttpAsyncSession session(1);
+
+    // The slow request occupies the only slot, so the other one expires in the queue
+    SHttpAsyncRequest slow(CUrl(server.GetUrl(1, 5000)));
+    slow.deadline = CTimeout(0.3);
+    SHttpAsyncRequest queued(CUrl(server.GetUrl(2)));
+    queued.deadline = CTimeout(0.1);
+
+    CStopWatch sw(CStopWatch::eStart);
+    auto slow_future = session.Execute(slow);
+    auto queued_future = session.Execute(queued);
+    auto slow_response = slow_future.get();
+    double elapsed = sw.Elapsed();
+    auto queued_response = queued_future.get();
+
+    _ASSERT(slow_response.status == SHttpAsyncResponse::eTimedOut);
+    _ASSERT(elapsed >= 0.3);
+    _ASSERT(elapsed < 2.0);
+    _ASSERT(queued_response.status == SHttpAsyncResponse::eTimedOut);
+    _ASSERT(server.requests == 1);
+
+    // The stream is reset, so the server could stop working on it
+    _ASSERT(CTestServer::WaitFor(server.cancelled, 1));
+
+    NcbiCout << "Deadline: timed out in " << NStr::DoubleToString(elapsed, 3) << " s" << NcbiEndl;
+}
+
+
+// Requests not complete yet are cancelled once the session is destroyed
+void CNCBITestHttpAsyncApp::TestDestruction()
+{
+    const size_t kRequests = 3;
+
+    CTestServer server;
+    vector<future<SHttpAsyncResponse>> responses;
+    CStopWatch sw(CStopWatch::eStart);
+
+    {
+        CHttpAsyncSession session(kRequests);
+
+        for (size_t i = 0; i < kRequests; ++i) {
+            responses.emplace_back(session.Execute(SHttpAsyncRequest(CUrl(server.GetUrl(i, 5000)))));
+        }
+
+        _ASSERT(CTestServer::WaitFor(server.requests, kRequests));
+    }
+
+    double elapsed = sw.Elapsed();
+
+    for (auto& response : responses) {
+        _ASSERT(response.get().status == SHttpAsyncResponse::eCancelled);
+    }
+
+    _ASSERT(elapsed < 2.0);
+    _ASSERT(CTestServer::WaitFor(server.cancelled, kRequests));
+
+    NcbiCout << "Destruction: done in " << NStr::DoubleToString(elapsed, 3) << " s" << NcbiEndl;
+}
+
+
+// Streams are forgotten once complete, so the connection does not look full
+void CNCBITestHttpAsyncApp::TestStreams()
+{
+    const size_t kRequests = CTestServer::kMaxStreams * 3;
+
+    CTestServer server;
+    CHttpAsyncSession session(10);
+    atomic_size_t ok_count(0);
+
+    for (size_t i = 0; i < kRequests; ++i) {
+        session.Execute(SHttpAsyncRequest(CUrl(server.GetUrl(i))), [&, i](SHttpAsyncResponse response) {
+            if ((response.status == SHttpAsyncResponse::eSuccess) && (response.body == NStr::NumericToString(i))) {
+                ++ok_count;
+            }
+        });
+    }
+
+    session.WaitAll();
+
+    _ASSERT(ok_count == kRequests);
+    _ASSERT(server.requests == kRequests);
+    _ASSERT(server.connections == 1);
+
+    NcbiCout << "Streams: " << kRequests << " requests over "
+             << server.connections << " connection(s)" << NcbiEndl;
+}
+
+
+// Many requests to the URL at once
+int CNCBITestHttpAsyncApp::RunLoad(const CArgs& args)
+{
+    const size_t request_count = args["requests"].AsInteger();
+    const size_t max_active = args["active"].AsInteger();
+
+    SHttpAsyncRequest request(CUrl(args["url"].AsString()));
+
+    if (args["deadline"].HasValue()) {
+        request.deadline = CTimeout(args["deadline"].AsDouble());
+    }
+
+    CHttpAsyncSession session(max_active);
+
+    // Check the future based interface first
+    auto first = session.Execute(request).get();
+    NcbiCout << request.url.ComposeUrl(CUrlArgs::eAmp_Char) << ": " << first.status_code
+             << (first.error.empty() ? "" : " (") << first.error
+             << (first.error.empty() ? "" : ")") << NcbiEndl;
+
+    atomic_size_t status_counts[SHttpAsyncResponse::eCancelled + 1] = {};
+    atomic_size_t ok_count(0);
+    CStopWatch sw(CStopWatch::eStart);
+
+    for (size_t i = 0; i < request_count; ++i) {
+        session.Execute(request, [&](SHttpAsyncResponse response) {
+            ++status_counts[response.status];
+
+            if ((response.status == SHttpAsyncResponse::eSuccess) &&
+                    (response.status_code == first.status_code) && (response.body == first.body)) {
+                ++ok_count;
+            }
+        });
+    }
+
+    session.WaitAll();
+    _ASSERT(!session.GetPendingCount());
+    double elapsed = sw.Elapsed();
+
+    NcbiCout << request_count << " requests (max " << max_active << " at a time) in "
+             << NStr::DoubleToString(elapsed, 3) << " s, "
+             << NStr::DoubleToString(request_count / elapsed, 0) << " requests/s: "
+             << status_counts[SHttpAsyncResponse::eSuccess]   << " succeeded ("
+             << ok_count << " as the first one), "
+             << status_counts[SHttpAsyncResponse::eFailed]    << " failed, "
+             << status_counts[SHttpAsyncResponse::eTimedOut]  << " timed out" << NcbiEndl;
+
+    return ok_count == request_count ? 0 : 1;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CNCBITestHttpAsyncApp().AppMain(argc, argv);
+}
@@ -0,0 +1,288 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   CHttpSession benchmark: requests per second with and without
+ *   keep-alive connection reuse
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbithr.hpp>
+#include <connect/ncbi_http_session.hpp>
+#include <connect/ncbi_util.h>
+#include <connect/server.hpp>
+#include <atomic>
+
+#include "test_assert.h"  // This header must go last
+
+
+BEGIN_NCBI_SCOPE
+
+
+/// CReuseServer --
+///
+/// CServer that counts accepted connections and stops on request.
+
+class CReuseServer : public CServer
+{
+public:
+    CReuseServer(void)
+        : m_Opened(0), m_ShutdownRequested(false)
+    {
+    }
+
+    virtual bool ShutdownRequested(void) { return m_ShutdownRequested; }
+    void RequestShutdown(void) { m_ShutdownRequested = true; }
+
+    void RegisterOpen(void) { ++m_Opened; }
+    unsigned GetOpenedCount(void) const { return m_Opened; }
+
+private:
+    atomic<unsigned> m_Opened;
+    atomic<bool>     m_ShutdownRequested;
+};
+
+
+/// CReuseConnectionHandler --
+///
+/// Minimal HTTP/1.x server: answers each request header (which ends with
+/// an empty line) with a small keep-alive response.
+
+class CReuseConnectionHandler : public IServer_LineMessageHandler
+{
+public:
+    CReuseConnectionHandler(CReuseServer* server)
+        : m_Server(server)
+    {
+    }
+
+    virtual void OnOpen(void) { m_Server->RegisterOpen(); }
+    virtual void OnMessage(BUF buf)
+    {
+        bool end_of_header = BUF_Size(buf) == 0;
+        BUF_Erase(buf);
+        if ( end_of_header ) {
+            static const char kResponse[] =
+                "HTTP/1.1 200 OK\r\n"
+                "Connection: keep-alive\r\n"
+                "Content-Type: text/plain\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "OK\n";
+            GetSocket().Write(kResponse, sizeof(kResponse) - 1);
+        }
+    }
+    virtual void OnWrite(void) { }
+
+private:
+    CReuseServer* m_Server;
+};
+
+
+class CReuseConnectionFactory : public IServer_ConnectionFactory
+{
+public:
+    CReuseConnectionFactory(CReuseServer* server)
+        : m_Server(server)
+    {
+    }
+
+    IServer_ConnectionHandler* Create(void)
+    {
+        return new CReuseConnectionHandler(m_Server);
+    }
+
+private:
+    CReuseServer* m_Server;
+};
+
+
+class CReuseServerThread : public CThread
+{
+public:
+    CReuseServerThread(CReuseServer& server)
+        : m_Server(server)
+    {
+    }
+
+protected:
+    virtual void* Main(void)
+    {
+        m_Server.Run();
+        return 0;
+    }
+
+private:
+    CReuseServer& m_Server;
+};
+
+
+/// CHttpSessionReuseApp --
+///
+/// Start a local HTTP server and time a series of GET requests sent through
+/// CHttpSession with the keep-alive connection pool disabled, and enabled.
+
+class CHttpSessionReuseApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run (void);
+    virtual void Exit(void);
+
+private:
+    bool x_RunOne(CReuseServer& server, const string& url,
+                  bool reuse, unsigned request_count);
+
+    CHttpSession::EProtocol m_Protocol;
+};
+
+
+void CHttpSessionReuseApp::Init(void)
+{
+    CORE_SetLOCK(MT_LOCK_cxx2c());
+    CORE_SetLOG(LOG_cxx2c());
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CHttpSession connection reuse benchmark");
+
+    arg_desc->AddDefaultKey("http", "VERSION",
+                            "HTTP protocol version",
+                            CArgDescriptions::eString, "1.1");
+    arg_desc->SetConstraint("http", &(*new CArgAllow_Strings, "1.0", "1.1"));
+
+    arg_desc->AddDefaultKey("requests", "N",
+                            "Number of requests to time for each run",
+                            CArgDescriptions::eInteger, "5000");
+    arg_desc->SetConstraint("requests", new CArgAllow_Integers(1, kMax_Int));
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CHttpSessionReuseApp::Exit(void)
+{
+    CORE_SetLOG(0);
+    CORE_SetLOCK(0);
+}
+
+
+bool CHttpSessionReuseApp::x_RunOne(CReuseServer& server, const string& url,
+                                    bool reuse, unsigned request_count)
+{
+    CRef<CHttpSession> session(new CHttpSession);
+    session->SetProtocol(m_Protocol);
+    if ( !reuse ) {
+        session->SetConnectionPool(0, 0, CTimeout(0.0));
+    }
+
+    unsigned opened = server.GetOpenedCount();
+    CStopWatch sw(CStopWatch::eStart);
+    for (unsigned i = 0;  i < request_count;  ++i) {
+        CHttpResponse response = session->Get(url);
+        string body;
+        if (response.GetStatusCode() == 200) {
+            NcbiStreamToString(&body, response.ContentStream());
+        }
+        if (body != "OK\n") {
+            ERR_POST("Request #" << i + 1 << " failed: "
+                     << response.GetStatusCode() << ' '
+                     << response.GetStatusText());
+            return false;
+        }
+    }
+    double elapsed = sw.Elapsed();
+    session->ClearConnectionPool();
+    opened = server.GetOpenedCount() - opened;
+
+    NcbiCout << (reuse ? "   with reuse: " : "without reuse: ")
+             << request_count << " requests in "
+             << NStr::DoubleToString(elapsed, 3) << " s, "
+             << NStr::DoubleToString(request_count / elapsed, 0)
+             << " requests/s, " << opened << " connection(s)" << NcbiEndl;
+    return true;
+}
+
+
+static const STimeout kShutdownCheckTimeout = { 0, 100000 };
+
+
+int CHttpSessionReuseApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    m_Protocol = args["http"].AsString() == "1.0"
+        ? CHttpSession::eHTTP_10 : CHttpSession::eHTTP_11;
+    unsigned request_count = args["requests"].AsInteger();
+
+    unsigned short port = 0;
+    {{
+        // Find a free port
+        CListeningSocket listener;
+        if (listener.Listen(0, 5, fSOCK_BindLocal | fSOCK_LogOff)
+            != eIO_Success) {
+            ERR_POST("Unable to find a free port to listen on");
+            return 1;
+        }
+        port = listener.GetPort(eNH_HostByteOrder);
+    }}
+
+    SServer_Parameters params;
+    params.accept_timeout = &kShutdownCheckTimeout;
+    params.init_threads = 2;
+    params.max_threads = 4;
+
+    CReuseServer server;
+    server.SetParameters(params);
+    server.AddListener(new CReuseConnectionFactory(&server), port);
+    server.StartListening();
+    CRef<CReuseServerThread> thread(new CReuseServerThread(server));
+    thread->Run();
+
+    string url = "http://127.0.0.1:" + NStr::UIntToString(port) + "/";
+    NcbiCout << "HTTP/" << args["http"].AsString() << ", " << url << NcbiEndl;
+    bool ok = x_RunOne(server, url, false, request_count)
+        &&    x_RunOne(server, url, true,  request_count);
+
+    server.RequestShutdown();
+    thread->Join();
+    return ok ? 0 : 1;
+}
+
+
+END_NCBI_SCOPE
+
+
+USING_NCBI_SCOPE;
+
+
+int main(int argc, const char* argv[])
+{
+    return CHttpSessionReuseApp().AppMain(argc, argv);
+}
@@ -0,0 +1,245 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   POLLSET stress test: connections are armed, removed and closed by
+ *   worker threads while another thread keeps waiting on the poll set
+ *   (the way CServer uses it)
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <connect/ncbi_core_cxx.hpp>
+#include <connect/ncbi_socket.hpp>
+#include <connect/ncbi_util.h>
+#include <atomic>
+#include <thread>
+
+#include "test_assert.h"  // This header must go last
+
+
+BEGIN_NCBI_SCOPE
+
+
+static const STimeout kPollTimeout = { 0, 1000 };
+static const STimeout kIoTimeout   = { 10, 0 };
+
+// Triggers per connection, to keep the ready list of the poll set busy
+static const size_t kTriggers = 8;
+
+
+class CPollSetTestApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run (void);
+    virtual void Exit(void);
+
+private:
+    void x_Poll  (POLLSET pollset, unsigned threads);
+    void x_Worker(POLLSET pollset, unsigned id, unsigned iterations);
+
+    atomic<bool>   m_Stop{false};
+    atomic<size_t> m_Events{0};
+    atomic<size_t> m_Failures{0};
+};
+
+
+void CPollSetTestApp::Init(void)
+{
+    CORE_SetLOCK(MT_LOCK_cxx2c());
+    CORE_SetLOG(LOG_cxx2c());
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "POLLSET multithreaded stress test");
+
+    arg_desc->AddDefaultKey("threads", "N",
+                            "Number of worker threads",
+                            CArgDescriptions::eInteger, "8");
+    arg_desc->SetConstraint("threads", new CArgAllow_Integers(1, 100));
+
+    arg_desc->AddDefaultKey("iterations", "N",
+                            "Connections to open and close by each worker",
+                            CArgDescriptions::eInteger, "500");
+    arg_desc->SetConstraint("iterations", new CArgAllow_Integers(1, kMax_Int));
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CPollSetTestApp::Exit(void)
+{
+    CORE_SetLOG(0);
+    CORE_SetLOCK(0);
+}
+
+
+// The only waiting thread, as the poll cycle of CServer
+void CPollSetTestApp::x_Poll(POLLSET pollset, unsigned threads)
+{
+    vector<SPOLLSET_Event> events(64);
+
+    while (!m_Stop) {
+        size_t count = 0;
+        EIO_Status status = POLLSET_Wait(pollset, &events[0], events.size(),
+                                         &kPollTimeout, &count);
+        if (status != eIO_Success  &&  status != eIO_Timeout) {
+            ERR_POST("POLLSET_Wait failed: " << IO_StatusStr(status));
+            ++m_Failures;
+            continue;
+        }
+        for (size_t i = 0;  i < count;  ++i) {
+            // Events can still come for handles being removed,
+            // but only with the data they have been armed with
+            uintptr_t id = reinterpret_cast<uintptr_t>(events[i].data);
+            if (id < 1  ||  id > threads  ||  events[i].revent == eIO_Open) {
+                ERR_POST("Bad event #" << i << " of " << count);
+                ++m_Failures;
+            }
+        }
+        m_Events += count;
+    }
+}
+
+
+// Each iteration arms a connection with data to read, a connection ready
+// for writing, and triggers that are set (so they go to the ready list
+// right away), then removes and closes all of them
+void CPollSetTestApp::x_Worker(POLLSET pollset, unsigned id, unsigned iterations)
+{
+    void* data = reinterpret_cast<void*>(uintptr_t(id));
+
+    CListeningSocket listener;
+    if (listener.Listen(0, 16, fSOCK_BindLocal | fSOCK_LogOff) != eIO_Success) {
+        ERR_POST("Worker " << id << " cannot listen");
+        ++m_Failures;
+        return;
+    }
+    unsigned short port = listener.GetPort(eNH_HostByteOrder);
+
+    for (unsigned n = 0;  n < iterations;  ++n) {
+        CSocket  client("127.0.0.1", port, &kIoTimeout, fSOCK_LogOff);
+        CSocket  server;
+        CTrigger triggers[kTriggers];
+
+        if (client.GetStatus(eIO_Open) != eIO_Success
+            ||  listener.Accept(server, &kIoTimeout) != eIO_Success
+            ||  client.Write("x", 1) != eIO_Success) {
+            ERR_POST("Worker " << id << " failed to set up connection #" << n);
+            ++m_Failures;
+            return;
+        }
+
+        vector<POLLABLE>  polls;
+        vector<EIO_Event> events;
+        polls.push_back(POLLABLE_FromSOCK(server.GetSOCK()));
+        events.push_back(eIO_Read);
+        polls.push_back(POLLABLE_FromSOCK(client.GetSOCK()));
+        events.push_back(eIO_Write);
+        for (auto& trigger : triggers) {
+            _VERIFY(trigger.Set() == eIO_Success);
+            polls.push_back(POLLABLE_FromTRIGGER(trigger.GetTRIGGER()));
+            events.push_back(eIO_Read);
+        }
+
+        for (size_t i = 0;  i < polls.size();  ++i) {
+            if (POLLSET_Arm(pollset, polls[i], events[i], data) != eIO_Success) {
+                ERR_POST("Worker " << id << " failed to arm handle " << i);
+                ++m_Failures;
+            }
+        }
+        // Give the poll thread a chance to report some of them
+        if (n % 2)
+            this_thread::yield();
+        for (size_t i = 0;  i < polls.size();  ++i) {
+            if (POLLSET_Remove(pollset, polls[i]) != eIO_Success) {
+                ERR_POST("Worker " << id << " failed to remove handle " << i);
+                ++m_Failures;
+            }
+        }
+        // The sockets and the triggers get closed here
+    }
+}
+
+
+int CPollSetTestApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    unsigned threads    = args["threads"].AsInteger();
+    unsigned iterations = args["iterations"].AsInteger();
+
+    POLLSET pollset;
+    EIO_Status status = POLLSET_Create(&pollset);
+    if (status == eIO_NotSupported) {
+        NcbiCout << "Poll set is not supported on this platform, skipped"
+                 << NcbiEndl;
+        return 0;
+    }
+    _ASSERT(status == eIO_Success);
+
+    thread poller(&CPollSetTestApp::x_Poll, this, pollset, threads);
+    vector<thread> workers;
+    for (unsigned i = 1;  i <= threads;  ++i) {
+        workers.emplace_back(&CPollSetTestApp::x_Worker, this,
+                             pollset, i, iterations);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    m_Stop = true;
+    poller.join();
+
+    // Nothing is left in the set
+    SPOLLSET_Event event;
+    size_t count = 0;
+    static const STimeout kZeroTimeout = { 0, 0 };
+    status = POLLSET_Wait(pollset, &event, 1, &kZeroTimeout, &count);
+    POLLSET_Close(pollset);
+
+    NcbiCout << threads << " workers closed " << threads * iterations
+             << " connections while polling, "
+             << m_Events << " events reported" << NcbiEndl;
+
+    _ASSERT(status == eIO_Timeout  &&  !count);
+    _ASSERT(!m_Failures);
+    return 0;
+}
+
+
+END_NCBI_SCOPE
+
+
+USING_NCBI_SCOPE;
+
+
+int main(int argc, const char* argv[])
+{
+    return CPollSetTestApp().AppMain(argc, argv);
+}
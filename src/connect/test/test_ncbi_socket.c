@@ -38,6 +38,7 @@
 #include <stdlib.h>
 #include <string.h>
 #if defined(NCBI_OS_UNIX)
+#  include <fcntl.h>
 #  include <unistd.h>
 #  define X_SLEEP(x)  /*((void) sleep(x))*/
 #elif defined(NCBI_OS_MSWIN)
@@ -126,6 +127,77 @@ static void TEST__client_1(SOCK sock)
         free(blob);
     }}
 
+    /* Send a very big binary blob scattered in pieces of various sizes
+     * (some empty), all in a single call */
+    {{
+        unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
+        SSOCK_IOVec    iov[2 * N_SUB_BLOB];
+        size_t         pos = 0;
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n)
+            blob[n] = (unsigned char)(n * 7);
+        for (n = 0;  n < 2 * N_SUB_BLOB;  ++n) {
+            size_t size = n & 1 ? (n % 3) * 1000 : SUB_BLOB_SIZE - 3000;
+            if (n == 2 * N_SUB_BLOB - 1)
+                size = BIG_BLOB_SIZE - pos;
+            iov[n].data = blob + pos;
+            iov[n].size = size;
+            pos += size;
+        }
+        assert(pos == BIG_BLOB_SIZE);
+        status = SOCK_WriteV(sock, iov, 2 * N_SUB_BLOB, &n_io_done,
+                             eIO_WritePersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+        free(blob);
+    }}
+
+#ifdef NCBI_OS_UNIX
+    /* Send a very big binary blob from the middle of a file */
+    {{
+        unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
+        FILE*          fp   = tmpfile();
+        assert(fp);
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n)
+            blob[n] = (unsigned char)(n ^ 0x5A);
+        verify(fwrite(blob, 1, SUB_BLOB_SIZE, fp) == SUB_BLOB_SIZE);
+        verify(fwrite(blob, 1, BIG_BLOB_SIZE, fp) == BIG_BLOB_SIZE);
+        verify(fflush(fp) == 0);
+        status = SOCK_SendFile(sock, fileno(fp), SUB_BLOB_SIZE, BIG_BLOB_SIZE,
+                               &n_io_done);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+        fclose(fp);
+        free(blob);
+    }}
+#endif /*NCBI_OS_UNIX*/
+
+#ifdef NCBI_OS_LINUX
+    /* Send a file that the kernel cannot send directly (so its contents get
+     * read into a buffer first), preceded by a copy to compare with */
+    {{
+        char* data = 0;
+        int   fd   = open("/proc/self/environ", O_RDONLY);
+        assert(fd >= 0);
+        n = 0;
+        do {
+            ssize_t x_read;
+            verify((data = (char*) realloc(data, n + TEST_BUFSIZE)) != 0);
+            x_read = pread(fd, data + n, TEST_BUFSIZE, (off_t) n);
+            assert(x_read >= 0);
+            if (!x_read)
+                break;
+            n += (size_t) x_read;
+        } while (n < 10 * TEST_BUFSIZE);
+        sprintf(buf, "%10lu", (unsigned long) n);
+        status = SOCK_Write(sock, buf, 10, &n_io_done, eIO_WritePersist);
+        assert(status == eIO_Success  &&  n_io_done == 10);
+        status = SOCK_Write(sock, data, n, &n_io_done, eIO_WritePersist);
+        assert(status == eIO_Success  &&  n_io_done == n);
+        status = SOCK_SendFile(sock, fd, 0, n, &n_io_done);
+        assert(status == eIO_Success  &&  n_io_done == n);
+        close(fd);
+        free(data);
+    }}
+#endif /*NCBI_OS_LINUX*/
+
     /* Send a very big binary blob with read on write */
     /* (it must be bounced by the server) */
     {{
@@ -236,6 +308,46 @@ static void TEST__server_1(SOCK sock)
         free(blob);
     }}
 
+    /* Receive a very big binary blob sent scattered */
+    {{
+        unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
+        status = SOCK_Read(sock,blob,BIG_BLOB_SIZE,&n_io_done,eIO_ReadPersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n)
+            assert(blob[n] == (unsigned char)(n * 7));
+        free(blob);
+    }}
+
+#ifdef NCBI_OS_UNIX
+    /* Receive a very big binary blob sent from a file */
+    {{
+        unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
+        status = SOCK_Read(sock,blob,BIG_BLOB_SIZE,&n_io_done,eIO_ReadPersist);
+        assert(status == eIO_Success  &&  n_io_done == BIG_BLOB_SIZE);
+        for (n = 0;  n < BIG_BLOB_SIZE;  ++n)
+            assert(blob[n] == (unsigned char)(n ^ 0x5A));
+        free(blob);
+    }}
+#endif /*NCBI_OS_UNIX*/
+
+#ifdef NCBI_OS_LINUX
+    /* Receive file contents twice (as read and as sent from the file) */
+    {{
+        unsigned long size;
+        char*         data;
+        status = SOCK_Read(sock, buf, 10, &n_io_done, eIO_ReadPersist);
+        assert(status == eIO_Success  &&  n_io_done == 10);
+        buf[10] = '\0';
+        verify(sscanf(buf, "%lu", &size) == 1);
+        data = (char*) malloc(2 * size + 1);
+        assert(data);
+        status = SOCK_Read(sock, data, 2 * size, &n_io_done, eIO_ReadPersist);
+        assert(status == eIO_Success  &&  n_io_done == 2 * size);
+        assert(memcmp(data, data + size, size) == 0);
+        free(data);
+    }}
+#endif /*NCBI_OS_LINUX*/
+
     /* Receive a very big binary blob, and write data back */
     {{
         unsigned char* blob = (unsigned char*) malloc(BIG_BLOB_SIZE);
@@ -883,6 +995,70 @@ static void TEST_SOCK_isip(void)
 }
 
 
+#ifdef NCBI_OS_UNIX
+/* The size of the data blocks read from the system into the socket's read
+ * buffer (and thus of the buffer chunks) -- see "ncbi_socket.c" */
+#define SOCK_READ_CHUNK  16384
+
+static void TEST_StripToPattern(void)
+{
+    LSOCK       lsock;
+    SOCK        server, client;
+    BUF         discard = 0;
+    char*       blob = (char*) malloc(SOCK_READ_CHUNK + 4);
+    char        buf[SOCK_READ_CHUNK + 4];
+    size_t      n;
+    STimeout    zero = { 0, 0 };
+    const char* unique = tmpnam(0);
+    CORE_LOGF(eLOG_Note, ("SOCK_StripToPattern(\"%s\")", unique));
+    verify(LSOCK_CreateUNIX(unique, 64, &lsock, fSOCK_LogDefault)
+           == eIO_Success);
+    verify(SOCK_CreateUNIX(unique, 0, &client, 0, 0, fSOCK_LogDefault)
+           == eIO_Success);
+    verify(LSOCK_Accept(lsock, 0, &server)
+           == eIO_Success);
+    /* all data get written ahead of reading */
+    verify(SOCK_SetTimeout(server, eIO_Read, &zero)
+           == eIO_Success);
+
+    /* make the pattern span over two chunks of the server's read buffer */
+    memset(blob, 'a', SOCK_READ_CHUNK - 1);
+    memcpy(blob + SOCK_READ_CHUNK - 1, "\r\nxyz", 5);
+    verify(SOCK_Write(client, blob, SOCK_READ_CHUNK, &n, eIO_WritePersist)
+           == eIO_Success);
+    verify(SOCK_Read(server, 0, SOCK_READ_CHUNK, &n, eIO_ReadPeek)
+           == eIO_Success  &&  n == SOCK_READ_CHUNK);
+    verify(SOCK_Write(client, blob + SOCK_READ_CHUNK, 4, &n, eIO_WritePersist)
+           == eIO_Success);
+    verify(SOCK_Read(server, 0, SOCK_READ_CHUNK + 4, &n, eIO_ReadPeek)
+           == eIO_Success  &&  n == SOCK_READ_CHUNK + 4);
+
+    verify(SOCK_StripToPattern(server, "\r\n", 2, &discard, &n)
+           == eIO_Success);
+    assert(n == SOCK_READ_CHUNK + 1  &&  BUF_Size(discard) == n);
+    verify(BUF_Read(discard, buf, sizeof(buf)) == n);
+    assert(memcmp(buf, blob, n) == 0);
+    verify(SOCK_Read(server, buf, 3, &n, eIO_ReadPersist) == eIO_Success);
+    assert(n == 3  &&  memcmp(buf, "xyz", 3) == 0);
+
+    /* a pattern that never comes:  all the rest gets stripped */
+    verify(SOCK_Write(client, "\r\r\n\r", 4, &n, eIO_WritePersist)
+           == eIO_Success);
+    verify(SOCK_Shutdown(client, eIO_Write) == eIO_Success);
+    verify(SOCK_StripToPattern(server, "\n\n", 2, &discard, &n)
+           == eIO_Closed);
+    assert(n == 4  &&  BUF_Size(discard) == 4);
+
+    BUF_Destroy(discard);
+    free(blob);
+    verify(SOCK_Destroy(client) == eIO_Success);
+    verify(SOCK_Destroy(server) == eIO_Success);
+    verify(LSOCK_Close(lsock) == eIO_Success);
+    remove(unique);
+}
+#endif /*NCBI_OS_UNIX*/
+
+
 #ifdef NCBI_OS_LINUX
 static void TEST_OnTopSock(void)
 {
@@ -954,6 +1130,10 @@ extern int main(int argc, const char* argv[])
 
         TEST_SOCK_isip();
 
+#ifdef NCBI_OS_UNIX
+        TEST_StripToPattern();
+#endif/*NCBI_OS_UNIX*/
+
 #ifdef NCBI_OS_LINUX
         TEST_OnTopSock();
 #endif/*NCBI_OS_LINUX*/
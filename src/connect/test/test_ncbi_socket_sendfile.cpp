@@ -0,0 +1,301 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Test of CSocket::WriteV/SendFile and CConn_SocketStream::WriteV/SendFile
+ *   over a local connection
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <connect/ncbi_conn_stream.hpp>
+#include <connect/ncbi_core_cxx.hpp>
+#include <connect/ncbi_socket.hpp>
+#include <connect/ncbi_util.h>
+
+#include "test_assert.h"  // This header must go last
+
+
+BEGIN_NCBI_SCOPE
+
+
+static string s_Pattern(size_t size, unsigned int seed)
+{
+    string data(size, '\0');
+    for (size_t n = 0;  n < size;  ++n)
+        data[n] = char((n * seed) ^ (n >> 8));
+    return data;
+}
+
+
+/// CReadThread --
+///
+/// Read the expected amount of data from a socket (so that the writer does
+/// not get stuck on a full socket buffer).
+
+class CReadThread : public CThread
+{
+public:
+    CReadThread(CSocket& sock, size_t size)
+        : m_Sock(sock), m_Size(size)
+    {
+    }
+
+    const string& GetData(void) const { return m_Data; }
+
+protected:
+    virtual void* Main(void)
+    {
+        size_t n_read;
+        m_Data.resize(m_Size);
+        m_Sock.Read(&m_Data[0], m_Size, &n_read, eIO_ReadPersist);
+        m_Data.resize(n_read);
+        return 0;
+    }
+
+private:
+    CSocket& m_Sock;
+    size_t   m_Size;
+    string   m_Data;
+};
+
+
+class CTestApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run (void);
+    virtual void Exit(void);
+
+private:
+    void x_Connect(CSocket& client, CSocket& server);
+
+    void x_TestSocket(void);
+    void x_TestStream(void);
+    void x_TestStreamTimeout(void);
+
+    CListeningSocket m_Listener;
+    string           m_FileName;
+    string           m_FileData;
+};
+
+
+void CTestApp::Init(void)
+{
+    CORE_SetLOCK(MT_LOCK_cxx2c());
+    CORE_SetLOG(LOG_cxx2c());
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CSocket and CConn_SocketStream"
+                              " WriteV/SendFile test");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CTestApp::Exit(void)
+{
+    CORE_SetLOG(0);
+    CORE_SetLOCK(0);
+}
+
+
+void CTestApp::x_Connect(CSocket& client, CSocket& server)
+{
+    unsigned short port = m_Listener.GetPort(eNH_HostByteOrder);
+    assert(client.Connect("127.0.0.1", port) == eIO_Success);
+    assert(m_Listener.Accept(server) == eIO_Success);
+}
+
+
+void CTestApp::x_TestSocket(void)
+{
+    ERR_POST(Info << "CSocket::WriteV/SendFile");
+
+    CSocket client, server;
+    x_Connect(client, server);
+
+    string a = s_Pattern(100000, 3), b = s_Pattern(70000, 5);
+    SSOCK_IOVec iov[4];
+    iov[0].data = a.data();
+    iov[0].size = a.size();
+    iov[1].data = 0;
+    iov[1].size = 0;
+    iov[2].data = b.data();
+    iov[2].size = b.size();
+    iov[3].data = "!";
+    iov[3].size = 1;
+    string expected = a + b + "!";
+#ifdef NCBI_OS_UNIX
+    expected += m_FileData.substr(1000, 200000);
+#endif //NCBI_OS_UNIX
+
+    CRef<CReadThread> reader(new CReadThread(server, expected.size()));
+    reader->Run();
+
+    size_t n_written;
+    assert(client.WriteV(iov, 4, &n_written) == eIO_Success);
+    assert(n_written == a.size() + b.size() + 1);
+#ifdef NCBI_OS_UNIX
+    CFileIO file;
+    file.Open(m_FileName, CFileIO::eOpen, CFileIO::eRead);
+    assert(client.SendFile(file.GetFileHandle(), 1000, 200000, &n_written)
+           == eIO_Success);
+    assert(n_written == 200000);
+#endif //NCBI_OS_UNIX
+
+    reader->Join();
+    assert(reader->GetData() == expected);
+
+    client.Close();
+    assert(client.WriteV(iov, 4, &n_written) == eIO_Closed);
+    assert(n_written == 0);
+}
+
+
+void CTestApp::x_TestStream(void)
+{
+    ERR_POST(Info << "CConn_SocketStream::WriteV/SendFile");
+
+    CSocket client, server;
+    x_Connect(client, server);
+    CConn_SocketStream stream(client);
+
+    string a = s_Pattern(50000, 7);
+    SSOCK_IOVec iov[2];
+    iov[0].data = a.data();
+    iov[0].size = a.size();
+    iov[1].data = "\n";
+    iov[1].size = 1;
+    string expected = "header\n" + a + "\n";
+#ifdef NCBI_OS_UNIX
+    expected += m_FileData;
+#endif //NCBI_OS_UNIX
+    expected += "trailer\n";
+
+    CRef<CReadThread> reader(new CReadThread(server, expected.size()));
+    reader->Run();
+
+    // the buffered output must go out first
+    stream << "header\n";
+    size_t n_written;
+    assert(stream.WriteV(iov, 2, &n_written) == eIO_Success);
+    assert(n_written == a.size() + 1);
+#ifdef NCBI_OS_UNIX
+    CFileIO file;
+    file.Open(m_FileName, CFileIO::eOpen, CFileIO::eRead);
+    assert(stream.SendFile(file.GetFileHandle(), 0, m_FileData.size(),
+                           &n_written) == eIO_Success);
+    assert(n_written == m_FileData.size());
+#endif //NCBI_OS_UNIX
+    stream << "trailer\n" << flush;
+    assert(stream.good());
+
+    reader->Join();
+    assert(reader->GetData() == expected);
+}
+
+
+void CTestApp::x_TestStreamTimeout(void)
+{
+#ifdef NCBI_OS_UNIX
+    ERR_POST(Info << "CConn_SocketStream::SendFile write timeout");
+
+    // Nothing gets read on the other end, so a file much larger than the
+    // socket buffers can only be sent partially before the timeout expires
+    const Uint8 kSize = 256 * 1024 * 1024;
+    string name = CFile::GetTmpName(CFile::eTmpFileCreate);
+    CFileIO file;
+    file.Open(name, CFileIO::eOpen, CFileIO::eReadWrite);
+    file.SetFileSize(kSize);
+
+    CSocket client, server;
+    x_Connect(client, server);
+    CConn_SocketStream stream(client);
+    // a write through the stream sets up the socket with its timeout
+    stream << "header\n" << flush;
+    assert(stream.good());
+
+    STimeout timeout = { 0, 500000 };
+    assert(stream.SetTimeout(eIO_Write, &timeout) == eIO_Success);
+    CStopWatch sw(CStopWatch::eStart);
+    size_t n_written;
+    EIO_Status status = stream.SendFile(file.GetFileHandle(), 0,
+                                        (size_t) kSize, &n_written);
+    double elapsed = sw.Elapsed();
+    ERR_POST(Info << "SendFile: " << IO_StatusStr(status) << ", "
+             << n_written << " byte(s) sent in " << elapsed << "s");
+    assert(status == eIO_Timeout);
+    assert(n_written < kSize);
+    assert(elapsed < 30.0);
+
+    // the unsent data must not hold up closing the stream
+    assert(stream.SetTimeout(eIO_Close, &timeout) == eIO_Success);
+    stream.Close();
+
+    file.Close();
+    CFile(name).Remove();
+#endif //NCBI_OS_UNIX
+}
+
+
+int CTestApp::Run(void)
+{
+    assert(m_Listener.Listen(0) == eIO_Success);
+
+    m_FileData = s_Pattern(300000, 11);
+    m_FileName = CFile::GetTmpName(CFile::eTmpFileCreate);
+    {{
+        CFileIO file;
+        file.Open(m_FileName, CFileIO::eCreate, CFileIO::eReadWrite);
+        assert(file.Write(m_FileData.data(), m_FileData.size())
+               == m_FileData.size());
+    }}
+
+    x_TestSocket();
+    x_TestStream();
+    x_TestStreamTimeout();
+
+    CFile(m_FileName).Remove();
+
+    ERR_POST(Info << "TEST completed successfully");
+    return 0;
+}
+
+
+END_NCBI_SCOPE
+
+
+int main(int argc, const char* argv[])
+{
+    USING_NCBI_SCOPE;
+    return CTestApp().AppMain(argc, argv);
+}
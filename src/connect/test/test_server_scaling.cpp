@@ -0,0 +1,340 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   CServer benchmark: request latency with many idle connections
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <connect/ncbi_util.h>
+#include <connect/server.hpp>
+#include <atomic>
+#ifdef NCBI_OS_UNIX
+#  include <sys/resource.h>
+#endif
+
+#include "test_assert.h"  // This header must go last
+
+
+BEGIN_NCBI_SCOPE
+
+
+/// CScaleServer --
+///
+/// CServer that counts accepted connections and stops on request.
+
+class CScaleServer : public CServer
+{
+public:
+    CScaleServer(void)
+        : m_Opened(0), m_ShutdownRequested(false)
+    {
+    }
+
+    virtual bool ShutdownRequested(void) { return m_ShutdownRequested; }
+    void RequestShutdown(void) { m_ShutdownRequested = true; }
+
+    void RegisterOpen(void) { ++m_Opened; }
+    unsigned GetOpenedCount(void) const { return m_Opened; }
+
+private:
+    atomic<unsigned> m_Opened;
+    atomic<bool>     m_ShutdownRequested;
+};
+
+
+/// CScaleConnectionHandler --
+///
+/// Answers each "ping" line with a "pong" line.
+
+class CScaleConnectionHandler : public IServer_LineMessageHandler
+{
+public:
+    CScaleConnectionHandler(CScaleServer* server)
+        : m_Server(server)
+    {
+    }
+
+    virtual void OnOpen(void) { m_Server->RegisterOpen(); }
+    virtual void OnMessage(BUF buf)
+    {
+        BUF_Erase(buf);
+        GetSocket().Write("pong\n", 5);
+    }
+    virtual void OnWrite(void) { }
+
+private:
+    CScaleServer* m_Server;
+};
+
+
+class CScaleConnectionFactory : public IServer_ConnectionFactory
+{
+public:
+    CScaleConnectionFactory(CScaleServer* server)
+        : m_Server(server)
+    {
+    }
+
+    IServer_ConnectionHandler* Create(void)
+    {
+        return new CScaleConnectionHandler(m_Server);
+    }
+
+private:
+    CScaleServer* m_Server;
+};
+
+
+class CScaleServerThread : public CThread
+{
+public:
+    CScaleServerThread(CScaleServer& server)
+        : m_Server(server)
+    {
+    }
+
+protected:
+    virtual void* Main(void)
+    {
+        m_Server.Run();
+        return 0;
+    }
+
+private:
+    CScaleServer& m_Server;
+};
+
+
+/// CServerScalingApp --
+///
+/// For each of the requested numbers of idle connections, start a server,
+/// open the idle connections, and measure the round trip time of requests
+/// sent over one more connection.  Compare the runs with the poll set
+/// enabled ("-api pollset") and disabled ("-api poll").
+
+class CServerScalingApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run (void);
+    virtual void Exit(void);
+
+private:
+    unsigned x_GetMaxConnections(void);
+    bool     x_RunOne(unsigned idle_count, unsigned request_count);
+};
+
+
+void CServerScalingApp::Init(void)
+{
+    CORE_SetLOCK(MT_LOCK_cxx2c());
+    CORE_SetLOG(LOG_cxx2c());
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CServer idle connections scaling benchmark");
+
+    arg_desc->AddDefaultKey("api", "API",
+                            "How the server waits for I/O",
+                            CArgDescriptions::eString, "pollset");
+    arg_desc->SetConstraint("api", &(*new CArgAllow_Strings, "poll", "pollset"));
+
+    arg_desc->AddDefaultKey("idle", "LIST",
+                            "Comma separated numbers of idle connections",
+                            CArgDescriptions::eString, "1000,10000,50000");
+
+    arg_desc->AddDefaultKey("requests", "N",
+                            "Number of requests to time for each run",
+                            CArgDescriptions::eInteger, "2000");
+    arg_desc->SetConstraint("requests", new CArgAllow_Integers(1, kMax_Int));
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CServerScalingApp::Exit(void)
+{
+    CORE_SetLOG(0);
+    CORE_SetLOCK(0);
+}
+
+
+unsigned CServerScalingApp::x_GetMaxConnections(void)
+{
+    // Both ends of each connection are in this process
+    unsigned max_fds = 1024;
+#ifdef NCBI_OS_UNIX
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        if (rl.rlim_cur < rl.rlim_max) {
+            rl.rlim_cur = rl.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &rl);
+            getrlimit(RLIMIT_NOFILE, &rl);
+        }
+        max_fds = rl.rlim_cur > kMax_UInt? kMax_UInt: (unsigned) rl.rlim_cur;
+    }
+#endif
+    return max_fds > 128? (max_fds - 128) / 2: 0;
+}
+
+
+static const STimeout kShutdownCheckTimeout = { 0, 100000 };
+static const STimeout kClientTimeout = { 30, 0 };
+
+
+bool CServerScalingApp::x_RunOne(unsigned idle_count, unsigned request_count)
+{
+    unsigned short port = 0;
+    {{
+        // Find a free port
+        CListeningSocket listener;
+        if (listener.Listen(0, 5, fSOCK_BindLocal | fSOCK_LogOff)
+            != eIO_Success) {
+            ERR_POST("Unable to find a free port to listen on");
+            return false;
+        }
+        port = listener.GetPort(eNH_HostByteOrder);
+    }}
+
+    SServer_Parameters params;
+    params.max_connections = idle_count + 16;
+    params.accept_timeout = &kShutdownCheckTimeout;
+    params.init_threads = 4;
+    params.max_threads = 8;
+
+    CScaleServer server;
+    server.SetParameters(params);
+    server.AddListener(new CScaleConnectionFactory(&server), port);
+    server.StartListening();
+    CRef<CScaleServerThread> thread(new CScaleServerThread(server));
+    thread->Run();
+
+    // Keep the backlog of not yet accepted connections short
+    const unsigned kMaxPending = 64;
+    vector< AutoPtr<CSocket> > idle;
+    idle.reserve(idle_count);
+    CStopWatch sw(CStopWatch::eStart);
+    bool ok = true;
+    for (unsigned i = 0;  ok  &&  i < idle_count;  ++i) {
+        while (i >= server.GetOpenedCount() + kMaxPending)
+            SleepMilliSec(1);
+        AutoPtr<CSocket> sock(new CSocket("127.0.0.1", port, &kClientTimeout,
+                                          fSOCK_LogOff));
+        if (sock->GetStatus(eIO_Open) != eIO_Success) {
+            ERR_POST("Cannot open idle connection #" << i + 1);
+            ok = false;
+        }
+        idle.push_back(sock);
+    }
+    while (ok  &&  server.GetOpenedCount() < idle.size())
+        SleepMilliSec(1);
+    double connect_time = sw.Elapsed();
+
+    double request_time = 0;
+    if (ok) {
+        CSocket sock("127.0.0.1", port, &kClientTimeout, fSOCK_LogOff);
+        sock.SetTimeout(eIO_ReadWrite, &kClientTimeout);
+        string line;
+        // warm up
+        ok = sock.Write("ping\n", 5) == eIO_Success
+            &&  sock.ReadLine(line) == eIO_Success;
+        sw.Restart();
+        for (unsigned i = 0;  ok  &&  i < request_count;  ++i) {
+            if (sock.Write("ping\n", 5) != eIO_Success
+                ||  sock.ReadLine(line) != eIO_Success
+                ||  line != "pong") {
+                ERR_POST("Request #" << i + 1 << " failed");
+                ok = false;
+            }
+        }
+        request_time = sw.Elapsed();
+    }
+
+    server.RequestShutdown();
+    thread->Join();
+    idle.clear();
+
+    if (ok) {
+        NcbiCout << setw(8) << idle_count << " idle: connected in "
+                 << NStr::DoubleToString(connect_time, 3) << " s, "
+                 << request_count << " requests in "
+                 << NStr::DoubleToString(request_time, 3) << " s, "
+                 << NStr::DoubleToString(request_time*1e6/request_count, 1)
+                 << " us/request" << NcbiEndl;
+    }
+    return ok;
+}
+
+
+int CServerScalingApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    // Must be set before the first server is run
+    bool use_poll_set = args["api"].AsString() == "pollset";
+    GetRWConfig().Set("server", "Use_Poll_Set",
+                      use_poll_set? "true": "false");
+
+    vector<string> counts;
+    NStr::Split(args["idle"].AsString(), ",", counts,
+                NStr::fSplit_Tokenize);
+    unsigned max_count = x_GetMaxConnections();
+    unsigned request_count = args["requests"].AsInteger();
+
+    NcbiCout << "Server I/O wait: "
+             << (use_poll_set? "poll set": "poll vector") << NcbiEndl;
+    ITERATE ( vector<string>, it, counts ) {
+        unsigned idle_count = NStr::StringToUInt(*it);
+        if (idle_count > max_count) {
+            NcbiCout << setw(8) << idle_count
+                     << " idle: skipped, open files limit allows only "
+                     << max_count << NcbiEndl;
+            continue;
+        }
+        if (!x_RunOne(idle_count, request_count))
+            return 1;
+    }
+    return 0;
+}
+
+
+END_NCBI_SCOPE
+
+
+USING_NCBI_SCOPE;
+
+
+int main(int argc, const char* argv[])
+{
+    return CServerScalingApp().AppMain(argc, argv);
+}
@@ -121,7 +121,13 @@ CSeq_id_Handle CSeq_id_Mapper::GetGiHandle(TGi gi)
 CSeq_id_Handle CSeq_id_Mapper::GetHandle(const CSeq_id& id, bool do_not_create)
 {
     CSeq_id_Which_Tree& tree = x_GetTree(id);
-    return do_not_create? tree.FindInfo(id): tree.FindOrCreate(id);
+    // Most requested ids are already known, so try to find them first
+    // under the shared read lock, and only then take the exclusive lock.
+    CSeq_id_Handle ret = tree.FindInfo(id);
+    if ( !ret && !do_not_create ) {
+        ret = tree.FindOrCreate(id);
+    }
+    return ret;
 }
 
 
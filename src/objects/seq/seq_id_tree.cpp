@@ -49,6 +49,35 @@ BEGIN_SCOPE(objects)
 DEFINE_STATIC_FAST_MUTEX(sx_GetSeqIdMutex);
 #endif
 
+////////////////////////////////////////////////////////////////////
+//
+//  CSeq_id_TreeLock::
+//
+
+
+size_t CSeq_id_TreeLock::x_GetShardIndex(void)
+{
+    // threads are assigned to shards in round-robin order
+    static atomic<size_t> s_NextIndex{0};
+    static thread_local size_t s_Index =
+        s_NextIndex.fetch_add(1, memory_order_relaxed) % kShardCount;
+    return s_Index;
+}
+
+
+void CSeq_id_TreeLock::WriteLock(void)
+{
+    m_WriterMutex.Lock();
+    m_Writer.store(true);
+    // wait for all current readers to leave
+    for ( size_t i = 0; i < kShardCount; ++i ) {
+        while ( m_Shards[i].m_Readers.load() != 0 ) {
+            NCBI_SCHED_YIELD();
+        }
+    }
+}
+
+
 ////////////////////////////////////////////////////////////////////
 //
 //  CSeq_id_***_Tree::
@@ -609,6 +638,12 @@ void CSeq_id_Gi_Tree::x_Unindex(const CSeq_id_Info* info)
 CSeq_id_Handle CSeq_id_Gi_Tree::GetGiHandle(TGi gi)
 {
     if ( gi != ZERO_GI ) {
+        {{
+            TReadLockGuard guard(m_TreeLock);
+            if ( m_SharedInfo ) {
+                return CSeq_id_Handle(m_SharedInfo, GI_TO(TPacked, gi));
+            }
+        }}
         TWriteLockGuard guard(m_TreeLock);
         if ( !m_SharedInfo ) {
             m_SharedInfo = new CSeq_id_Gi_Info(m_Mapper);
@@ -616,6 +651,12 @@ CSeq_id_Handle CSeq_id_Gi_Tree::GetGiHandle(TGi gi)
         return CSeq_id_Handle(m_SharedInfo, GI_TO(TPacked, gi));
     }
     else {
+        {{
+            TReadLockGuard guard(m_TreeLock);
+            if ( m_ZeroInfo ) {
+                return CSeq_id_Handle(m_ZeroInfo);
+            }
+        }}
         TWriteLockGuard guard(m_TreeLock);
         if ( !m_ZeroInfo ) {
             CRef<CSeq_id> zero_id(new CSeq_id);
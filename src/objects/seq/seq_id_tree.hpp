@@ -58,6 +58,7 @@
 #include <set>
 #include <map>
 #include <unordered_map>
+#include <atomic>
 
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
@@ -69,6 +70,82 @@ class CSeq_id_Info;
 class CSeq_id_Mapper;
 class CSeq_id_Which_Tree;
 
+////////////////////////////////////////////////////////////////////
+//
+//  CSeq_id_TreeLock::
+//
+//    Read-mostly lock of a seq-id tree.
+//    Readers only increment a counter in one of the cache line sized
+//    shards selected by the current thread, so lookups of existing
+//    handles from different threads do not contend on a shared
+//    cache line. Writers are serialized by a mutex and wait until
+//    all shard counters drop to zero.
+//    Recursive locking is not allowed.
+//
+
+class CSeq_id_TreeLock
+{
+public:
+    typedef CGuard<CSeq_id_TreeLock,
+                   SSimpleReadLock<CSeq_id_TreeLock>,
+                   SSimpleReadUnlock<CSeq_id_TreeLock> > TReadLockGuard;
+    typedef CGuard<CSeq_id_TreeLock,
+                   SSimpleWriteLock<CSeq_id_TreeLock>,
+                   SSimpleWriteUnlock<CSeq_id_TreeLock> > TWriteLockGuard;
+
+    CSeq_id_TreeLock(void)
+        : m_Writer(false)
+        {
+        }
+
+    void ReadLock(void)
+        {
+            atomic<int>& readers = x_GetShard();
+            for ( ;; ) {
+                readers.fetch_add(1);
+                if ( !m_Writer.load() ) {
+                    return;
+                }
+                // writer is active, step back and wait for it to finish
+                readers.fetch_sub(1);
+                CFastMutexGuard guard(m_WriterMutex);
+            }
+        }
+    void ReadUnlock(void)
+        {
+            x_GetShard().fetch_sub(1, memory_order_release);
+        }
+
+    void WriteLock(void);
+    void WriteUnlock(void)
+        {
+            m_Writer.store(false);
+            m_WriterMutex.Unlock();
+        }
+
+private:
+    CSeq_id_TreeLock(const CSeq_id_TreeLock&);
+    CSeq_id_TreeLock& operator=(const CSeq_id_TreeLock&);
+
+    enum {
+        kShardCount = 16
+    };
+    struct alignas(64) SShard {
+        atomic<int> m_Readers{0};
+    };
+
+    static size_t x_GetShardIndex(void);
+    atomic<int>& x_GetShard(void)
+        {
+            return m_Shards[x_GetShardIndex()].m_Readers;
+        }
+
+    SShard       m_Shards[kShardCount];
+    atomic<bool> m_Writer;
+    CFastMutex   m_WriterMutex;
+};
+
+
 struct PHashNocase {
     static char get_hash(char c)
         {
@@ -185,7 +262,7 @@ protected:
         }
     virtual void x_Unindex(const CSeq_id_Info* info) = 0;
 
-    typedef CFastMutex TTreeLock;
+    typedef CSeq_id_TreeLock TTreeLock;
     typedef TTreeLock::TReadLockGuard TReadLockGuard;
     typedef TTreeLock::TWriteLockGuard TWriteLockGuard;
 
@@ -3129,6 +3129,133 @@ void CSeq_loc_Mapper_Base::x_SetLastTruncated(void)
 }
 
 
+// Index of mapping ranges used when mapping a batch of locations.
+// For each source id the mappings are sorted by start, so that all
+// mappings intersecting a range can be found without searching the
+// range map. Requests with non-decreasing starts continue the sweep
+// from the position found by the previous request.
+class CSeq_loc_Mapper_Base::CBatchMappingIndex
+{
+public:
+    CBatchMappingIndex(const CMappingRanges& mappings)
+        : m_Mappings(&mappings),
+          m_LastIdMappings(0)
+        {
+        }
+
+    // Add all mappings intersecting the range, not sorted.
+    void GetMappings(const CSeq_id_Handle& idh,
+                     const TRange&         range,
+                     TSortedMappings&      mappings);
+    // Get the first mapping found for range 0..1, if any.
+    const CMappingRange* GetFirstMapping(const CSeq_id_Handle& idh)
+        {
+            return x_GetIdMappings(idh).m_FirstMapping;
+        }
+
+private:
+    struct SIdMappings {
+        SIdMappings(void)
+            : m_FirstMapping(0), m_Cursor(0), m_LastFrom(0)
+            {
+            }
+
+        // mappings sorted by source start
+        TSortedMappings      m_Sorted;
+        // maximum source end of mappings [0..i]
+        vector<TSeqPos>      m_MaxTo;
+        const CMappingRange* m_FirstMapping;
+        // sweep position
+        size_t               m_Cursor;
+        TSeqPos              m_LastFrom;
+    };
+    typedef map<CSeq_id_Handle, SIdMappings> TIdMappings;
+
+    SIdMappings& x_GetIdMappings(const CSeq_id_Handle& idh);
+
+    CConstRef<CMappingRanges> m_Mappings;
+    TIdMappings               m_IdMappings;
+    // the last used id, the locations are mostly on the same sequence
+    CSeq_id_Handle            m_LastId;
+    SIdMappings*              m_LastIdMappings;
+};
+
+
+CSeq_loc_Mapper_Base::CBatchMappingIndex::SIdMappings&
+CSeq_loc_Mapper_Base::CBatchMappingIndex::x_GetIdMappings(const CSeq_id_Handle& idh)
+{
+    if ( m_LastIdMappings  &&  idh == m_LastId ) {
+        return *m_LastIdMappings;
+    }
+    pair<TIdMappings::iterator, bool> ins =
+        m_IdMappings.insert(TIdMappings::value_type(idh, SIdMappings()));
+    SIdMappings& id_mappings = ins.first->second;
+    if ( ins.second ) {
+        CMappingRanges::TIdIterator ranges = m_Mappings->GetIdMap().find(idh);
+        if ( ranges != m_Mappings->GetIdMap().end() ) {
+            ITERATE ( CMappingRanges::TRangeMap, it, ranges->second ) {
+                id_mappings.m_Sorted.push_back(it->second);
+            }
+            stable_sort(id_mappings.m_Sorted.begin(), id_mappings.m_Sorted.end(),
+                        [](const CRef<CMappingRange>& a,
+                           const CRef<CMappingRange>& b) -> bool
+                        {
+                            return a->GetSrc_from() < b->GetSrc_from();
+                        });
+            id_mappings.m_MaxTo.reserve(id_mappings.m_Sorted.size());
+            TSeqPos max_to = 0;
+            ITERATE ( TSortedMappings, it, id_mappings.m_Sorted ) {
+                max_to = max(max_to, (*it)->GetSrc_from() + (*it)->GetLength());
+                id_mappings.m_MaxTo.push_back(max_to);
+            }
+            // The same lookup as in x_MapInterval().
+            TRangeIterator first = m_Mappings->BeginMappingRanges(idh, 0, 1);
+            if ( first ) {
+                id_mappings.m_FirstMapping = first->second.GetPointerOrNull();
+            }
+        }
+    }
+    m_LastId = idh;
+    m_LastIdMappings = &id_mappings;
+    return id_mappings;
+}
+
+
+void CSeq_loc_Mapper_Base::CBatchMappingIndex::GetMappings(
+    const CSeq_id_Handle& idh,
+    const TRange&         range,
+    TSortedMappings&      mappings)
+{
+    SIdMappings& id_mappings = x_GetIdMappings(idh);
+    const TSortedMappings& sorted = id_mappings.m_Sorted;
+    const vector<TSeqPos>& max_to = id_mappings.m_MaxTo;
+    TSeqPos from = range.GetFrom();
+    TSeqPos to = range.GetTo();
+    // Find the first mapping which can end at or after 'from'.
+    size_t index;
+    if ( from >= id_mappings.m_LastFrom ) {
+        // Continue the sweep.
+        index = id_mappings.m_Cursor;
+        while ( index < max_to.size()  &&  max_to[index] < from ) {
+            ++index;
+        }
+    }
+    else {
+        index = lower_bound(max_to.begin(), max_to.end(), from) -
+            max_to.begin();
+    }
+    id_mappings.m_Cursor = index;
+    id_mappings.m_LastFrom = from;
+    for ( ; index < sorted.size()  &&  sorted[index]->GetSrc_from() <= to;
+          ++index ) {
+        const CMappingRange& mapping = *sorted[index];
+        if ( mapping.GetSrc_from() + mapping.GetLength() >= from ) {
+            mappings.push_back(sorted[index]);
+        }
+    }
+}
+
+
 // Map a single interval. Return true if the range could be mapped
 // at least partially.
 bool CSeq_loc_Mapper_Base::x_MapInterval(const CSeq_id&   src_id,
@@ -3153,10 +3280,15 @@ bool CSeq_loc_Mapper_Base::x_MapInterval(const CSeq_id&   src_id,
 
     // Collect mappings which can be used to map the range.
     TSortedMappings mappings;
-    TRangeIterator rg_it = m_Mappings->BeginMappingRanges(
-        src_idh, src_rg.GetFrom(), src_rg.GetTo());
-    for ( ; rg_it; ++rg_it) {
-        mappings.push_back(rg_it->second);
+    if ( m_BatchIndex  &&  !src_rg.Empty() ) {
+        m_BatchIndex->GetMappings(src_idh, src_rg, mappings);
+    }
+    else {
+        TRangeIterator rg_it = m_Mappings->BeginMappingRanges(
+            src_idh, src_rg.GetFrom(), src_rg.GetTo());
+        for ( ; rg_it; ++rg_it) {
+            mappings.push_back(rg_it->second);
+        }
     }
     // Sort the mappings depending on the original location strand.
     if ( IsReverse(src_strand) ) {
@@ -3170,9 +3302,18 @@ bool CSeq_loc_Mapper_Base::x_MapInterval(const CSeq_id&   src_id,
     // This should very *rarely* be needed
     if( ! m_Mappings.Empty() ) {
         // get first mapping
-        TRangeIterator r_it = m_Mappings->BeginMappingRanges(src_idh, 0, 1);
-        if( r_it && r_it->second ) {
-            const CMappingRange &mapping = *r_it->second;
+        const CMappingRange* first_mapping = 0;
+        if ( m_BatchIndex ) {
+            first_mapping = m_BatchIndex->GetFirstMapping(src_idh);
+        }
+        else {
+            TRangeIterator r_it = m_Mappings->BeginMappingRanges(src_idh, 0, 1);
+            if ( r_it ) {
+                first_mapping = r_it->second.GetPointerOrNull();
+            }
+        }
+        if( first_mapping ) {
+            const CMappingRange &mapping = *first_mapping;
             // try to detect if we hit the case where we couldn't do a frame-shift
             if( ! mapping.m_Reverse && mapping.m_Frame > 1 && mapping.m_Dst_from == 0 &&
                 mapping.m_Dst_len <= static_cast<TSeqPos>(mapping.m_Frame - 1)  )
@@ -3672,6 +3813,48 @@ CRef<CSeq_loc> CSeq_loc_Mapper_Base::Map(const CSeq_loc& src_loc)
 }
 
 
+void CSeq_loc_Mapper_Base::Map(const TSrcLocs&    src_locs,
+                               TMappedLocs&       mapped_locs,
+                               CObjectMemoryPool* arena)
+{
+    // Order the locations by primary source id and start.
+    typedef pair<CSeq_id_Handle, TSeqPos> TLocKey;
+    typedef pair<TLocKey, size_t> TLocOrder;
+    vector<TLocOrder> order;
+    order.reserve(src_locs.size());
+    for ( size_t i = 0; i < src_locs.size(); ++i ) {
+        if ( !src_locs[i] ) {
+            continue;
+        }
+        CSeq_id_Handle idh;
+        if ( const CSeq_id* id = src_locs[i]->GetId() ) {
+            idh = x_GetPrimaryId(CSeq_id_Handle::GetHandle(*id));
+        }
+        order.push_back(TLocOrder(TLocKey(idh,
+            src_locs[i]->GetTotalRange().GetFrom()), i));
+    }
+    sort(order.begin(), order.end());
+
+    mapped_locs.clear();
+    mapped_locs.resize(src_locs.size());
+    CBatchMappingIndex index(*m_Mappings);
+    m_BatchIndex = &index;
+    m_Arena = arena;
+    try {
+        ITERATE ( vector<TLocOrder>, it, order ) {
+            mapped_locs[it->second] = Map(*src_locs[it->second]);
+        }
+    }
+    catch (...) {
+        m_BatchIndex = 0;
+        m_Arena = 0;
+        throw;
+    }
+    m_BatchIndex = 0;
+    m_Arena = 0;
+}
+
+
 class CTotalRangeSynonymMapper : public ISynonymMapper
 {
 public:
@@ -3736,7 +3919,7 @@ x_RangeToSeq_loc(const CSeq_id_Handle& idh,
         to = to/3;
     }
 
-    CRef<CSeq_loc> loc(new CSeq_loc);
+    CRef<CSeq_loc> loc(new(m_Arena) CSeq_loc);
     // If any fuzz is set, create interval, not point.
     // Points with fuzz can create problems later since they don't
     // specify fuzz direction. See GP-2895.
@@ -3744,6 +3927,7 @@ x_RangeToSeq_loc(const CSeq_id_Handle& idh,
         (m_FuzzOption & fFuzzOption_CStyle) == 0 )
     {
         // point
+        loc->Select(CSeq_loc::e_Pnt, eDoResetVariant, m_Arena);
         loc->SetPnt().SetId().Assign(*idh.GetSeqId());
         loc->SetPnt().SetPoint(from);
         if (strand_idx > 0) {
@@ -3765,6 +3949,7 @@ x_RangeToSeq_loc(const CSeq_id_Handle& idh,
     }
     else {
         // interval
+        loc->Select(CSeq_loc::e_Int, eDoResetVariant, m_Arena);
         loc->SetInt().SetId().Assign(*idh.GetSeqId());
         loc->SetInt().SetFrom(from);
         loc->SetInt().SetTo(to);
@@ -4033,7 +4218,8 @@ bool CSeq_loc_Mapper_Base::x_ReverseRangeOrder(int str) const
 CRef<CSeq_loc> CSeq_loc_Mapper_Base::x_GetMappedSeq_loc(void)
 {
     // Create a new mix to store all mapped ranges in it.
-    CRef<CSeq_loc> dst_loc(new CSeq_loc);
+    CRef<CSeq_loc> dst_loc(new(m_Arena) CSeq_loc);
+    dst_loc->Select(CSeq_loc::e_Mix, eDoResetVariant, m_Arena);
     CSeq_loc_mix::Tdata& dst_mix = dst_loc->SetMix().Set();
     // Iterate all mapped seq-ids.
     NON_CONST_ITERATE(TRangesById, id_it, m_MappedLocs) {
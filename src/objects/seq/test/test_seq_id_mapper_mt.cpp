@@ -0,0 +1,196 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *   This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Test program to collect throughput of CSeq_id_Mapper lookups of
+ *   already existing handles depending on the number of threads
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seq/seq_id_handle.hpp>
+#include <objects/seq/seq_id_mapper.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+typedef vector< CRef<CSeq_id> > TIds;
+typedef vector<CSeq_id_Handle> THandles;
+
+
+/// Thread resolving all ids repeatedly and checking that the handles
+/// are the same as the ones created before the measurement
+class CLookupThread : public CThread
+{
+public:
+    CLookupThread(const TIds& ids, const THandles& handles,
+                  unsigned int lookups, unsigned int start)
+        : m_Ids(ids), m_Handles(handles),
+          m_Lookups(lookups), m_Start(start), m_Errors(0)
+        {
+        }
+
+    unsigned int GetErrors(void) const
+        {
+            return m_Errors;
+        }
+
+protected:
+    virtual void* Main(void)
+        {
+            size_t count = m_Ids.size();
+            size_t index = m_Start % count;
+            for ( unsigned int i = 0; i < m_Lookups; ++i ) {
+                CSeq_id_Handle idh;
+                if ( m_Ids[index]->IsGi() ) {
+                    idh = CSeq_id_Handle::GetGiHandle(m_Ids[index]->GetGi());
+                }
+                else {
+                    idh = CSeq_id_Handle::GetHandle(*m_Ids[index]);
+                }
+                if ( idh != m_Handles[index] ) {
+                    ++m_Errors;
+                }
+                if ( ++index == count ) {
+                    index = 0;
+                }
+            }
+            return 0;
+        }
+
+private:
+    const TIds&     m_Ids;
+    const THandles& m_Handles;
+    unsigned int    m_Lookups;
+    unsigned int    m_Start;
+    unsigned int    m_Errors;
+};
+
+
+
+class CSeqIdMapperPerfTest : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    double x_Measure(unsigned int threads);
+
+    TIds         m_Ids;
+    THandles     m_Handles;
+    unsigned int m_Lookups;
+    unsigned int m_Errors;
+};
+
+
+void CSeqIdMapperPerfTest::Init(void)
+{
+    SetDiagPostLevel(eDiag_Error);
+
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+
+    d->AddDefaultKey("t", "threads",
+                     "maximum number of threads, tested are the powers "
+                     "of 2 up to this value",
+                     CArgDescriptions::eInteger, "64");
+    d->AddDefaultKey("n", "lookups",
+                     "number of lookups made in each measurement",
+                     CArgDescriptions::eInteger, "4000000");
+    d->AddDefaultKey("i", "ids",
+                     "number of distinct ids of each kind",
+                     CArgDescriptions::eInteger, "1000");
+    SetupArgDescriptions(d.release());
+}
+
+
+double CSeqIdMapperPerfTest::x_Measure(unsigned int threads)
+{
+    vector< CRef<CLookupThread> > thr;
+    CStopWatch timer(CStopWatch::eStart);
+    for ( unsigned int i = 0; i < threads; ++i ) {
+        thr.push_back(Ref(new CLookupThread(m_Ids, m_Handles,
+                                            m_Lookups/threads,
+                                            i*997)));
+        thr.back()->Run();
+    }
+    NON_CONST_ITERATE ( vector< CRef<CLookupThread> >, it, thr ) {
+        (*it)->Join();
+        m_Errors += (*it)->GetErrors();
+    }
+    double elapsed = timer.Elapsed();
+    return (m_Lookups/threads*threads) / elapsed;
+}
+
+
+int CSeqIdMapperPerfTest::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    unsigned int max_threads = (unsigned int)args["t"].AsInteger();
+    unsigned int id_count = (unsigned int)args["i"].AsInteger();
+    m_Lookups = (unsigned int)args["n"].AsInteger();
+    m_Errors = 0;
+
+    // accessions, gis, packed and plain general ids, and local ids
+    for ( unsigned int i = 0; i < id_count; ++i ) {
+        m_Ids.push_back(Ref(new CSeq_id("NC_"+NStr::NumericToString(100000+i)+".1")));
+        m_Ids.push_back(Ref(new CSeq_id(CSeq_id::e_Gi, 1000+i)));
+        m_Ids.push_back(Ref(new CSeq_id("gnl|TESTDB|ID"+NStr::NumericToString(i))));
+        m_Ids.push_back(Ref(new CSeq_id("gnl|TESTDB|"+NStr::NumericToString(i))));
+        m_Ids.push_back(Ref(new CSeq_id("lcl|contig"+NStr::NumericToString(i))));
+    }
+    ITERATE ( TIds, it, m_Ids ) {
+        m_Handles.push_back(CSeq_id_Handle::GetHandle(**it));
+    }
+
+    cout << "threads\tlookups/s" << endl;
+    for ( unsigned int threads = 1; threads <= max_threads; threads *= 2 ) {
+        double rate = x_Measure(threads);
+        cout << threads << "\t" << NStr::DoubleToString(rate, 0) << endl;
+    }
+
+    if ( m_Errors ) {
+        ERR_POST("Lookups returned different handles: " << m_Errors);
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CSeqIdMapperPerfTest().AppMain(argc, argv);
+}
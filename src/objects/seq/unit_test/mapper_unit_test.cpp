@@ -46,6 +46,7 @@
 #include <objects/seqfeat/Cdregion.hpp>
 
 #include <corelib/ncbiapp.hpp>
+#include <corelib/ncbimempool.hpp>
 #include <corelib/test_boost.hpp>
 
 #include <common/test_assert.h>  /* This header must go last */
@@ -1190,6 +1191,62 @@ void TestMapper_TruncatedMix()
 }
 
 
+void TestMapper_Batch()
+{
+    CNcbiIfstream in("mapper_test_data/truncatedmix.asn");
+    cout << "Testing batch mapping" << endl;
+
+    CSeq_loc src, dst_plus, dst_minus;
+    in >> MSerial_AsnText >> src;
+    in >> MSerial_AsnText >> dst_plus;
+    in >> MSerial_AsnText >> dst_minus;
+    CSeq_loc_Mapper_Base mapper_plus(src, dst_plus);
+    CSeq_loc_Mapper_Base mapper_minus(src, dst_minus);
+
+    // Use all source locations from the file, skip reference results.
+    CSeq_loc_Mapper_Base::TSrcLocs locs;
+    for (int i = 0; i < 8; ++i) {
+        CRef<CSeq_loc> orig(new CSeq_loc);
+        CSeq_loc ref_mapped;
+        in >> MSerial_AsnText >> *orig;
+        in >> MSerial_AsnText >> ref_mapped;
+        in >> MSerial_AsnText >> ref_mapped;
+        locs.push_back(orig);
+    }
+    // Add the locations in reverse order to test non-sorted input,
+    // and a null location.
+    for (int i = 7; i >= 0; --i) {
+        locs.push_back(locs[i]);
+    }
+    locs.push_back(CConstRef<CSeq_loc>());
+
+    CSeq_loc_Mapper_Base* mappers[] = { &mapper_plus, &mapper_minus };
+    for (auto mapper : mappers) {
+        CSeq_loc_Mapper_Base::TMappedLocs mapped;
+        CSeq_loc_Mapper_Base::TMappedLocs mapped_arena;
+        mapper->Map(locs, mapped);
+        {{
+            CRef<CObjectMemoryPool> arena(new CObjectMemoryPool);
+            mapper->Map(locs, mapped_arena, arena);
+        }}
+        BOOST_REQUIRE_EQUAL(mapped.size(), locs.size());
+        BOOST_REQUIRE_EQUAL(mapped_arena.size(), locs.size());
+        for (size_t i = 0; i < locs.size(); ++i) {
+            if ( !locs[i] ) {
+                BOOST_CHECK(!mapped[i]);
+                BOOST_CHECK(!mapped_arena[i]);
+                continue;
+            }
+            CRef<CSeq_loc> ref_mapped = mapper->Map(*locs[i]);
+            BOOST_REQUIRE(mapped[i]);
+            BOOST_REQUIRE(mapped_arena[i]);
+            BOOST_CHECK(mapped[i]->Equals(*ref_mapped));
+            BOOST_CHECK(mapped_arena[i]->Equals(*ref_mapped));
+        }
+    }
+}
+
+
 void TestMapper_Trimming()
 {
     CNcbiIfstream in("mapper_test_data/trimming.asn");
@@ -1420,4 +1477,5 @@ BOOST_AUTO_TEST_CASE(s_TestMapping)
     TestMapper_ExonPartsOrder();
     TestMapper_TruncatedMix();
     TestMapper_Trimming();
+    TestMapper_Batch();
 }
@@ -38,9 +38,16 @@
 #include <serial/objostrxml.hpp>
 #include <serial/objhook.hpp>
 #include <serial/objcopy.hpp>
+#include <serial/streamiter.hpp>
 #include <corelib/ncbifile.hpp>
 #include <common/test_data_path.h>
 #include <objects/seqset/Seq_entry.hpp>
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/Seq_annot.hpp>
 #include <corelib/test_boost.hpp>
 #include <objects/general/Object_id.hpp>
 #include <objects/seqloc/Seq_id.hpp>
@@ -401,3 +408,152 @@ BOOST_AUTO_TEST_CASE(s_TestAsnSerializationCopy)
         CFile(loc_name).Remove();
     }
 }
+
+
+static CRef<CSeq_entry> s_MakeBioseqEntry(int id, int length)
+{
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    CRef<CSeq_id> seq_id(new CSeq_id);
+    seq_id->SetLocal().SetId(id);
+    seq.SetId().push_back(seq_id);
+    CSeq_inst& inst = seq.SetInst();
+    inst.SetRepr(CSeq_inst::eRepr_raw);
+    inst.SetMol(CSeq_inst::eMol_dna);
+    inst.SetLength(length);
+    string& data = inst.SetSeq_data().SetIupacna().Set();
+    for ( int i = 0; i < length; ++i ) {
+        data += "ACGT"[(i + id) % 4];
+    }
+    return entry;
+}
+
+static CRef<CBioseq_set> s_MakeBioseqSet(int first_id, int count)
+{
+    CRef<CBioseq_set> bss(new CBioseq_set);
+    bss->SetId().SetId(first_id);
+    bss->SetLevel(1);
+    bss->SetClass(CBioseq_set::eClass_genbank);
+    bss->SetSeq_set();
+    for ( int i = 0; i < count; ++i ) {
+        int id = first_id + i;
+        if ( i % 50 == 7 ) {
+            // nested set
+            CRef<CSeq_entry> entry(new CSeq_entry);
+            entry->SetSet().SetClass(CBioseq_set::eClass_nuc_prot);
+            entry->SetSet().SetSeq_set().push_back(s_MakeBioseqEntry(-id, 10));
+            entry->SetSet().SetSeq_set().push_back(s_MakeBioseqEntry(id, 20));
+            bss->SetSeq_set().push_back(entry);
+        }
+        else {
+            bss->SetSeq_set().push_back(s_MakeBioseqEntry(id, 1 + id % 300));
+        }
+    }
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    annot->SetData().SetFtable();
+    bss->SetAnnot().push_back(annot);
+    return bss;
+}
+
+BOOST_AUTO_TEST_CASE(s_TestAsyncIteratorPreScan)
+{
+    LOG_POST("-------------------------------------------------");
+    LOG_POST("TestAsyncIteratorPreScan");
+    CNcbiOstrstream ostr;
+    {
+        unique_ptr<CObjectOStream> out(
+            CObjectOStream::Open(eSerial_AsnBinary, ostr));
+        *out << *s_MakeBioseqSet(1, 1000);
+        *out << *s_MakeBioseqSet(2001, 0);
+        *out << *s_MakeBioseqSet(3001, 1);
+        *out << *s_MakeBioseqSet(4001, 500);
+    }
+    string data = CNcbiOstrstreamToString(ostr);
+
+    vector< CRef<CSeq_entry> > expected;
+    {
+        CNcbiIstrstream istr(data);
+        for (CSeq_entry& entry : CObjectIStreamIterator<CBioseq_set, CSeq_entry>(
+                 *CObjectIStream::Open(eSerial_AsnBinary, istr), eTakeOwnership)) {
+            expected.push_back(CRef<CSeq_entry>(&entry));
+        }
+    }
+    BOOST_CHECK_EQUAL(expected.size(), 1561u);
+
+    typedef CObjectIStreamAsyncIterator<CBioseq_set, CSeq_entry> TIterator;
+    for ( size_t buffer_size : { 1, 4096, 1024*1024 } ) {
+        for ( bool same_thread : { false, true } ) {
+            CNcbiIstrstream istr(data);
+            size_t count = 0;
+            for (CSeq_entry& entry : TIterator(
+                     *CObjectIStream::Open(eSerial_AsnBinary, istr), eTakeOwnership,
+                     TIterator::CParams().PreScanContainer("seq-set")
+                     .MinRawBufferSize(buffer_size)
+                     .MaxTotalRawSize(64*1024)
+                     .ReadAndSkipInTheSameThread(same_thread))) {
+                BOOST_REQUIRE(count < expected.size());
+                BOOST_CHECK(entry.Equals(*expected[count]));
+                ++count;
+            }
+            BOOST_CHECK_EQUAL(count, expected.size());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(s_TestAsyncIteratorPreScanError)
+{
+    LOG_POST("-------------------------------------------------");
+    LOG_POST("TestAsyncIteratorPreScanError");
+    CRef<CBioseq_set> bss = s_MakeBioseqSet(1, 1000);
+    (*next(bss->SetSeq_set().begin(), 500))->SetSeq().SetId().front()
+        ->SetLocal().SetStr("corrupted");
+    CNcbiOstrstream ostr;
+    {
+        unique_ptr<CObjectOStream> out(
+            CObjectOStream::Open(eSerial_AsnBinary, ostr));
+        *out << *bss;
+    }
+    string data = CNcbiOstrstreamToString(ostr);
+
+    vector< CRef<CSeq_entry> > expected;
+    {
+        CNcbiIstrstream istr(data);
+        for (CSeq_entry& entry : CObjectIStreamIterator<CBioseq_set, CSeq_entry>(
+                 *CObjectIStream::Open(eSerial_AsnBinary, istr), eTakeOwnership)) {
+            expected.push_back(CRef<CSeq_entry>(&entry));
+        }
+    }
+
+    // break the tag of the string id, in the middle of a raw data buffer
+    size_t pos = data.find("corrupted");
+    BOOST_REQUIRE(pos != NPOS  &&  pos >= 2);
+    data[pos-2] = '\xff';
+
+    typedef CObjectIStreamAsyncIterator<CBioseq_set, CSeq_entry> TIterator;
+    for ( bool same_thread : { false, true } ) {
+        CNcbiIstrstream istr(data);
+        size_t count = 0;
+        bool failed = false;
+        try {
+            for (CSeq_entry& entry : TIterator(
+                     *CObjectIStream::Open(eSerial_AsnBinary, istr), eTakeOwnership,
+                     TIterator::CParams().PreScanContainer("seq-set")
+                     .MinRawBufferSize(4096)
+                     .MaxTotalRawSize(64*1024)
+                     .ReadAndSkipInTheSameThread(same_thread))) {
+                BOOST_REQUIRE(count < expected.size());
+                BOOST_CHECK(entry.Equals(*expected[count]));
+                ++count;
+            }
+        }
+        catch (CException& e) {
+            LOG_POST("Expected error after " << count << " entries: " << e.what());
+            failed = true;
+        }
+        // the entries of the buffers before the broken one are delivered,
+        // then the error is reported instead of the end of data
+        BOOST_CHECK(failed);
+        BOOST_CHECK(count > 0);
+        BOOST_CHECK(count < expected.size());
+    }
+}
@@ -85,7 +85,7 @@
 
 BEGIN_NCBI_SCOPE
 
-NCBI_DEFINE_ERR_SUBCODE_X(2);
+NCBI_DEFINE_ERR_SUBCODE_X(3);
 
 BEGIN_SCOPE(objects)
 
@@ -1717,7 +1717,8 @@ CAnnot_Collector::CAnnot_Collector(CScope& scope)
       m_Scope(scope),
       m_LoadBytes(0),
       m_LoadSeconds(0),
-      m_FromOtherTSE(false)
+      m_FromOtherTSE(false),
+      m_ChunksToLoad(0)
 {
 }
 
@@ -1832,6 +1833,196 @@ void CAnnot_Collector::x_StopSearchLimits(void)
 }
 
 
+NCBI_PARAM_DECL(unsigned, OBJMGR, PREFETCH_CHUNKS_THREADS);
+NCBI_PARAM_DEF_EX(unsigned, OBJMGR, PREFETCH_CHUNKS_THREADS, 4,
+                  eParam_NoThread, OBJMGR_PREFETCH_CHUNKS_THREADS);
+
+static unsigned s_GetPrefetchChunksThreads(void)
+{
+    static CSafeStatic<NCBI_PARAM_TYPE(OBJMGR, PREFETCH_CHUNKS_THREADS)> sx_Value;
+    return max(sx_Value->Get(), 1u);
+}
+
+
+// Chunks of one data loader to be loaded by a single request
+struct SPrefetchChunksRequest
+{
+    CDataLoader* m_Loader;
+    vector< CConstRef<CTSE_Chunk_Info> > m_Chunks;
+};
+typedef vector<SPrefetchChunksRequest> TPrefetchChunksRequests;
+
+
+static void s_ProcessPrefetchChunksRequests(TPrefetchChunksRequests& requests,
+                                            atomic<size_t>& next_request)
+{
+    for ( ;; ) {
+        size_t index = next_request.fetch_add(1);
+        if ( index >= requests.size() ) {
+            break;
+        }
+        SPrefetchChunksRequest& request = requests[index];
+        try {
+            CTSE_Split_Info::x_LoadChunks(request.m_Loader, request.m_Chunks);
+        }
+        catch ( CException& exc ) {
+            // the chunks will be loaded again by the actual search,
+            // which will report the error if it persists
+            ERR_POST_X(3, Warning << "CAnnot_Collector: "
+                       "failed to prefetch chunks: " << exc);
+        }
+    }
+}
+
+
+#if defined(NCBI_THREADS)
+class CPrefetchChunksThread : public CThread
+{
+public:
+    CPrefetchChunksThread(TPrefetchChunksRequests& requests,
+                          atomic<size_t>& next_request)
+        : m_Requests(requests),
+          m_NextRequest(next_request)
+        {
+        }
+
+protected:
+    virtual void* Main(void)
+        {
+            s_ProcessPrefetchChunksRequests(m_Requests, m_NextRequest);
+            return 0;
+        }
+
+private:
+    TPrefetchChunksRequests& m_Requests;
+    atomic<size_t>&          m_NextRequest;
+};
+#endif
+
+
+static void s_PrefetchChunks(const vector< CConstRef<CTSE_Chunk_Info> >& chunks)
+{
+    if ( chunks.empty() ) {
+        return;
+    }
+    unsigned max_threads = s_GetPrefetchChunksThreads();
+    // group chunks by data loader and blob
+    typedef map<const CTSE_Split_Info*,
+                vector< CConstRef<CTSE_Chunk_Info> > > TBlobChunks;
+    typedef map<CDataLoader*, TBlobChunks> TLoaderChunks;
+    TLoaderChunks loader_chunks;
+    ITERATE ( vector< CConstRef<CTSE_Chunk_Info> >, it, chunks ) {
+        const CTSE_Split_Info& split_info = (*it)->GetSplitInfo();
+        loader_chunks[&split_info.GetDataLoader()][&split_info]
+            .push_back(*it);
+    }
+    // distribute blobs of each loader among concurrent requests,
+    // all chunks of a blob go into the same request
+    TPrefetchChunksRequests requests;
+    ITERATE ( TLoaderChunks, it, loader_chunks ) {
+        size_t first = requests.size();
+        size_t count = min(it->second.size(), size_t(max_threads));
+        requests.resize(first + count);
+        size_t index = 0;
+        ITERATE ( TBlobChunks, it2, it->second ) {
+            SPrefetchChunksRequest& request = requests[first + index];
+            request.m_Loader = it->first;
+            request.m_Chunks.insert(request.m_Chunks.end(),
+                                    it2->second.begin(), it2->second.end());
+            index = (index + 1) % count;
+        }
+    }
+    atomic<size_t> next_request(0);
+#if defined(NCBI_THREADS)
+    vector< CRef<CPrefetchChunksThread> > threads;
+    size_t thread_count = min(requests.size(), size_t(max_threads));
+    for ( size_t i = 1; i < thread_count; ++i ) {
+        CRef<CPrefetchChunksThread> thr
+            (new CPrefetchChunksThread(requests, next_request));
+        if ( !thr->Run() ) {
+            break;
+        }
+        threads.push_back(thr);
+    }
+#endif
+    // the current thread processes requests too
+    s_ProcessPrefetchChunksRequests(requests, next_request);
+#if defined(NCBI_THREADS)
+    NON_CONST_ITERATE ( vector< CRef<CPrefetchChunksThread> >, it, threads ) {
+        (*it)->Join();
+    }
+#endif
+}
+
+
+class CAnnot_Collector::CPrefetchChunksGuard
+{
+public:
+    // start collecting chunks, the search state that may be changed by
+    // the prefetch pass is saved to be restored before the actual search
+    explicit CPrefetchChunksGuard(CAnnot_Collector& collector)
+        : m_Collector(collector),
+          m_UnseenAnnotTypes(collector.m_UnseenAnnotTypes),
+          m_CollectAnnotTypes(collector.m_CollectAnnotTypes),
+          m_SearchSegments(collector.m_SearchSegments),
+          m_SearchTime(collector.m_SearchTime)
+        {
+            _ASSERT(!collector.m_ChunksToLoad);
+            collector.m_ChunksToLoad = &m_Chunks;
+        }
+    ~CPrefetchChunksGuard(void)
+        {
+            x_Restore();
+        }
+
+    // stop collecting and load all collected chunks
+    void LoadChunks(void)
+        {
+            x_Restore();
+            s_PrefetchChunks(m_Chunks);
+        }
+
+private:
+    void x_Restore(void)
+        {
+            if ( m_Collector.m_ChunksToLoad ) {
+                m_Collector.m_ChunksToLoad = 0;
+                m_Collector.m_UnseenAnnotTypes = m_UnseenAnnotTypes;
+                m_Collector.m_CollectAnnotTypes = m_CollectAnnotTypes;
+                m_Collector.m_SearchSegments = m_SearchSegments;
+                m_Collector.m_SearchTime = m_SearchTime;
+            }
+        }
+
+    CAnnot_Collector& m_Collector;
+    TChunksToLoad     m_Chunks;
+    TAnnotTypesBitset m_UnseenAnnotTypes;
+    TAnnotTypesBitset m_CollectAnnotTypes;
+    TMaxSearchSegments m_SearchSegments;
+    CStopWatch        m_SearchTime;
+
+private:
+    CPrefetchChunksGuard(const CPrefetchChunksGuard&);
+    void operator=(const CPrefetchChunksGuard&);
+};
+
+
+bool CAnnot_Collector::x_NeedPrefetchChunks(void) const
+{
+    return m_Selector->m_PrefetchChunks &&
+        !m_Selector->m_CollectCostOfLoading &&
+        !m_Selector->m_CollectTypes &&
+        !m_Selector->m_CollectNames &&
+        !m_ChunksToLoad;
+}
+
+
+bool CAnnot_Collector::x_CollectStubsOnly(void) const
+{
+    return m_Selector->m_CollectCostOfLoading || m_ChunksToLoad;
+}
+
+
 bool CAnnot_Collector::x_FoundAllNamedAnnotAccessions(unique_ptr<SAnnotSelector>& local_sel)
 {
     if ( !m_AnnotNames.get() ) {
@@ -1893,6 +2084,11 @@ void CAnnot_Collector::x_Initialize(const SAnnotSelector& selector,
     // main sequence
     bool deeper = true;
     if ( adaptive_flags || !exact_depth || depth == 0 ) {
+        if ( x_NeedPrefetchChunks() ) {
+            CPrefetchChunksGuard prefetch(*this);
+            x_SearchMaster(bh, master_id, master_range);
+            prefetch.LoadChunks();
+        }
         x_SearchMaster(bh, master_id, master_range);
         deeper = !x_NoMoreObjects();
     }
@@ -1929,6 +2125,12 @@ void CAnnot_Collector::x_Initialize(const SAnnotSelector& selector,
             last_depth = level;
             // segments
             if ( adaptive_flags || !exact_depth || depth == level ) {
+                if ( x_NeedPrefetchChunks() ) {
+                    CPrefetchChunksGuard prefetch(*this);
+                    x_SearchSegments(bh, master_id, master_range,
+                                     *master_loc_empty, level);
+                    prefetch.LoadChunks();
+                }
                 deeper = x_SearchSegments(bh, master_id, master_range,
                                           *master_loc_empty, level);
                 if ( deeper ) {
@@ -1989,6 +2191,11 @@ void CAnnot_Collector::x_Initialize(const SAnnotSelector& selector,
     // main sequence
     bool deeper = true;
     if ( adaptive_flags || !exact_depth || depth == 0 ) {
+        if ( x_NeedPrefetchChunks() ) {
+            CPrefetchChunksGuard prefetch(*this);
+            x_SearchLoc(master_loc, 0, 0, true);
+            prefetch.LoadChunks();
+        }
         x_SearchLoc(master_loc, 0, 0, true);
         deeper = !x_NoMoreObjects();
     }
@@ -2007,6 +2214,11 @@ void CAnnot_Collector::x_Initialize(const SAnnotSelector& selector,
             last_depth = level;
             // segments
             if ( adaptive_flags || !exact_depth || depth == level ) {
+                if ( x_NeedPrefetchChunks() ) {
+                    CPrefetchChunksGuard prefetch(*this);
+                    x_SearchSegments(master_loc, level);
+                    prefetch.LoadChunks();
+                }
                 deeper = x_SearchSegments(master_loc, level);
                 if ( deeper ) {
                     deeper = !x_NoMoreObjects();
@@ -2814,7 +3026,14 @@ bool CAnnot_Collector::x_SearchTSE2(const CTSE_Handle&    tseh,
     const CTSE_Info& tse = tseh.x_GetTSE_Info();
     bool found = false;
 
-    tse.UpdateAnnotIndex(id);
+    if ( m_ChunksToLoad && tse.HasSplitInfo() ) {
+        // chunks with the Bioseq will be prefetched too
+        tse.GetSplitInfo().x_AddChunksForGetRecords(*m_ChunksToLoad, id);
+        tse.UpdateAnnotIndex();
+    }
+    else {
+        tse.UpdateAnnotIndex(id);
+    }
     CTSE_Info::TAnnotLockReadGuard guard(tse.GetAnnotLock());
 
     //CStopWatch sw(CStopWatch::eStart);
@@ -2970,7 +3189,7 @@ void CAnnot_Collector::x_SearchObjects(const CTSE_Handle&    tseh,
             return;
         }
     }
-    if ( m_Selector->m_CollectCostOfLoading ) {
+    if ( x_CollectStubsOnly() ) {
         return;
     }
 
@@ -3121,8 +3340,6 @@ void CAnnot_Collector::x_SearchRange(const CTSE_Handle&    tseh,
             if ( objs->x_RangeMapIsEmpty(index) ) {
                 continue;
             }
-            const CTSE_Info::TRangeMap& rmap = objs->x_GetRangeMap(index);
-
             size_t start_size = m_AnnotSet.size(); // for rollback
 
             // Same annotations may appear more than once if circular.
@@ -3132,8 +3349,8 @@ void CAnnot_Collector::x_SearchRange(const CTSE_Handle&    tseh,
             ITERATE(CHandleRange, rg_it, hr) {
                 CHandleRange::TRange range = rg_it->first;
 
-                for ( CTSE_Info::TRangeMap::const_iterator
-                          aoit(rmap.begin(range));
+                for ( SIdAnnotObjs::CRangeIterator
+                          aoit = objs->x_BeginRange(index, range);
                       aoit; ++aoit ) {
                     const CAnnotObject_Info& annot_info =
                         *aoit->second.m_AnnotObject_Info;
@@ -3171,8 +3388,13 @@ void CAnnot_Collector::x_SearchRange(const CTSE_Handle&    tseh,
                             continue;
                         }
                         if ( chunk.NotLoaded() &&
-                             m_Selector->m_CollectCostOfLoading &&
+                             x_CollectStubsOnly() &&
                              chunk.GetChunkId() != CTSE_Chunk_Info::kDelayedMain_ChunkId ) {
+                            if ( m_ChunksToLoad ) {
+                                // remember chunk to be prefetched
+                                m_ChunksToLoad->push_back(ConstRef(&chunk));
+                                continue;
+                            }
                             // accumulate cost of chunks to be loaded
                             auto cost = chunk.GetLoadCost();
                             m_LoadBytes += cost.first;
@@ -3197,7 +3419,7 @@ void CAnnot_Collector::x_SearchRange(const CTSE_Handle&    tseh,
                         _ASSERT(!enough);
                         continue;
                     }
-                    if ( m_Selector->m_CollectCostOfLoading ) {
+                    if ( x_CollectStubsOnly() ) {
                         continue;
                     }
 
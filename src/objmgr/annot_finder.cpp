@@ -254,12 +254,11 @@ void CSeq_annot_Finder::x_Find(const CSeq_entry_Info& entry,
         if (objs->x_RangeMapIsEmpty(index))
             continue;
 
-        const CTSE_Info::TRangeMap& rmap = objs->x_GetRangeMap(index);
-
         bool run_again;
         do {
             run_again = false;
-            CTSE_Info::TRangeMap::const_iterator it = rmap.find(overlap_range);
+            SIdAnnotObjs::CRangeIterator it =
+                objs->x_FindRange(index, overlap_range);
             while (it && it.GetInterval() == overlap_range) {
                 const CAnnotObject_Info& annot_info = *it->second.m_AnnotObject_Info;
                 ++it;
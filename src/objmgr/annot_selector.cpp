@@ -78,6 +78,7 @@ SAnnotSelector::SAnnotSelector(TAnnotType annot,
       m_CollectTypes(false),
       m_CollectNames(false),
       m_CollectCostOfLoading(false),
+      m_PrefetchChunks(false),
       m_IgnoreStrand(false),
       m_HasWildcardInAnnotsNames(false),
       m_FilterMask(0),
@@ -113,6 +114,7 @@ SAnnotSelector::SAnnotSelector(TFeatType feat,
       m_CollectTypes(false),
       m_CollectNames(false),
       m_CollectCostOfLoading(false),
+      m_PrefetchChunks(false),
       m_IgnoreStrand(false),
       m_HasWildcardInAnnotsNames(false),
       m_FilterMask(0),
@@ -144,6 +146,7 @@ SAnnotSelector::SAnnotSelector(TFeatSubtype feat_subtype)
       m_CollectTypes(false),
       m_CollectNames(false),
       m_CollectCostOfLoading(false),
+      m_PrefetchChunks(false),
       m_IgnoreStrand(false),
       m_HasWildcardInAnnotsNames(false),
       m_FilterMask(0),
@@ -192,6 +195,7 @@ SAnnotSelector& SAnnotSelector::operator=(const SAnnotSelector& sel)
         m_CollectTypes = sel.m_CollectTypes;
         m_CollectNames = sel.m_CollectNames;
         m_CollectCostOfLoading = sel.m_CollectCostOfLoading;
+        m_PrefetchChunks = sel.m_PrefetchChunks;
         m_IgnoreStrand = sel.m_IgnoreStrand;
         m_HasWildcardInAnnotsNames = sel.m_HasWildcardInAnnotsNames;
         m_FilterMask = sel.m_FilterMask;
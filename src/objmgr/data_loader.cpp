@@ -37,6 +37,7 @@
 #include <objects/seq/seq_id_handle.hpp>
 #include <objmgr/annot_name.hpp>
 #include <objmgr/annot_type_selector.hpp>
+#include <objmgr/impl/data_source.hpp>
 #include <objmgr/impl/tse_info.hpp>
 #include <objmgr/impl/bioseq_info.hpp>
 #include <objmgr/impl/tse_chunk_info.hpp>
@@ -986,6 +987,22 @@ unsigned CDataLoader::GetDefaultBlobCacheSizeLimit(void) const
     return kMax_UInt;
 }
 
+
+size_t CDataLoader::GetDefaultBlobCacheMemoryLimit(void) const
+{
+    return 0;
+}
+
+
+CDataLoader::SBlobCacheStatistics
+CDataLoader::GetBlobCacheStatistics(void) const
+{
+    if ( !m_DataSource ) {
+        return SBlobCacheStatistics();
+    }
+    return m_DataSource->GetBlobCacheStatistics();
+}
+
 bool CDataLoader::GetTrackSplitSeq() const
 {
     return false;
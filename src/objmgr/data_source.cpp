@@ -101,6 +101,27 @@ unsigned CDataSource::GetDefaultBlobCacheSizeLimit(void)
 }
 
 
+NCBI_PARAM_DECL(size_t, OBJMGR, BLOB_CACHE_MEMORY);
+NCBI_PARAM_DEF_EX(size_t, OBJMGR, BLOB_CACHE_MEMORY, 0,
+                  eParam_NoThread, OBJMGR_BLOB_CACHE_MEMORY);
+
+size_t CDataSource::GetDefaultBlobCacheMemoryLimit(void)
+{
+    static CSafeStatic<NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_MEMORY)> sx_Value;
+    return sx_Value->Get();
+}
+
+
+static size_t s_GetBlobCacheMemoryLimit(size_t limit1, size_t limit2)
+{
+    // 0 means unlimited
+    if ( !limit1 || !limit2 ) {
+        return max(limit1, limit2);
+    }
+    return min(limit1, limit2);
+}
+
+
 NCBI_PARAM_DECL(bool, OBJMGR, BULK_CHUNKS);
 NCBI_PARAM_DEF_EX(bool, OBJMGR, BULK_CHUNKS, true,
                   eParam_NoThread, OBJMGR_BULK_CHUNKS);
@@ -116,8 +137,13 @@ CDataSource::CDataSource(void)
     : m_DefaultPriority(CObjectManager::kPriority_Entry),
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(GetDefaultBlobCacheSizeLimit()),
+      m_Blob_Cache_Memory(0),
+      m_Blob_Cache_Memory_Limit(GetDefaultBlobCacheMemoryLimit()),
+      m_Blob_Cache_Evicted(0),
+      m_Blob_Cache_Evicted_Memory(0),
       m_StaticBlobCounter(0),
-      m_TrackSplitSeq(false)
+      m_TrackSplitSeq(false),
+      m_Statistics(&CObjMgrStatistics::GetObjMgrGroup())
 {
 }
 
@@ -128,8 +154,15 @@ CDataSource::CDataSource(CDataLoader& loader)
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(min(GetDefaultBlobCacheSizeLimit(),
                                   loader.GetDefaultBlobCacheSizeLimit())),
+      m_Blob_Cache_Memory(0),
+      m_Blob_Cache_Memory_Limit(
+          s_GetBlobCacheMemoryLimit(GetDefaultBlobCacheMemoryLimit(),
+                                    loader.GetDefaultBlobCacheMemoryLimit())),
+      m_Blob_Cache_Evicted(0),
+      m_Blob_Cache_Evicted_Memory(0),
       m_StaticBlobCounter(0),
-      m_TrackSplitSeq(loader.GetTrackSplitSeq())
+      m_TrackSplitSeq(loader.GetTrackSplitSeq()),
+      m_Statistics(&CObjMgrStatistics::GetGroup(loader.GetName()))
 {
     m_Loader->SetTargetDataSource(*this);
 }
@@ -140,8 +173,13 @@ CDataSource::CDataSource(const CObject& shared_object, const CSeq_entry& entry)
       m_DefaultPriority(CObjectManager::kPriority_Entry),
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(GetDefaultBlobCacheSizeLimit()),
+      m_Blob_Cache_Memory(0),
+      m_Blob_Cache_Memory_Limit(GetDefaultBlobCacheMemoryLimit()),
+      m_Blob_Cache_Evicted(0),
+      m_Blob_Cache_Evicted_Memory(0),
       m_StaticBlobCounter(0),
-      m_TrackSplitSeq(false)
+      m_TrackSplitSeq(false),
+      m_Statistics(&CObjMgrStatistics::GetObjMgrGroup())
 {
     CTSE_Lock tse_lock = AddTSE(const_cast<CSeq_entry&>(entry));
     m_StaticBlobs.PutLock(tse_lock);
@@ -208,6 +246,7 @@ void CDataSource::DropAllTSEs(void)
         m_Blob_Map.clear();
         m_Blob_Cache.clear();
         m_Blob_Cache_Size = 0;
+        m_Blob_Cache_Memory = 0;
         m_StaticBlobCounter = 0;
     }}
 }
@@ -584,6 +623,8 @@ CDataSource::GetSeq_entry_Lock(const CBlobIdKey& blob_id)
     TSeq_entry_Lock ret;
     {{
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBlobById);
             ret.first = m_Loader->GetBlobById(blob_id);
         }
         catch ( CLoaderException& exc ) {
@@ -993,6 +1034,8 @@ CDataSource::x_GetRecords(const CSeq_id_Handle& idh,
     if ( m_Loader ) {
         CDataLoader::TTSE_LockSet tse_set2;
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetRecords);
             tse_set2 = m_Loader->GetRecords(idh, choice);
         }
         catch ( CLoaderException& exc ) {
@@ -1091,6 +1134,8 @@ void CDataSource::GetTSESetWithOrphanAnnots(const TSeq_idSet& ids,
         // collect set of TSEs with orphan annotations
         CDataLoader::TTSE_LockSet tse_set;
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetAnnotRecords);
             tse_set = m_Loader->GetOrphanAnnotRecordsNA(ids, sel, processed_nas);
         }
         catch ( CLoaderException& exc ) {
@@ -1149,6 +1194,8 @@ void CDataSource::GetTSESetWithBioseqAnnots(const CBioseq_Info& bioseq,
         // external annotations
         CDataLoader::TTSE_LockSet tse_set2;
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetAnnotRecords);
             tse_set2 = m_Loader->GetExternalAnnotRecordsNA(bioseq, sel, processed_nas);
         }
         catch ( CLoaderException& exc ) {
@@ -1530,6 +1577,8 @@ void CDataSource::GetIds(const CSeq_id_Handle& idh, TIds& ids)
     // Bioseq not found - try to request ids from loader if any.
     if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetIds);
             m_Loader->GetIds(idh, ids);
         }
         catch ( CLoaderException& exc ) {
@@ -1550,6 +1599,8 @@ CDataSource::SAccVerFound CDataSource::GetAccVer(const CSeq_id_Handle& idh)
     }
     else if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetAccVerFound(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1571,6 +1622,8 @@ CDataSource::SGiFound CDataSource::GetGi(const CSeq_id_Handle& idh)
     }
     else if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetGiFound(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1598,6 +1651,8 @@ string CDataSource::GetLabel(const CSeq_id_Handle& idh)
     }
     if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetLabel(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1618,6 +1673,8 @@ TTaxId CDataSource::GetTaxId(const CSeq_id_Handle& idh)
     }
     else if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetTaxId(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1638,6 +1695,8 @@ TSeqPos CDataSource::GetSequenceLength(const CSeq_id_Handle& idh)
     }
     else if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetSequenceLength(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1660,6 +1719,8 @@ CDataSource::GetSequenceType(const CSeq_id_Handle& idh)
     }
     else if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetSequenceTypeFound(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1680,6 +1741,8 @@ int CDataSource::GetSequenceState(const CSeq_id_Handle& idh)
     }
     else if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetSequenceState(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1711,6 +1774,8 @@ void CDataSource::GetBulkIds(const TIds& ids, TLoaded& loaded, TBulkIds& ret)
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetBulkIds(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1741,6 +1806,8 @@ void CDataSource::GetAccVers(const TIds& ids, TLoaded& loaded, TIds& ret)
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetAccVers(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1771,6 +1838,8 @@ void CDataSource::GetGis(const TIds& ids, TLoaded& loaded, TGis& ret)
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetGis(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1801,6 +1870,8 @@ void CDataSource::GetLabels(const TIds& ids, TLoaded& loaded, TLabels& ret)
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetLabels(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1831,6 +1902,8 @@ void CDataSource::GetTaxIds(const TIds& ids, TLoaded& loaded, TTaxIds& ret)
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetTaxIds(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1862,6 +1935,8 @@ void CDataSource::GetSequenceLengths(const TIds& ids, TLoaded& loaded,
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetSequenceLengths(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1893,6 +1968,8 @@ void CDataSource::GetSequenceTypes(const TIds& ids, TLoaded& loaded,
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetSequenceTypes(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1924,6 +2001,8 @@ void CDataSource::GetSequenceStates(const TIds& ids, TLoaded& loaded,
     }
     if ( remaining && m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetSequenceStates(ids, loaded, ret);
         }
         catch ( CLoaderException& exc ) {
@@ -1940,6 +2019,8 @@ CDataSource::GetSequenceHash(const CSeq_id_Handle& idh)
     SHashFound ret;
     if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetSequenceInfo);
             ret = m_Loader->GetSequenceHashFound(idh);
         }
         catch ( CLoaderException& exc ) {
@@ -1956,6 +2037,8 @@ void CDataSource::GetSequenceHashes(const TIds& ids, TLoaded& loaded,
 {
     if ( m_Loader ) {
         try {
+            CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                            CObjMgrStatGroup::eCall_GetBulkInfo);
             m_Loader->GetSequenceHashes(ids, loaded, ret, known);
         }
         catch ( CLoaderException& exc ) {
@@ -1970,6 +2053,8 @@ void CDataSource::GetCDDAnnots(const TSeqIdSets& id_sets, TLoaded& loaded, TCDD_
 {
     if (!m_Loader) return;
     try {
+        CObjMgrStatCallGuard stat_guard(GetStatistics(),
+                                        CObjMgrStatGroup::eCall_GetAnnotRecords);
         m_Loader->GetCDDAnnots(id_sets, loaded, ret);
     }
     catch ( CLoaderException& exc ) {
@@ -1980,10 +2065,12 @@ void CDataSource::GetCDDAnnots(const TSeqIdSets& id_sets, TLoaded& loaded, TCDD_
 
 
 static void s_GetBlobs(CDataLoader* loader,
+                       CObjMgrStatGroup& stat,
                        CDataLoader::TTSE_LockSets& all_tse_sets,
                        CDataLoader::TTSE_LockSets& current_tse_sets)
 {
     try {
+        CObjMgrStatCallGuard stat_guard(stat, CObjMgrStatGroup::eCall_GetBlobs);
         loader->GetBlobs(current_tse_sets);
     }
     catch ( CLoaderException& exc ) {
@@ -2020,12 +2107,12 @@ void CDataSource::GetBlobs(TSeqMatchMap& match_map)
                 CDataLoader::TTSE_LockSets::value_type(
                 match->first, CDataLoader::TTSE_LockSet()));
             if ( ++current_tse_sets_size >= limit_blobs_request ) {
-                s_GetBlobs(m_Loader, tse_sets, current_tse_sets);
+                s_GetBlobs(m_Loader, GetStatistics(), tse_sets, current_tse_sets);
                 current_tse_sets_size = 0;
             }
         }
         if ( !current_tse_sets.empty() ) {
-            s_GetBlobs(m_Loader, tse_sets, current_tse_sets);
+            s_GetBlobs(m_Loader, GetStatistics(), tse_sets, current_tse_sets);
         }
         if ( s_GetBulkChunks() ) {
             // bulk chunk loading
@@ -2229,6 +2316,9 @@ CTSE_LoadLock CDataSource::GetTSE_LoadLock(const TBlobId& blob_id)
                 _ASSERT(!slot->m_LoadMutex);
                 slot->m_LoadMutex.Reset(new CTSE_Info::CLoadMutex);
             }
+            GetStatistics().Add(IsLoaded(*slot)?
+                                CObjMgrStatGroup::eCounter_TSE_Found:
+                                CObjMgrStatGroup::eCounter_TSE_NotFound);
             x_SetLock(lock, slot);
             load_mutex = lock->m_LoadMutex;
         }}
@@ -2306,11 +2396,18 @@ void CDataSource::SetLoaded(CTSE_LoadLock& lock)
         CDSDetachGuard detach_guard;
         detach_guard.Attach(this, &*lock);
     }}
+    if ( m_Blob_Cache_Memory_Limit ) {
+        CConstRef<CSeq_entry> entry = lock->GetSeq_entryCore();
+        if ( entry ) {
+            lock->AddObjectMemory(*entry);
+        }
+    }
     {{
         TCacheLock::TWriteLockGuard guard2(m_DSCacheLock);
         lock->m_LoadState = CTSE_Info::eLoaded;
         lock->m_LoadMutex.Reset();
     }}
+    GetStatistics().Add(CObjMgrStatGroup::eCounter_TSE_Loaded);
     lock.ReleaseLoadLock();
 }
 
@@ -2344,17 +2441,27 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
             m_Blob_Cache_Size += 1;
             _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
             tse->m_CacheState = CTSE_Info::eInCache;
+            tse->m_CacheMemory = tse->GetEstimatedMemory();
+            m_Blob_Cache_Memory += tse->m_CacheMemory;
         }
         _ASSERT(tse->m_CachePosition ==
                 find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse));
         _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
         
         unsigned cache_size = m_Blob_Cache_Size_Limit;
-        while ( m_Blob_Cache_Size > cache_size ) {
+        size_t cache_memory = m_Blob_Cache_Memory_Limit;
+        while ( m_Blob_Cache_Size > cache_size ||
+                (cache_memory && m_Blob_Cache_Memory > cache_memory) ) {
             CRef<CTSE_Info> del_tse = m_Blob_Cache.front();
             m_Blob_Cache.pop_front();
             m_Blob_Cache_Size -= 1;
             _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+            _ASSERT(m_Blob_Cache_Memory >= del_tse->m_CacheMemory);
+            m_Blob_Cache_Memory -= del_tse->m_CacheMemory;
+            m_Blob_Cache_Evicted += 1;
+            m_Blob_Cache_Evicted_Memory += del_tse->m_CacheMemory;
+            GetStatistics().Add(CObjMgrStatGroup::eCounter_TSE_Evicted);
+            del_tse->m_CacheMemory = 0;
             del_tse->m_CacheState = CTSE_Info::eNotInCache;
             to_delete.push_back(del_tse);
             _VERIFY(DropTSE(*del_tse));
@@ -2363,6 +2470,21 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
 }
 
 
+CDataSource::TBlobCacheStatistics
+CDataSource::GetBlobCacheStatistics(void) const
+{
+    TBlobCacheStatistics stat;
+    TCacheLock::TWriteLockGuard guard(m_DSCacheLock);
+    stat.m_Blobs = m_Blob_Cache_Size;
+    stat.m_BlobsLimit = m_Blob_Cache_Size_Limit;
+    stat.m_Memory = m_Blob_Cache_Memory;
+    stat.m_MemoryLimit = m_Blob_Cache_Memory_Limit;
+    stat.m_EvictedBlobs = m_Blob_Cache_Evicted;
+    stat.m_EvictedMemory = m_Blob_Cache_Evicted_Memory;
+    return stat;
+}
+
+
 void CDataSource::x_SetLock(CTSE_Lock& lock, CConstRef<CTSE_Info> tse) const
 {
     _ASSERT(!lock);
@@ -2381,6 +2503,9 @@ void CDataSource::x_SetLock(CTSE_Lock& lock, CConstRef<CTSE_Info> tse) const
         m_Blob_Cache.erase(tse->m_CachePosition);
         m_Blob_Cache_Size -= 1;
         _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+        _ASSERT(m_Blob_Cache_Memory >= tse->m_CacheMemory);
+        m_Blob_Cache_Memory -= tse->m_CacheMemory;
+        tse->m_CacheMemory = 0;
     }
     
     _ASSERT(find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse) ==
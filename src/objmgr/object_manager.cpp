@@ -41,6 +41,7 @@
 #include <objmgr/impl/scope_impl.hpp>
 #include <objmgr/impl/data_source.hpp>
 #include <objmgr/objmgr_exception.hpp>
+#include <objmgr/objmgr_statistics.hpp>
 #include <objmgr/error_codes.hpp>
 
 #include <objects/seq/seq_id_mapper.hpp>
@@ -52,7 +53,7 @@
 
 BEGIN_NCBI_SCOPE
 
-NCBI_DEFINE_ERR_SUBCODE_X(7);
+NCBI_DEFINE_ERR_SUBCODE_X(8);
 
 BEGIN_SCOPE(objects)
 
@@ -114,6 +115,18 @@ CObjectManager::CObjectManager(void)
 }
 
 
+NCBI_PARAM_DECL(int, OBJMGR, STATISTICS);
+NCBI_PARAM_DEF_EX(int, OBJMGR, STATISTICS, 0,
+                  eParam_NoThread, OBJMGR_STATISTICS);
+
+// 0 - none, 1 - print counters on exit, 2 - print call histograms too
+static int s_GetStatisticsLevel(void)
+{
+    static CSafeStatic<NCBI_PARAM_TYPE(OBJMGR, STATISTICS)> sx_Value;
+    return sx_Value->Get();
+}
+
+
 CObjectManager::~CObjectManager(void)
 {
     // delete scopes
@@ -139,6 +152,12 @@ CObjectManager::~CObjectManager(void)
         }
         m_mapToSource.erase(m_mapToSource.begin());
     }
+    if ( int level = s_GetStatisticsLevel() ) {
+        CNcbiOstrstream str;
+        CObjMgrStatistics::Print(str, level > 1);
+        LOG_POST_X(8, Info << "Object manager statistics:\n" <<
+                   CNcbiOstrstreamToString(str));
+    }
     // LOG_POST_X(3, "~CObjectManager - delete " << this << "  done");
 }
 
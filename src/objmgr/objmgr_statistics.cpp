@@ -0,0 +1,311 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Object manager statistics: counters and call time histograms
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <objmgr/objmgr_statistics.hpp>
+#include <corelib/ncbimtx.hpp>
+#include <corelib/ncbi_param.hpp>
+#include <corelib/perf_log.hpp>
+#include <exception>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+
+NCBI_PARAM_DECL(bool, OBJMGR, STATISTICS_PERF_LOG);
+NCBI_PARAM_DEF_EX(bool, OBJMGR, STATISTICS_PERF_LOG, false,
+                  eParam_NoThread, OBJMGR_STATISTICS_PERF_LOG);
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjMgrStatHistogram
+/////////////////////////////////////////////////////////////////////////////
+
+
+CObjMgrStatHistogram::CObjMgrStatHistogram(void)
+{
+    Reset();
+}
+
+
+void CObjMgrStatHistogram::Reset(void)
+{
+    m_Count.store(0, memory_order_relaxed);
+    m_TotalTime.store(0, memory_order_relaxed);
+    m_MaxTime.store(0, memory_order_relaxed);
+    for ( size_t i = 0; i < kBucketCount; ++i ) {
+        m_Buckets[i].store(0, memory_order_relaxed);
+    }
+}
+
+
+void CObjMgrStatHistogram::Add(double seconds)
+{
+    Uint8 us = seconds > 0? Uint8(seconds*1e6): 0;
+    size_t bucket = 0;
+    for ( Uint8 v = us; v && bucket < kBucketCount-1; v >>= 1 ) {
+        ++bucket;
+    }
+    m_Count.fetch_add(1, memory_order_relaxed);
+    m_TotalTime.fetch_add(us, memory_order_relaxed);
+    m_Buckets[bucket].fetch_add(1, memory_order_relaxed);
+    Uint8 old_max = m_MaxTime.load(memory_order_relaxed);
+    while ( us > old_max &&
+            !m_MaxTime.compare_exchange_weak(old_max, us,
+                                             memory_order_relaxed) ) {
+    }
+}
+
+
+double CObjMgrStatHistogram::GetBucketLimit(size_t bucket)
+{
+    _ASSERT(bucket < kBucketCount);
+    if ( bucket == kBucketCount-1 ) {
+        return kMax_Double;
+    }
+    return (Uint8(1) << bucket)*1e-6;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjMgrStatGroup
+/////////////////////////////////////////////////////////////////////////////
+
+
+CObjMgrStatGroup::CObjMgrStatGroup(const string& name)
+    : m_Name(name)
+{
+    for ( int i = 0; i < eCounter_Count; ++i ) {
+        m_Counters[i].store(0, memory_order_relaxed);
+    }
+}
+
+
+const char* CObjMgrStatGroup::GetCounterName(ECounter counter)
+{
+    static const char* const kNames[eCounter_Count] = {
+        "TSE loaded",
+        "TSE found",
+        "TSE not found",
+        "TSE evicted",
+        "chunks loaded",
+        "live TSE info"
+    };
+    _ASSERT(counter >= 0 && counter < eCounter_Count);
+    return kNames[counter];
+}
+
+
+const char* CObjMgrStatGroup::GetCallName(ECall call)
+{
+    static const char* const kNames[eCall_Count] = {
+        "GetRecords",
+        "GetBlobs",
+        "GetBlobById",
+        "GetAnnotRecords",
+        "GetIds",
+        "GetSequenceInfo",
+        "GetBulkInfo",
+        "GetChunk",
+        "GetChunks",
+        "LockWait"
+    };
+    _ASSERT(call >= 0 && call < eCall_Count);
+    return kNames[call];
+}
+
+
+void CObjMgrStatGroup::Print(CNcbiOstream& out, bool print_histograms) const
+{
+    out << m_Name << ":\n";
+    for ( int i = 0; i < eCounter_Count; ++i ) {
+        if ( Int8 value = GetCounter(ECounter(i)) ) {
+            out << "  " << GetCounterName(ECounter(i)) << ": "
+                << value << "\n";
+        }
+    }
+    for ( int i = 0; i < eCall_Count; ++i ) {
+        const CObjMgrStatHistogram& hist = GetCall(ECall(i));
+        Uint8 count = hist.GetCount();
+        if ( !count ) {
+            continue;
+        }
+        double time = hist.GetTotalTime();
+        out << "  " << GetCallName(ECall(i)) << ": " << count
+            << " calls in " << NStr::DoubleToString(time, 3) << " s ("
+            << NStr::DoubleToString(time*1000/count, 3) << " ms/one, max "
+            << NStr::DoubleToString(hist.GetMaxTime()*1000, 3) << " ms)\n";
+        if ( print_histograms ) {
+            for ( size_t b = 0; b < CObjMgrStatHistogram::kBucketCount; ++b ) {
+                if ( Uint8 c = hist.GetBucketCount(b) ) {
+                    out << "    ";
+                    if ( b == CObjMgrStatHistogram::kBucketCount-1 ) {
+                        out << ">= " << (Uint8(1) << (b-1));
+                    }
+                    else {
+                        out << "< " << (Uint8(1) << b);
+                    }
+                    out << " us: " << c << "\n";
+                }
+            }
+        }
+    }
+}
+
+
+void CObjMgrStatGroup::Reset(void)
+{
+    for ( int i = 0; i < eCounter_Count; ++i ) {
+        if ( i != eCounter_TSE_Info_Live ) {
+            m_Counters[i].store(0, memory_order_relaxed);
+        }
+    }
+    for ( int i = 0; i < eCall_Count; ++i ) {
+        m_Calls[i].Reset();
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjMgrStatistics
+/////////////////////////////////////////////////////////////////////////////
+
+
+DEFINE_STATIC_FAST_MUTEX(s_GroupsMutex);
+
+typedef map<string, CObjMgrStatGroup*> TStatGroupMap;
+
+static TStatGroupMap& s_GetGroupMap(void)
+{
+    // the groups are referenced by data sources and static objects,
+    // so they are never deleted
+    static TStatGroupMap* s_Groups = new TStatGroupMap;
+    return *s_Groups;
+}
+
+
+CObjMgrStatGroup& CObjMgrStatistics::GetGroup(const string& name)
+{
+    CFastMutexGuard guard(s_GroupsMutex);
+    CObjMgrStatGroup*& slot = s_GetGroupMap()[name];
+    if ( !slot ) {
+        slot = new CObjMgrStatGroup(name);
+    }
+    return *slot;
+}
+
+
+CObjMgrStatGroup& CObjMgrStatistics::GetObjMgrGroup(void)
+{
+    static CObjMgrStatGroup& s_Group = GetGroup("objmgr");
+    return s_Group;
+}
+
+
+CObjMgrStatistics::TGroups CObjMgrStatistics::GetGroups(void)
+{
+    TGroups groups;
+    CFastMutexGuard guard(s_GroupsMutex);
+    ITERATE ( TStatGroupMap, it, s_GetGroupMap() ) {
+        groups.push_back(it->second);
+    }
+    return groups;
+}
+
+
+void CObjMgrStatistics::Print(CNcbiOstream& out, bool print_histograms)
+{
+    TGroups groups = GetGroups();
+    ITERATE ( TGroups, it, groups ) {
+        (*it)->Print(out, print_histograms);
+    }
+}
+
+
+void CObjMgrStatistics::Reset(void)
+{
+    TGroups groups = GetGroups();
+    ITERATE ( TGroups, it, groups ) {
+        (*it)->Reset();
+    }
+}
+
+
+bool CObjMgrStatistics::IsPerfLogEnabled(void)
+{
+    static bool value =
+        NCBI_PARAM_TYPE(OBJMGR, STATISTICS_PERF_LOG)::GetDefault();
+    return value && CPerfLogger::IsON();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjMgrStatCallGuard
+/////////////////////////////////////////////////////////////////////////////
+
+
+CObjMgrStatCallGuard::CObjMgrStatCallGuard(CObjMgrStatGroup& group,
+                                           CObjMgrStatGroup::ECall call)
+    : m_Group(group),
+      m_Call(call),
+      m_Timer(CStopWatch::eStart),
+      m_UncaughtExceptions(0)
+{
+    if ( CObjMgrStatistics::IsPerfLogEnabled() ) {
+        m_PerfLogger.reset(new CPerfLogger(CPerfLogger::eStart));
+        m_UncaughtExceptions = std::uncaught_exceptions();
+    }
+}
+
+
+CObjMgrStatCallGuard::~CObjMgrStatCallGuard(void)
+{
+    m_Group.AddCall(m_Call, m_Timer.Elapsed());
+    if ( m_PerfLogger ) {
+        try {
+            bool failed = std::uncaught_exceptions() > m_UncaughtExceptions;
+            m_PerfLogger->Post(failed?
+                               CRequestStatus::e500_InternalServerError:
+                               CRequestStatus::e200_Ok,
+                               string("objmgr_")+
+                               CObjMgrStatGroup::GetCallName(m_Call))
+                .Print("loader", m_Group.GetName());
+        }
+        catch ( exception& ) {
+            // never throw from destructor
+        }
+    }
+}
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
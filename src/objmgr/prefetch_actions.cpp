@@ -34,6 +34,7 @@
 #include <objmgr/prefetch_actions.hpp>
 #include <objmgr/scope.hpp>
 #include <objmgr/impl/scope_impl.hpp>
+#include <objmgr/impl/tse_info.hpp>
 #include <objmgr/objmgr_exception.hpp>
 
 
@@ -96,6 +97,21 @@ bool CPrefetchBioseq::Execute(CRef<CPrefetchRequest> /*token*/)
 }
 
 
+size_t CPrefetchBioseq::GetResultMemory(void) const
+{
+    if ( !GetResult() ) {
+        return 0;
+    }
+    return GetResult().GetTSE_Handle().x_GetTSE_Info().GetEstimatedMemory();
+}
+
+
+void CPrefetchBioseq::ReleaseResult(void)
+{
+    m_Result.Reset();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CPrefetchFeat_CI
 
@@ -153,6 +169,21 @@ bool CPrefetchFeat_CI::Execute(CRef<CPrefetchRequest> token)
 }
 
 
+size_t CPrefetchFeat_CI::GetResultMemory(void) const
+{
+    // annotations are usually in the TSE of the Bioseq,
+    // there's no estimation for location based iteration
+    return CPrefetchBioseq::GetResultMemory();
+}
+
+
+void CPrefetchFeat_CI::ReleaseResult(void)
+{
+    m_Result = CFeat_CI();
+    CPrefetchBioseq::ReleaseResult();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CPrefetchComplete<CBioseq_Handle>
 
@@ -179,6 +210,13 @@ bool CPrefetchComplete<CBioseq_Handle>::Execute(CRef<CPrefetchRequest> token)
 }
 
 
+void CPrefetchComplete<CBioseq_Handle>::ReleaseResult(void)
+{
+    m_Result.Reset();
+    CPrefetchBioseq::ReleaseResult();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CStdPrefetch
 
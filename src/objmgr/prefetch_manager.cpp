@@ -47,6 +47,17 @@ IPrefetchAction::~IPrefetchAction(void)
 }
 
 
+size_t IPrefetchAction::GetResultMemory(void) const
+{
+    return 0;
+}
+
+
+void IPrefetchAction::ReleaseResult(void)
+{
+}
+
+
 IPrefetchActionSource::~IPrefetchActionSource(void)
 {
 }
@@ -133,7 +144,12 @@ CPrefetchSequence::CPrefetchSequence(CPrefetchManager& manager,
                                      IPrefetchActionSource* source,
                                      size_t active_size)
     : m_Manager(&manager),
-      m_Source(source)
+      m_Source(source),
+      m_MaxActive(active_size),
+      m_MaxMemory(0),
+      m_ReleaseConsumed(false),
+      m_ConsumedCount(0),
+      m_ConsumedMemory(0)
 {
     for ( size_t i = 0; i < active_size; ++i ) {
         EnqueNextAction();
@@ -141,12 +157,30 @@ CPrefetchSequence::CPrefetchSequence(CPrefetchManager& manager,
 }
 
 
+CPrefetchSequence::CPrefetchSequence(CPrefetchManager& manager,
+                                     IPrefetchActionSource* source,
+                                     size_t max_active,
+                                     size_t max_memory)
+    : m_Manager(&manager),
+      m_Source(source),
+      m_MaxActive(max(max_active, size_t(1))),
+      m_MaxMemory(max_memory),
+      m_ReleaseConsumed(true),
+      m_ConsumedCount(0),
+      m_ConsumedMemory(0)
+{
+    CMutexGuard guard(m_Mutex);
+    x_EnqueActions();
+}
+
+
 CPrefetchSequence::~CPrefetchSequence(void)
 {
     CMutexGuard guard(m_Mutex);
     ITERATE ( list< CRef<CPrefetchRequest> >, it, m_ActiveTokens ) {
         it->GetNCPointer()->RequestToCancel();
     }
+    x_ReleaseCurrentToken();
 }
 
 
@@ -164,11 +198,96 @@ void CPrefetchSequence::EnqueNextAction(void)
 }
 
 
+static void s_AddTokenMemory(const CPrefetchRequest& token,
+                             size_t& memory,
+                             size_t& completed,
+                             size_t& running)
+{
+    if ( !token.IsDone() ) {
+        ++running;
+    }
+    else if ( token.GetState() == SPrefetchTypes::eCompleted ) {
+        ++completed;
+        memory += token.GetAction()->GetResultMemory();
+    }
+}
+
+
+size_t CPrefetchSequence::x_GetPrefetchedMemory(size_t* completed_count,
+                                                size_t* running_count) const
+{
+    size_t memory = 0, completed = 0, running = 0;
+    if ( m_CurrentToken ) {
+        s_AddTokenMemory(*m_CurrentToken, memory, completed, running);
+    }
+    ITERATE ( list< CRef<CPrefetchRequest> >, it, m_ActiveTokens ) {
+        s_AddTokenMemory(**it, memory, completed, running);
+    }
+    if ( completed_count ) {
+        *completed_count = completed;
+    }
+    if ( running_count ) {
+        *running_count = running;
+    }
+    return memory;
+}
+
+
+void CPrefetchSequence::x_EnqueActions(void)
+{
+    while ( m_Source && m_ActiveTokens.size() < m_MaxActive ) {
+        if ( m_MaxMemory && !m_ActiveTokens.empty() ) {
+            // back-pressure: don't go further ahead of the consumer
+            // if the prefetched data are too big already
+            size_t completed, running;
+            size_t memory = x_GetPrefetchedMemory(&completed, &running);
+            if ( running ) {
+                // assume running actions will have average result size
+                size_t count = m_ConsumedCount + completed;
+                if ( !count ) {
+                    // no estimation yet, wait for the first result
+                    break;
+                }
+                memory += running*((m_ConsumedMemory + memory)/count);
+            }
+            if ( memory >= m_MaxMemory ) {
+                break;
+            }
+        }
+        EnqueNextAction();
+    }
+}
+
+
+void CPrefetchSequence::x_ReleaseCurrentToken(void)
+{
+    if ( !m_CurrentToken ) {
+        return;
+    }
+    CRef<CPrefetchRequest> token;
+    token.Swap(m_CurrentToken);
+    if ( token->GetState() == SPrefetchTypes::eCompleted ) {
+        ++m_ConsumedCount;
+        m_ConsumedMemory += token->GetAction()->GetResultMemory();
+        token->GetAction()->ReleaseResult();
+    }
+}
+
+
 CRef<CPrefetchRequest> CPrefetchSequence::GetNextToken(void)
 {
     CRef<CPrefetchRequest> ret;
     CMutexGuard guard(m_Mutex);
-    if ( !m_ActiveTokens.empty() ) {
+    if ( m_ReleaseConsumed ) {
+        x_ReleaseCurrentToken();
+        if ( !m_ActiveTokens.empty() ) {
+            ret = m_ActiveTokens.front();
+            m_ActiveTokens.pop_front();
+            m_CurrentToken = ret;
+        }
+        x_EnqueActions();
+    }
+    else if ( !m_ActiveTokens.empty() ) {
         EnqueNextAction();
         ret = m_ActiveTokens.front();
         m_ActiveTokens.pop_front();
@@ -177,5 +296,19 @@ CRef<CPrefetchRequest> CPrefetchSequence::GetNextToken(void)
 }
 
 
+size_t CPrefetchSequence::GetPrefetchedMemory(void) const
+{
+    CMutexGuard guard(m_Mutex);
+    return x_GetPrefetchedMemory();
+}
+
+
+size_t CPrefetchSequence::GetActiveCount(void) const
+{
+    CMutexGuard guard(m_Mutex);
+    return m_ActiveTokens.size();
+}
+
+
 END_SCOPE(objects)
 END_NCBI_SCOPE
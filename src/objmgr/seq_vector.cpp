@@ -1348,5 +1348,187 @@ void CSeqVector::SetNoAmbiguities(void)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CSeqVector_SpanCI
+/////////////////////////////////////////////////////////////////////////////
+
+
+CSeqVector_SpanCI::CSeqVector_SpanCI(void)
+    : m_Stop(0),
+      m_Pos(0),
+      m_Length(0),
+      m_DataCoding(CSeq_data::e_not_set),
+      m_Data(0),
+      m_DataOffset(0),
+      m_DataStrand(eNa_strand_plus)
+{
+}
+
+
+CSeqVector_SpanCI::CSeqVector_SpanCI(const CSeqVector& seq_vector,
+                                     TSeqPos start,
+                                     TSeqPos stop)
+    : m_Stop(min(stop, seq_vector.size())),
+      m_Pos(start),
+      m_Length(0),
+      m_DataCoding(CSeq_data::e_not_set),
+      m_Data(0),
+      m_DataOffset(0),
+      m_DataStrand(eNa_strand_plus)
+{
+    if ( m_Pos >= m_Stop ) {
+        return;
+    }
+    if ( seq_vector.m_TSE && !seq_vector.CanGetRange(m_Pos, m_Stop) ) {
+        NCBI_THROW_FMT(CSeqVectorException, eDataError,
+                       "CSeqVector_SpanCI: "
+                       "cannot get seq-data in range: "
+                       <<m_Pos<<"-"<<m_Stop);
+    }
+    SSeqMapSelector sel(CSeqMap::fDefaultFlags, kMax_UInt);
+    sel.SetStrand(seq_vector.m_Strand);
+    if ( seq_vector.m_TSE ) {
+        sel.SetLinkUsedTSE(seq_vector.m_TSE);
+    }
+    m_Seg = CSeqMap_CI(seq_vector.m_SeqMap,
+                       seq_vector.m_Scope.GetScopeOrNull(), sel, m_Pos);
+    x_Update();
+}
+
+
+CSeqVector_SpanCI::~CSeqVector_SpanCI(void)
+{
+}
+
+
+CSeqVector_SpanCI& CSeqVector_SpanCI::operator++(void)
+{
+    m_Pos += m_Length;
+    if ( m_Pos < m_Stop ) {
+        ++m_Seg;
+        x_Update();
+    }
+    else {
+        m_Length = 0;
+        m_Data = 0;
+    }
+    return *this;
+}
+
+
+template<class Container>
+static inline
+const char* s_GetSpanData(const Container& cont, size_t pos, size_t count,
+                          size_t residues_per_byte)
+{
+    size_t end = pos + count;
+    if ( end < pos ||
+         (end + residues_per_byte - 1) / residues_per_byte > cont.size() ) {
+        ThrowOutOfRangeSeq_inst(end);
+    }
+    return &cont[0] + pos / residues_per_byte;
+}
+
+
+void CSeqVector_SpanCI::x_Update(void)
+{
+    // skip 0 length segments
+    while ( m_Seg && m_Seg.GetEndPosition() <= m_Pos ) {
+        ++m_Seg;
+    }
+    if ( !m_Seg || m_Seg.GetPosition() > m_Pos ) {
+        NCBI_THROW_FMT(CSeqVectorException, eDataError,
+                       "CSeqVector_SpanCI: cannot locate segment at "<<m_Pos);
+    }
+    m_Length = min(m_Stop, m_Seg.GetEndPosition()) - m_Pos;
+    m_DataCoding = CSeq_data::e_not_set;
+    m_Data = 0;
+    m_DataOffset = 0;
+    m_DataStrand = eNa_strand_plus;
+
+    switch ( m_Seg.GetType() ) {
+    case CSeqMap::eSeqGap:
+        return;
+    case CSeqMap::eSeqData:
+        break;
+    default:
+        NCBI_THROW_FMT(CSeqVectorException, eDataError,
+                       "Invalid segment type: "<<m_Seg.GetType());
+    }
+
+    const CSeq_data& data = m_Seg.GetRefData();
+    if ( data.IsGap() ) {
+        return;
+    }
+    bool reverse = m_Seg.GetRefMinusStrand();
+    TSeqPos dataPos;
+    if ( reverse ) {
+        // Revert segment offset
+        dataPos = m_Seg.GetRefEndPosition() -
+            (m_Pos - m_Seg.GetPosition()) - m_Length;
+    }
+    else {
+        dataPos = m_Seg.GetRefPosition() + (m_Pos - m_Seg.GetPosition());
+    }
+
+    TCoding coding = data.Which();
+    switch ( coding ) {
+    case CSeq_data::e_Iupacna:
+        m_Data = s_GetSpanData(data.GetIupacna().Get(), dataPos, m_Length, 1);
+        break;
+    case CSeq_data::e_Iupacaa:
+        m_Data = s_GetSpanData(data.GetIupacaa().Get(), dataPos, m_Length, 1);
+        break;
+    case CSeq_data::e_Ncbi2na:
+        m_Data = s_GetSpanData(data.GetNcbi2na().Get(), dataPos, m_Length, 4);
+        m_DataOffset = dataPos % 4;
+        break;
+    case CSeq_data::e_Ncbi4na:
+        m_Data = s_GetSpanData(data.GetNcbi4na().Get(), dataPos, m_Length, 2);
+        m_DataOffset = dataPos % 2;
+        break;
+    case CSeq_data::e_Ncbi8na:
+        m_Data = s_GetSpanData(data.GetNcbi8na().Get(), dataPos, m_Length, 1);
+        break;
+    case CSeq_data::e_Ncbi8aa:
+        m_Data = s_GetSpanData(data.GetNcbi8aa().Get(), dataPos, m_Length, 1);
+        break;
+    case CSeq_data::e_Ncbieaa:
+        m_Data = s_GetSpanData(data.GetNcbieaa().Get(), dataPos, m_Length, 1);
+        break;
+    case CSeq_data::e_Ncbistdaa:
+        m_Data = s_GetSpanData(data.GetNcbistdaa().Get(),
+                               dataPos, m_Length, 1);
+        break;
+    case CSeq_data::e_Ncbipna:
+    case CSeq_data::e_Ncbipaa:
+        NCBI_THROW_FMT(CSeqVectorException, eCodingError,
+                       "CSeqVector_SpanCI: unsupported coding: "<<coding);
+    default:
+        NCBI_THROW_FMT(CSeqVectorException, eCodingError,
+                       "Invalid data coding: "<<coding);
+    }
+    m_DataCoding = coding;
+    if ( reverse ) {
+        m_DataStrand = eNa_strand_minus;
+    }
+}
+
+
+size_t CSeqVector_SpanCI::GetDataSize(void) const
+{
+    switch ( m_DataCoding ) {
+    case CSeq_data::e_not_set:
+        return 0;
+    case CSeq_data::e_Ncbi2na:
+        return (m_DataOffset + m_Length + 3) / 4;
+    case CSeq_data::e_Ncbi4na:
+        return (m_DataOffset + m_Length + 1) / 2;
+    default:
+        return m_Length;
+    }
+}
+
+
 END_SCOPE(objects)
 END_NCBI_SCOPE
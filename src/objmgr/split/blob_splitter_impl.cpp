@@ -48,6 +48,10 @@
 #include <objmgr/object_manager.hpp>
 #include <objects/seq/Seqdesc.hpp>
 #include <objects/seqset/Seq_entry.hpp>
+#include <serial/iterator.hpp>
+#include <corelib/ncbithr.hpp>
+#include <atomic>
+#include <exception>
 
 
 #define NCBI_USE_ERRCODE_X   ObjMgr_BlobSplit
@@ -95,6 +99,9 @@ bool CBlobSplitterImpl::Split(const CSeq_entry& entry)
     m_Scope = new CScope(*CObjectManager::GetInstance());
     m_Scope->AddTopLevelSeqEntry(entry);
 
+    // estimate annotation sizes in advance, possibly in parallel threads
+    CollectAnnotSizes(entry);
+
     // copying skeleton while stripping annotations
     CopySkeleton(*m_Skeleton, entry);
 
@@ -136,6 +143,129 @@ bool CBlobSplitterImpl::Split(const CSeq_entry& entry)
 }
 
 
+namespace {
+
+    struct SAnnotSizesTasks
+    {
+        typedef vector<const CSeq_annot*> TAnnots;
+        typedef vector<CSeq_annot_SplitInfo::SSizes> TSizes;
+
+        SAnnotSizesTasks(const SSplitterParams& params,
+                         const TAnnots& annots)
+            : m_Params(params),
+              m_Annots(annots),
+              m_Sizes(annots.size()),
+              m_NextTask(0)
+            {
+            }
+
+        void Process(void)
+            {
+                // each thread serializes and compresses with its own sizer
+                CAsnSizer sizer;
+                for ( ;; ) {
+                    size_t index = m_NextTask.fetch_add(1);
+                    if ( index >= m_Annots.size() ) {
+                        break;
+                    }
+                    try {
+                        CSeq_annot_SplitInfo::CalcSizes(m_Sizes[index],
+                                                        *m_Annots[index],
+                                                        m_Params, sizer);
+                    }
+                    catch ( ... ) {
+                        CFastMutexGuard guard(m_ErrorMutex);
+                        if ( !m_Error ) {
+                            m_Error = current_exception();
+                        }
+                    }
+                }
+            }
+
+        const SSplitterParams& m_Params;
+        const TAnnots& m_Annots;
+        TSizes m_Sizes;
+        atomic<size_t> m_NextTask;
+        CFastMutex m_ErrorMutex;
+        exception_ptr m_Error;
+    };
+
+
+#if defined(NCBI_THREADS)
+    class CAnnotSizesThread : public CThread
+    {
+    public:
+        explicit CAnnotSizesThread(SAnnotSizesTasks& tasks)
+            : m_Tasks(tasks)
+            {
+            }
+
+    protected:
+        virtual void* Main(void)
+            {
+                m_Tasks.Process();
+                return 0;
+            }
+
+    private:
+        SAnnotSizesTasks& m_Tasks;
+    };
+#endif
+}
+
+
+void CBlobSplitterImpl::CollectAnnotSizes(const CSeq_entry& entry)
+{
+    m_AnnotSizes.clear();
+#if defined(NCBI_THREADS)
+    if ( m_Params.m_ThreadCount <= 1 ) {
+        // sizes will be calculated while copying skeleton
+        return;
+    }
+
+    SAnnotSizesTasks::TAnnots annots;
+    for ( CTypeConstIterator<CSeq_annot> it(ConstBegin(entry)); it; ++it ) {
+        if ( CanSplitAnnot(*it) ) {
+            annots.push_back(&*it);
+        }
+    }
+    size_t thread_count = min(size_t(m_Params.m_ThreadCount), annots.size());
+    if ( thread_count <= 1 ) {
+        return;
+    }
+
+    SAnnotSizesTasks tasks(m_Params, annots);
+    vector< CRef<CAnnotSizesThread> > threads;
+    for ( size_t i = 1; i < thread_count; ++i ) {
+        CRef<CAnnotSizesThread> thr(new CAnnotSizesThread(tasks));
+        if ( !thr->Run() ) {
+            break;
+        }
+        threads.push_back(thr);
+    }
+    // the current thread works too
+    tasks.Process();
+    NON_CONST_ITERATE ( vector< CRef<CAnnotSizesThread> >, it, threads ) {
+        (*it)->Join();
+    }
+    if ( tasks.m_Error ) {
+        rethrow_exception(tasks.m_Error);
+    }
+    for ( size_t i = 0; i < annots.size(); ++i ) {
+        swap(m_AnnotSizes[ConstRef(annots[i])], tasks.m_Sizes[i]);
+    }
+#endif
+}
+
+
+const CSeq_annot_SplitInfo::SSizes*
+CBlobSplitterImpl::GetAnnotSizes(const CSeq_annot& annot) const
+{
+    TAnnotSizes::const_iterator it = m_AnnotSizes.find(ConstRef(&annot));
+    return it == m_AnnotSizes.end()? 0: &it->second;
+}
+
+
 void CBlobSplitterImpl::CollectPieces(void)
 {
     // Collect annotation pieces and strip skeleton annotations
@@ -104,6 +104,7 @@ void CBlobSplitterImpl::Reset(void)
     m_Skeleton.Reset(new CSeq_entry);
     m_NextBioseq_set_Id = 1;
     m_Entries.clear();
+    m_AnnotSizes.clear();
     m_Pieces.clear();
     m_Chunks.clear();
     m_Scope.Reset();
@@ -55,7 +55,8 @@ SSplitterParams::SSplitterParams(void)
       m_DisableSplitAssembly(DISABLE_SPLIT_ASSEMBLY),
       m_JoinSmallChunks(false),
       m_SplitWholeBioseqs(true),
-      m_SplitNonFeatureSeqTables(kDefaultSplitNonFeatureSeqTables)
+      m_SplitNonFeatureSeqTables(kDefaultSplitNonFeatureSeqTables),
+      m_ThreadCount(1)
 {
     SetChunkSize(kDefaultChunkSize);
 }
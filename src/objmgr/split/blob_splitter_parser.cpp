@@ -631,8 +631,7 @@ bool CBlobSplitterImpl::CopySequence(CPlace_SplitInfo& place_info,
 }
 
 
-bool CBlobSplitterImpl::CopyAnnot(CPlace_SplitInfo& place_info,
-                                  const CSeq_annot& annot)
+bool CBlobSplitterImpl::CanSplitAnnot(const CSeq_annot& annot) const
 {
     if ( m_Params.m_DisableSplitAnnotations ) {
         return false;
@@ -642,18 +641,24 @@ bool CBlobSplitterImpl::CopyAnnot(CPlace_SplitInfo& place_info,
     case CSeq_annot::TData::e_Ftable:
     case CSeq_annot::TData::e_Align:
     case CSeq_annot::TData::e_Graph:
-        break;
+        return true;
     case CSeq_annot::TData::e_Seq_table:
-        if ( m_Params.m_SplitNonFeatureSeqTables ||
-             CSeqTableInfo::IsGoodFeatTable(annot.GetData().GetSeq_table()) ) {
-            break;
-        }
-        // splitting non-feature Seq-tables is disabled
-        return false;
+        // splitting non-feature Seq-tables may be disabled
+        return m_Params.m_SplitNonFeatureSeqTables ||
+            CSeqTableInfo::IsGoodFeatTable(annot.GetData().GetSeq_table());
     default:
         // we don't split other types of Seq-annot
         return false;
     }
+}
+
+
+bool CBlobSplitterImpl::CopyAnnot(CPlace_SplitInfo& place_info,
+                                  const CSeq_annot& annot)
+{
+    if ( !CanSplitAnnot(annot) ) {
+        return false;
+    }
 
     CSeq_annot_SplitInfo& info = place_info.m_Annots[ConstRef(&annot)];
     info.SetSeq_annot(annot, m_Params, *this);
@@ -49,6 +49,7 @@
 #include <objmgr/annot_selector.hpp>
 
 #include <objmgr/split/asn_sizer.hpp>
+#include <objmgr/split/blob_splitter_impl.hpp>
 
 #define NCBI_USE_ERRCODE_X   ObjMgr_ObjSplitInfo
 
@@ -278,40 +279,84 @@ int CSeq_annot_SplitInfo::Compare(const CSeq_annot_SplitInfo& other) const
 }
 
 
+void CSeq_annot_SplitInfo::CalcSizes(SSizes& sizes,
+                                     const CSeq_annot& annot,
+                                     const SSplitterParams& params,
+                                     CAsnSizer& sizer)
+{
+    sizer.Set(annot, params);
+    sizes.m_Size = CSize(sizer);
+    sizes.m_ObjectSizes.clear();
+
+    auto ratio = sizes.m_Size.GetExactRatio();
+    switch ( annot.GetData().Which() ) {
+    case CSeq_annot::TData::e_Ftable:
+        ITERATE(CSeq_annot::C_Data::TFtable, it, annot.GetData().GetFtable()) {
+            sizes.m_ObjectSizes.push_back(CSize(sizer.GetAsnSize(**it), ratio));
+        }
+        break;
+    case CSeq_annot::TData::e_Align:
+        ITERATE(CSeq_annot::C_Data::TAlign, it, annot.GetData().GetAlign()) {
+            sizes.m_ObjectSizes.push_back(CSize(sizer.GetAsnSize(**it), ratio));
+        }
+        break;
+    case CSeq_annot::TData::e_Graph:
+        ITERATE(CSeq_annot::C_Data::TGraph, it, annot.GetData().GetGraph()) {
+            sizes.m_ObjectSizes.push_back(CSize(sizer.GetAsnSize(**it), ratio));
+        }
+        break;
+    case CSeq_annot::TData::e_Seq_table:
+        sizes.m_ObjectSizes.push_back
+            (CSize(sizer.GetAsnSize(annot.GetData().GetSeq_table()), ratio));
+        break;
+    default:
+        _ASSERT("bad annot type" && 0);
+    }
+}
+
+
 void CSeq_annot_SplitInfo::SetSeq_annot(const CSeq_annot& annot,
                                         const SSplitterParams& params,
                                         const CBlobSplitterImpl& impl)
 {
-    s_Sizer->Set(annot, params);
-    m_Size = CSize(*s_Sizer);
+    // use sizes estimated in advance if any
+    SSizes local_sizes;
+    const SSizes* sizes = impl.GetAnnotSizes(annot);
+    if ( !sizes ) {
+        CalcSizes(local_sizes, annot, params, *s_Sizer);
+        sizes = &local_sizes;
+    }
+    m_Size = sizes->m_Size;
 
-    auto ratio = m_Size.GetExactRatio();
     _ASSERT(!m_Src_annot);
     m_Src_annot.Reset(&annot);
     _ASSERT(!m_Name.IsNamed());
     m_Name = GetName(annot);
+    SSizes::TObjectSizes::const_iterator size = sizes->m_ObjectSizes.begin();
     switch ( annot.GetData().Which() ) {
     case CSeq_annot::TData::e_Ftable:
         ITERATE(CSeq_annot::C_Data::TFtable, it, annot.GetData().GetFtable()) {
-            Add(CAnnotObject_SplitInfo(**it, impl, ratio));
+            Add(CAnnotObject_SplitInfo(**it, impl, *size++));
         }
         break;
     case CSeq_annot::TData::e_Align:
         ITERATE(CSeq_annot::C_Data::TAlign, it, annot.GetData().GetAlign()) {
-            Add(CAnnotObject_SplitInfo(**it, impl, ratio));
+            Add(CAnnotObject_SplitInfo(**it, impl, *size++));
         }
         break;
     case CSeq_annot::TData::e_Graph:
         ITERATE(CSeq_annot::C_Data::TGraph, it, annot.GetData().GetGraph()) {
-            Add(CAnnotObject_SplitInfo(**it, impl, ratio));
+            Add(CAnnotObject_SplitInfo(**it, impl, *size++));
         }
         break;
     case CSeq_annot::TData::e_Seq_table:
-        Add(CAnnotObject_SplitInfo(annot.GetData().GetSeq_table(), impl, ratio));
+        Add(CAnnotObject_SplitInfo(annot.GetData().GetSeq_table(), impl,
+                                   *size++));
         break;
     default:
         _ASSERT("bad annot type" && 0);
     }
+    _ASSERT(size == sizes->m_ObjectSizes.end());
     if ( m_Name.IsNamed() ) {
         // named annotation should have at most regular priority
         m_NamePriority = max(m_TopPriority,
@@ -371,10 +416,10 @@ CNcbiOstream& CSeq_annot_SplitInfo::Print(CNcbiOstream& out) const
 
 CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_feat& obj,
                                                const CBlobSplitterImpl& impl,
-                                               CSize::TSizeRatio ratio)
+                                               const CSize& size)
     : m_ObjectType(CSeq_annot::C_Data::e_Ftable),
       m_Object(&obj),
-      m_Size(s_Sizer->GetAsnSize(obj), ratio)
+      m_Size(size)
 {
     m_Location.Add(obj, impl);
 }
@@ -382,10 +427,10 @@ CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_feat& obj,
 
 CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_graph& obj,
                                                const CBlobSplitterImpl& impl,
-                                               CSize::TSizeRatio ratio)
+                                               const CSize& size)
     : m_ObjectType(CSeq_annot::C_Data::e_Graph),
       m_Object(&obj),
-      m_Size(s_Sizer->GetAsnSize(obj), ratio)
+      m_Size(size)
 {
     m_Location.Add(obj, impl);
 }
@@ -393,10 +438,10 @@ CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_graph& obj,
 
 CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_align& obj,
                                                const CBlobSplitterImpl& impl,
-                                               CSize::TSizeRatio ratio)
+                                               const CSize& size)
     : m_ObjectType(CSeq_annot::C_Data::e_Align),
       m_Object(&obj),
-      m_Size(s_Sizer->GetAsnSize(obj), ratio)
+      m_Size(size)
 {
     m_Location.Add(obj, impl);
 }
@@ -404,10 +449,10 @@ CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_align& obj,
 
 CAnnotObject_SplitInfo::CAnnotObject_SplitInfo(const CSeq_table& obj,
                                                const CBlobSplitterImpl& impl,
-                                               CSize::TSizeRatio ratio)
+                                               const CSize& size)
     : m_ObjectType(CSeq_annot::C_Data::e_Seq_table),
       m_Object(&obj),
-      m_Size(s_Sizer->GetAsnSize(obj), ratio)
+      m_Size(size)
 {
     m_Location.Add(obj, impl);
 }
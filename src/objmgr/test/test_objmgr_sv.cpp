@@ -46,6 +46,7 @@
 #include <objmgr/seq_vector.hpp>
 
 #include <objects/seq/seq__.hpp>
+#include <objects/seq/seqport_util.hpp>
 #include <objects/seqloc/seqloc__.hpp>
 
 #include <vector>
@@ -327,6 +328,40 @@ static string Pack(const string& s, CSeq_data::E_Choice coding)
 }
 
 
+// Decode the raw spans of the interval into iupacna
+static string SpansToIupacna(const CSeqVector& sv,
+                             TSeqPos start, TSeqPos stop)
+{
+    string ret;
+    for ( CSeqVector_SpanCI it(sv, start, stop); it; ++it ) {
+        _ASSERT(it.GetPos() == start + ret.size());
+        if ( it.IsInGap() ) {
+            ret.append(it.GetLength(), 'N');
+            continue;
+        }
+        const char* data = it.GetData();
+        CRef<CSeq_data> raw;
+        if ( it.GetCoding() == CSeq_data::e_Iupacna ) {
+            raw = new CSeq_data(string(data, it.GetDataSize()),
+                                it.GetCoding());
+        }
+        else {
+            raw = new CSeq_data(vector<char>(data, data+it.GetDataSize()),
+                                it.GetCoding());
+        }
+        CSeq_data iupacna;
+        CSeqportUtil::Convert(*raw, &iupacna, CSeq_data::e_Iupacna,
+                              it.GetDataOffset(), it.GetLength());
+        if ( it.GetStrand() == eNa_strand_minus ) {
+            CSeqportUtil::ReverseComplement(&iupacna, 0, it.GetLength());
+        }
+        ret += iupacna.GetIupacna().Get();
+    }
+    _ASSERT(ret.size() == stop - start);
+    return ret;
+}
+
+
 int CTestApp::Run(void)
 {
     SetDiagPostFlag(eDPF_All);
@@ -473,6 +508,13 @@ int CTestApp::Run(void)
             const string& ref = ss[key];
             _ASSERT(ref.size() == main.GetBioseqLength());
             _ASSERT(equal(data.begin(), data.end(), ref.begin()+start));
+            if ( !protein ) {
+                const string& iupac_ref =
+                    ss[GetKey(CBioseq_Handle::eCoding_Iupac, strand,
+                              false, 0)];
+                _ASSERT(SpansToIupacna(sv, start, stop) ==
+                        iupac_ref.substr(start, stop-start));
+            }
             if ( !ncbi2na || randomize_ncbi2na_seed ) {
                 string packed;
                 sv.GetPackedSeqData(packed, start, stop);
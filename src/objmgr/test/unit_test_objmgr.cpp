@@ -45,7 +45,16 @@
 #include <objmgr/graph_ci.hpp>
 #include <objmgr/seq_table_ci.hpp>
 #include <objmgr/annot_ci.hpp>
+#include <objmgr/objmgr_statistics.hpp>
+#include <objmgr/prefetch_manager.hpp>
+#include <objmgr/prefetch_actions.hpp>
 #include <objmgr/impl/synonyms.hpp>
+#include <objmgr/impl/tse_info.hpp>
+#include <objmgr/impl/data_source.hpp>
+#include <objmgr/impl/tse_loadlock.hpp>
+#include <objmgr/impl/tse_split_info.hpp>
+#include <objmgr/impl/tse_chunk_info.hpp>
+#include <objmgr/data_loader.hpp>
 
 #include <objects/general/general__.hpp>
 #include <objects/seqfeat/seqfeat__.hpp>
@@ -1259,3 +1268,490 @@ BOOST_AUTO_TEST_CASE(AddSeqIdHistory)
     }}
     SetDiagPostLevel(old_level);
 }
+
+
+BOOST_AUTO_TEST_CASE(TestEstimateObjectMemory)
+{
+    CRef<CSeq_id> id = s_GetId(1);
+    size_t entry_size =
+        CTSE_Info::EstimateObjectMemory(*s_GetEntry(1, 10));
+    size_t long_entry_size =
+        CTSE_Info::EstimateObjectMemory(*s_GetEntry(1, 100000));
+    BOOST_CHECK(entry_size > sizeof(CSeq_entry)+sizeof(CBioseq));
+    BOOST_CHECK(long_entry_size >= entry_size + 100000 - 10);
+
+    size_t annot_size = CTSE_Info::EstimateObjectMemory(*s_GetAnnot(*id, 1));
+    size_t big_annot_size =
+        CTSE_Info::EstimateObjectMemory(*s_GetAnnot(*id, 100));
+    BOOST_CHECK(annot_size > sizeof(CSeq_annot)+sizeof(CSeq_feat));
+    BOOST_CHECK(big_annot_size > 99*sizeof(CSeq_feat) + annot_size);
+}
+
+
+class CMemoryLimitTestLoader : public CDataLoader
+{
+public:
+    struct SParams {
+        size_t  m_MemoryLimit;
+        TSeqPos m_Length;
+    };
+    typedef SRegisterLoaderInfo<CMemoryLimitTestLoader> TRegisterLoaderInfo;
+
+    static TRegisterLoaderInfo RegisterInObjectManager(CObjectManager& om,
+                                                       const SParams& params)
+        {
+            CParamLoaderMaker<CMemoryLimitTestLoader, SParams> maker(params);
+            CDataLoader::RegisterInObjectManager(om, maker,
+                                                 CObjectManager::eNonDefault,
+                                                 CObjectManager::kPriority_Default);
+            return maker.GetRegisterInfo();
+        }
+    static string GetLoaderNameFromArgs(const SParams& /*params*/)
+        {
+            return "MemoryLimitTestLoader";
+        }
+
+    CMemoryLimitTestLoader(const string& name, const SParams& params)
+        : CDataLoader(name), m_Params(params)
+        {
+        }
+
+    // every blob contains one Bioseq, gi N is in the blob N
+    virtual TTSE_LockSet GetRecords(const CSeq_id_Handle& idh,
+                                    EChoice /*choice*/)
+        {
+            TTSE_LockSet locks;
+            if ( !idh.IsGi() ) {
+                return locks;
+            }
+            int gi = int(GI_TO(TIntId, idh.GetGi()));
+            CTSE_LoadLock lock =
+                GetDataSource()->GetTSE_LoadLock(TBlobId(new CBlobIdInt(gi)));
+            if ( !lock.IsLoaded() ) {
+                lock->SetSeq_entry(*s_GetEntry(gi-1, m_Params.m_Length));
+                lock.SetLoaded();
+            }
+            locks.insert(lock);
+            return locks;
+        }
+    virtual size_t GetDefaultBlobCacheMemoryLimit(void) const
+        {
+            return m_Params.m_MemoryLimit;
+        }
+
+private:
+    SParams m_Params;
+};
+
+
+BOOST_AUTO_TEST_CASE(TestBlobCacheMemoryLimit)
+{
+    const TSeqPos kLength = 10000;
+    const size_t kBlobCount = 20;
+    const size_t kMemoryLimit = 5*kLength;
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    CMemoryLimitTestLoader::SParams params = { kMemoryLimit, kLength };
+    CDataLoader* loader =
+        CMemoryLimitTestLoader::RegisterInObjectManager(*om, params)
+        .GetLoader();
+    {{
+        CScope scope(*om);
+        scope.AddDataLoader(loader->GetName());
+        for ( size_t i = 0; i < kBlobCount; ++i ) {
+            CBioseq_Handle bh = scope.GetBioseqHandle(*s_GetId(100+i));
+            BOOST_REQUIRE(bh);
+            BOOST_CHECK_EQUAL(bh.GetBioseqLength(), kLength);
+            bh.Reset();
+            // unlocked blob goes to the loader's cache
+            scope.ResetHistory();
+        }
+    }}
+    CDataLoader::SBlobCacheStatistics stat =
+        loader->GetBlobCacheStatistics();
+    BOOST_CHECK_EQUAL(stat.m_MemoryLimit, kMemoryLimit);
+    BOOST_CHECK(stat.m_Memory <= kMemoryLimit);
+    BOOST_CHECK(stat.m_Blobs > 0);
+    BOOST_CHECK(stat.m_Blobs < kBlobCount);
+    BOOST_CHECK_EQUAL(stat.m_Blobs + stat.m_EvictedBlobs, kBlobCount);
+    BOOST_CHECK(stat.m_EvictedMemory >= stat.m_EvictedBlobs*kLength);
+    om->RevokeDataLoader(*loader);
+}
+
+
+// Loader of one split blob, each chunk contains kFeatCount features
+// on gi kSplitGi in its own range of the sequence.
+class CSplitTestLoader : public CDataLoader
+{
+public:
+    static constexpr int     kSplitGi     = 7000;
+    static constexpr int     kChunkCount  = 4;
+    static constexpr size_t  kFeatCount   = 2000;
+    static constexpr TSeqPos kFeatStep    = 5;
+    static constexpr TSeqPos kFeatLength  = 10;
+    static constexpr TSeqPos kChunkLength = kFeatCount*kFeatStep + kFeatLength;
+
+    typedef SRegisterLoaderInfo<CSplitTestLoader> TRegisterLoaderInfo;
+
+    static TRegisterLoaderInfo RegisterInObjectManager(CObjectManager& om)
+        {
+            CSimpleLoaderMaker<CSplitTestLoader> maker;
+            CDataLoader::RegisterInObjectManager(om, maker,
+                                                 CObjectManager::eNonDefault,
+                                                 CObjectManager::kPriority_Default);
+            return maker.GetRegisterInfo();
+        }
+    static string GetLoaderNameFromArgs(void)
+        {
+            return "SplitTestLoader";
+        }
+
+    CSplitTestLoader(const string& name)
+        : CDataLoader(name), m_LoadedChunks(0), m_BulkLoadedChunks(0)
+        {
+        }
+
+    static CRange<TSeqPos> GetFeatRange(int chunk_id, size_t i)
+        {
+            TSeqPos from = chunk_id*kChunkLength + TSeqPos(i)*kFeatStep;
+            return CRange<TSeqPos>(from, from + kFeatLength - 1);
+        }
+
+    virtual TTSE_LockSet GetRecords(const CSeq_id_Handle& idh,
+                                    EChoice /*choice*/)
+        {
+            TTSE_LockSet locks;
+            if ( !idh.IsGi() || idh.GetGi() != GI_FROM(int, kSplitGi) ) {
+                return locks;
+            }
+            CTSE_LoadLock lock =
+                GetDataSource()->GetTSE_LoadLock(TBlobId(new CBlobIdInt(kSplitGi)));
+            if ( !lock.IsLoaded() ) {
+                CRef<CSeq_entry> entry(new CSeq_entry);
+                entry->SetSet().SetId().SetId(0);
+                entry->SetSet().SetSeq_set()
+                    .push_back(s_GetEntry(kSplitGi-1, kChunkCount*kChunkLength));
+                lock->SetSeq_entry(*entry);
+                CTSE_Split_Info& split_info = lock->GetSplitInfo();
+                for ( int chunk_id = 0; chunk_id < kChunkCount; ++chunk_id ) {
+                    CRef<CTSE_Chunk_Info> chunk(new CTSE_Chunk_Info(chunk_id));
+                    chunk->x_AddAnnotPlace(0);
+                    chunk->x_AddAnnotType(CAnnotName(),
+                                          SAnnotTypeSelector(CSeq_annot::C_Data::e_Ftable),
+                                          idh,
+                                          GetFeatRange(chunk_id, 0)
+                                          .CombinationWith(GetFeatRange(chunk_id, kFeatCount-1)));
+                    split_info.AddChunk(*chunk);
+                }
+                lock.SetLoaded();
+            }
+            locks.insert(lock);
+            return locks;
+        }
+    virtual void GetChunk(TChunk chunk_info)
+        {
+            CRef<CSeq_id> id = s_GetId(kSplitGi-1);
+            CRef<CSeq_annot> annot(new CSeq_annot);
+            for ( size_t i = 0; i < kFeatCount; ++i ) {
+                CRef<CSeq_feat> feat(new CSeq_feat);
+                CRange<TSeqPos> range = GetFeatRange(chunk_info->GetChunkId(), i);
+                feat->SetLocation().SetInt().SetId(*id);
+                feat->SetLocation().SetInt().SetFrom(range.GetFrom());
+                feat->SetLocation().SetInt().SetTo(range.GetTo());
+                feat->SetData().SetRegion("test");
+                annot->SetData().SetFtable().push_back(feat);
+            }
+            CTSE_Chunk_Info::TPlace place;
+            place.second = 0;
+            chunk_info->x_LoadAnnot(place, *annot);
+            chunk_info->SetLoaded();
+            ++m_LoadedChunks;
+        }
+    virtual void GetChunks(const TChunkSet& chunks)
+        {
+            m_BulkLoadedChunks += int(chunks.size());
+            CDataLoader::GetChunks(chunks);
+        }
+
+    atomic<int> m_LoadedChunks;
+    // chunks requested by GetChunks(), as the prefetching does
+    atomic<int> m_BulkLoadedChunks;
+};
+
+
+static size_t s_CountSplitFeats(CBioseq_Handle bh, TSeqPos from, TSeqPos to)
+{
+    size_t count = 0;
+    for ( CFeat_CI it(bh, CRange<TSeqPos>(from, to)); it; ++it ) {
+        ++count;
+    }
+    return count;
+}
+
+
+static size_t s_ExpectedSplitFeats(int loaded_chunks, TSeqPos from, TSeqPos to)
+{
+    size_t count = 0;
+    for ( int chunk_id = 0; chunk_id < loaded_chunks; ++chunk_id ) {
+        for ( size_t i = 0; i < CSplitTestLoader::kFeatCount; ++i ) {
+            if ( CSplitTestLoader::GetFeatRange(chunk_id, i)
+                 .IntersectingWith(CRange<TSeqPos>(from, to)) ) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSplitAnnotIndex)
+{
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    CSplitTestLoader* loader =
+        CSplitTestLoader::RegisterInObjectManager(*om).GetLoader();
+    const TSeqPos kChunkLength = CSplitTestLoader::kChunkLength;
+    {{
+        CScope scope(*om);
+        scope.AddDataLoader(loader->GetName());
+        CBioseq_Handle bh =
+            scope.GetBioseqHandle(*s_GetId(CSplitTestLoader::kSplitGi-1));
+        BOOST_REQUIRE(bh);
+        BOOST_CHECK_EQUAL(loader->m_LoadedChunks.load(), 0);
+        // load chunks one by one, the index has more than the default
+        // OBJMGR/STATIC_ANNOT_INDEX_SIZE objects after the third one
+        for ( int chunk_id = 0; chunk_id < CSplitTestLoader::kChunkCount;
+              ++chunk_id ) {
+            TSeqPos from = chunk_id*kChunkLength + kChunkLength/3;
+            TSeqPos to = chunk_id*kChunkLength + kChunkLength/2;
+            BOOST_CHECK_EQUAL(s_CountSplitFeats(bh, from, to),
+                              s_ExpectedSplitFeats(chunk_id+1, from, to));
+            BOOST_CHECK_EQUAL(loader->m_LoadedChunks.load(), chunk_id+1);
+            // ranges of all the loaded chunks, crossing chunk boundaries
+            for ( int i = 0; i < chunk_id; ++i ) {
+                from = i*kChunkLength + kChunkLength - 100;
+                to = (i+1)*kChunkLength + 100;
+                BOOST_CHECK_EQUAL(s_CountSplitFeats(bh, from, to),
+                                  s_ExpectedSplitFeats(chunk_id+1, from, to));
+            }
+        }
+        TSeqPos length = bh.GetBioseqLength();
+        BOOST_CHECK_EQUAL(s_CountSplitFeats(bh, 0, length-1),
+                          CSplitTestLoader::kChunkCount*
+                          CSplitTestLoader::kFeatCount);
+        BOOST_CHECK_EQUAL(s_CountSplitFeats(bh, length/2, length/2),
+                          s_ExpectedSplitFeats(CSplitTestLoader::kChunkCount,
+                                               length/2, length/2));
+    }}
+    om->RevokeDataLoader(*loader);
+}
+
+
+static vector< CRange<TSeqPos> > s_GetSplitFeats(CSplitTestLoader* loader,
+                                                 TSeqPos from, TSeqPos to,
+                                                 const SAnnotSelector& sel)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    scope.AddDataLoader(loader->GetName());
+    CBioseq_Handle bh =
+        scope.GetBioseqHandle(*s_GetId(CSplitTestLoader::kSplitGi-1));
+    BOOST_REQUIRE(bh);
+    BOOST_CHECK_EQUAL(loader->m_LoadedChunks.load(), 0);
+    vector< CRange<TSeqPos> > feats;
+    CFeat_CI it(bh, CRange<TSeqPos>(from, to), sel);
+    // all the chunks are loaded by the iterator constructor
+    int loaded_chunks = loader->m_LoadedChunks.load();
+    for ( ; it; ++it ) {
+        feats.push_back(it->GetLocation().GetTotalRange());
+    }
+    BOOST_CHECK_EQUAL(loader->m_LoadedChunks.load(), loaded_chunks);
+    return feats;
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSplitPrefetchChunks)
+{
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    const TSeqPos kChunkLength = CSplitTestLoader::kChunkLength;
+    // from the middle of the second chunk to the middle of the third one
+    TSeqPos from = kChunkLength + kChunkLength/2;
+    TSeqPos to = 2*kChunkLength + kChunkLength/2;
+
+    // with a size limit the search loads chunks one by one,
+    // while the prefetch pass loads them all in a bulk request
+    SAnnotSelector sel;
+    sel.SetMaxSize(kMax_Int);
+
+    // each search gets its own loader, so no chunk is loaded beforehand
+    CSplitTestLoader* loader =
+        CSplitTestLoader::RegisterInObjectManager(*om).GetLoader();
+    vector< CRange<TSeqPos> > plain_feats =
+        s_GetSplitFeats(loader, from, to, sel);
+    BOOST_CHECK_EQUAL(loader->m_LoadedChunks.load(), 2);
+    BOOST_CHECK_EQUAL(loader->m_BulkLoadedChunks.load(), 0);
+    om->RevokeDataLoader(*loader);
+
+    loader = CSplitTestLoader::RegisterInObjectManager(*om).GetLoader();
+    sel.SetPrefetchChunks();
+    vector< CRange<TSeqPos> > prefetch_feats =
+        s_GetSplitFeats(loader, from, to, sel);
+    // both chunks are loaded by the prefetch pass, in a bulk request
+    BOOST_CHECK_EQUAL(loader->m_LoadedChunks.load(), 2);
+    BOOST_CHECK_EQUAL(loader->m_BulkLoadedChunks.load(), 2);
+    om->RevokeDataLoader(*loader);
+
+    BOOST_CHECK_EQUAL(plain_feats.size(), s_ExpectedSplitFeats(3, from, to));
+    BOOST_CHECK(prefetch_feats == plain_feats);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestStatisticsHistogram)
+{
+    CObjMgrStatGroup group("test");
+    group.AddCall(CObjMgrStatGroup::eCall_GetRecords, 0);
+    group.AddCall(CObjMgrStatGroup::eCall_GetRecords, 3e-6);
+    group.AddCall(CObjMgrStatGroup::eCall_GetRecords, 1e6);
+    const CObjMgrStatHistogram& hist =
+        group.GetCall(CObjMgrStatGroup::eCall_GetRecords);
+    BOOST_CHECK_EQUAL(hist.GetCount(), 3u);
+    BOOST_CHECK_EQUAL(hist.GetBucketCount(0), 1u);
+    BOOST_CHECK_EQUAL(hist.GetBucketCount(2), 1u);
+    BOOST_CHECK_EQUAL(
+        hist.GetBucketCount(CObjMgrStatHistogram::kBucketCount-1), 1u);
+    BOOST_CHECK_CLOSE(hist.GetMaxTime(), 1e6, 1e-6);
+    BOOST_CHECK(CObjMgrStatHistogram::GetBucketLimit(2) > 3e-6);
+
+    group.Add(CObjMgrStatGroup::eCounter_TSE_Info_Live, 2);
+    group.Add(CObjMgrStatGroup::eCounter_TSE_Loaded);
+    CNcbiOstrstream str;
+    group.Print(str, true);
+    string text = CNcbiOstrstreamToString(str);
+    BOOST_CHECK(text.find("GetRecords: 3 calls") != NPOS);
+    BOOST_CHECK(text.find("TSE loaded: 1") != NPOS);
+
+    group.Reset();
+    BOOST_CHECK_EQUAL(hist.GetCount(), 0u);
+    BOOST_CHECK_EQUAL(group.GetCounter(CObjMgrStatGroup::eCounter_TSE_Loaded),
+                      0);
+    BOOST_CHECK_EQUAL(
+        group.GetCounter(CObjMgrStatGroup::eCounter_TSE_Info_Live), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestStatisticsLiveTSE)
+{
+    CObjMgrStatGroup& group = CObjMgrStatistics::GetObjMgrGroup();
+    BOOST_CHECK_EQUAL(&CObjMgrStatistics::GetGroup("objmgr"), &group);
+    Int8 live = group.GetCounter(CObjMgrStatGroup::eCounter_TSE_Info_Live);
+    {{
+        CScope scope(*CObjectManager::GetInstance());
+        scope.AddTopLevelSeqEntry(*s_GetEntry(1, 10));
+        BOOST_CHECK_EQUAL(
+            group.GetCounter(CObjMgrStatGroup::eCounter_TSE_Info_Live),
+            live+1);
+    }}
+    BOOST_CHECK_EQUAL(
+        group.GetCounter(CObjMgrStatGroup::eCounter_TSE_Info_Live), live);
+}
+
+
+class CTestPrefetchAction : public CObject, public IPrefetchAction
+{
+public:
+    CTestPrefetchAction(size_t memory, atomic<int>& held)
+        : m_Memory(memory), m_Held(held), m_HasResult(false)
+        {
+        }
+
+    virtual bool Execute(CRef<CPrefetchRequest> /*token*/)
+        {
+            m_HasResult = true;
+            ++m_Held;
+            return true;
+        }
+    virtual size_t GetResultMemory(void) const
+        {
+            return m_HasResult? m_Memory: 0;
+        }
+    virtual void ReleaseResult(void)
+        {
+            if ( m_HasResult ) {
+                m_HasResult = false;
+                --m_Held;
+            }
+        }
+
+private:
+    size_t m_Memory;
+    atomic<int>& m_Held;
+    bool m_HasResult;
+};
+
+
+class CTestPrefetchSource : public CObject, public IPrefetchActionSource
+{
+public:
+    CTestPrefetchSource(int count, size_t memory, atomic<int>& held)
+        : m_Count(count), m_Memory(memory), m_Held(held)
+        {
+        }
+
+    virtual CIRef<IPrefetchAction> GetNextAction(void)
+        {
+            CIRef<IPrefetchAction> ret;
+            if ( m_Count > 0 ) {
+                --m_Count;
+                ret.Reset(new CTestPrefetchAction(m_Memory, m_Held));
+            }
+            return ret;
+        }
+
+private:
+    int m_Count;
+    size_t m_Memory;
+    atomic<int>& m_Held;
+};
+
+
+BOOST_AUTO_TEST_CASE(TestPrefetchSequenceMemoryLimit)
+{
+    const int kActionCount = 50;
+    const size_t kActionMemory = 1000;
+    const size_t kMaxMemory = 3500;
+    atomic<int> held(0);
+    CRef<CPrefetchManager> manager(new CPrefetchManager(4));
+    {{
+        CRef<CPrefetchSequence> seq
+            (new CPrefetchSequence(*manager,
+                                   new CTestPrefetchSource(kActionCount,
+                                                           kActionMemory,
+                                                           held),
+                                   20, kMaxMemory));
+        int consumed = 0;
+        while ( CRef<CPrefetchRequest> token = seq->GetNextToken() ) {
+            CStdPrefetch::Wait(token);
+            BOOST_CHECK(token->GetState() == SPrefetchTypes::eCompleted);
+            ++consumed;
+            // the previous result is released, and the window is limited
+            // by memory rather than by the number of actions
+            BOOST_CHECK(seq->GetActiveCount() <= kMaxMemory/kActionMemory);
+            BOOST_CHECK(held.load() <= int(kMaxMemory/kActionMemory)+1);
+        }
+        BOOST_CHECK_EQUAL(consumed, kActionCount);
+        BOOST_CHECK_EQUAL(held.load(), 0);
+    }}
+    {{
+        // unbounded sequence keeps the results for the consumer
+        CRef<CPrefetchSequence> seq
+            (new CPrefetchSequence(*manager,
+                                   new CTestPrefetchSource(3,
+                                                           kActionMemory,
+                                                           held),
+                                   10));
+        vector< CRef<CPrefetchRequest> > tokens;
+        while ( CRef<CPrefetchRequest> token = seq->GetNextToken() ) {
+            CStdPrefetch::Wait(token);
+            tokens.push_back(token);
+        }
+        BOOST_CHECK_EQUAL(held.load(), 3);
+    }}
+    manager->Shutdown();
+}
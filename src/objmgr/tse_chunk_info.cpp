@@ -68,7 +68,8 @@ CTSE_Chunk_Info::CTSE_Chunk_Info(TChunkId id)
       m_ChunkId(id),
       m_LoadBytes(0),
       m_LoadSeconds(0),
-      m_ExplicitFeatIds(false)
+      m_ExplicitFeatIds(false),
+      m_AnnotsPending(false)
 {
 }
 
@@ -152,6 +153,7 @@ void CTSE_Chunk_Info::x_SplitAttach(CTSE_Split_Info& split_info)
 
     // index annots
     split_info.x_UpdateAnnotIndex(*this);
+    x_SetAnnotsPending();
 }
 
 
@@ -272,7 +274,13 @@ void CTSE_Chunk_Info::Load(void) const
     _ASSERT(x_Attached());
     CInitGuard init(chunk->m_LoadLock, m_SplitInfo->GetMutexPool());
     if ( init ) {
-        m_SplitInfo->GetDataLoader().GetChunk(Ref(chunk));
+        CObjMgrStatGroup& stat = m_SplitInfo->GetStatistics();
+        {{
+            CObjMgrStatCallGuard stat_guard(stat,
+                                            CObjMgrStatGroup::eCall_GetChunk);
+            m_SplitInfo->GetDataLoader().GetChunk(Ref(chunk));
+        }}
+        stat.Add(CObjMgrStatGroup::eCounter_Chunk_Loaded);
         _ASSERT(IsLoaded());
     }
 }
@@ -291,6 +299,27 @@ void CTSE_Chunk_Info::SetLoaded(CObject* obj)
         }
         m_LoadLock.Reset(obj);
     }}
+    x_ResetAnnotsPending();
+}
+
+
+void CTSE_Chunk_Info::x_SetAnnotsPending(void)
+{
+    _ASSERT(x_Attached());
+    if ( NotLoaded() &&
+         (!m_AnnotContents.empty() || !m_AnnotPlaces.empty() ||
+          !m_BioseqPlaces.empty() || GetChunkId() == kDelayedMain_ChunkId) &&
+         !m_AnnotsPending.exchange(true) ) {
+        m_SplitInfo->x_AddPendingAnnotChunks(1);
+    }
+}
+
+
+void CTSE_Chunk_Info::x_ResetAnnotsPending(void)
+{
+    if ( m_AnnotsPending.exchange(false) ) {
+        m_SplitInfo->x_AddPendingAnnotChunks(-1);
+    }
 }
 
 
@@ -362,6 +391,7 @@ void CTSE_Chunk_Info::x_AddAnnotPlace(const TPlace& place)
     m_AnnotPlaces.push_back(place);
     if ( m_SplitInfo ) {
         m_SplitInfo->x_AddAnnotPlace(place, GetChunkId());
+        x_SetAnnotsPending();
     }
 }
 
@@ -725,6 +755,7 @@ void CTSE_Chunk_Info::x_LoadDescr(const TPlace& place,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    m_SplitInfo->x_AddObjectMemory(descr);
     m_SplitInfo->x_LoadDescr(place, descr);
 }
 
@@ -734,6 +765,7 @@ void CTSE_Chunk_Info::x_LoadAnnot(const TPlace& place,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    m_SplitInfo->x_AddObjectMemory(annot);
     m_SplitInfo->x_LoadAnnot(place, annot, GetChunkId());
 }
 
@@ -754,6 +786,9 @@ void CTSE_Chunk_Info::x_LoadBioseqs(const TPlace& place,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    ITERATE ( list< CRef<CBioseq> >, it, bioseqs ) {
+        m_SplitInfo->x_AddObjectMemory(**it);
+    }
     m_SplitInfo->x_LoadBioseqs(place, bioseqs, GetChunkId());
 }
 
@@ -763,6 +798,9 @@ void CTSE_Chunk_Info::x_LoadSequence(const TPlace& place, TSeqPos pos,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    ITERATE ( TSequence, it, sequence ) {
+        m_SplitInfo->x_AddObjectMemory(**it);
+    }
     m_SplitInfo->x_LoadSequence(place, pos, sequence);
 }
 
@@ -772,6 +810,9 @@ void CTSE_Chunk_Info::x_LoadAssembly(const TBioseqId& seq_id,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    ITERATE ( TAssembly, it, assembly ) {
+        m_SplitInfo->x_AddObjectMemory(**it);
+    }
     m_SplitInfo->x_LoadAssembly(seq_id, assembly);
 }
 
@@ -781,6 +822,7 @@ void CTSE_Chunk_Info::x_LoadSeq_entry(CSeq_entry& entry,
 {
     _ASSERT(x_Attached());
     _ASSERT(!IsLoaded());
+    m_SplitInfo->x_AddObjectMemory(entry);
     m_SplitInfo->x_LoadSeq_entry(entry, set_info);
 }
 
@@ -48,6 +48,8 @@
 
 #include <objects/seqset/Seq_entry.hpp>
 #include <objects/submit/Seq_submit.hpp>
+#include <serial/objectinfo.hpp>
+#include <serial/objectiter.hpp>
 
 #include <objmgr/objmgr_exception.hpp>
 #include <objmgr/error_codes.hpp>
@@ -64,6 +66,19 @@ NCBI_DEFINE_ERR_SUBCODE_X(3);
 BEGIN_SCOPE(objects)
 
 
+// minimal number of objects in annotation index of a loaded TSE
+// to convert it into compact read-only form, 0 - never convert
+NCBI_PARAM_DECL(size_t, OBJMGR, STATIC_ANNOT_INDEX_SIZE);
+NCBI_PARAM_DEF_EX(size_t, OBJMGR, STATIC_ANNOT_INDEX_SIZE, 4096,
+                  eParam_NoThread, OBJMGR_STATIC_ANNOT_INDEX_SIZE);
+
+static size_t s_GetStaticAnnotIndexSize(void)
+{
+    static CSafeStatic<NCBI_PARAM_TYPE(OBJMGR, STATIC_ANNOT_INDEX_SIZE)> sx_Value;
+    return sx_Value->Get();
+}
+
+
 SIdAnnotObjs::SIdAnnotObjs(void)
 {
 }
@@ -75,11 +90,51 @@ SIdAnnotObjs::~SIdAnnotObjs(void)
         delete *it;
         *it = 0;
     }
+    NON_CONST_ITERATE ( TStaticAnnotSet, it, m_StaticAnnotSet ) {
+        delete *it;
+        *it = 0;
+    }
+}
+
+
+SIdAnnotObjs::CRangeIterator
+SIdAnnotObjs::x_BeginRange(size_t index, const TRange& range) const
+{
+    _ASSERT(!x_RangeMapIsEmpty(index));
+    CRangeIterator iter;
+    if ( TStaticRangeMap* slot = x_GetStaticSlot(index) ) {
+        iter.m_Static = true;
+        iter.m_StaticIter = slot->begin(range);
+    }
+    else {
+        iter.m_Iter = m_AnnotSet[index]->begin(range);
+    }
+    return iter;
+}
+
+
+SIdAnnotObjs::CRangeIterator
+SIdAnnotObjs::x_FindRange(size_t index, const TRange& range) const
+{
+    _ASSERT(!x_RangeMapIsEmpty(index));
+    CRangeIterator iter;
+    if ( TStaticRangeMap* slot = x_GetStaticSlot(index) ) {
+        iter.m_Static = true;
+        iter.m_StaticIter = slot->find(range);
+    }
+    else {
+        iter.m_Iter = m_AnnotSet[index]->find(range);
+    }
+    return iter;
 }
 
 
-SIdAnnotObjs::TRangeMap& SIdAnnotObjs::x_GetRangeMap(size_t index)
+SIdAnnotObjs::TRangeMap& SIdAnnotObjs::x_GetRangeMap(size_t index,
+                                                     size_t* thawed)
 {
+    if ( thawed ) {
+        *thawed = 0;
+    }
     if ( index >= m_AnnotSet.size() ) {
         m_AnnotSet.resize(index+1);
     }
@@ -87,6 +142,18 @@ SIdAnnotObjs::TRangeMap& SIdAnnotObjs::x_GetRangeMap(size_t index)
     if ( !slot ) {
         slot = new TRangeMap;
     }
+    if ( TStaticRangeMap* static_slot = x_GetStaticSlot(index) ) {
+        // modification of compact index, convert it back to range map
+        for ( TStaticRangeMap::const_iterator it = static_slot->begin();
+              it; ++it ) {
+            slot->insert(*it);
+        }
+        if ( thawed ) {
+            *thawed = static_slot->size();
+        }
+        delete static_slot;
+        m_StaticAnnotSet[index] = 0;
+    }
     return *slot;
 }
 
@@ -94,6 +161,14 @@ SIdAnnotObjs::TRangeMap& SIdAnnotObjs::x_GetRangeMap(size_t index)
 bool SIdAnnotObjs::x_CleanRangeMaps(void)
 {
     while ( !m_AnnotSet.empty() ) {
+        size_t index = m_AnnotSet.size()-1;
+        if ( TStaticRangeMap* static_slot = x_GetStaticSlot(index) ) {
+            if ( !static_slot->empty() ) {
+                return false;
+            }
+            delete static_slot;
+            m_StaticAnnotSet[index] = 0;
+        }
         TRangeMap*& slot = m_AnnotSet.back();
         if ( slot ) {
             if ( !slot->empty() ) {
@@ -103,14 +178,40 @@ bool SIdAnnotObjs::x_CleanRangeMaps(void)
             slot = 0;
         }
         m_AnnotSet.pop_back();
+        if ( m_StaticAnnotSet.size() > index ) {
+            m_StaticAnnotSet.resize(index);
+        }
     }
     return true;
 }
 
 
+size_t SIdAnnotObjs::x_FreezeRangeMaps(size_t min_size)
+{
+    size_t count = 0;
+    for ( size_t index = 0; index < m_AnnotSet.size(); ++index ) {
+        TRangeMap*& slot = m_AnnotSet[index];
+        if ( !slot || slot->empty() || slot->size() < min_size ) {
+            continue;
+        }
+        _ASSERT(!x_GetStaticSlot(index));
+        if ( index >= m_StaticAnnotSet.size() ) {
+            m_StaticAnnotSet.resize(index+1);
+        }
+        m_StaticAnnotSet[index] = new TStaticRangeMap(slot->begin(),
+                                                      slot->end());
+        count += m_StaticAnnotSet[index]->size();
+        delete slot;
+        slot = 0;
+    }
+    return count;
+}
+
+
 SIdAnnotObjs::SIdAnnotObjs(const SIdAnnotObjs& _DEBUG_ARG(objs))
 {
     _ASSERT(objs.m_AnnotSet.empty());
+    _ASSERT(objs.m_StaticAnnotSet.empty());
     _ASSERT(objs.m_SNPSet.empty());
 }
 
@@ -194,6 +295,7 @@ CTSE_Info::CTSE_Info(const CTSE_Lock& tse)
     m_TopLevelObjectType = tse->m_TopLevelObjectType;
     m_Name = tse->m_Name;
     m_UsedMemory = tse->m_UsedMemory;
+    m_ObjectMemory = tse->GetObjectMemory();
     m_LoadState = eLoaded;
 
     // update Seq-inst object with split data
@@ -226,6 +328,8 @@ CTSE_Info::~CTSE_Info(void)
     _ASSERT(m_DataSource == 0);
     if( m_Split )
         m_Split->x_TSEDetach(*this);
+    CObjMgrStatistics::GetObjMgrGroup()
+        .Add(CObjMgrStatGroup::eCounter_TSE_Info_Live, -1);
 }
 
 
@@ -236,6 +340,7 @@ CTSE_Info& CTSE_Info::Assign(const CTSE_Lock& tse)
     m_TopLevelObjectType = tse->m_TopLevelObjectType;
     m_Name = tse->m_Name;
     m_UsedMemory = tse->m_UsedMemory;
+    m_ObjectMemory = tse->GetObjectMemory();
 
     if (tse->m_Contents)
         x_SetObject(*tse,NULL);//tse->m_BaseTSE->m_ObjectCopyMap);
@@ -260,6 +365,7 @@ CTSE_Info& CTSE_Info::Assign(const CTSE_Lock& tse,
     m_TopLevelObjectType = tse->m_TopLevelObjectType;
     m_Name = tse->m_Name;
     m_UsedMemory = tse->m_UsedMemory;
+    m_ObjectMemory = tse->GetObjectMemory();
 
     if (entry)
         SetSeq_entry(*entry);
@@ -288,13 +394,18 @@ CTSE_Info& CTSE_Info::Assign(const CTSE_Lock& tse,
 
 void CTSE_Info::x_Initialize(void)
 {
+    CObjMgrStatistics::GetObjMgrGroup()
+        .Add(CObjMgrStatGroup::eCounter_TSE_Info_Live);
     m_DataSource = 0;
     m_BlobVersion = -1;
     m_BlobState = CBioseq_Handle::fState_none;
     m_TopLevelObjectType = CTSE_Handle::eTopLevel_Seq_entry;
     m_UsedMemory = 0;
+    m_ObjectMemory = 0;
+    m_AnnotIndexMemory = 0;
     m_LoadState = eNotLoaded;
     m_CacheState = eNotInCache;
+    m_CacheMemory = 0;
     m_AnnotIdsFlags = 0;
 }
 
@@ -348,6 +459,81 @@ void CTSE_Info::AddUsedMemory(size_t size)
 }
 
 
+// approximate overhead of a heap allocated node of a container
+static const size_t kNodeMemoryOverhead = 4*sizeof(void*);
+
+
+static size_t s_EstimateObjectMemory(const CConstObjectInfo& info)
+{
+    size_t size = 0;
+    switch ( info.GetTypeFamily() ) {
+    case eTypeFamilyPrimitive:
+        // only the heap allocated part, the object itself is in its parent
+        if ( info.GetPrimitiveValueType() == ePrimitiveValueString ) {
+            const string& str =
+                *static_cast<const string*>(info.GetObjectPtr());
+            if ( str.capacity() >= sizeof(string) ) {
+                size += str.capacity() + 1;
+            }
+        }
+        else if ( info.GetPrimitiveValueType() == ePrimitiveValueOctetString ) {
+            const vector<char>& data =
+                *static_cast<const vector<char>*>(info.GetObjectPtr());
+            size += data.capacity();
+        }
+        break;
+    case eTypeFamilyClass:
+        for ( CConstObjectInfoMI it = info.BeginMembers(); it; ++it ) {
+            if ( it.IsSet() ) {
+                size += s_EstimateObjectMemory(*it);
+            }
+        }
+        break;
+    case eTypeFamilyChoice:
+        if ( info.GetCurrentChoiceVariantIndex() != kEmptyChoice ) {
+            size += s_EstimateObjectMemory(*info.GetCurrentChoiceVariant());
+        }
+        break;
+    case eTypeFamilyContainer:
+        for ( CConstObjectInfoEI it = info.BeginElements(); it; ++it ) {
+            CConstObjectInfo element = *it;
+            size += kNodeMemoryOverhead + element.GetTypeInfo()->GetSize();
+            size += s_EstimateObjectMemory(element);
+        }
+        break;
+    case eTypeFamilyPointer:
+    {{
+        CConstObjectInfo object = info.GetPointedObject();
+        if ( object ) {
+            size += object.GetTypeInfo()->GetSize();
+            size += s_EstimateObjectMemory(object);
+        }
+        break;
+    }}
+    }
+    return size;
+}
+
+
+size_t CTSE_Info::EstimateObjectMemory(const CSerialObject& obj)
+{
+    CConstObjectInfo info(&obj, obj.GetThisTypeInfo());
+    return info.GetTypeInfo()->GetSize() + s_EstimateObjectMemory(info);
+}
+
+
+void CTSE_Info::AddObjectMemory(const CSerialObject& obj)
+{
+    // the estimation requires full scan of the object,
+    // so do it only if the memory is limited
+    if ( !HasDataSource() ||
+         GetDataSource().GetBlobCacheMemoryLimit() == 0 ) {
+        return;
+    }
+    m_ObjectMemory.fetch_add(EstimateObjectMemory(obj), memory_order_relaxed);
+}
+
+
 void CTSE_Info::SetSeq_entry(CSeq_entry& entry, CTSE_SetObjectInfo* set_info)
 {
     if ( m_Which != CSeq_entry::e_not_set ) {
@@ -1043,6 +1229,7 @@ void CTSE_Info::UpdateAnnotIndex(CTSE_Info_Object& object)
         //CStopWatch sw(CStopWatch::eStart);
         object.x_UpdateAnnotIndex(*this);
         _ASSERT(!object.x_DirtyAnnotIndex());
+        x_FreezeAnnotIndex();
         //LOG_POST(Info<<"Updated annot index in "<<sw.Elapsed());
     }
 }
@@ -1176,6 +1363,60 @@ bool CTSE_Info::x_HasIdObjects(const CSeq_id_Handle& idh) const
 }
 
 
+// approximate memory of one entry in annotation index range map
+static const size_t kAnnotIndexEntryMemory =
+    sizeof(CTSE_Info::TRangeMap::value_type) + kNodeMemoryOverhead;
+// and in compact read-only index
+static const size_t kStaticAnnotIndexEntryMemory =
+    sizeof(CTSE_Info::TRangeMap::value_type) + sizeof(TSeqPos);
+
+
+void CTSE_Info::x_FreezeAnnotIndex(void)
+{
+    // Only TSEs loaded by data loader are not modified in place,
+    // edited TSEs are copied, so modifications of compact index
+    // are limited to loading of new chunks.
+    if ( m_BaseTSE || !HasDataSource() ||
+         !GetDataSource().GetDataLoader() ) {
+        return;
+    }
+    size_t min_size = s_GetStaticAnnotIndexSize();
+    if ( !min_size ) {
+        return;
+    }
+    // every loaded chunk would convert the index back, so wait until
+    // all chunks with annotations are loaded
+    if ( HasSplitInfo() && GetSplitInfo().x_HasPendingAnnotChunks() ) {
+        return;
+    }
+    size_t count = 0;
+    NON_CONST_ITERATE ( TNamedAnnotObjs, it, m_NamedAnnotObjs ) {
+        NON_CONST_ITERATE ( TAnnotObjs, it2, it->second ) {
+            count += it2->second.x_FreezeRangeMaps(min_size);
+        }
+    }
+    if ( count ) {
+        m_AnnotIndexMemory.fetch_sub(count*(kAnnotIndexEntryMemory-
+                                            kStaticAnnotIndexEntryMemory),
+                                     memory_order_relaxed);
+    }
+}
+
+
+CTSE_Info::TRangeMap& CTSE_Info::x_SetRangeMap(SIdAnnotObjs& objs,
+                                               size_t index)
+{
+    size_t thawed;
+    TRangeMap& rangeMap = objs.x_GetRangeMap(index, &thawed);
+    if ( thawed ) {
+        m_AnnotIndexMemory.fetch_add(thawed*(kAnnotIndexEntryMemory-
+                                             kStaticAnnotIndexEntryMemory),
+                                     memory_order_relaxed);
+    }
+    return rangeMap;
+}
+
+
 inline
 void CTSE_Info::x_MapAnnotObject(TRangeMap& rangeMap,
                                  const SAnnotObject_Key& key,
@@ -1183,6 +1424,8 @@ void CTSE_Info::x_MapAnnotObject(TRangeMap& rangeMap,
 {
     //_ASSERT(index.m_AnnotObject_Info == key.m_AnnotObject_Info);
     rangeMap.insert(TRangeMap::value_type(key.m_Range, index));
+    m_AnnotIndexMemory.fetch_add(kAnnotIndexEntryMemory,
+                                 memory_order_relaxed);
 }
 
 
@@ -1195,6 +1438,8 @@ bool CTSE_Info::x_UnmapAnnotObject(TRangeMap& rangeMap,
           it && it->first == key.m_Range; ++it ) {
         if ( it->second.m_AnnotObject_Info == &info ) {
             rangeMap.erase(it);
+            m_AnnotIndexMemory.fetch_sub(kAnnotIndexEntryMemory,
+                                         memory_order_relaxed);
             return rangeMap.empty();
         }
     }
@@ -1213,7 +1458,7 @@ void CTSE_Info::x_MapAnnotObject(SIdAnnotObjs& objs,
         index.m_AnnotObject_Info->GetLocsTypes(idx_set);
         ITERATE(CAnnotObject_Info::TTypeIndexSet, idx_rg, idx_set) {
             for (size_t idx = idx_rg->first; idx < idx_rg->second; ++idx) {
-                x_MapAnnotObject(objs.x_GetRangeMap(idx), key, index);
+                x_MapAnnotObject(x_SetRangeMap(objs, idx), key, index);
             }
         }
     }
@@ -1221,7 +1466,7 @@ void CTSE_Info::x_MapAnnotObject(SIdAnnotObjs& objs,
         CAnnotType_Index::TIndexRange idx_rg =
             CAnnotType_Index::GetTypeIndex(*index.m_AnnotObject_Info);
         for (size_t idx = idx_rg.first; idx < idx_rg.second; ++idx) {
-            x_MapAnnotObject(objs.x_GetRangeMap(idx), key, index);
+            x_MapAnnotObject(x_SetRangeMap(objs, idx), key, index);
         }
     }
 }
@@ -1235,7 +1480,7 @@ bool CTSE_Info::x_UnmapAnnotObject(SIdAnnotObjs& objs,
         CAnnotType_Index::GetTypeIndex(info);
     for (size_t idx = idx_rg.first; idx < idx_rg.second; ++idx) {
         _ASSERT(idx < objs.x_GetRangeMapCount());
-        if ( x_UnmapAnnotObject(objs.x_GetRangeMap(idx), info, key) ) {
+        if ( x_UnmapAnnotObject(x_SetRangeMap(objs, idx), info, key) ) {
             if ( objs.x_CleanRangeMaps() ) {
                 return objs.m_SNPSet.empty();
             }
@@ -2007,8 +2252,8 @@ CTSE_Info::x_FindSeq_feat(const CSeq_id_Handle& loc_id,
         }
         if ( index < objs->x_GetRangeMapCount() &&
              !objs->x_RangeMapIsEmpty(index) ) {
-            const TRangeMap& rmap = objs->x_GetRangeMap(index);
-            for ( TRangeMap::const_iterator it(rmap.begin(range)); it; ++it ) {
+            for ( SIdAnnotObjs::CRangeIterator it =
+                      objs->x_BeginRange(index, range); it; ++it ) {
                 const CAnnotObject_Info& annot_info =
                     *it->second.m_AnnotObject_Info;
                 if ( !annot_info.IsRegular() ) {
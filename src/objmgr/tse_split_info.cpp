@@ -64,6 +64,7 @@ CTSE_Split_Info::CTSE_Split_Info(void)
       m_BlobVersion(-1),
       m_SplitVersion(-1),
       m_BioseqChunkId(-1),
+      m_PendingAnnotChunks(0),
       m_SeqIdToChunksSorted(false),
       m_ContainsBioseqs(false)
 {
@@ -75,6 +76,7 @@ CTSE_Split_Info::CTSE_Split_Info(TBlobId blob_id, TBlobVersion blob_ver)
       m_BlobVersion(blob_ver),
       m_SplitVersion(-1),
       m_BioseqChunkId(-1),
+      m_PendingAnnotChunks(0),
       m_SeqIdToChunksSorted(false),
       m_ContainsBioseqs(false)
 {
@@ -199,6 +201,26 @@ CDataLoader& CTSE_Split_Info::GetDataLoader(void) const
 }
 
 
+CObjMgrStatGroup& CTSE_Split_Info::GetStatistics(void) const
+{
+    _ASSERT(m_DataLoader);
+    return m_DataLoader->GetStatistics();
+}
+
+
+static void s_GetChunks(CDataLoader& loader, CDataLoader::TChunkSet& chunks)
+{
+    _ASSERT(!chunks.empty());
+    CObjMgrStatGroup& stat = chunks.front()->GetSplitInfo().GetStatistics();
+    {{
+        CObjMgrStatCallGuard stat_guard(stat,
+                                        CObjMgrStatGroup::eCall_GetChunks);
+        loader.GetChunks(chunks);
+    }}
+    stat.Add(CObjMgrStatGroup::eCounter_Chunk_Loaded, chunks.size());
+}
+
+
 bool CTSE_Split_Info::x_HasDelayedMainChunk(void) const
 {
     CMutexGuard guard(m_ChunksMutex);
@@ -554,14 +576,14 @@ void CTSE_Split_Info::x_LoadChunks(const TChunkIds& chunk_ids) const
         guards.push_back(guard);
         if ( guards.size() >= limit_chunks_request ) {
             // Load chunks
-            info_nc.GetDataLoader().GetChunks(chunks);
+            s_GetChunks(info_nc.GetDataLoader(), chunks);
             guards.clear();
             chunks.clear();
         }
     }
     if ( !guards.empty() ) {
         // Load chunks
-        info_nc.GetDataLoader().GetChunks(chunks);
+        s_GetChunks(info_nc.GetDataLoader(), chunks);
         guards.clear();
         chunks.clear();
     }
@@ -614,14 +636,14 @@ void CTSE_Split_Info::x_LoadChunks(CDataLoader* loader,
         guards.push_back(guard);
         if ( guards.size() >= limit_chunks_request ) {
             // Load chunks
-            loader->GetChunks(chunks);
+            s_GetChunks(*loader, chunks);
             guards.clear();
             chunks.clear();
         }
     }
     if ( !guards.empty() ) {
         // Load chunks
-        loader->GetChunks(chunks);
+        s_GetChunks(*loader, chunks);
         guards.clear();
         chunks.clear();
     }
@@ -729,6 +751,15 @@ void CTSE_Split_Info::x_AddUsedMemory(size_t size)
 }
 
 
+void CTSE_Split_Info::x_AddObjectMemory(const CSerialObject& obj)
+{
+    NON_CONST_ITERATE ( TTSE_Set, it, m_TSE_Set ) {
+        CTSE_Info& tse = *it->first;
+        tse.AddObjectMemory(obj);
+    }
+}
+
+
 void CTSE_Split_Info::x_SetBioseqUpdater(CRef<CBioseqUpdater> updater)
 {
     NON_CONST_ITERATE ( TTSE_Set, it, m_TSE_Set ) {
@@ -30,6 +30,7 @@
 */
 
 #include <ncbi_pch.hpp>
+#include <corelib/ncbithr.hpp>
 #include <serial/objistr.hpp>
 #include <serial/serial.hpp>
 #include <serial/iterator.hpp>
@@ -87,6 +88,8 @@
 #include <objmgr/annot_ci.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
@@ -1987,6 +1990,7 @@ CFeatTree& CFeatTree::operator=(const CFeatTree& ft)
         m_GeneCheckMode = ft.m_GeneCheckMode;
         m_IgnoreMissingGeneXref = ft.m_IgnoreMissingGeneXref;
         m_SNPStrandMode = ft.m_SNPStrandMode;
+        m_ThreadCount = ft.m_ThreadCount;
         m_Index = null;
         m_InfoArray.reserve(ft.m_InfoArray.size());
         ITERATE ( TInfoArray, it, ft.m_InfoArray ) {
@@ -2006,6 +2010,7 @@ void CFeatTree::x_Init(void)
     m_GeneCheckMode = eGeneCheck_match;
     m_IgnoreMissingGeneXref = false;
     m_SNPStrandMode = eSNPStrand_both;
+    m_ThreadCount = 1;
 }
 
 
@@ -2033,6 +2038,12 @@ void CFeatTree::SetSNPStrandMode(ESNPStrandMode mode)
 }
 
 
+void CFeatTree::SetThreadCount(unsigned count)
+{
+    m_ThreadCount = max(count, 1u);
+}
+
+
 void CFeatTree::AddFeatures(CFeat_CI it)
 {
     for ( ; it; ++it ) {
@@ -2491,6 +2502,383 @@ bool s_IsNotSubrange(const CRange<TSeqPos>& r1, const CRange<TSeqPos>& r2)
 }
 
 
+// Parent candidate of a child range found by overlap
+struct SOverlapMatch
+{
+    size_t m_Child; // index of child range
+    CFeatTree::CFeatInfo* m_Parent;
+    // -1 when the locations do not overlap, such matches are stored only
+    // for multi-id pairs to exclude their repeated tests
+    Int8 m_Overlap;
+    // overlap was found after forcing child's strand to parent's one
+    bool m_StrandAdjusted;
+};
+typedef vector<SOverlapMatch> TOverlapMatches;
+
+
+// Sweep over child ranges sorted by start and parent ranges sorted by end.
+// Candidate matching of a child range doesn't depend on other children,
+// so any subset of children can be scanned independently, possibly in
+// parallel threads.  The matches are applied to the tree later in the order
+// of child ranges to get exactly the same results as a sequential scan.
+class COverlapScanner
+{
+public:
+    COverlapScanner(const STypeLink& link,
+                    bool check_genes,
+                    CFeatTree* tree,
+                    const TRangeArray& cc,
+                    TRangeArray& pp);
+
+    size_t GetChildCount(void) const
+        {
+            return m_Children.size();
+        }
+
+    void Scan(size_t begin, size_t end, TOverlapMatches& matches) const;
+
+private:
+    struct SChildInfo {
+        SChildInfo(void)
+            : m_ParentsBegin(0),
+              m_ParentsEnd(0),
+              m_CircularLength(kInvalidSeqPos),
+              m_OverlapType(eOverlap_Simple),
+              m_StrandMatchRule(eStrandMatch_all)
+            {
+            }
+        CConstRef<CSeq_loc> m_Loc;
+        // range of parents with the same Seq-id
+        size_t m_ParentsBegin, m_ParentsEnd;
+        TSeqPos m_CircularLength;
+        EOverlapType m_OverlapType;
+        EStrandMatchRule m_StrandMatchRule;
+    };
+    struct SParentInfo {
+        SParentInfo(void)
+            : m_Gene(0)
+            {
+            }
+        CConstRef<CSeq_loc> m_Loc;
+        CFeatTree::CFeatInfo* m_Gene;
+    };
+
+    const STypeLink& m_Link;
+    bool m_CheckGenes;
+    const TRangeArray& m_Children;
+    const TRangeArray& m_Parents;
+    vector<SChildInfo> m_ChildInfos;
+    vector<SParentInfo> m_ParentInfos;
+};
+
+
+COverlapScanner::COverlapScanner(const STypeLink& link,
+                                 bool check_genes,
+                                 CFeatTree* tree,
+                                 const TRangeArray& cc,
+                                 TRangeArray& pp)
+    : m_Link(link),
+      m_CheckGenes(check_genes),
+      m_Children(cc),
+      m_Parents(pp),
+      m_ChildInfos(cc.size()),
+      m_ParentInfos(pp.size())
+{
+    // Collect everything that needs object manager or feature tree state
+    // here, the scan itself only reads the prepared data and locations.
+    size_t pi = 0, pe = 0;
+    TSeqPos circular_length = kInvalidSeqPos;
+    for ( size_t ci = 0; ci < cc.size(); ++ci ) {
+        const SFeatRangeInfo& child = cc[ci];
+        if ( !child.m_Id ) {
+            continue;
+        }
+        if ( pi == pe || pp[pi].m_Id != child.m_Id ) {
+            // skip all parents with Seq-ids smaller than child's
+            pi = pe;
+            while ( pi < pp.size() && pp[pi].m_Id < child.m_Id ) {
+                ++pi;
+            }
+            if ( pi == pp.size() ) { // no more parents
+                break;
+            }
+            if ( pp[pi].m_Id != child.m_Id ) {
+                // no parents on child's Seq-id
+                pe = pi;
+                continue;
+            }
+            // find end of Seq-id parents
+            pe = pi;
+            while ( pe < pp.size() && pp[pe].m_Id == child.m_Id ) {
+                ++pe;
+            }
+            circular_length =
+                sx_GetCircularLength(pp[pi].m_Info->m_Feat.GetScope(),
+                                     child.m_Id);
+            // update parents' m_MinFrom on the Seq-id
+            size_t i = pe;
+            TSeqPos min_from = pp[--i].m_Range.GetFrom();
+            pp[i].m_MinFrom = min_from;
+            while ( i != pi ) {
+                min_from = min(min_from, pp[--i].m_Range.GetFrom());
+                pp[i].m_MinFrom = min_from;
+            }
+            for ( i = pi; i < pe; ++i ) {
+                CFeatTree::CFeatInfo& parent = *pp[i].m_Info;
+                SParentInfo& p_info = m_ParentInfos[i];
+                p_info.m_Loc = link.m_ByProduct?
+                    &parent.m_Feat.GetProduct():
+                    &parent.m_Feat.GetLocation();
+                if ( check_genes ) {
+                    p_info.m_Gene = parent.GetChildrenGene();
+                }
+            }
+        }
+        CFeatTree::CFeatInfo& info = *child.m_Info;
+        SChildInfo& c_info = m_ChildInfos[ci];
+        c_info.m_Loc = &info.m_Feat.GetLocation();
+        c_info.m_ParentsBegin = pi;
+        c_info.m_ParentsEnd = pe;
+        c_info.m_CircularLength = circular_length;
+        c_info.m_OverlapType =
+            sx_GetOverlapType(link, *c_info.m_Loc, circular_length);
+        c_info.m_StrandMatchRule = s_GetStrandMatchRule(link, info, tree);
+    }
+}
+
+
+void COverlapScanner::Scan(size_t begin, size_t end,
+                           TOverlapMatches& matches) const
+{
+    for ( size_t ci = begin; ci < end; ++ci ) {
+        const SFeatRangeInfo& child = m_Children[ci];
+        const SChildInfo& c_info = m_ChildInfos[ci];
+        if ( c_info.m_ParentsBegin == c_info.m_ParentsEnd ) {
+            continue;
+        }
+        // child parameters
+        CFeatTree::CFeatInfo& info = *child.m_Info;
+        const CSeq_loc& c_loc = *c_info.m_Loc;
+        CRef<CSeq_loc> c_loc2;
+        ENa_strand c_loc2_strand = eNa_strand_unknown;
+
+        // skip non-overlapping parents
+        TRangeArray::const_iterator pb = m_Parents.begin();
+        TRangeArray::const_iterator pi =
+            partition_point(pb + c_info.m_ParentsBegin,
+                            pb + c_info.m_ParentsEnd,
+                            [&](const SFeatRangeInfo& p) -> bool
+                            {
+                                return p.m_Range.GetToOpen() <
+                                    child.m_Range.GetFrom();
+                            });
+        TRangeArray::const_iterator pe = pb + c_info.m_ParentsEnd;
+
+        // scan parent candidates
+        for ( TRangeArray::const_iterator pc = pi;
+              pc != pe && pc->m_MinFrom < child.m_Range.GetToOpen();
+              ++pc ) {
+            if ( !pc->m_Range.IntersectingWith(child.m_Range) ) {
+                continue;
+            }
+            const SParentInfo& p_info = m_ParentInfos[pc - pb];
+            if ( m_CheckGenes && info.IsSetGene() ) {
+                // check gene mismatch
+                if ( info.m_Gene != p_info.m_Gene ) {
+                    continue;
+                }
+            }
+            SOverlapMatch match;
+            match.m_Child = ci;
+            match.m_Parent = pc->m_Info;
+            match.m_StrandAdjusted = false;
+            bool multi_id_pair = info.m_MultiId && pc->m_Info->m_MultiId;
+            const CSeq_loc& p_loc = *p_info.m_Loc;
+            CScope* scope = &pc->m_Info->m_Feat.GetScope();
+            Int8 overlap;
+            try {
+                if ( kOptimizeTestOverlap &&
+                     c_info.m_OverlapType == eOverlap_Subset &&
+                     child.m_Id && pc->m_Id &&
+                     s_IsNotSubrange(child.m_Range, pc->m_Range) ) {
+                    // fast check with simple locations failed
+                    overlap = -1;
+                }
+                else {
+                    // full check
+                    overlap = TestForOverlap64(p_loc,
+                                               c_loc,
+                                               c_info.m_OverlapType,
+                                               c_info.m_CircularLength,
+                                               scope);
+                }
+            }
+            catch ( CException& /*ignored*/ ) {
+                overlap = -1;
+            }
+            if ( overlap >= 0 || multi_id_pair ) {
+                match.m_Overlap = overlap;
+                matches.push_back(match);
+                continue;
+            }
+            if ( c_info.m_StrandMatchRule == eStrandMatch_all ) {
+                // strands mismatch -> no overlap
+                continue;
+            }
+            if ( info.m_MultiId || pc->m_Info->m_MultiId ) {
+                // cannot compare strands on multi-id locations
+                continue;
+            }
+            ENa_strand pstrand = GetStrand(p_loc, scope);
+            if ( pstrand == eNa_strand_other ) {
+                // parent has mixed strands -> no overlap
+                continue;
+            }
+            if ( pstrand == eNa_strand_unknown ) {
+                pstrand = eNa_strand_plus;
+            }
+            if ( c_info.m_StrandMatchRule == eStrandMatch_at_least_one &&
+                 GetStrand(c_loc) != eNa_strand_other ) {
+                // child's strand is single and doesn't match
+                continue;
+            }
+            if ( !c_loc2 || c_loc2_strand != pstrand ) {
+                // adjust strand to parent
+                if ( !c_loc2 ) {
+                    c_loc2 = SerialClone(c_loc);
+                }
+                // force
+                c_loc2->SetStrand(pstrand);
+                c_loc2_strand = pstrand;
+            }
+            try {
+                overlap = TestForOverlap64(p_loc,
+                                           *c_loc2,
+                                           c_info.m_OverlapType,
+                                           c_info.m_CircularLength,
+                                           scope);
+            }
+            catch ( CException& /*ignored*/ ) {
+                overlap = -1;
+            }
+            if ( overlap >= 0 ) {
+                match.m_Overlap = overlap;
+                match.m_StrandAdjusted = true;
+                matches.push_back(match);
+            }
+        }
+    }
+}
+
+
+// Minimal number of child ranges scanned by a thread
+static const size_t kMinParallelScanSize = 64;
+
+struct SOverlapScanTasks
+{
+    SOverlapScanTasks(const COverlapScanner& scanner, size_t task_count)
+        : m_Scanner(scanner),
+          m_Results(task_count),
+          m_NextTask(0)
+        {
+        }
+
+    void Process(void)
+        {
+            size_t count = m_Results.size();
+            size_t size = m_Scanner.GetChildCount();
+            for ( ;; ) {
+                size_t index = m_NextTask.fetch_add(1);
+                if ( index >= count ) {
+                    break;
+                }
+                try {
+                    m_Scanner.Scan(size*index/count, size*(index+1)/count,
+                                   m_Results[index]);
+                }
+                catch ( ... ) {
+                    CFastMutexGuard guard(m_ErrorMutex);
+                    if ( !m_Error ) {
+                        m_Error = current_exception();
+                    }
+                }
+            }
+        }
+
+    const COverlapScanner& m_Scanner;
+    vector<TOverlapMatches> m_Results;
+    atomic<size_t> m_NextTask;
+    CFastMutex m_ErrorMutex;
+    exception_ptr m_Error;
+};
+
+
+#if defined(NCBI_THREADS)
+class COverlapScanThread : public CThread
+{
+public:
+    explicit COverlapScanThread(SOverlapScanTasks& tasks)
+        : m_Tasks(tasks)
+        {
+        }
+
+protected:
+    virtual void* Main(void)
+        {
+            m_Tasks.Process();
+            return 0;
+        }
+
+private:
+    SOverlapScanTasks& m_Tasks;
+};
+#endif
+
+
+static void s_ScanOverlaps(const COverlapScanner& scanner,
+                           unsigned max_threads,
+                           TOverlapMatches& matches)
+{
+    size_t size = scanner.GetChildCount();
+    size_t thread_count = min(size_t(max_threads),
+                              size / kMinParallelScanSize);
+#if defined(NCBI_THREADS)
+    if ( thread_count > 1 ) {
+        // split into more tasks than threads for better load balance
+        SOverlapScanTasks tasks(scanner,
+                                min(thread_count*4,
+                                    size / kMinParallelScanSize));
+        vector< CRef<COverlapScanThread> > threads;
+        for ( size_t i = 1; i < thread_count; ++i ) {
+            CRef<COverlapScanThread> thr(new COverlapScanThread(tasks));
+            if ( !thr->Run() ) {
+                break;
+            }
+            threads.push_back(thr);
+        }
+        // the current thread scans too
+        tasks.Process();
+        NON_CONST_ITERATE ( vector< CRef<COverlapScanThread> >, it, threads ) {
+            (*it)->Join();
+        }
+        if ( tasks.m_Error ) {
+            rethrow_exception(tasks.m_Error);
+        }
+        size_t total = 0;
+        ITERATE ( vector<TOverlapMatches>, it, tasks.m_Results ) {
+            total += it->size();
+        }
+        matches.reserve(total);
+        ITERATE ( vector<TOverlapMatches>, it, tasks.m_Results ) {
+            matches.insert(matches.end(), it->begin(), it->end());
+        }
+        return;
+    }
+#endif
+    scanner.Scan(0, size, matches);
+}
+
+
 static void s_CollectBestOverlaps(CFeatTree::TFeatArray& features,
                                   TBestArray& bests,
                                   const STypeLink& link,
@@ -2530,178 +2918,50 @@ static void s_CollectBestOverlaps(CFeatTree::TFeatArray& features,
     }
     sort(cc.begin(), cc.end(), PLessByStart());
 
+    // find parent candidates of all children
+    TOverlapMatches matches;
+    {{
+        COverlapScanner scanner(link, check_genes, tree, cc, pp);
+        s_ScanOverlaps(scanner, tree->GetThreadCount(), matches);
+    }}
+
     typedef pair<CFeatTree::CFeatInfo*, CFeatTree::CFeatInfo*> TFeatPair;
     set<TFeatPair> multi_id_tested;
 
-    // assign parents in single scan over both lists
+    // assign parents in the order of the sweep
     {{
         CDisambiguator disambibuator(features);
-        TRangeArray::iterator pi = pp.begin();
-        TRangeArray::iterator ci = cc.begin();
-        for ( ; ci != cc.end(); ) {
-            // skip all parents with Seq-ids smaller than first child
-            while ( pi != pp.end() && pi->m_Id < ci->m_Id ) {
-                ++pi;
-            }
-            if ( pi == pp.end() ) { // no more parents
-                break;
-            }
-            const CSeq_id_Handle& cur_id = pi->m_Id;
-            if ( ci->m_Id < cur_id || !ci->m_Id ) {
-                // skip all children with Seq-ids smaller than first parent
-                do {
-                    ++ci;
-                } while ( ci != cc.end() && (ci->m_Id < cur_id || !ci->m_Id) );
+        ITERATE ( TOverlapMatches, it, matches ) {
+            const SFeatRangeInfo& child = cc[it->m_Child];
+            CFeatTree::CFeatInfo& info = *child.m_Info;
+            CFeatTree::CFeatInfo* parent = it->m_Parent;
+            if ( info.m_MultiId && parent->m_MultiId &&
+                 !multi_id_tested.insert(TFeatPair(&info, parent)).second ) {
+                // already tested this pair of child and parent
                 continue;
             }
-
-            // find end of Seq-id parents
-            TRangeArray::iterator pe = pi;
-            while ( pe != pp.end() && pe->m_Id == cur_id ) {
-                ++pe;
+            if ( it->m_Overlap < 0 ) {
+                continue;
             }
-
-            TSeqPos circular_length =
-                sx_GetCircularLength(pi->m_Info->m_Feat.GetScope(), cur_id);
-            
-            {{
-                // update parents' m_MinFrom on the Seq-id
-                TRangeArray::iterator i = pe;
-                TSeqPos min_from = (--i)->m_Range.GetFrom();
-                i->m_MinFrom = min_from;
-                while ( i != pi ) {
-                    min_from = min(min_from, (--i)->m_Range.GetFrom());
-                    i->m_MinFrom = min_from;
-                }
-            }}
-
-            // scan all Seq-id children
-            for ( ; ci != cc.end() && pi != pe && ci->m_Id == cur_id; ++ci ) {
-                // child parameters
-                CFeatTree::CFeatInfo& info = *ci->m_Info;
-                const CSeq_loc& c_loc = info.m_Feat.GetLocation();
-                CRef<CSeq_loc> c_loc2;
-                ENa_strand c_loc2_strand = eNa_strand_unknown;
-                EOverlapType overlap_type =
-                    sx_GetOverlapType(link, c_loc, circular_length);
-                EStrandMatchRule strand_match_rule =
-                    s_GetStrandMatchRule(link, info, tree);
-                // Some CDS:mRNA/VDJ_segment/C_region relationships may be ambiguous. For these types
-                // we need to collect all candidates before selecting the best ones.
-                bool disambiguate =
-                    info.GetSubtype() == CSeqFeatData::eSubtype_cdregion &&
-                    link.m_ParentType == CSeqFeatData::eSubtype_mRNA;
-
-                // skip non-overlapping parents
-                while ( pi != pe &&
-                        pi->m_Range.GetToOpen() < ci->m_Range.GetFrom() ) {
-                    ++pi;
-                }
-            
-                // scan parent candidates
-                for ( TRangeArray::iterator pc = pi;
-                      pc != pe && pc->m_MinFrom < ci->m_Range.GetToOpen();
-                      ++pc ) {
-                    if ( !pc->m_Range.IntersectingWith(ci->m_Range) ) {
+            // Some CDS:mRNA/VDJ_segment/C_region relationships may be ambiguous. For these types
+            // we need to collect all candidates before selecting the best ones.
+            bool disambiguate =
+                info.GetSubtype() == CSeqFeatData::eSubtype_cdregion &&
+                link.m_ParentType == CSeqFeatData::eSubtype_mRNA;
+            Int1 quality = s_GetParentQuality(info, *parent);
+            if ( !it->m_StrandAdjusted ) {
+                if ( disambiguate ) {
+                    if ( !disambibuator.Add(&info, parent, quality, it->m_Overlap) ) {
                         continue;
                     }
-                    if ( check_genes && info.IsSetGene() ) {
-                        // check gene mismatch
-                        if ( info.m_Gene != pc->m_Info->GetChildrenGene() ) {
-                            continue;
-                        }
-                    }
-                    if ( info.m_MultiId && pc->m_Info->m_MultiId &&
-                         !multi_id_tested.insert(TFeatPair(&info, pc->m_Info)).second ) {
-                        // already tested this pair of child and parent
-                        continue;
-                    }
-                    const CMappedFeat& p_feat = pc->m_Info->m_Feat;
-                    const CSeq_loc& p_loc =
-                        link.m_ByProduct?
-                        p_feat.GetProduct():
-                        p_feat.GetLocation();
-                    CScope* scope = &p_feat.GetScope();
-                    Int1 quality = s_GetParentQuality(info, *pc->m_Info);
-                    Int8 overlap;
-                    try {
-                        if ( kOptimizeTestOverlap && overlap_type == eOverlap_Subset &&
-                             ci->m_Id && pc->m_Id &&
-                             s_IsNotSubrange(ci->m_Range, pc->m_Range) ) {
-                            // fast check with simple locations failed
-                            overlap = -1;
-                        }
-                        else {
-                            // full check
-                            overlap = TestForOverlap64(p_loc,
-                                                       c_loc,
-                                                       overlap_type,
-                                                       circular_length,
-                                                       scope);
-                        }
-                    }
-                    catch ( CException& /*ignored*/ ) {
-                        overlap = -1;
-                    }
-                    if ( overlap >= 0 ) {
-                        if (disambiguate) {
-                            if ( !disambibuator.Add(ci->m_Info, pc->m_Info, quality, overlap) ) {
-                                continue;
-                            }
-                        }
-                        ci->m_Best->CheckBest(quality, overlap, pc->m_Info);
-                        continue;
-                    }
-                    if ( strand_match_rule == eStrandMatch_all ) {
-                        // strands mismatch -> no overlap
-                        continue;
-                    }
-                    if ( info.m_MultiId || pc->m_Info->m_MultiId ) {
-                        // cannot compare strands on multi-id locations
-                        continue;
-                    }
-                    ENa_strand pstrand = GetStrand(p_loc, scope);
-                    if ( pstrand == eNa_strand_other ) {
-                        // parent has mixed strands -> no overlap
-                        continue;
-                    }
-                    if ( pstrand == eNa_strand_unknown ) {
-                        pstrand = eNa_strand_plus;
-                    }
-                    if ( strand_match_rule == eStrandMatch_at_least_one &&
-                         GetStrand(c_loc) != eNa_strand_other ) {
-                        // child's strand is single and doesn't match
-                        continue;
-                    }
-                    if ( !c_loc2 || c_loc2_strand != pstrand ) {
-                        // adjust strand to parent
-                        if ( !c_loc2 ) {
-                            c_loc2 = SerialClone(c_loc);
-                        }
-                        // force
-                        c_loc2->SetStrand(pstrand);
-                        c_loc2_strand = pstrand;
-                    }
-                    try {
-                        overlap = TestForOverlap64(p_loc,
-                                                   *c_loc2,
-                                                   overlap_type,
-                                                   circular_length,
-                                                   scope);
-                    }
-                    catch ( CException& /*ignored*/ ) {
-                        overlap = -1;
-                    }
-                    if ( overlap >= 0 ) {
-                        if (disambiguate) {
-                            disambibuator.Add(ci->m_Info, pc->m_Info, quality, overlap);
-                        }
-                        ci->m_Best->CheckBest((Int1)(quality-1), overlap, pc->m_Info);
-                    }
                 }
+                child.m_Best->CheckBest(quality, it->m_Overlap, parent);
             }
-            // skip remaining Seq-id children
-            for ( ; ci != cc.end() && ci->m_Id == cur_id; ++ci ) {
+            else {
+                if ( disambiguate ) {
+                    disambibuator.Add(&info, parent, quality, it->m_Overlap);
+                }
+                child.m_Best->CheckBest((Int1)(quality-1), it->m_Overlap, parent);
             }
         }
         disambibuator.Disambiguate(bests);
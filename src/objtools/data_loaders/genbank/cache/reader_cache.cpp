@@ -31,6 +31,7 @@
 #include <objtools/data_loaders/genbank/cache/reader_cache.hpp>
 #include <objtools/data_loaders/genbank/cache/reader_cache_entry.hpp>
 #include <objtools/data_loaders/genbank/cache/reader_cache_params.h>
+#include <objtools/data_loaders/genbank/cache/shmem_cache.hpp>
 #include <objtools/data_loaders/genbank/readers.hpp> // for entry point
 #include <objtools/data_loaders/genbank/impl/dispatcher.hpp>
 #include <objtools/data_loaders/genbank/impl/processors.hpp>
@@ -1575,6 +1576,8 @@ static const SPluginParams::SDefaultValue s_DefaultParams[] = {
     { "purge_batch_sleep", "500" }, // .5 sec
     { "purge_thread_delay", "3600" }, // 1 hour
     { "purge_clean_log", "16" },
+    // shmem:
+    { "size", "256M" },
     // netcache:
     { "connection_max_retries", "0" },
     { "connection_timeout", "0.3" },
@@ -1665,6 +1668,8 @@ ICache* SCacheInfo::CreateCache(const TParams* params,
     typedef CPluginManager<ICache> TCacheManager;
     CRef<TCacheManager> manager(CPluginManagerGetter<ICache>::Get());
     _ASSERT(manager);
+    // shared memory cache is built into this library
+    manager->RegisterWithEntryPoint(NCBI_EntryPoint_xcache_shmem);
     return manager->CreateInstanceFromKey
         (cache_params.get(), NCBI_GBLOADER_READER_CACHE_PARAM_DRIVER);
 }
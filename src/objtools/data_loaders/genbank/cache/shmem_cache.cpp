@@ -0,0 +1,971 @@
+/*  $Id$
+* ===========================================================================
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+* ===========================================================================
+*
+*  Author:  agent
+*
+*  File Description: ICache implementation in a memory mapped file
+*                    shared by all processes on the same host
+*
+*/
+
+#include <ncbi_pch.hpp>
+#include <objtools/data_loaders/genbank/cache/shmem_cache.hpp>
+#include <corelib/ncbi_process.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <corelib/plugin_manager_store.hpp>
+#include <corelib/stream_utils.hpp>
+#include <util/cache/icache_cf.hpp>
+
+#include <atomic>
+
+BEGIN_NCBI_SCOPE
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Layout of the cache file
+/////////////////////////////////////////////////////////////////////////////
+
+static const Uint4 kShmemCacheMagic = 0x4e43534d; // "NCSM"
+static const Uint4 kShmemCacheLayoutVersion = 1;
+
+// alignment of slots and records
+static const size_t kSlotAlign = 64;
+static const size_t kRecordAlign = 8;
+static const size_t kDataAlign = 4096;
+
+// number of slots checked when looking for an entry
+static const size_t kMaxProbes = 8;
+
+// pseudo version of records with current blob version
+static const ICache::TBlobVersion kCurrentVersionMark = kMin_Int;
+
+// how long to wait for another process to initialize new cache file
+static const unsigned kInitWaitMilliSec = 5000;
+// how many times to retry reading of a slot being modified
+static const unsigned kSlotReadSpins = 1000;
+// how often to check if the process holding writer lock is alive
+static const unsigned kWriterCheckSpins = 100000;
+
+
+struct CSharedMemoryCache::SHeader
+{
+    atomic<Uint4>  m_Magic; // set last, after the file is initialized
+    Uint4          m_LayoutVersion;
+    Uint8          m_SlotCount;
+    Uint8          m_SlotsOffset;
+    Uint8          m_DataOffset;
+    Uint8          m_DataSize;
+    // Logical end of the last record in the ring buffer. It never
+    // decreases, and the data byte at logical position P is stored at
+    // m_DataOffset + P % m_DataSize.
+    alignas(kSlotAlign) atomic<Uint8> m_WritePos;
+    // pid of the process holding the writer lock, 0 if unlocked
+    atomic<Uint4>  m_WriterPid;
+};
+
+
+struct CSharedMemoryCache::SSlot
+{
+    // Odd while the slot is being modified by the writer.
+    atomic<Uint4>  m_Sequence;
+    atomic<Uint4>  m_AccessTime;
+    atomic<Uint8>  m_Hash;
+    // Logical position of the record, 0 if the slot is empty.
+    atomic<Uint8>  m_Position;
+    atomic<Uint4>  m_RecordSize;
+    atomic<Uint4>  m_StoreTime;
+};
+
+
+// Record header in the ring buffer, followed by key, subkey, and data.
+struct SShmemCacheRecord
+{
+    Uint8 m_Hash;
+    Uint4 m_KeySize;
+    Uint4 m_SubkeySize;
+    Int4  m_Version;
+    Uint4 m_DataSize;
+};
+
+
+struct CSharedMemoryCache::SEntry
+{
+    SSlot* m_Slot;
+    Uint4  m_StoreTime;
+    Uint4  m_AccessTime;
+    string m_Data;
+};
+
+
+static inline size_t s_Align(size_t size, size_t align)
+{
+    return (size + align - 1) / align * align;
+}
+
+
+static inline Uint4 s_Now(void)
+{
+    return Uint4(time(0));
+}
+
+
+static Uint8 s_GetHash(const string& key,
+                       ICache::TBlobVersion version,
+                       const string& subkey)
+{
+    // FNV-1a
+    Uint8 h = NCBI_CONST_UINT8(14695981039346656037);
+    const Uint8 prime = NCBI_CONST_UINT8(1099511628211);
+    ITERATE ( string, it, key ) {
+        h = (h ^ Uint1(*it)) * prime;
+    }
+    h = (h ^ 0xff) * prime;
+    ITERATE ( string, it, subkey ) {
+        h = (h ^ Uint1(*it)) * prime;
+    }
+    for ( int i = 0; i < 4; ++i ) {
+        h = (h ^ Uint1(Uint4(version) >> (i*8))) * prime;
+    }
+    return h;
+}
+
+
+static string s_MakeRecord(Uint8 hash,
+                           const string& key,
+                           ICache::TBlobVersion version,
+                           const string& subkey,
+                           const void* data,
+                           size_t size)
+{
+    SShmemCacheRecord rec;
+    rec.m_Hash = hash;
+    rec.m_KeySize = Uint4(key.size());
+    rec.m_SubkeySize = Uint4(subkey.size());
+    rec.m_Version = version;
+    rec.m_DataSize = Uint4(size);
+    string ret;
+    ret.reserve(s_Align(sizeof(rec)+key.size()+subkey.size()+size,
+                        kRecordAlign));
+    ret.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    ret += key;
+    ret += subkey;
+    ret.append(static_cast<const char*>(data), size);
+    ret.resize(s_Align(ret.size(), kRecordAlign));
+    return ret;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CSharedMemoryCache
+/////////////////////////////////////////////////////////////////////////////
+
+
+CSharedMemoryCache::CSharedMemoryCache(void)
+    : m_Header(0),
+      m_Flags(fBestPerformance),
+      m_TimeStampFlags(fNoTimeStamp),
+      m_Timeout(0),
+      m_VersionRetention(eKeepAll)
+{
+}
+
+
+CSharedMemoryCache::CSharedMemoryCache(const string& file_name,
+                                       Uint8 data_size,
+                                       size_t slot_count)
+    : m_FileName(file_name),
+      m_Header(0),
+      m_Flags(fBestPerformance),
+      m_TimeStampFlags(fNoTimeStamp),
+      m_Timeout(0),
+      m_VersionRetention(eKeepAll)
+{
+    data_size = s_Align(max(data_size, Uint8(1<<20)), kDataAlign);
+    if ( !slot_count ) {
+        slot_count = size_t(data_size / 512);
+    }
+    slot_count = max(slot_count, kMaxProbes);
+    size_t slots_offset = s_Align(sizeof(SHeader), kSlotAlign);
+    size_t data_offset = s_Align(slots_offset + slot_count*sizeof(SSlot),
+                                 kDataAlign);
+    Uint8 file_size = data_offset + data_size;
+
+    // Only one process can create the file, it initializes the header,
+    // while the others wait until the magic number appears.
+    bool created = false;
+    try {
+        CFileIO file;
+        file.Open(m_FileName, CFileIO::eCreateNew, CFileIO::eReadWrite);
+        file.SetFileSize(file_size, CFileIO::eBegin);
+        file.Close();
+        created = true;
+    }
+    catch ( CFileException& ) {
+        // already exists
+    }
+    if ( created ) {
+        m_File.reset(new CMemoryFile(m_FileName,
+                                     CMemoryFile::eMMP_ReadWrite,
+                                     CMemoryFile::eMMS_Shared));
+        m_Header = static_cast<SHeader*>(m_File->GetPtr());
+        m_Header->m_LayoutVersion = kShmemCacheLayoutVersion;
+        m_Header->m_SlotCount = slot_count;
+        m_Header->m_SlotsOffset = slots_offset;
+        m_Header->m_DataOffset = data_offset;
+        m_Header->m_DataSize = data_size;
+        // logical positions start from data size to make 0 an empty slot
+        m_Header->m_WritePos.store(data_size, memory_order_relaxed);
+        m_Header->m_WriterPid.store(0, memory_order_relaxed);
+        m_Header->m_Magic.store(kShmemCacheMagic, memory_order_release);
+        return;
+    }
+    for ( unsigned waited = 0; ; waited += 10 ) {
+        if ( CFile(m_FileName).GetLength() >= Int8(sizeof(SHeader)) ) {
+            m_File.reset(new CMemoryFile(m_FileName,
+                                         CMemoryFile::eMMP_ReadWrite,
+                                         CMemoryFile::eMMS_Shared));
+            m_Header = static_cast<SHeader*>(m_File->GetPtr());
+            if ( m_Header->m_Magic.load(memory_order_acquire) ==
+                 kShmemCacheMagic ) {
+                break;
+            }
+            m_Header = 0;
+            m_File.reset();
+        }
+        if ( waited >= kInitWaitMilliSec ) {
+            NCBI_THROW(CFileException, eMemoryMap,
+                       "CSharedMemoryCache: cache file "+m_FileName+
+                       " is not initialized");
+        }
+        SleepMilliSec(10);
+    }
+    if ( m_Header->m_LayoutVersion != kShmemCacheLayoutVersion ||
+         m_File->GetSize() < m_Header->m_DataOffset+m_Header->m_DataSize ) {
+        m_Header = 0;
+        m_File.reset();
+        NCBI_THROW(CFileException, eMemoryMap,
+                   "CSharedMemoryCache: incompatible cache file "+m_FileName);
+    }
+}
+
+
+CSharedMemoryCache::~CSharedMemoryCache(void)
+{
+}
+
+
+char* CSharedMemoryCache::x_GetData(void) const
+{
+    return reinterpret_cast<char*>(m_Header) + m_Header->m_DataOffset;
+}
+
+
+CSharedMemoryCache::SSlot* CSharedMemoryCache::x_GetSlots(void) const
+{
+    return reinterpret_cast<SSlot*>(reinterpret_cast<char*>(m_Header) +
+                                    m_Header->m_SlotsOffset);
+}
+
+
+bool CSharedMemoryCache::x_IsExpired(unsigned age) const
+{
+    return m_Timeout && age > m_Timeout;
+}
+
+
+void CSharedMemoryCache::x_LockWriter(void)
+{
+    Uint4 pid = Uint4(CCurrentProcess::GetPid());
+    for ( unsigned spins = 1; ; ++spins ) {
+        Uint4 owner = 0;
+        if ( m_Header->m_WriterPid.compare_exchange_weak(owner, pid,
+                                                         memory_order_acquire) ) {
+            return;
+        }
+        if ( spins % kWriterCheckSpins == 0 && owner &&
+             !CProcess(TPid(owner), CProcess::ePid).IsAlive() ) {
+            // the writer died while holding the lock
+            ERR_POST(Warning<<"CSharedMemoryCache: "
+                     "releasing writer lock of dead process "<<owner);
+            m_Header->m_WriterPid.compare_exchange_strong(owner, 0);
+        }
+        NCBI_SCHED_YIELD();
+    }
+}
+
+
+void CSharedMemoryCache::x_UnlockWriter(void)
+{
+    m_Header->m_WriterPid.store(0, memory_order_release);
+}
+
+
+class CSharedMemoryCache_WriterGuard
+{
+public:
+    explicit CSharedMemoryCache_WriterGuard(CSharedMemoryCache& cache)
+        : m_Cache(cache)
+        {
+            m_Cache.x_LockWriter();
+        }
+    ~CSharedMemoryCache_WriterGuard(void)
+        {
+            m_Cache.x_UnlockWriter();
+        }
+private:
+    CSharedMemoryCache& m_Cache;
+};
+
+
+// Start modification of the slot by the writer.
+// The sequence number may be left odd by a dead writer process.
+static inline Uint4 s_BeginUpdate(CSharedMemoryCache::SSlot& slot)
+{
+    Uint4 seq = slot.m_Sequence.load(memory_order_relaxed) | 1;
+    slot.m_Sequence.store(seq, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    return seq;
+}
+
+
+static inline void s_EndUpdate(CSharedMemoryCache::SSlot& slot, Uint4 seq)
+{
+    slot.m_Sequence.store(seq+1, memory_order_release);
+}
+
+
+bool CSharedMemoryCache::x_Find(const string& key,
+                                TBlobVersion version,
+                                const string& subkey,
+                                SEntry& entry,
+                                bool get_data)
+{
+    if ( !m_Header ) {
+        return false;
+    }
+    Uint8 hash = s_GetHash(key, version, subkey);
+    const Uint8 data_size = m_Header->m_DataSize;
+    const char* data = x_GetData();
+    SSlot* slots = x_GetSlots();
+    size_t key_end = sizeof(SShmemCacheRecord)+key.size()+subkey.size();
+    for ( size_t probe = 0; probe < kMaxProbes; ++probe ) {
+        SSlot& slot = slots[(hash+probe) % m_Header->m_SlotCount];
+        Uint8 slot_hash = 0, pos = 0;
+        Uint4 size = 0, store_time = 0;
+        for ( unsigned spins = 0; spins < kSlotReadSpins; ++spins ) {
+            Uint4 seq = slot.m_Sequence.load(memory_order_acquire);
+            if ( seq & 1 ) {
+                // being modified, or abandoned by a dead writer
+                pos = 0;
+                NCBI_SCHED_YIELD();
+                continue;
+            }
+            slot_hash = slot.m_Hash.load(memory_order_relaxed);
+            pos = slot.m_Position.load(memory_order_relaxed);
+            size = slot.m_RecordSize.load(memory_order_relaxed);
+            store_time = slot.m_StoreTime.load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if ( slot.m_Sequence.load(memory_order_relaxed) == seq ) {
+                break;
+            }
+        }
+        if ( !pos || slot_hash != hash ||
+             size < key_end || size > data_size ||
+             pos % data_size + size > data_size ) {
+            continue;
+        }
+        if ( m_Header->m_WritePos.load(memory_order_acquire) >
+             pos + data_size ) {
+            // overwritten already
+            continue;
+        }
+        // copy the record and check that it wasn't overwritten meanwhile
+        string record(data + pos % data_size, get_data? size: key_end);
+        atomic_thread_fence(memory_order_acquire);
+        if ( m_Header->m_WritePos.load(memory_order_relaxed) >
+             pos + data_size ) {
+            continue;
+        }
+        SShmemCacheRecord rec;
+        memcpy(&rec, record.data(), sizeof(rec));
+        if ( rec.m_Hash != hash ||
+             rec.m_Version != version ||
+             rec.m_KeySize != key.size() ||
+             rec.m_SubkeySize != subkey.size() ||
+             key_end + rec.m_DataSize > size ||
+             record.compare(sizeof(rec), key.size(), key) != 0 ||
+             record.compare(sizeof(rec)+key.size(), subkey.size(),
+                            subkey) != 0 ) {
+            continue;
+        }
+        Uint4 now = s_Now();
+        if ( x_IsExpired(now - store_time) ) {
+            return false;
+        }
+        entry.m_Slot = &slot;
+        entry.m_StoreTime = store_time;
+        entry.m_AccessTime = slot.m_AccessTime.load(memory_order_relaxed);
+        if ( get_data ) {
+            entry.m_Data.assign(record, key_end, rec.m_DataSize);
+        }
+        else {
+            entry.m_Data.clear();
+        }
+        slot.m_AccessTime.store(now, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+
+bool CSharedMemoryCache::x_FindCurrentVersion(const string& key,
+                                              const string& subkey,
+                                              TBlobVersion& version,
+                                              unsigned& age)
+{
+    SEntry entry;
+    if ( !x_Find(key, kCurrentVersionMark, subkey, entry) ||
+         entry.m_Data.size() != sizeof(Int4) ) {
+        return false;
+    }
+    Int4 value;
+    memcpy(&value, entry.m_Data.data(), sizeof(value));
+    version = value;
+    age = s_Now() - entry.m_StoreTime;
+    return true;
+}
+
+
+void CSharedMemoryCache::x_Store(const string& key,
+                                 TBlobVersion version,
+                                 const string& subkey,
+                                 const void* data,
+                                 size_t size)
+{
+    if ( !m_Header ) {
+        return;
+    }
+    const Uint8 data_size = m_Header->m_DataSize;
+    if ( s_Align(sizeof(SShmemCacheRecord)+key.size()+subkey.size()+size,
+                 kRecordAlign) > data_size/4 ) {
+        // too big to be cached
+        return;
+    }
+    Uint8 hash = s_GetHash(key, version, subkey);
+    string record = s_MakeRecord(hash, key, version, subkey, data, size);
+    SSlot* slots = x_GetSlots();
+
+    CSharedMemoryCache_WriterGuard guard(*this);
+    // reserve space in the ring, records do not wrap around its end
+    Uint8 pos = m_Header->m_WritePos.load(memory_order_relaxed);
+    if ( pos % data_size + record.size() > data_size ) {
+        pos += data_size - pos % data_size;
+    }
+    Uint8 end = pos + record.size();
+
+    // select slot: the same entry, or a free one, or the oldest one
+    SSlot* slot = 0;
+    SSlot* oldest = 0;
+    for ( size_t probe = 0; probe < kMaxProbes; ++probe ) {
+        SSlot& s = slots[(hash+probe) % m_Header->m_SlotCount];
+        Uint8 s_pos = s.m_Position.load(memory_order_relaxed);
+        if ( s_pos && s.m_Hash.load(memory_order_relaxed) == hash ) {
+            slot = &s;
+            break;
+        }
+        if ( !s_pos || s_pos + data_size < end ) {
+            // empty or its record will be overwritten
+            if ( !slot ) {
+                slot = &s;
+            }
+        }
+        else if ( !oldest ||
+                  s_pos < oldest->m_Position.load(memory_order_relaxed) ) {
+            oldest = &s;
+        }
+    }
+    if ( !slot ) {
+        slot = oldest;
+    }
+
+    // Advance write position before the data are written, so readers
+    // will detect overwritten records.
+    m_Header->m_WritePos.store(end, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(x_GetData() + pos % data_size, record.data(), record.size());
+
+    Uint4 now = s_Now();
+    Uint4 seq = s_BeginUpdate(*slot);
+    slot->m_Hash.store(hash, memory_order_relaxed);
+    slot->m_Position.store(pos, memory_order_relaxed);
+    slot->m_RecordSize.store(Uint4(record.size()), memory_order_relaxed);
+    slot->m_StoreTime.store(now, memory_order_relaxed);
+    slot->m_AccessTime.store(now, memory_order_relaxed);
+    s_EndUpdate(*slot, seq);
+}
+
+
+bool CSharedMemoryCache::x_Remove(const string& key,
+                                  TBlobVersion version,
+                                  const string& subkey)
+{
+    SEntry entry;
+    if ( !x_Find(key, version, subkey, entry, false) ) {
+        return false;
+    }
+    CSharedMemoryCache_WriterGuard guard(*this);
+    SSlot* slot = entry.m_Slot;
+    if ( slot->m_Hash.load(memory_order_relaxed) !=
+         s_GetHash(key, version, subkey) ) {
+        // replaced by another entry
+        return false;
+    }
+    Uint4 seq = s_BeginUpdate(*slot);
+    slot->m_Position.store(0, memory_order_relaxed);
+    s_EndUpdate(*slot, seq);
+    return true;
+}
+
+
+ICache::TFlags CSharedMemoryCache::GetFlags(void)
+{
+    return m_Flags;
+}
+
+
+void CSharedMemoryCache::SetFlags(TFlags flags)
+{
+    m_Flags = flags;
+}
+
+
+void CSharedMemoryCache::SetTimeStampPolicy(TTimeStampFlags policy,
+                                            unsigned int    timeout,
+                                            unsigned int    /*max_timeout*/)
+{
+    m_TimeStampFlags = policy;
+    m_Timeout = timeout;
+}
+
+
+ICache::TTimeStampFlags CSharedMemoryCache::GetTimeStampPolicy(void) const
+{
+    return m_TimeStampFlags;
+}
+
+
+int CSharedMemoryCache::GetTimeout(void) const
+{
+    return int(m_Timeout);
+}
+
+
+bool CSharedMemoryCache::IsOpen(void) const
+{
+    return m_Header != 0;
+}
+
+
+void CSharedMemoryCache::SetVersionRetention(EKeepVersions policy)
+{
+    m_VersionRetention = policy;
+}
+
+
+ICache::EKeepVersions CSharedMemoryCache::GetVersionRetention(void) const
+{
+    return m_VersionRetention;
+}
+
+
+void CSharedMemoryCache::Store(const string&  key,
+                               TBlobVersion   version,
+                               const string&  subkey,
+                               const void*    data,
+                               size_t         size,
+                               unsigned int   /*time_to_live*/,
+                               const string&  /*owner*/)
+{
+    if ( m_VersionRetention != eKeepAll ) {
+        TBlobVersion old_version;
+        unsigned age;
+        if ( x_FindCurrentVersion(key, subkey, old_version, age) &&
+             old_version != version &&
+             (m_VersionRetention == eDropAll || old_version < version) ) {
+            x_Remove(key, old_version, subkey);
+        }
+    }
+    x_Store(key, version, subkey, data, size);
+    SetBlobVersionAsCurrent(key, subkey, version);
+}
+
+
+size_t CSharedMemoryCache::GetSize(const string&  key,
+                                   TBlobVersion   version,
+                                   const string&  subkey)
+{
+    SEntry entry;
+    if ( !x_Find(key, version, subkey, entry) ) {
+        return 0;
+    }
+    return entry.m_Data.size();
+}
+
+
+void CSharedMemoryCache::GetBlobOwner(const string&  /*key*/,
+                                      TBlobVersion   /*version*/,
+                                      const string&  /*subkey*/,
+                                      string*        owner)
+{
+    // owners are not stored
+    _ASSERT(owner);
+    owner->erase();
+}
+
+
+bool CSharedMemoryCache::Read(const string& key,
+                              TBlobVersion  version,
+                              const string& subkey,
+                              void*         buf,
+                              size_t        buf_size)
+{
+    SEntry entry;
+    if ( !x_Find(key, version, subkey, entry) ) {
+        return false;
+    }
+    memcpy(buf, entry.m_Data.data(), min(buf_size, entry.m_Data.size()));
+    return true;
+}
+
+
+IReader* CSharedMemoryCache::GetReadStream(const string&  key,
+                                           TBlobVersion   version,
+                                           const string&  subkey)
+{
+    SEntry entry;
+    if ( !x_Find(key, version, subkey, entry) ) {
+        return 0;
+    }
+    return new CStringReader(entry.m_Data);
+}
+
+
+IReader* CSharedMemoryCache::GetReadStream(const string&         key,
+                                           const string&         subkey,
+                                           TBlobVersion*         version,
+                                           EBlobVersionValidity* validity)
+{
+    unsigned age;
+    if ( !x_FindCurrentVersion(key, subkey, *version, age) ) {
+        return 0;
+    }
+    *validity = x_IsExpired(age)? eExpired: eCurrent;
+    return GetReadStream(key, *version, subkey);
+}
+
+
+void CSharedMemoryCache::SetBlobVersionAsCurrent(const string&  key,
+                                                 const string&  subkey,
+                                                 TBlobVersion   version)
+{
+    Int4 value = version;
+    x_Store(key, kCurrentVersionMark, subkey, &value, sizeof(value));
+}
+
+
+void CSharedMemoryCache::GetBlobAccess(const string&     key,
+                                       TBlobVersion      version,
+                                       const string&     subkey,
+                                       SBlobAccessDescr* blob_descr)
+{
+    blob_descr->blob_found = false;
+    blob_descr->blob_size = 0;
+    blob_descr->reader.reset();
+    if ( blob_descr->return_current_version ) {
+        unsigned age;
+        if ( !x_FindCurrentVersion(key, subkey, version, age) ) {
+            return;
+        }
+        blob_descr->return_current_version_supported = true;
+        blob_descr->current_version = version;
+        blob_descr->current_version_validity =
+            x_IsExpired(age)? eExpired: eCurrent;
+    }
+    SEntry entry;
+    if ( !x_Find(key, version, subkey, entry) ) {
+        return;
+    }
+    blob_descr->actual_age = s_Now() - entry.m_StoreTime;
+    if ( blob_descr->maximum_age &&
+         blob_descr->actual_age > blob_descr->maximum_age ) {
+        return;
+    }
+    blob_descr->blob_found = true;
+    blob_descr->blob_size = entry.m_Data.size();
+    if ( blob_descr->buf && blob_descr->buf_size >= entry.m_Data.size() ) {
+        memcpy(blob_descr->buf, entry.m_Data.data(), entry.m_Data.size());
+    }
+    else {
+        blob_descr->reader.reset(new CStringReader(entry.m_Data));
+    }
+}
+
+
+/// Writer collecting data in memory and storing them in the cache
+/// at destruction.
+class CSharedMemoryCacheWriter : public IWriter
+{
+public:
+    CSharedMemoryCacheWriter(CSharedMemoryCache& cache,
+                             const string& key,
+                             ICache::TBlobVersion version,
+                             const string& subkey)
+        : m_Cache(cache), m_Key(key), m_Version(version), m_Subkey(subkey)
+        {
+        }
+    ~CSharedMemoryCacheWriter(void)
+        {
+            try {
+                m_Cache.Store(m_Key, m_Version, m_Subkey,
+                              m_Data.data(), m_Data.size());
+            }
+            catch ( exception& exc ) {
+                ERR_POST("CSharedMemoryCache: cannot store blob "<<
+                         m_Key<<","<<m_Subkey<<": "<<exc.what());
+            }
+        }
+
+    virtual ERW_Result Write(const void* buf,
+                             size_t      count,
+                             size_t*     bytes_written = 0)
+        {
+            m_Data.append(static_cast<const char*>(buf), count);
+            if ( bytes_written ) {
+                *bytes_written = count;
+            }
+            return eRW_Success;
+        }
+    virtual ERW_Result Flush(void)
+        {
+            return eRW_Success;
+        }
+
+private:
+    CSharedMemoryCache&  m_Cache;
+    string               m_Key;
+    ICache::TBlobVersion m_Version;
+    string               m_Subkey;
+    string               m_Data;
+};
+
+
+IWriter* CSharedMemoryCache::GetWriteStream(const string&  key,
+                                            TBlobVersion   version,
+                                            const string&  subkey,
+                                            unsigned int   /*time_to_live*/,
+                                            const string&  /*owner*/)
+{
+    if ( !m_Header ) {
+        return 0;
+    }
+    return new CSharedMemoryCacheWriter(*this, key, version, subkey);
+}
+
+
+void CSharedMemoryCache::Remove(const string&  key,
+                                TBlobVersion   version,
+                                const string&  subkey)
+{
+    x_Remove(key, version, subkey);
+    TBlobVersion current_version;
+    unsigned age;
+    if ( x_FindCurrentVersion(key, subkey, current_version, age) &&
+         current_version == version ) {
+        x_Remove(key, kCurrentVersionMark, subkey);
+    }
+}
+
+
+time_t CSharedMemoryCache::GetAccessTime(const string&  key,
+                                         TBlobVersion   version,
+                                         const string&  subkey)
+{
+    SEntry entry;
+    if ( !x_Find(key, version, subkey, entry, false) ) {
+        return 0;
+    }
+    return entry.m_AccessTime;
+}
+
+
+bool CSharedMemoryCache::HasBlobs(const string&  key,
+                                  const string&  subkey)
+{
+    SEntry entry;
+    return x_Find(key, kCurrentVersionMark, subkey, entry, false) ||
+        x_Find(key, 0, subkey, entry, false);
+}
+
+
+void CSharedMemoryCache::Purge(time_t access_timeout)
+{
+    if ( !m_Header ) {
+        return;
+    }
+    Uint4 min_time = s_Now() - Uint4(access_timeout);
+    SSlot* slots = x_GetSlots();
+    CSharedMemoryCache_WriterGuard guard(*this);
+    for ( size_t i = 0; i < m_Header->m_SlotCount; ++i ) {
+        SSlot& slot = slots[i];
+        if ( slot.m_Position.load(memory_order_relaxed) &&
+             slot.m_AccessTime.load(memory_order_relaxed) < min_time ) {
+            Uint4 seq = s_BeginUpdate(slot);
+            slot.m_Position.store(0, memory_order_relaxed);
+            s_EndUpdate(slot, seq);
+        }
+    }
+}
+
+
+void CSharedMemoryCache::Purge(const string&  key,
+                               const string&  subkey,
+                               time_t         access_timeout)
+{
+    // versions of a key are not enumerable, so only the current one
+    // is checked
+    TBlobVersion version;
+    unsigned age;
+    if ( !x_FindCurrentVersion(key, subkey, version, age) ) {
+        return;
+    }
+    SEntry entry;
+    if ( x_Find(key, version, subkey, entry, false) &&
+         time_t(entry.m_AccessTime) < time(0) - access_timeout ) {
+        Remove(key, version, subkey);
+    }
+}
+
+
+static const char* const kCFParam_path = "path";
+static const char* const kCFParam_name = "name";
+static const char* const kCFParam_size = "size";
+static const char* const kCFParam_slots = "slots";
+
+
+static string s_GetFileName(const string& path, const string& name)
+{
+    return CDirEntry::MakePath(path, name, "shm");
+}
+
+
+bool CSharedMemoryCache::SameCacheParams(const TCacheParams* params) const
+{
+    if ( !params ) {
+        return false;
+    }
+    const TCacheParams* driver = params->FindNode("driver");
+    if ( !driver || driver->GetValue().value !=
+         NCBI_GBLOADER_SHMEM_CACHE_DRIVER_NAME ) {
+        return false;
+    }
+    const TCacheParams* driver_params =
+        params->FindNode(NCBI_GBLOADER_SHMEM_CACHE_DRIVER_NAME);
+    if ( !driver_params ) {
+        return false;
+    }
+    const TCacheParams* path = driver_params->FindNode(kCFParam_path);
+    const TCacheParams* name = driver_params->FindNode(kCFParam_name);
+    return path && name &&
+        s_GetFileName(path->GetValue().value, name->GetValue().value) ==
+        m_FileName;
+}
+
+
+string CSharedMemoryCache::GetCacheName(void) const
+{
+    return m_FileName;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Class factory
+/////////////////////////////////////////////////////////////////////////////
+
+
+class CSharedMemoryCacheCF : public CICacheCF<CSharedMemoryCache>
+{
+public:
+    typedef CICacheCF<CSharedMemoryCache> TParent;
+
+    CSharedMemoryCacheCF(void)
+        : TParent(NCBI_GBLOADER_SHMEM_CACHE_DRIVER_NAME, 0)
+        {
+        }
+
+private:
+    virtual ICache* x_CreateInstance(
+        const string&                  driver  = kEmptyStr,
+        CVersionInfo                   version = NCBI_INTERFACE_VERSION(ICache),
+        const TPluginManagerParamTree* params = 0) const;
+};
+
+
+ICache* CSharedMemoryCacheCF::x_CreateInstance(
+    const string&                  driver,
+    CVersionInfo                   version,
+    const TPluginManagerParamTree* params) const
+{
+    if ( (!driver.empty() && driver != m_DriverName) ||
+         version.Match(NCBI_INTERFACE_VERSION(ICache)) ==
+         CVersionInfo::eNonCompatible ) {
+        return 0;
+    }
+    string path = GetParam(params, kCFParam_path, false, ".genbank_cache");
+    string name = GetParam(params, kCFParam_name, false, "cache");
+    Uint8 size = GetParamDataSize(params, kCFParam_size, false, 256<<20);
+    int slots = GetParamInt(params, kCFParam_slots, false, 0);
+    CDir(path).CreatePath();
+    unique_ptr<CSharedMemoryCache> cache
+        (new CSharedMemoryCache(s_GetFileName(path, name),
+                                size, size_t(max(slots, 0))));
+    ConfigureICache(cache.get(), params);
+    return cache.release();
+}
+
+
+void NCBI_EntryPoint_xcache_shmem(
+     CPluginManager<ICache>::TDriverInfoList&   info_list,
+     CPluginManager<ICache>::EEntryPointRequest method)
+{
+    CHostEntryPointImpl<CSharedMemoryCacheCF>::NCBI_EntryPointImpl(info_list,
+                                                                   method);
+}
+
+
+void Cache_RegisterDriver_SharedMemory(void)
+{
+    RegisterEntryPoint<ICache>(NCBI_EntryPoint_xcache_shmem);
+}
+
+
+END_NCBI_SCOPE
@@ -0,0 +1,142 @@
+/*  $Id$
+* ===========================================================================
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+* ===========================================================================
+*
+*  Author:  agent
+*
+*  File Description: Test of ICache in a memory mapped file
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbifile.hpp>
+#include <objtools/data_loaders/genbank/cache/shmem_cache.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+
+USING_NCBI_SCOPE;
+
+class CTestApplication : public CNcbiApplication
+{
+public:
+    virtual int Run(void);
+    virtual void Init(void);
+};
+
+
+void CTestApplication::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->AddDefaultKey("count", "Count",
+                            "number of blobs to store",
+                            CArgDescriptions::eInteger, "10000");
+    string prog_description = "test_shmem_cache";
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              prog_description, false);
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+static string s_MakeData(int i)
+{
+    return string(100 + i % 1000, char('a' + i % 26));
+}
+
+
+int CTestApplication::Run(void)
+{
+    const CArgs& args = GetArgs();
+    int count = args["count"].AsInteger();
+
+    CTmpFile tmp;
+    const string& file_name = tmp.GetFileName();
+    // the file is created by the cache itself
+    CFile(file_name).Remove();
+
+    // two cache objects on the same file act as two worker processes
+    CSharedMemoryCache cache1(file_name, 4<<20);
+    CSharedMemoryCache cache2(file_name, 4<<20);
+    _ASSERT(cache1.IsOpen() && cache2.IsOpen());
+
+    // versions
+    string data = s_MakeData(1);
+    cache1.Store("key", 2, "subkey", data.data(), data.size());
+    _ASSERT(cache2.HasBlobs("key", "subkey"));
+    _ASSERT(!cache2.HasBlobs("key", "other"));
+    char buffer[4096];
+    ICache::SBlobAccessDescr descr(buffer, sizeof(buffer));
+    descr.return_current_version = true;
+    cache2.GetBlobAccess("key", 0, "subkey", &descr);
+    _ASSERT(descr.return_current_version_supported);
+    _ASSERT(descr.current_version == 2);
+    _ASSERT(descr.blob_found);
+    _ASSERT(string(buffer, descr.blob_size) == data);
+    cache2.SetBlobVersionAsCurrent("key", "subkey", 3);
+    ICache::TBlobVersion version = 0;
+    ICache::EBlobVersionValidity validity;
+    unique_ptr<IReader> reader
+        (cache1.GetReadStream("key", "subkey", &version, &validity));
+    _ASSERT(version == 3);
+    _ASSERT(!reader.get());
+    cache1.Remove("key", 2, "subkey");
+    _ASSERT(cache2.GetSize("key", 2, "subkey") == 0);
+
+    // eviction: the ring buffer is smaller than all the data
+    size_t total_size = 0;
+    for ( int i = 0; i < count; ++i ) {
+        string data = s_MakeData(i);
+        total_size += data.size();
+        unique_ptr<IWriter> writer
+            (cache1.GetWriteStream(NStr::IntToString(i), i, "blob"));
+        writer->Write(data.data(), data.size());
+    }
+    int found_count = 0;
+    for ( int i = 0; i < count; ++i ) {
+        string key = NStr::IntToString(i);
+        size_t size = cache2.GetSize(key, i, "blob");
+        if ( !size ) {
+            continue;
+        }
+        ++found_count;
+        string data(size, '\0');
+        _VERIFY(cache2.Read(key, i, "blob", &data[0], size));
+        _ASSERT(data == s_MakeData(i));
+    }
+    NcbiCout << "Stored " << count << " blobs of " << total_size
+             << " bytes, found " << found_count << NcbiEndl;
+    _ASSERT(found_count > 0);
+    // the last stored blob is never evicted
+    _ASSERT(cache2.GetSize(NStr::IntToString(count-1), count-1, "blob"));
+
+    NcbiCout << "Passed" << NcbiEndl;
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestApplication().AppMain(argc, argv);
+}
@@ -39,6 +39,8 @@
 #include <objects/seq/Seq_inst.hpp>
 
 #include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <serial/serial.hpp>
 #include <corelib/ncbifile.hpp>
 
 #include <objtools/edit/huge_asn_reader.hpp>
@@ -93,6 +95,7 @@ bool CHugeAsnReader::IsHugeSet(CBioseq_set::TClass setClass)
 void CHugeAsnReader::Open(CHugeFile* file, ILineErrorListener * pMessageListener)
 {
     x_ResetIndex();
+    CloseIndex();
 
     m_file = file;
     mp_MessageListener = pMessageListener;
@@ -237,7 +240,11 @@ bool CHugeAsnReader::GetNextBlob()
     if (m_next_pos >= m_file->m_filesize)
         return false;
 
-    x_IndexNextAsn1();
+    if (auto blob = x_FindIndexedBlob(m_next_pos); blob) {
+        x_LoadIndexedBlob(*blob);
+    } else {
+        x_IndexNextAsn1();
+    }
     return true;
 }
 
@@ -464,6 +471,313 @@ CRef<CSerialObject> CHugeAsnReader::ReadAny()
 }
 
 
+// Sidecar index layout; all numbers are in native byte order and all
+// records are 8-byte aligned, so the file can be used straight from
+// the memory mapping:
+//   SIndexHeader
+//   for every blob: SIndexSet[set_count], SIndexBioseq[bioseq_count] and
+//     the ASN.1 binary data of the blob (submit block, descriptors of the
+//     sets, then ids and descriptors of the bioseqs, in record order)
+//   SIndexBlob[blob_count], sorted by position
+static const char   kIndexMagic[8] = { 'H', 'U', 'G', 'E', 'A', 'S', 'N', 'X' };
+static const Uint4  kIndexVersion  = 1;
+
+namespace
+{
+    struct SIndexHeader
+    {
+        char  magic[8];
+        Uint4 version;
+        Uint4 blob_count;
+        Uint8 blobs_offset;
+        Uint8 file_size;
+        Int8  file_mtime;
+    };
+
+    enum EIndexFlags : Uint4
+    {
+        fIndex_HasDescr        = 1 << 0,
+        fIndex_HasAnnot        = 1 << 1,
+        fIndex_HasLevel        = 1 << 2,
+        fIndex_HasSubmitBlock  = 1 << 3,
+        fIndex_HasHugeSetAnnot = 1 << 4,
+    };
+
+    struct SIndexSet
+    {
+        Uint8 pos;
+        Int4  parent; // -1 for the root set
+        Int4  set_class;
+        Int4  level;
+        Uint4 flags;
+    };
+
+    struct SIndexBioseq
+    {
+        Uint8 pos;
+        Int4  parent;
+        Uint4 length;
+        Int4  mol;
+        Int4  repr;
+        Uint4 id_count;
+        Uint4 flags;
+    };
+
+    void s_WriteIndexData(CNcbiOstream& out, const void* data, size_t size)
+    {
+        static const char kPadding[8] = {};
+        out.write(static_cast<const char*>(data), size);
+        out.write(kPadding, (8 - size % 8) % 8);
+    }
+
+    // checks that count records of record_size bytes at offset lie
+    // after the header and end before limit
+    bool s_IsValidIndexRange(Uint8 offset, Uint8 count, Uint8 record_size, Uint8 limit)
+    {
+        return offset % 8 == 0 && offset >= sizeof(SIndexHeader) && offset <= limit &&
+            count <= (limit - offset) / record_size;
+    }
+
+    Int8 s_GetModificationTime(const string& filename)
+    {
+        time_t mtime = 0;
+        if (!CFile(filename).GetTimeT(&mtime))
+            return -1;
+        return mtime;
+    }
+}
+
+struct CHugeAsnReader::SIndexBlob
+{
+    Uint8 pos;
+    Uint8 next_pos;
+    Uint8 sets_offset;
+    Uint8 bioseqs_offset;
+    Uint8 data_offset;
+    Uint8 data_size;
+    Uint4 set_count;
+    Uint4 bioseq_count;
+    Int4  max_local_id;
+    Uint4 flags;
+};
+
+
+string CHugeAsnReader::GetIndexName(const string& filename)
+{
+    return filename + ".hidx";
+}
+
+void CHugeAsnReader::x_WriteBlobIndex(CNcbiOstream& out, SIndexBlob& blob) const
+{
+    blob.pos = m_current_pos;
+    blob.next_pos = m_next_pos;
+    blob.max_local_id = m_max_local_id;
+    blob.flags = (m_submit_block ? fIndex_HasSubmitBlock : 0) |
+        (m_HasHugeSetAnnot ? fIndex_HasHugeSetAnnot : 0);
+
+    CNcbiOstrstream data;
+    unique_ptr<CObjectOStream> data_out(CObjectOStream::Open(eSerial_AsnBinary, data));
+    if (m_submit_block)
+        *data_out << *m_submit_block;
+
+    map<const TBioseqSetInfo*, Int4> set_index;
+    vector<SIndexSet> sets;
+    sets.reserve(m_bioseq_set_list.size());
+    for (auto& info: m_bioseq_set_list) {
+        auto parent = info.m_parent_set == m_bioseq_set_list.end() ? -1 : set_index[&*info.m_parent_set];
+        set_index[&info] = Int4(sets.size());
+        sets.push_back({ Uint8(info.m_pos), parent, info.m_class,
+            info.m_Level.value_or(0),
+            (info.m_descr ? fIndex_HasDescr : 0) |
+            (info.m_HasAnnot ? fIndex_HasAnnot : 0) |
+            (info.m_Level ? fIndex_HasLevel : 0) });
+        if (info.m_descr)
+            *data_out << *info.m_descr;
+    }
+
+    vector<SIndexBioseq> bioseqs;
+    bioseqs.reserve(m_bioseq_list.size());
+    for (auto& info: m_bioseq_list) {
+        bioseqs.push_back({ Uint8(info.m_pos), set_index[&*info.m_parent_set],
+            info.m_length, info.m_mol, info.m_repr, Uint4(info.m_ids.size()),
+            info.m_descr ? fIndex_HasDescr : 0 });
+        for (auto& id: info.m_ids)
+            *data_out << *id;
+        if (info.m_descr)
+            *data_out << *info.m_descr;
+    }
+    data_out->Close();
+
+    blob.set_count = Uint4(sets.size());
+    blob.sets_offset = out.tellp();
+    s_WriteIndexData(out, sets.data(), sets.size() * sizeof(SIndexSet));
+    blob.bioseq_count = Uint4(bioseqs.size());
+    blob.bioseqs_offset = out.tellp();
+    s_WriteIndexData(out, bioseqs.data(), bioseqs.size() * sizeof(SIndexBioseq));
+    string str = CNcbiOstrstreamToString(data);
+    blob.data_offset = out.tellp();
+    blob.data_size = str.size();
+    s_WriteIndexData(out, str.data(), str.size());
+}
+
+void CHugeAsnReader::WriteIndex(const string& index_name) const
+{
+    if (!m_file || !m_file->IsOpen())
+        NCBI_THROW(CFileException, eNotExists, "Cannot index a file which is not open");
+
+    SIndexHeader header = {};
+    header.version = kIndexVersion;
+    header.file_size = m_file->m_filesize;
+    header.file_mtime = s_GetModificationTime(m_file->m_filename);
+
+    CNcbiOfstream out(index_name.c_str(), ios::binary | ios::trunc);
+    // the header goes last, so that an incomplete index is never accepted
+    s_WriteIndexData(out, &header, sizeof(header));
+
+    // a plain reader so that the state of this one is left untouched
+    CHugeAsnReader scanner(m_file, nullptr);
+    vector<SIndexBlob> blobs;
+    while (scanner.GetNextBlob()) {
+        blobs.push_back({});
+        scanner.x_WriteBlobIndex(out, blobs.back());
+    }
+
+    header.blob_count = Uint4(blobs.size());
+    header.blobs_offset = out.tellp();
+    s_WriteIndexData(out, blobs.data(), blobs.size() * sizeof(SIndexBlob));
+    memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.close();
+    if (!out)
+        NCBI_THROW(CFileException, eFileIO, "Cannot write index " + index_name);
+}
+
+bool CHugeAsnReader::OpenIndex(const string& index_name)
+{
+    CloseIndex();
+    if (!m_file || !m_file->IsOpen() || CFile(index_name).GetLength() < Int8(sizeof(SIndexHeader)))
+        return false;
+
+    auto index = make_unique<CMemoryFile>(index_name);
+    auto data = (const char*)index->GetPtr();
+    auto size = Uint8(index->GetSize());
+    auto header = (const SIndexHeader*)data;
+    if (!data ||
+        memcmp(header->magic, kIndexMagic, sizeof(header->magic)) != 0 ||
+        header->version != kIndexVersion ||
+        header->file_size != Uint8(m_file->m_filesize) ||
+        header->file_mtime != s_GetModificationTime(m_file->m_filename) ||
+        !s_IsValidIndexRange(header->blobs_offset, header->blob_count, sizeof(SIndexBlob), size))
+        return false;
+
+    // GetNextBlob() uses the records as they are, so every offset, count
+    // and parent reference is checked once here
+    auto blobs = (const SIndexBlob*)(data + header->blobs_offset);
+    Uint8 prev_next_pos = 0;
+    for (auto blob = blobs; blob != blobs + header->blob_count; ++blob) {
+        if (blob->pos < prev_next_pos || blob->next_pos <= blob->pos ||
+            blob->next_pos > header->file_size ||
+            !s_IsValidIndexRange(blob->sets_offset, blob->set_count, sizeof(SIndexSet), header->blobs_offset) ||
+            !s_IsValidIndexRange(blob->bioseqs_offset, blob->bioseq_count, sizeof(SIndexBioseq), header->blobs_offset) ||
+            !s_IsValidIndexRange(blob->data_offset, blob->data_size, 1, header->blobs_offset))
+            return false;
+        prev_next_pos = blob->next_pos;
+
+        auto sets = (const SIndexSet*)(data + blob->sets_offset);
+        for (Uint4 i = 0; i < blob->set_count; ++i) {
+            if (sets[i].parent < -1 || sets[i].parent >= Int4(i))
+                return false;
+        }
+        auto bioseqs = (const SIndexBioseq*)(data + blob->bioseqs_offset);
+        for (Uint4 i = 0; i < blob->bioseq_count; ++i) {
+            if (bioseqs[i].parent < 0 || Uint4(bioseqs[i].parent) >= blob->set_count)
+                return false;
+        }
+    }
+
+    m_index = std::move(index);
+    return true;
+}
+
+void CHugeAsnReader::CloseIndex()
+{
+    m_index.reset();
+}
+
+const CHugeAsnReader::SIndexBlob* CHugeAsnReader::x_FindIndexedBlob(TFileSize pos) const
+{
+    if (!m_index)
+        return nullptr;
+
+    auto data = (const char*)m_index->GetPtr();
+    auto header = (const SIndexHeader*)data;
+    auto begin = (const SIndexBlob*)(data + header->blobs_offset);
+    auto end = begin + header->blob_count;
+    auto it = lower_bound(begin, end, Uint8(pos),
+        [](const SIndexBlob& blob, Uint8 pos) { return blob.pos < pos; });
+    if (it == end || it->pos != Uint8(pos))
+        return nullptr;
+    return it;
+}
+
+void CHugeAsnReader::x_LoadIndexedBlob(const SIndexBlob& blob)
+{
+    x_ResetIndex();
+    m_current_pos = blob.pos;
+    m_next_pos = blob.next_pos;
+    m_max_local_id = blob.max_local_id;
+    m_HasHugeSetAnnot = (blob.flags & fIndex_HasHugeSetAnnot) != 0;
+
+    auto data = (const char*)m_index->GetPtr();
+    unique_ptr<CObjectIStream> in(CObjectIStream::CreateFromBuffer(
+        eSerial_AsnBinary, data + blob.data_offset, blob.data_size));
+    in->UseMemoryPool();
+
+    if (blob.flags & fIndex_HasSubmitBlock) {
+        auto submit_block = Ref(new CSubmit_block);
+        *in >> *submit_block;
+        m_submit_block = submit_block;
+    }
+
+    vector<TBioseqSetList::iterator> sets;
+    sets.reserve(blob.set_count);
+    auto set_rec = (const SIndexSet*)(data + blob.sets_offset);
+    for (auto rec = set_rec; rec != set_rec + blob.set_count; ++rec) {
+        auto parent = rec->parent < 0 ? m_bioseq_set_list.end() : sets[rec->parent];
+        auto& info = m_bioseq_set_list.emplace_back(TBioseqSetInfo{ TFileSize(rec->pos), parent,
+            CBioseq_set::TClass(rec->set_class) });
+        info.m_HasAnnot = (rec->flags & fIndex_HasAnnot) != 0;
+        if (rec->flags & fIndex_HasLevel)
+            info.m_Level = rec->level;
+        if (rec->flags & fIndex_HasDescr) {
+            auto descr = Ref(new CSeq_descr);
+            *in >> *descr;
+            info.m_descr = descr;
+        }
+        sets.push_back(prev(m_bioseq_set_list.end()));
+    }
+
+    auto bioseq_rec = (const SIndexBioseq*)(data + blob.bioseqs_offset);
+    for (auto rec = bioseq_rec; rec != bioseq_rec + blob.bioseq_count; ++rec) {
+        auto& info = m_bioseq_list.emplace_back(TBioseqInfo{ TFileSize(rec->pos), sets[rec->parent],
+            rec->length });
+        info.m_mol = CSeq_inst::TMol(rec->mol);
+        info.m_repr = CSeq_inst::TRepr(rec->repr);
+        for (Uint4 i = 0; i < rec->id_count; ++i) {
+            auto id = Ref(new CSeq_id);
+            *in >> *id;
+            info.m_ids.push_back(id);
+        }
+        if (rec->flags & fIndex_HasDescr) {
+            auto descr = Ref(new CSeq_descr);
+            *in >> *descr;
+            info.m_descr = descr;
+        }
+    }
+}
+
+
 CHugeAsnReader::TStreamPos CHugeAsnReader::GetCurrentPos() const
 {
     return m_current_pos;
@@ -96,6 +96,7 @@ void CHugeFileDemoApp::Init()
     arg_desc->AddFlag("rw1848", "Testing RW-1848");
 
     arg_desc->AddFlag("traditional", "Open file in traditional mode");
+    arg_desc->AddFlag("index", "Use the sidecar index of the input file, (re)creating it when missing or out of date");
 
     SetupArgDescriptions(arg_desc.release());
 }
@@ -111,6 +112,11 @@ int CHugeFileDemoApp::Run()
 
     edit::CHugeFileProcess huge;
     huge.Open(filename);
+    if (GetArgs()["index"] && !huge.OpenIndex()) {
+        std::cerr << "Writing index " << edit::CHugeAsnReader::GetIndexName(filename) << std::endl;
+        huge.WriteIndex();
+        huge.OpenIndex();
+    }
 
     // context doesn't have huge' classes anymore, existing implementations should use traditional OM classes and approaches
     // huge classes are used only for opening files and non-standard algorithms
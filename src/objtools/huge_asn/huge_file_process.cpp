@@ -127,6 +127,18 @@ void CHugeFileProcess::OpenReader()
     m_pReader->Open(m_pHugeFile.get(), nullptr);
 }
 
+void CHugeFileProcess::WriteIndex(const string& index_name)
+{
+    m_pReader->WriteIndex(index_name.empty() ?
+        CHugeAsnReader::GetIndexName(m_pHugeFile->m_filename) : index_name);
+}
+
+bool CHugeFileProcess::OpenIndex(const string& index_name)
+{
+    return m_pReader->OpenIndex(index_name.empty() ?
+        CHugeAsnReader::GetIndexName(m_pHugeFile->m_filename) : index_name);
+}
+
 CHugeFileProcess::~CHugeFileProcess()
 {
 }
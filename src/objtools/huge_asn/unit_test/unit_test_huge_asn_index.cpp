@@ -0,0 +1,249 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* Author:  agent
+*
+* File Description:
+*   Round trip of the CHugeAsnReader sidecar index: the records restored
+*   from the index must be the same as the ones collected by a plain scan.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbifile.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <objtools/huge_asn/huge_file.hpp>
+#include <objtools/huge_asn/huge_asn_reader.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <serial/serial.hpp>
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+USING_SCOPE(edit);
+
+namespace
+{
+
+const char* const kEntries =
+    "Seq-entry ::= set {\n"
+    "  level 1,\n"
+    "  class genbank,\n"
+    "  descr { title \"top\" },\n"
+    "  seq-set {\n"
+    "    set {\n"
+    "      class nuc-prot,\n"
+    "      descr { title \"np1\" },\n"
+    "      seq-set {\n"
+    "        seq { id { local str \"nuc1\" },\n"
+    "              inst { repr raw, mol dna, length 4, seq-data iupacna \"ACGT\" } },\n"
+    "        seq { id { local str \"prot1\" }, descr { title \"protein\" },\n"
+    "              inst { repr raw, mol aa, length 2, seq-data iupacaa \"MK\" } }\n"
+    "      }\n"
+    "    },\n"
+    "    seq { id { local str \"nuc2\", genbank { accession \"AB000001\", version 1 } },\n"
+    "          inst { repr raw, mol dna, length 3, seq-data iupacna \"ACG\" } }\n"
+    "  }\n"
+    "}\n"
+    "Seq-entry ::= seq {\n"
+    "  id { local str \"single\" },\n"
+    "  inst { repr raw, mol rna, length 5, seq-data iupacna \"ACGTA\" },\n"
+    "  annot { { data ftable { {\n"
+    "    id local id 42,\n"
+    "    data comment NULL,\n"
+    "    location whole local str \"single\" } } } }\n"
+    "}\n";
+
+string s_DescrToString(const CConstRef<CSeq_descr>& descr)
+{
+    if (!descr)
+        return "-";
+    CNcbiOstrstream out;
+    out << MSerial_AsnText << *descr;
+    return CNcbiOstrstreamToString(out);
+}
+
+// Flattens everything GetNextBlob() collects for the current blob
+string s_DumpBlob(const CHugeAsnReader& reader)
+{
+    CNcbiOstrstream out;
+    out << "max_local_id " << reader.GetMaxLocalId()
+        << " huge_set_annot " << reader.HasHugeSetAnnot() << "\n";
+    map<const CHugeAsnReader::TBioseqSetInfo*, size_t> set_index;
+    for (auto& info: reader.GetBiosets()) {
+        set_index.emplace(&info, set_index.size());
+        out << "set " << info.m_pos << " parent ";
+        if (info.m_parent_set == reader.GetBiosets().end())
+            out << "-";
+        else
+            out << set_index[&*info.m_parent_set];
+        out << " class " << info.m_class << " annot " << info.m_HasAnnot
+            << " level " << (info.m_Level ? NStr::IntToString(*info.m_Level) : "-")
+            << " descr " << s_DescrToString(info.m_descr) << "\n";
+    }
+    for (auto& info: reader.GetBioseqs()) {
+        out << "bioseq " << info.m_pos << " parent " << set_index[&*info.m_parent_set]
+            << " length " << info.m_length << " mol " << info.m_mol << " repr " << info.m_repr
+            << " ids";
+        for (auto& id: info.m_ids)
+            out << " " << id->AsFastaString();
+        out << " descr " << s_DescrToString(info.m_descr) << "\n";
+    }
+    return CNcbiOstrstreamToString(out);
+}
+
+vector<string> s_ReadBlobs(CHugeAsnReader& reader)
+{
+    vector<string> blobs;
+    while (reader.GetNextBlob())
+        blobs.push_back(s_DumpBlob(reader));
+    return blobs;
+}
+
+struct SHugeAsnFixture
+{
+    SHugeAsnFixture()
+        : m_FileName(CFile::GetTmpName(CFile::eTmpFileCreate)),
+          m_IndexName(CHugeAsnReader::GetIndexName(m_FileName))
+    {
+        CNcbiOfstream(m_FileName.c_str()) << kEntries;
+        m_File.Open(m_FileName, &m_Types);
+    }
+    ~SHugeAsnFixture()
+    {
+        CFile(m_FileName).Remove();
+        CFile(m_IndexName).Remove();
+    }
+
+    void PatchIndex(size_t offset, Uint8 value)
+    {
+        CFileIO io;
+        io.Open(m_IndexName, CFileIO::eOpen, CFileIO::eReadWrite);
+        io.SetFilePos(offset, CFileIO::eBegin);
+        io.Write(&value, sizeof(value));
+    }
+    Uint8 ReadIndex(size_t offset)
+    {
+        Uint8 value = 0;
+        CFileIO io;
+        io.Open(m_IndexName, CFileIO::eOpen, CFileIO::eRead);
+        io.SetFilePos(offset, CFileIO::eBegin);
+        io.Read(&value, sizeof(value));
+        return value;
+    }
+
+    string    m_FileName;
+    string    m_IndexName;
+    set<TTypeInfo> m_Types{ CSeq_entry::GetTypeInfo() };
+    CHugeFile m_File;
+};
+
+// offsets of the header fields and of the blob records in the index file
+const size_t kHeaderBlobsOffset = 16;
+const size_t kBlobSetsOffset    = 16;
+const size_t kBlobDataOffset    = 32;
+
+}
+
+
+BOOST_FIXTURE_TEST_CASE(TestIndexRoundTrip, SHugeAsnFixture)
+{
+    CHugeAsnReader scanner(&m_File, nullptr);
+    auto scanned = s_ReadBlobs(scanner);
+    BOOST_REQUIRE_EQUAL(scanned.size(), 2u);
+
+    scanner.WriteIndex(m_IndexName);
+
+    CHugeAsnReader indexed(&m_File, nullptr);
+    BOOST_REQUIRE(indexed.OpenIndex(m_IndexName));
+    BOOST_CHECK(indexed.HasIndex());
+    auto restored = s_ReadBlobs(indexed);
+    BOOST_REQUIRE_EQUAL(restored.size(), scanned.size());
+    for (size_t i = 0; i < scanned.size(); ++i)
+        BOOST_CHECK_EQUAL(restored[i], scanned[i]);
+
+    // the flattened view used by the data loader must not change either
+    CHugeAsnReader plain(&m_File, nullptr);
+    BOOST_REQUIRE(plain.GetNextBlob());
+    plain.FlattenGenbankSet();
+    CHugeAsnReader flattened(&m_File, nullptr);
+    BOOST_REQUIRE(flattened.OpenIndex(m_IndexName));
+    BOOST_REQUIRE(flattened.GetNextBlob());
+    flattened.FlattenGenbankSet();
+    BOOST_REQUIRE_EQUAL(flattened.GetTopIds().size(), plain.GetTopIds().size());
+    for (auto it1 = plain.GetTopIds().begin(), it2 = flattened.GetTopIds().begin();
+         it1 != plain.GetTopIds().end(); ++it1, ++it2)
+        BOOST_CHECK_EQUAL((*it2)->AsFastaString(), (*it1)->AsFastaString());
+    auto id = Ref(new CSeq_id("lcl|prot1"));
+    BOOST_CHECK(flattened.LoadBioseq(id)->Equals(*plain.LoadBioseq(id)));
+}
+
+
+BOOST_FIXTURE_TEST_CASE(TestIndexRejected, SHugeAsnFixture)
+{
+    CHugeAsnReader reader(&m_File, nullptr);
+    BOOST_CHECK(!reader.OpenIndex(m_IndexName));
+    reader.WriteIndex(m_IndexName);
+    BOOST_REQUIRE(reader.OpenIndex(m_IndexName));
+    reader.CloseIndex();
+
+    auto blobs_offset = ReadIndex(kHeaderBlobsOffset);
+
+    // a record pointing past the end of the index
+    PatchIndex(size_t(blobs_offset + kBlobDataOffset), Uint8(-8));
+    BOOST_CHECK(!reader.OpenIndex(m_IndexName));
+    BOOST_CHECK(!reader.HasIndex());
+
+    // a record overlapping the blob table
+    reader.WriteIndex(m_IndexName);
+    PatchIndex(size_t(blobs_offset + kBlobSetsOffset), blobs_offset);
+    BOOST_CHECK(!reader.OpenIndex(m_IndexName));
+
+    // a truncated index
+    reader.WriteIndex(m_IndexName);
+    {
+        CFileIO io;
+        io.Open(m_IndexName, CFileIO::eOpen, CFileIO::eReadWrite);
+        io.SetFileSize(blobs_offset + 8, CFileIO::eBegin);
+    }
+    BOOST_CHECK(!reader.OpenIndex(m_IndexName));
+
+    // the indexed file has been modified
+    reader.WriteIndex(m_IndexName);
+    BOOST_REQUIRE(reader.OpenIndex(m_IndexName));
+    reader.CloseIndex();
+    time_t mtime = 0;
+    BOOST_REQUIRE(CFile(m_FileName).GetTimeT(&mtime));
+    mtime -= 3600;
+    BOOST_REQUIRE(CFile(m_FileName).SetTimeT(&mtime, &mtime));
+    BOOST_CHECK(!reader.OpenIndex(m_IndexName));
+
+    // blobs are still read correctly without the index
+    BOOST_CHECK_EQUAL(s_ReadBlobs(reader).size(), 2u);
+}
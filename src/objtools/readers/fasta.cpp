@@ -42,7 +42,9 @@
 #include <objtools/error_codes.hpp>
 
 #include <corelib/ncbiutil.hpp>
+#include <corelib/ncbi_system.hpp>
 #include <util/format_guess.hpp>
+#include <util/thread_pool.hpp>
 #include <util/sequtil/sequtil_convert.hpp>
 
 #include <objects/general/Object_id.hpp>
@@ -84,6 +86,7 @@
 #include <objtools/readers/mod_reader.hpp>
 
 #include <ctype.h>
+#include <typeinfo>
 
 // The "49518053" is just a random number to minimize the chance of the
 // variable name conflicting with another variable name and has no
@@ -471,6 +474,300 @@ CRef<CSeq_entry> CFastaReader::ReadSet(int max_seqs, ILineErrorListener * pMessa
     }
 }
 
+
+struct CFastaReader::SDeferredIDs
+{
+    Uint8        line_number;
+    size_t       message_count; // messages of the batch preceding the check
+    CBioseq::TId ids;
+};
+
+
+// Serves one batch of records copied out of the main input, reporting
+// line numbers and positions as they were in the original input.
+class CFastaBatchLineReader : public ILineReader
+{
+public:
+    CFastaBatchLineReader(Uint8 first_line, Int8 start_pos)
+        : m_FirstLine(first_line), m_StartPos(start_pos) {}
+
+    string& SetData(void) { return m_Data; }
+    void Start(void)
+        { m_Reader.reset(new CMemoryLineReader(m_Data.data(), m_Data.size())); }
+
+    bool AtEOF(void) const override { return m_Reader->AtEOF(); }
+    char PeekChar(void) const override { return m_Reader->PeekChar(); }
+    ILineReader& operator++(void) override { ++*m_Reader; return *this; }
+    void UngetLine(void) override { m_Reader->UngetLine(); }
+    CTempString operator*(void) const override { return **m_Reader; }
+    CT_POS_TYPE GetPosition(void) const override
+        { return NcbiInt8ToStreampos(
+              m_StartPos + NcbiStreamposToInt8(m_Reader->GetPosition())); }
+    Uint8 GetLineNumber(void) const override
+        { return m_FirstLine + m_Reader->GetLineNumber(); }
+
+private:
+    Uint8  m_FirstLine; // lines preceding the batch
+    Int8   m_StartPos;
+    string m_Data;
+    unique_ptr<CMemoryLineReader> m_Reader;
+};
+
+
+class CFastaBatchTask : public CThreadPool_Task
+{
+public:
+    CFastaBatchTask(CFastaBatchLineReader* lr, bool collect_messages)
+        : m_LineReader(lr), m_Done(0, 1)
+    {
+        if (collect_messages) {
+            m_Messages.reset(new CMessageListenerLenient);
+        }
+    }
+
+    void SetReader(unique_ptr<CFastaReader> reader)
+    {
+        m_Reader = std::move(reader);
+        m_Reader->m_DeferredIDs = &m_DeferredIDs;
+    }
+    void SetEndPosition(Int8 pos) { m_ExpectedEndPos = pos; }
+
+    EStatus Execute(void) override
+    {
+        try {
+            m_LineReader->Start();
+            m_NeedsGeneratedID = !x_Read(*m_Reader, m_Messages.get());
+            _ASSERT(m_NeedsGeneratedID  ||  m_ExpectedEndPos < 0  ||
+                    NcbiStreamposToInt8(m_LineReader->GetPosition())
+                    == m_ExpectedEndPos);
+        } catch (...) {
+            m_Exception = current_exception();
+        }
+        m_Reader.reset();
+        if ( !m_NeedsGeneratedID ) {
+            m_LineReader.Reset();
+        }
+        m_Done.Post();
+        return eCompleted;
+    }
+
+    void Wait(void) { m_Done.Wait(); }
+
+    // Parse the batch again in the calling thread, with IDs generated
+    // and checked right away, as ReadSet() does.
+    void ReadInOrder(const CFastaReader& main_reader,
+                     ILineErrorListener* pMessageListener)
+    {
+        m_Entries.clear();
+        m_LineReader->Start();
+        x_Read(*main_reader.x_CreateBatchReader(*m_LineReader), pMessageListener);
+        m_LineReader.Reset();
+    }
+
+    vector<CRef<CSeq_entry>>           m_Entries;
+    unique_ptr<CMessageListenerLenient> m_Messages;
+    vector<CFastaReader::SDeferredIDs>  m_DeferredIDs;
+    exception_ptr                      m_Exception;
+    // the batch was not parsed to the end, see ReadInOrder()
+    bool                               m_NeedsGeneratedID = false;
+
+private:
+    // Returns false if a batch reader stops at a record needing
+    // a generated ID.
+    bool x_Read(CFastaReader& reader, ILineErrorListener* pMessageListener)
+    {
+        while ( !reader.AtEOF() ) {
+            try {
+                CRef<CSeq_entry> entry(reader.ReadOneSeq(pMessageListener));
+                if (reader.m_NeedsGeneratedID) {
+                    return false;
+                }
+                if (entry.NotEmpty()) {
+                    m_Entries.push_back(entry);
+                }
+            } catch (const CObjReaderParseException& e) {
+                if (e.GetErrCode() != CObjReaderParseException::eEOF) {
+                    throw;
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    CRef<CFastaBatchLineReader> m_LineReader;
+    unique_ptr<CFastaReader>    m_Reader;
+    CSemaphore                  m_Done;
+    Int8                        m_ExpectedEndPos = -1;
+};
+
+
+bool CFastaReader::x_CanReadInParallel(void) const
+{
+    // Subclasses may keep state across records that a batch reader
+    // would not see.
+    return typeid(*this) == typeid(CFastaReader)  &&
+        !TestFlag(fOneSeq)  &&  !TestFlag(fNoParseID)  &&
+        !TestFlag(fAligning)  &&  !TestFlag(fInSegSet)  &&
+        !m_MaskVec  &&  m_NextMask.IsNull()  &&
+        m_PostponedMods.empty();
+}
+
+
+unique_ptr<CFastaReader>
+CFastaReader::x_CreateBatchReader(ILineReader& reader) const
+{
+    unique_ptr<CFastaReader> batch(new CFastaReader(reader, GetFlags(), m_fIdCheck));
+    batch->m_iFlags = m_iFlags;
+    batch->m_IDHandler = m_IDHandler;
+    batch->m_ModHandler = m_ModHandler;
+    batch->m_fModFilter = m_fModFilter;
+    batch->m_bModifiedMaxIdLength = m_bModifiedMaxIdLength;
+    batch->m_MaxIDLength = m_MaxIDLength;
+    batch->m_gapNmin = m_gapNmin;
+    batch->m_gap_Unknown_length = m_gap_Unknown_length;
+    batch->m_gap_type = m_gap_type;
+    batch->m_GapsizeToLinkageEvidence = m_GapsizeToLinkageEvidence;
+    batch->m_DefaultLinkageEvidence = m_DefaultLinkageEvidence;
+    batch->m_ignorable = m_ignorable;
+    return batch;
+}
+
+
+CRef<CSeq_entry> CFastaReader::ReadSetParallel(unsigned int num_threads,
+                                               ILineErrorListener * pMessageListener)
+{
+    if (num_threads == 0) {
+        num_threads = CSystemInfo::GetCpuCount();
+    }
+    if (num_threads <= 1  ||  !x_CanReadInParallel()) {
+        return ReadSet(kMax_Int, pMessageListener);
+    }
+
+    // Batches are cut at deflines once they reach either limit; the
+    // number of batches in flight bounds the memory held by the results.
+    const size_t kBatchRecords = 256;
+    const size_t kBatchBytes   = 4 * 1024 * 1024;
+    const size_t kMaxPending   = 4 * num_threads;
+
+    CThreadPool pool(kMaxPending, num_threads, num_threads);
+    deque<CRef<CFastaBatchTask>> pending;
+
+    vector<CRef<CSeq_entry>> entries;
+    bool failed = false;
+
+    // Merge the oldest batch, replaying its messages in input order.
+    auto merge_front = [&]() {
+        CRef<CFastaBatchTask> task = pending.front();
+        pending.pop_front();
+        task->Wait();
+        if (failed) {
+            return;
+        }
+        if (task->m_NeedsGeneratedID) {
+            // all the preceding records are merged by now, so the IDs
+            // are generated and checked for uniqueness in input order
+            task->ReadInOrder(*this, pMessageListener);
+            entries.insert(entries.end(), task->m_Entries.begin(), task->m_Entries.end());
+            return;
+        }
+        entries.insert(entries.end(), task->m_Entries.begin(), task->m_Entries.end());
+        // Replay the messages, checking the deferred IDs where the batch
+        // reader would have checked them.
+        size_t message_count = task->m_Messages ? task->m_Messages->Count() : 0;
+        size_t i = 0;
+        auto replay = [&](size_t count) {
+            for ( ;  i < count;  ++i) {
+                const ILineError& err = task->m_Messages->GetError(i);
+                if ( !pMessageListener->PutError(err) ) {
+                    // as PostWarning() would have done in sequential mode
+                    auto le = dynamic_cast<const CObjReaderLineException*>(&err);
+                    throw CObjReaderParseException(DIAG_COMPILE_INFO, 0,
+                        le ? CObjReaderParseException::EErrCode(le->GetErrCode())
+                           : CObjReaderParseException::eFormat,
+                        le ? le->ErrorMessage() : err.Message(),
+                        err.Line(), err.GetSeverity());
+                }
+            }
+        };
+        for (const auto& deferred : task->m_DeferredIDs) {
+            replay(min(deferred.message_count, message_count));
+            m_BestID = FindBestChoice(deferred.ids, CSeq_id::BestRank);
+            x_CheckUniqueIDs(deferred.ids, deferred.line_number, pMessageListener);
+        }
+        replay(message_count);
+        if (task->m_Exception) {
+            rethrow_exception(task->m_Exception);
+        }
+    };
+
+    try {
+        ILineReader& lr = GetLineReader();
+        while ( !lr.AtEOF() ) {
+            CRef<CFastaBatchLineReader> batch_lr(
+                new CFastaBatchLineReader(LineNumber(), StreamPosition()));
+            string& data = batch_lr->SetData();
+            size_t records = 0;
+            Int8 pos = StreamPosition();
+            while ( !lr.AtEOF() ) {
+                CTempString line = *++lr;
+                // '>?' starts a gap line, not a new record, unless it is
+                // '>?_' (see ReadOneSeq())
+                if (NStr::StartsWith(line, '>')  &&
+                    (!NStr::StartsWith(line, ">?")  ||
+                     NStr::StartsWith(line, ">?_"))) {
+                    if (records == kBatchRecords  ||
+                        (records > 0  &&  data.size() >= kBatchBytes)) {
+                        lr.UngetLine();
+                        break;
+                    }
+                    ++records;
+                }
+                // keep the original line break, so that positions
+                // within the batch match the input (CRLF)
+                Int8 next_pos = StreamPosition();
+                data.append(line.data(), line.size());
+                switch (next_pos - pos - Int8(line.size())) {
+                case 0:  break; // no final line break
+                case 2:  data += "\r\n";  break;
+                default: data += '\n';    break;
+                }
+                pos = next_pos;
+            }
+
+            CRef<CFastaBatchTask> task(
+                new CFastaBatchTask(batch_lr, pMessageListener != nullptr));
+            task->SetReader(x_CreateBatchReader(*batch_lr));
+            task->SetEndPosition(pos);
+            if (pending.size() == kMaxPending) {
+                merge_front();
+            }
+            pending.push_back(task);
+            pool.AddTask(task);
+        }
+        while ( !pending.empty() ) {
+            merge_front();
+        }
+    } catch (...) {
+        // let the batches already handed out finish before unwinding
+        failed = true;
+        while ( !pending.empty() ) {
+            merge_front();
+        }
+        throw;
+    }
+
+    if (entries.size() == 1) {
+        return entries.front();
+    }
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    for (auto& it : entries) {
+        entry->SetSet().SetSeq_set().push_back(it);
+    }
+    entry->Parentize();
+    return entry;
+}
+
 CRef<CSeq_loc> CFastaReader::SaveMask(void)
 {
     m_NextMask.Reset(new CSeq_loc);
@@ -603,14 +900,26 @@ void CFastaReader::ParseDefLine(const TStr& s, ILineErrorListener * pMessageList
     }
 
     if (TestFlag(fUniqueIDs)) {
-        ITERATE (CBioseq::TId, it, GetIDs()) {
-            CSeq_id_Handle h = CSeq_id_Handle::GetHandle(**it);
-            if ( !m_IDHandler->CacheIdHandle(h) ) {
-                FASTA_ERROR(LineNumber(),
-                    "CFastaReader: Seq-id " << h.AsString()
-                    << " is a duplicate around line " << LineNumber(),
-                    CObjReaderParseException::eDuplicateID );
-            }
+        if (m_DeferredIDs) {
+            m_DeferredIDs->push_back(SDeferredIDs{LineNumber(),
+                pMessageListener ? pMessageListener->Count() : 0, GetIDs()});
+        } else {
+            x_CheckUniqueIDs(GetIDs(), LineNumber(), pMessageListener);
+        }
+    }
+}
+
+
+void CFastaReader::x_CheckUniqueIDs(const CBioseq::TId& ids, Uint8 line_number,
+                                    ILineErrorListener * pMessageListener)
+{
+    ITERATE (CBioseq::TId, it, ids) {
+        CSeq_id_Handle h = CSeq_id_Handle::GetHandle(**it);
+        if ( !m_IDHandler->CacheIdHandle(h) ) {
+            FASTA_ERROR(line_number,
+                "CFastaReader: Seq-id " << h.AsString()
+                << " is a duplicate around line " << line_number,
+                CObjReaderParseException::eDuplicateID );
         }
     }
 }
@@ -702,6 +1011,16 @@ bool CFastaReader::IsValidLocalID(const TStr& idString,
 
 void CFastaReader::GenerateID(void)
 {
+    if (m_DeferredIDs) {
+        // A batch reader stops here; generated IDs depend on the records
+        // before this one, so ReadSetParallel() parses the batch again
+        // when it is merged.
+        m_NeedsGeneratedID = true;
+        CRef<CSeq_id> id(new CSeq_id);
+        id->SetLocal().SetId(0);
+        SetIDs().push_back(id);
+        return;
+    }
     CRef<CSeq_id> id = m_IDHandler->GenerateID(TestFlag(fUniqueIDs));
     SetIDs().push_back(id);
 }
@@ -1972,6 +2291,118 @@ void ScanFastaFile(IFastaEntryScan* scanner,
 }
 
 
+CFastaRecordIterator::CFastaRecordIterator(ILineReader& reader,
+                                           EPacking packing)
+    : m_Reader(&reader), m_Packing(packing), m_Valid(false), m_LineNumber(0),
+      m_IdPos(0), m_IdLength(0)
+{
+    x_Read();
+}
+
+
+CFastaRecordIterator& CFastaRecordIterator::operator++(void)
+{
+    x_Read();
+    return *this;
+}
+
+
+CTempString CFastaRecordIterator::GetSequence(void) const
+{
+    return m_Packing == ePacking_None ? CTempString(m_Residues)
+                                      : CTempString(m_Packed);
+}
+
+
+static inline bool s_IsFastaComment(char c)
+{
+    return c == '!'  ||  c == '#'  ||  c == ';';
+}
+
+// As in CFastaReader::ReadOneSeq(), '>?' starts a gap line unless it is
+// followed by '_', which marks a defline.
+static inline bool s_IsFastaGapLine(const CTempString& line)
+{
+    return NStr::StartsWith(line, ">?")  &&  !NStr::StartsWith(line, ">?_");
+}
+
+
+void CFastaRecordIterator::x_Read(void)
+{
+    ILineReader& lr = *m_Reader;
+    m_Valid = false;
+    m_Defline.clear();
+    m_IdPos = m_IdLength = 0;
+    m_Residues.clear();
+    m_Packed.clear();
+
+    // find the defline
+    while ( !lr.AtEOF() ) {
+        CTempString line = NStr::TruncateSpaces_Unsafe(*++lr);
+        if (line.empty()  ||  s_IsFastaComment(line[0])) {
+            continue;
+        }
+        if (line[0] != '>'  ||  s_IsFastaGapLine(line)) {
+            NCBI_THROW2(CObjReaderParseException, eNoDefline,
+                        "CFastaRecordIterator: Expected defline around line " +
+                        NStr::NumericToString(lr.GetLineNumber()),
+                        lr.GetLineNumber());
+        }
+        size_t skip = NStr::StartsWith(line, ">?_") ? 3 : 1;
+        m_Defline.assign(line.data() + skip, line.size() - skip);
+        m_LineNumber = lr.GetLineNumber();
+        m_Valid = true;
+        break;
+    }
+    if ( !m_Valid ) {
+        return;
+    }
+    m_IdPos = m_Defline.find_first_not_of(" \t");
+    if (m_IdPos == NPOS) {
+        m_IdPos = m_Defline.size();
+    }
+    m_IdLength = min(m_Defline.find_first_of(" \t\1", m_IdPos),
+                     m_Defline.size()) - m_IdPos;
+
+    // collect the residues up to the next defline
+    while ( !lr.AtEOF() ) {
+        if (lr.PeekChar() == '>') {
+            CTempString line = *++lr;
+            if ( !s_IsFastaGapLine(line) ) {
+                lr.UngetLine();
+                break;
+            }
+            continue; // gap line
+        }
+        CTempString line = NStr::TruncateSpaces_Unsafe(*++lr);
+        if (line.empty()  ||  s_IsFastaComment(line[0])) {
+            continue;
+        }
+        const char* p   = line.data();
+        const char* end = p + line.size();
+        const char* ws;
+        while ((ws = find_if(p, end, [](char c) { return c == ' '  ||  c == '\t'; })) != end) {
+            m_Residues.append(p, ws);
+            p = ws + 1;
+        }
+        m_Residues.append(p, end);
+    }
+
+    if (m_Packing != ePacking_None  &&  !m_Residues.empty()) {
+        TSeqPos length = GetLength();
+        CSeqUtil::ECoding coding = CSeqUtil::e_Ncbi4na;
+        size_t packed_size = (length + 1) / 2;
+        if (m_Packing == ePacking_2na) {
+            coding = CSeqUtil::e_Ncbi2na;
+            packed_size = (length + 3) / 4;
+        }
+        m_Packed.resize(packed_size);
+        CSeqConvert::Convert(m_Residues.data(), CSeqUtil::e_Iupacna, 0, length,
+                             &m_Packed[0], coding);
+    }
+}
+
+
 static void s_AppendMods(
         const CModHandler::TModList& mods,
         string& title
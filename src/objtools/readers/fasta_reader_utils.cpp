@@ -466,9 +466,7 @@ CRef<CSeq_id> CSeqIdGenerator::GenerateID(const bool advance)
 CRef<CSeq_id> CSeqIdGenerator::GenerateID(const string& defline, const bool advance)
 {
     CRef<CSeq_id> seq_id(new CSeq_id);
-    auto n = m_Counter.load();
-    if (advance)
-        m_Counter++;
+    auto n = advance ? m_Counter++ : m_Counter.load();
 
     if (m_Prefix.empty()  &&  m_Suffix.empty()) {
         seq_id->SetLocal().SetId(n);
@@ -0,0 +1,238 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Check CFastaRecordIterator against CFastaReader, and compare the
+ *   record rates of the two.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/line_reader.hpp>
+#include <util/random_gen.hpp>
+#include <util/sequtil/sequtil_convert.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <objtools/readers/fasta.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+class CTestFastaRecordIterator : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+private:
+    void x_Generate(int records, int length);
+    bool x_Check(void);
+    void x_Report(const char* name, size_t records, double seconds);
+    void x_TimeReader(void);
+    void x_TimeIterator(CFastaRecordIterator::EPacking packing,
+                        const char* name);
+
+    string m_Data;
+    bool   m_Generated;
+};
+
+
+void CTestFastaRecordIterator::Init(void)
+{
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+    d->SetUsageContext(GetArguments().GetProgramBasename(),
+                       "FASTA record iterator test");
+    d->AddOptionalKey("i", "file", "nucleotide FASTA file to read instead "
+                      "of generated data", CArgDescriptions::eInputFile);
+    d->AddDefaultKey("records", "count",
+                     "number of generated records",
+                     CArgDescriptions::eInteger, "200000");
+    d->AddDefaultKey("length", "residues",
+                     "average length of the generated records",
+                     CArgDescriptions::eInteger, "500");
+    d->AddFlag("nobench", "only compare results, do not report timings");
+    SetupArgDescriptions(d.release());
+}
+
+
+void CTestFastaRecordIterator::x_Generate(int records, int length)
+{
+    static const char kBases[] = "ACGTacgtNRYK";
+    CRandom rnd(1);
+    m_Data = "; generated\n";
+    for ( int i = 0; i < records; ++i ) {
+        // '>?_' marks a defline, not a gap line
+        m_Data += (i % 97 == 1 ? ">?_lcl|seq" : ">lcl|seq") +
+            NStr::IntToString(i) + " record " + NStr::IntToString(i) + "\n";
+        int len = rnd.GetRand(1, 2 * length);
+        for ( int pos = 0; pos < len; ++pos ) {
+            m_Data += kBases[rnd.GetRand(0, pos % 300 < 10 ? 11 : 3)];
+            if ( pos % 60 == 59  ||  pos == len - 1 ) {
+                m_Data += '\n';
+            }
+        }
+    }
+}
+
+
+bool CTestFastaRecordIterator::x_Check(void)
+{
+    CMemoryLineReader lr(m_Data.data(), m_Data.size());
+    CFastaReader reader(lr, CFastaReader::fAssumeNuc | CFastaReader::fForceType |
+                        CFastaReader::fNoSplit | CFastaReader::fLeaveAsText);
+
+    CMemoryLineReader lr_2na(m_Data.data(), m_Data.size());
+    CFastaRecordIterator it(lr_2na, CFastaRecordIterator::ePacking_2na);
+    CMemoryLineReader lr_4na(m_Data.data(), m_Data.size());
+    CFastaRecordIterator it_4na(lr_4na, CFastaRecordIterator::ePacking_4na);
+
+    string residues, packed;
+    size_t count = 0;
+    for ( ;  !lr.AtEOF();  ++it, ++it_4na, ++count ) {
+        CRef<CSeq_entry> entry = reader.ReadOneSeq();
+        const CSeq_inst& inst = entry->GetSeq().GetInst();
+        if ( !it  ||  !it_4na ) {
+            ERR_POST(Error << "Iterator ended early at record " << count);
+            return false;
+        }
+        residues = inst.GetSeq_data().GetIupacna().Get();
+        if ( it.GetLength() != inst.GetLength()  ||
+             it.GetLength() != residues.size() ) {
+            ERR_POST(Error << "Length mismatch for " << it.GetId());
+            return false;
+        }
+        // Convert() does not shrink the destination
+        packed.erase();
+        CSeqConvert::Convert(residues, CSeqUtil::e_Iupacna, 0, it.GetLength(),
+                             packed, CSeqUtil::e_Ncbi2na);
+        if ( it.GetSequence() != packed ) {
+            ERR_POST(Error << "ncbi2na mismatch for " << it.GetId());
+            return false;
+        }
+        packed.erase();
+        CSeqConvert::Convert(residues, CSeqUtil::e_Iupacna, 0, it.GetLength(),
+                             packed, CSeqUtil::e_Ncbi4na);
+        if ( it_4na.GetSequence() != packed ) {
+            ERR_POST(Error << "ncbi4na mismatch for " << it.GetId());
+            return false;
+        }
+        string id = entry->GetSeq().GetId().front()->AsFastaString();
+        if ( m_Generated  &&  id != it.GetId() ) {
+            ERR_POST(Error << "ID mismatch: " << id << " vs " << it.GetId());
+            return false;
+        }
+    }
+    if ( it ) {
+        ERR_POST(Error << "Iterator returned extra records");
+        return false;
+    }
+    NcbiCout << "Checked " << count << " records" << NcbiEndl;
+    return true;
+}
+
+
+void CTestFastaRecordIterator::x_Report(const char* name, size_t records,
+                                        double seconds)
+{
+    NcbiCout << setw(24) << left << name << right << fixed
+             << setprecision(0)
+             << setw(12) << records / seconds << " records/s"
+             << setprecision(1)
+             << setw(9) << m_Data.size() / seconds / 1e6 << " MB/s"
+             << NcbiEndl;
+}
+
+
+void CTestFastaRecordIterator::x_TimeReader(void)
+{
+    CMemoryLineReader lr(m_Data.data(), m_Data.size());
+    CFastaReader reader(lr, CFastaReader::fAssumeNuc |
+                        CFastaReader::fNoUserObjs);
+    CStopWatch sw(CStopWatch::eStart);
+    size_t count = 0;
+    while ( !lr.AtEOF() ) {
+        reader.ReadOneSeq();
+        ++count;
+    }
+    x_Report("CFastaReader", count, sw.Elapsed());
+}
+
+
+void CTestFastaRecordIterator::x_TimeIterator(
+    CFastaRecordIterator::EPacking packing, const char* name)
+{
+    CMemoryLineReader lr(m_Data.data(), m_Data.size());
+    CStopWatch sw(CStopWatch::eStart);
+    size_t count = 0;
+    for ( CFastaRecordIterator it(lr, packing);  it;  ++it ) {
+        ++count;
+    }
+    x_Report(name, count, sw.Elapsed());
+}
+
+
+int CTestFastaRecordIterator::Run(void)
+{
+    const CArgs& args = GetArgs();
+    if ( args["i"] ) {
+        CNcbiOstrstream str;
+        NcbiStreamCopy(str, args["i"].AsInputFile());
+        m_Data = CNcbiOstrstreamToString(str);
+        m_Generated = false;
+    } else {
+        x_Generate(args["records"].AsInteger(), args["length"].AsInteger());
+        m_Generated = true;
+    }
+
+    if ( !x_Check() ) {
+        return 1;
+    }
+    if ( !args["nobench"] ) {
+        x_TimeReader();
+        x_TimeIterator(CFastaRecordIterator::ePacking_None,
+                       "CFastaRecordIterator");
+        x_TimeIterator(CFastaRecordIterator::ePacking_2na,
+                       "CFastaRecordIterator 2na");
+        x_TimeIterator(CFastaRecordIterator::ePacking_4na,
+                       "CFastaRecordIterator 4na");
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestFastaRecordIterator().AppMain(argc, argv);
+}
@@ -1649,6 +1649,109 @@ BOOST_AUTO_TEST_CASE(RW1125_RW1245)
             "Could not construct seq-id from '" + idString + "'");
 }
 
+// Read the input both with ReadSet() and ReadSetParallel(), and check
+// that the results and the messages are the same.
+static void s_CheckReadSetParallel(const string& fasta,
+                                   CFastaReader::TFlags flags,
+                                   size_t expected_seqs,
+                                   size_t expected_messages)
+{
+    CMemoryLineReader lr1(fasta.data(), fasta.size());
+    CFastaReader reader1(lr1, flags);
+    reader1.SetMinGaps(5, 100);
+    CMessageListenerLenient sequential_messages;
+    auto pSequential = reader1.ReadSet(kMax_Int, &sequential_messages);
+
+    CMemoryLineReader lr2(fasta.data(), fasta.size());
+    CFastaReader reader2(lr2, flags);
+    reader2.SetMinGaps(5, 100);
+    CMessageListenerLenient parallel_messages;
+    auto pParallel = reader2.ReadSetParallel(4, &parallel_messages);
+
+    BOOST_CHECK_EQUAL(pParallel->GetSet().GetSeq_set().size(), expected_seqs);
+    BOOST_CHECK(pSequential->Equals(*pParallel));
+    BOOST_CHECK_EQUAL(lr1.GetLineNumber(), lr2.GetLineNumber());
+
+    BOOST_REQUIRE_EQUAL(sequential_messages.Count(), expected_messages);
+    BOOST_REQUIRE_EQUAL(parallel_messages.Count(), expected_messages);
+    for (size_t i = 0;  i < expected_messages;  ++i) {
+        const ILineError& expected = sequential_messages.GetError(i);
+        const ILineError& actual = parallel_messages.GetError(i);
+        BOOST_CHECK_EQUAL(actual.Line(), expected.Line());
+        BOOST_CHECK_EQUAL(actual.SeqId(), expected.SeqId());
+        BOOST_CHECK_EQUAL(actual.Message(), expected.Message());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestReadSetParallel)
+{
+    string fasta = "; leading comment\n";
+    for (int i = 0;  i < 2000;  ++i) {
+        // '>?_' is a defline, not a gap
+        fasta += (i % 100 == 50 ? ">?_lcl|seq" : ">lcl|seq") +
+            NStr::IntToString(i) + " record " + NStr::IntToString(i) + "\n";
+        fasta += "ACGTACGTACGTNNNNNNNNNNACGTACGT\n";
+        if (i % 7 == 0) {
+            fasta += ">?unk100\n";
+        }
+        fasta += string(i % 50 + 1, "ACGT"[i % 4]) + "\n";
+    }
+
+    const CFastaReader::TFlags kFlags =
+        CFastaReader::fAssumeNuc | CFastaReader::fParseGaps |
+        CFastaReader::fUniqueIDs;
+
+    s_CheckReadSetParallel(fasta, kFlags, 2000, 0);
+
+    // the same with CRLF line breaks
+    string crlf = NStr::Replace(fasta, "\n", "\r\n");
+    s_CheckReadSetParallel(crlf, kFlags, 2000, 0);
+
+    // a duplicate ID is caught across batches, and reported for the later
+    // record with the line number it has in the input, whichever batch
+    // happens to be parsed first
+    size_t dup_line = count(fasta.begin(), fasta.end(), '\n') + 1;
+    fasta += ">lcl|seq3\nACGT\n";
+    for (int i = 0;  i < 10;  ++i) {
+        CMemoryLineReader lr(fasta.data(), fasta.size());
+        CFastaReader reader(lr, kFlags);
+        CMessageListenerLenient dups;
+        auto pWithDup = reader.ReadSetParallel(4, &dups);
+        BOOST_CHECK_EQUAL(pWithDup->GetSet().GetSeq_set().size(), 2001);
+        BOOST_REQUIRE_EQUAL(dups.Count(), 1);
+        BOOST_CHECK_EQUAL(dups.GetError(0).Problem(),
+                          ILineError::eProblem_GeneralParsingError);
+        BOOST_CHECK_EQUAL(dups.GetError(0).Line(), dup_line);
+    }
+    s_CheckReadSetParallel(fasta, kFlags, 2001, 1);
+    s_CheckReadSetParallel(NStr::Replace(fasta, "\n", "\r\n"), kFlags, 2001, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadSetParallelGeneratedIDs)
+{
+    // Records without IDs in all the batches, local IDs that the generated
+    // ones would run into, and a duplicate ID at the end
+    string fasta;
+    for (int i = 0;  i < 1000;  ++i) {
+        if (i % 300 == 10) {
+            fasta += ">lcl|" + NStr::IntToString(i) + "\n";
+        } else if (i % 3 == 0) {
+            fasta += ">\n";
+        } else {
+            fasta += ">lcl|seq" + NStr::IntToString(i) + "\n";
+        }
+        fasta += string(i % 50 + 1, "ACGT"[i % 4]) + "\n";
+    }
+    fasta += ">lcl|seq1\nACGT\n";
+
+    // the generated IDs do not depend on which batch is parsed first
+    for (int i = 0;  i < 5;  ++i) {
+        s_CheckReadSetParallel(fasta, CFastaReader::fAssumeNuc, 1001, 0);
+        s_CheckReadSetParallel(fasta,
+            CFastaReader::fAssumeNuc | CFastaReader::fUniqueIDs, 1001, 1);
+    }
+}
+
 /*
 BOOST_AUTO_TEST_CASE(TestModFilter)
 {
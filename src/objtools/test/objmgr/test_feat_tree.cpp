@@ -72,11 +72,16 @@ void CTestApp::Init(void)
     // Create
     unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
 
-    // GI to fetch
-    arg_desc->AddKey("i", "InFile",
-                     "file with features to process",
-                     CArgDescriptions::eInputFile,
-                     CArgDescriptions::fBinary);
+    arg_desc->AddOptionalKey("i", "InFile",
+                             "file with features to process",
+                             CArgDescriptions::eInputFile,
+                             CArgDescriptions::fBinary);
+    // sequence to get features from GenBank, e.g. a human chromosome
+    // NC_000001.11 with -timing option makes a benchmark
+    arg_desc->AddOptionalKey("id", "SeqId",
+                             "Seq-id of sequence with features to process",
+                             CArgDescriptions::eString);
+    arg_desc->SetDependency("id", CArgDescriptions::eExcludes, "i");
     arg_desc->AddOptionalKey("format", "InFormat",
                              "format of input file",
                              CArgDescriptions::eString);
@@ -94,6 +99,9 @@ void CTestApp::Init(void)
                              CArgDescriptions::eOutputFile);
 
     arg_desc->AddFlag("no-xref", "Do not use xref for feature linking");
+    arg_desc->AddDefaultKey("threads", "Threads",
+                            "number of threads for parent matching",
+                            CArgDescriptions::eInteger, "1");
     arg_desc->AddFlag("timing", "Print time spent");
     arg_desc->AddFlag("verbose", "Print detailed feature info");
 
@@ -300,7 +308,11 @@ int CTestApp::Run(void)
 {
     const CArgs& args = GetArgs();
 
-    CScope scope(*CObjectManager::GetInstance());
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    if ( args["id"] ) {
+        CGBDataLoader::RegisterInObjectManager(*om);
+    }
+    CScope scope(*om);
     scope.AddDefaults();
 
     const bool timing = args["timing"];
@@ -308,44 +320,58 @@ int CTestApp::Run(void)
     
     CSeq_entry_Handle added_entry;
     CSeq_annot_Handle added_annot;
+    CBioseq_Handle bioseq;
 
-    s_StartTiming(sw, timing);
-
-    CNcbiIstream& in = args["i"].AsInputFile();
     CNcbiOstream& out = args["o"]? args["o"].AsOutputFile(): NcbiCout;
 
-    ESerialDataFormat format = args["format"]?
-        s_GetFormat(args["format"].AsString()):
-        s_GuessFormat(in);
-
-    string type =
-        args["type"]? args["type"].AsString(): s_GuessType(in, format);
+    s_StartTiming(sw, timing);
 
-    switch ( format ) {
-    case eSerial_AsnText:
-        in >> MSerial_AsnText;
-        break;
-    case eSerial_AsnBinary:
-        in >> MSerial_AsnBinary;
-        break;
-    case eSerial_Xml:
-        in >> MSerial_Xml;
-        break;
-    default:
-        break;
-    }
-    if ( type == "Seq-entry" ) {
-        CRef<CSeq_entry> entry(new CSeq_entry);
-        in >> *entry;
-        added_entry = scope.AddTopLevelSeqEntry(*entry);
+    if ( args["id"] ) {
+        CSeq_id id(args["id"].AsString());
+        bioseq = scope.GetBioseqHandle(id);
+        if ( !bioseq ) {
+            ERR_POST(Fatal<<"Sequence not found: "<<id.AsFastaString());
+        }
     }
-    else if ( type == "Seq-annot" ) {
-        CRef<CSeq_annot> annot(new CSeq_annot);
-        in >> *annot;
-        added_annot = scope.AddSeq_annot(*annot);
+    else if ( !args["i"] ) {
+        ERR_POST(Fatal<<"Either -i or -id argument is required");
     }
     else {
-        ERR_POST(Fatal<<"Unknown input object type");
+        CNcbiIstream& in = args["i"].AsInputFile();
+
+        ESerialDataFormat format = args["format"]?
+            s_GetFormat(args["format"].AsString()):
+            s_GuessFormat(in);
+
+        string type =
+            args["type"]? args["type"].AsString(): s_GuessType(in, format);
+
+        switch ( format ) {
+        case eSerial_AsnText:
+            in >> MSerial_AsnText;
+            break;
+        case eSerial_AsnBinary:
+            in >> MSerial_AsnBinary;
+            break;
+        case eSerial_Xml:
+            in >> MSerial_Xml;
+            break;
+        default:
+            break;
+        }
+        if ( type == "Seq-entry" ) {
+            CRef<CSeq_entry> entry(new CSeq_entry);
+            in >> *entry;
+            added_entry = scope.AddTopLevelSeqEntry(*entry);
+        }
+        else if ( type == "Seq-annot" ) {
+            CRef<CSeq_annot> annot(new CSeq_annot);
+            in >> *annot;
+            added_annot = scope.AddSeq_annot(*annot);
+        }
+        else {
+            ERR_POST(Fatal<<"Unknown input object type");
+        }
     }
 
     s_StopTiming(sw, timing, "Loaded data");
@@ -354,6 +380,7 @@ int CTestApp::Run(void)
     if ( args["no-xref"] ) {
         ft.SetFeatIdMode(ft.eFeatId_ignore);
     }
+    ft.SetThreadCount(args["threads"].AsInteger());
     //ft.SetFeatIdMode(feat_id_mode);
     //ft.SetSNPStrandMode(snp_strand_mode);
 
@@ -364,6 +391,9 @@ int CTestApp::Run(void)
     if ( added_annot ) {
         ft.AddFeatures(CFeat_CI(added_annot));
     }
+    if ( bioseq ) {
+        ft.AddFeatures(CFeat_CI(bioseq));
+    }
     s_StopTiming(sw, timing, "Added features");
 
     s_StartTiming(sw, timing);
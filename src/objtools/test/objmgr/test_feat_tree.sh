@@ -46,28 +46,36 @@ do_test() {
     rm "$dst"
 }
 
-d="$base/data"
-r="$base/res"
-x="$base/data3"
-for f in `cd "$d"; ls`; do
-    if test -f "$x/$f"; then
-	echo "Skipping test $d/$f replaced with $x/$f"
-	continue
-    fi
-    do_test "$f" "$d" "$r"
-done
+run_all() {
+    d="$base/data"
+    r="$base/res"
+    x="$base/data3"
+    for f in `cd "$d"; ls`; do
+        if test -f "$x/$f"; then
+            echo "Skipping test $d/$f replaced with $x/$f"
+            continue
+        fi
+        do_test "$f" "$d" "$r"
+    done
+
+    d="$base/data2"
+    r="$base/res2"
+    for f in `cd "$d"; ls`; do
+        do_test "$f" "$d" "$r"
+    done
+
+    d="$base/data3"
+    r="$base/res3"
+    for f in `cd "$d"; ls`; do
+        do_test "$f" "$d" "$r"
+    done
+}
 
-d="$base/data2"
-r="$base/res2"
-for f in `cd "$d"; ls`; do
-    do_test "$f" "$d" "$r"
-done
+run_all
 
-d="$base/data3"
-r="$base/res3"
-for f in `cd "$d"; ls`; do
-    do_test "$f" "$d" "$r"
-done
+# parallel parent matching must give the same trees
+tool="test_feat_tree -threads 4 $@"
+run_all
 
 echo "Done."
 exit $ret
@@ -467,6 +467,7 @@ CObjectIStream::CObjectIStream(ESerialDataFormat format)
       m_SkipUnknownVariants(eSerialSkipUnknown_Default),
       m_Fail(fNotOpen),
       m_Flags(fFlagNone),
+      m_MemoryPoolScope(eMemoryPool_Stream),
       m_MonitorType(0),
       m_MemberDefault(0), m_SpecialCaseToExpect(0), m_SpecialCaseUsed(eReadAsNormal)
 {
@@ -774,7 +775,18 @@ bool CObjectIStream::x_HavePathHooks() const
 
 void CObjectIStream::UseMemoryPool(void)
 {
-    SetMemoryPool(new CObjectMemoryPool);
+    UseMemoryPool(eMemoryPool_Stream);
+}
+
+void CObjectIStream::UseMemoryPool(EMemoryPoolScope scope, size_t chunk_size)
+{
+    // one object graph per pool makes bigger chunks affordable
+    static const size_t kObjectPoolChunkSize = 64*1024;
+    if ( chunk_size == 0  &&  scope == eMemoryPool_Object ) {
+        chunk_size = kObjectPoolChunkSize;
+    }
+    m_MemoryPoolScope = scope;
+    SetMemoryPool(new CObjectMemoryPool(chunk_size));
 }
 
 string CObjectIStream::GetStackTrace(void) const
@@ -906,6 +918,10 @@ void CObjectIStream::EndOfRead(void)
     m_MonitorType = 0;
     if ( m_Objects )
         m_Objects->Clear();
+    if ( m_MemoryPool  &&  m_MemoryPoolScope == eMemoryPool_Object ) {
+        // the chunks stay alive as long as the objects allocated in them
+        m_MemoryPool = new CObjectMemoryPool(m_MemoryPool->GetChunkSize());
+    }
 }
 
 set<TTypeInfo> CObjectIStream::GuessDataType(const set<TTypeInfo>& known_types,
@@ -156,8 +156,13 @@ void CObjectIStreamJson::SkipEndOfLine(char c)
 char CObjectIStreamJson::SkipWhiteSpace(void)
 {
     try { // catch CEofException
+        // most calls find no white space at all
+        char c = m_Input.PeekChar();
+        if ( c > ' ' ) {
+            return c;
+        }
         for ( ;; ) {
-            char c = m_Input.SkipSpaces();
+            c = m_Input.SkipSpaces();
             switch ( c ) {
             case '\t':
                 m_Input.SkipChar();
@@ -310,48 +315,68 @@ TUnicodeSymbol CObjectIStreamJson::ReadUtf8Char(char c)
     return chU;
 }
 
+// Plain chars are copied in bulk by CIStreamBuffer::FindAnyChar(),
+// which stops only at the chars listed here; escape sequences and,
+// when converting into a single byte encoding, 8-bit chars are
+// then decoded one at a time by ReadEncodedChar().
+static const char   s_StringStop[] = { '\"', '\\', '\r', '\n' };
+static const size_t s_StringStopCount = sizeof(s_StringStop);
+static const char   s_DataStop[] = { ',', ']', '}', ' ', '\r', '\n', '\\' };
+static const size_t s_DataStopCount = sizeof(s_DataStop);
+
+bool CObjectIStreamJson::x_NeedsConversion(EStringType type) const
+{
+    EEncoding enc_out( type == eStringTypeUTF8 ? eEncoding_UTF8 : m_StringEncoding);
+    return enc_out != eEncoding_UTF8 && enc_out != eEncoding_Unknown;
+}
+
+void CObjectIStreamJson::x_ReadEncodedChar(string& str, EStringType type)
+{
+    bool encoded = false;
+    str += ReadEncodedChar(type, encoded);
+    // an escaped char may produce several UTF8 bytes
+    if (!m_Utf8Buf.empty()) {
+        while (++m_Utf8Pos != m_Utf8Buf.end()) {
+            str += char(*m_Utf8Pos & 0xFF);
+        }
+        m_Utf8Buf.clear();
+        m_Utf8Pos = m_Utf8Buf.begin();
+    }
+}
+
 string CObjectIStreamJson::x_ReadString(EStringType type)
 {
     m_ExpectValue = false;
     Expect('\"',true);
+    bool convert = x_NeedsConversion(type);
     string str;
     for (;;) {
-        bool encoded = false;
-        char c = ReadEncodedChar(type, encoded);
-        if (!encoded) {
-            if (c == '\r' || c == '\n') {
-                ThrowError(fFormatError, "end of line: expected '\"'");
-            } else if (c == '\"') {
-                break;
-            }
-        }
-        str += char(c);
-        // pre-allocate memory for long strings
-        if ( str.size() > 128  &&  (double)str.capacity()/((double)str.size()+1.0) < 1.1 ) {
-            str.reserve(str.size()*2);
+        char c = m_Input.FindAnyChar(s_StringStop, s_StringStopCount,
+                                     &str, convert);
+        if (c == '\"') {
+            m_Input.SkipChar();
+            break;
+        } else if (c == '\r' || c == '\n') {
+            m_Input.SkipChar();
+            ThrowError(fFormatError, "end of line: expected '\"'");
         }
+        x_ReadEncodedChar(str, type);
     }
-    str.reserve(str.size());
     return str;
 }
 
 void CObjectIStreamJson::x_ReadData(string& str, EStringType type /*= eStringTypeVisible*/)
 {
     SkipWhiteSpace();
+    bool convert = x_NeedsConversion(type);
     for (;;) {
-        bool encoded = false;
-        char c = ReadEncodedChar(type, encoded);
-        if (!encoded && strchr(",]} \r\n", c)) {
-            m_Input.UngetChar(c);
+        char c = m_Input.FindAnyChar(s_DataStop, s_DataStopCount,
+                                     &str, convert);
+        if (c != '\\' && (c & 0x80) == 0) {
             break;
         }
-        str += char(c);
-        // pre-allocate memory for long strings
-        if ( str.size() > 128  &&  (double)str.capacity()/((double)str.size()+1.0) < 1.1 ) {
-            str.reserve(str.size()*2);
-        }
+        x_ReadEncodedChar(str, type);
     }
-    str.reserve(str.size());
 }
 
 bool CObjectIStreamJson::x_ReadDataAndCheck(string& str, EStringType type)
@@ -373,19 +398,20 @@ void  CObjectIStreamJson::x_SkipData(void)
     m_ExpectValue = false;
     char to = GetChar(true);
     for (;;) {
-        bool encoded = false;
-        char c = ReadEncodedChar(eStringTypeUTF8, encoded);
-        if (!encoded) {
-            if (to == '\"') {
-                if (c == to) {
-                    break;
-                }
+        char c;
+        if (to == '\"') {
+            c = m_Input.FindAnyChar(s_StringStop, 2);
+            if (c == to) {
+                m_Input.SkipChar();
+                break;
             }
-            else if (strchr(",]} \r\n", c)) {
-                m_Input.UngetChar(c);
+        } else {
+            c = m_Input.FindAnyChar(s_DataStop, s_DataStopCount);
+            if (c != '\\') {
                 break;
             }
         }
+        ReadEscapedChar();
     }
 }
 
@@ -657,7 +683,16 @@ void CObjectIStreamJson::SkipAnyContent(void)
     } else {
         to = '\n';
     }
-    for (char c = m_Input.PeekChar(); ; c = m_Input.PeekChar()) {
+    // everything but these chars is skipped in bulk
+    char stop[5] = { to, '\n', '\"', '{', '[' };
+    size_t stop_count = 5;
+    if (to == '\"') {
+        stop_count = 2;
+    } else if (to == '\n') {
+        stop[0] = ',';
+    }
+    for (char c = m_Input.FindAnyChar(stop, stop_count); ;
+         c = m_Input.FindAnyChar(stop, stop_count)) {
         if (to == '\n') {
             if (c == ',') {
                 return;
@@ -809,6 +844,22 @@ void CObjectIStreamJson::EndClass(void)
 
 TMemberIndex CObjectIStreamJson::FindDeep(
     const CItemsInfo& items, const CTempString& name, bool& deep) const
+{
+    // the same few names are looked up over and over again,
+    // and most of them are not found at once because of hyphens
+    TMemberCache::key_type key(&items, name);
+    TMemberCache::const_iterator found = m_MemberCache.find(key);
+    if (found != m_MemberCache.end()) {
+        deep = found->second.second;
+        return found->second.first;
+    }
+    TMemberIndex i = x_FindDeep(items, name, deep);
+    m_MemberCache.insert(TMemberCache::value_type(key, make_pair(i, deep)));
+    return i;
+}
+
+TMemberIndex CObjectIStreamJson::x_FindDeep(
+    const CItemsInfo& items, const CTempString& name, bool& deep) const
 {
     TMemberIndex i = items.Find(name);
     if (i != kInvalidMember) {
@@ -102,6 +102,47 @@ BOOST_AUTO_TEST_CASE(s_TestAsnSerialization)
         BOOST_CHECK( CFile( bin_in).Compare( bin_out) );
     }
 }
+
+/////////////////////////////////////////////////////////////////////////////
+// Test JSON serialization
+
+BOOST_AUTO_TEST_CASE(s_TestJsonSerialization)
+{
+    CRef<CWeb_Env> env(new CWeb_Env);
+    {
+        unique_ptr<CObjectIStream> in(
+            CObjectIStream::Open("webenv.ent",eSerial_AsnText));
+        *in >> *env;
+    }
+    // strings with escaped chars, and one longer than the input buffer
+    CRef<CArgument> arg(new CArgument);
+    arg->SetName("escaped");
+    arg->SetValue("quote \" backslash \\ slash / end");
+    env->SetArguments().push_back(arg);
+    arg.Reset(new CArgument);
+    arg->SetName("long");
+    arg->SetValue(string(20000, 'x') + "\\\"" + string(20000, 'y'));
+    env->SetArguments().push_back(arg);
+
+    CNcbiOstrstream out;
+    out << MSerial_Json << *env;
+    string data = CNcbiOstrstreamToString(out);
+    {
+        // read JSON
+        CRef<CWeb_Env> read(new CWeb_Env);
+        CNcbiIstrstream istr(data);
+        istr >> MSerial_Json >> *read;
+        BOOST_CHECK( read->Equals(*env) );
+    }
+    {
+        // skip data
+        CNcbiIstrstream istr(data);
+        unique_ptr<CObjectIStream> in(
+            CObjectIStream::Open(eSerial_Json, istr));
+        in->Skip(CWeb_Env::GetTypeInfo());
+        BOOST_CHECK( in->EndOfData() );
+    }
+}
 #endif
 
 /////////////////////////////////////////////////////////////////////////////
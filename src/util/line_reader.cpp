@@ -41,11 +41,40 @@
 
 #include <string.h>
 
+#if NCBI_SSE >= 20  &&  \
+    (defined(NCBI_COMPILER_GCC)  ||  defined(NCBI_COMPILER_ANY_CLANG))
+#  include <emmintrin.h>
+#  define NCBI_LINE_READER_SSE
+#endif
+
 #define NCBI_USE_ERRCODE_X   Util_LineReader
 
 BEGIN_NCBI_SCOPE
 
 
+// Find the first CR or LF in [p, end), return end if there is none.
+static inline
+const char* s_FindEOL(const char* p, const char* end)
+{
+#if defined(NCBI_LINE_READER_SSE)
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    for ( ; end - p >= 16; p += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, cr),
+                                                  _mm_cmpeq_epi8(v, lf)));
+        if ( mask ) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+    while ( p < end  &&  *p != '\r'  &&  *p != '\n' ) {
+        ++p;
+    }
+    return p;
+}
+
+
 CRef<ILineReader> ILineReader::New(const string& filename)
 {
     CRef<ILineReader> lr;
@@ -362,10 +391,8 @@ CMemoryLineReader& CMemoryLineReader::operator++(void)
         /* If after UngetLine(), line is already in buffer, so end is known*/
         p = m_Line.end();
     } else {
-        /* Line is in stream, go char by char until delimiters */
-        while ( p < m_End  &&  *p != '\r'  && *p != '\n' ) {
-            ++p;
-        }
+        /* Line is in stream, scan until delimiters */
+        p = s_FindEOL(p, m_End);
         m_Line = CTempString(m_Pos, p - m_Pos);
     }
     // skip over delimiters until the beginning of the next string
@@ -421,7 +448,8 @@ CBufferedLineReader::CBufferedLineReader(IReader* reader,
       m_UngetLine(false),
       m_BufferSize(32*1024),
       m_Buffer(new char[m_BufferSize]),
-      m_Pos(m_Buffer.get()),
+      m_Start(m_Buffer.get()),
+      m_Pos(m_Start),
       m_End(m_Pos),
       m_InputPos(0),
       m_LineNumber(0)
@@ -437,7 +465,8 @@ CBufferedLineReader::CBufferedLineReader(CNcbiIstream& is,
       m_UngetLine(false),
       m_BufferSize(32*1024),
       m_Buffer(new char[m_BufferSize]),
-      m_Pos(m_Buffer.get()),
+      m_Start(m_Buffer.get()),
+      m_Pos(m_Start),
       m_End(m_Pos),
       m_InputPos(0),
       m_LineNumber(0)
@@ -446,21 +475,52 @@ CBufferedLineReader::CBufferedLineReader(CNcbiIstream& is,
 }
 
 
-CBufferedLineReader::CBufferedLineReader(const string& filename)
-    : m_Reader(CFileReader::New(filename)),
-      m_Eof(false),
+CBufferedLineReader::CBufferedLineReader(const string& filename,
+                                         EFileMapping mapping)
+    : m_Eof(false),
       m_UngetLine(false),
+      m_LastReadSize(0),
       m_BufferSize(32*1024),
-      m_Buffer(new char[m_BufferSize]),
-      m_Pos(m_Buffer.get()),
-      m_End(m_Pos),
+      m_Start(0),
+      m_Pos(0),
+      m_End(0),
       m_InputPos(0),
       m_LineNumber(0)
 {
+    if ( mapping == eFileMapping_Auto  &&  filename != "-"  &&
+         x_MapFile(filename) ) {
+        return;
+    }
+    m_Reader.reset(CFileReader::New(filename));
+    m_Buffer.reset(new char[m_BufferSize]);
+    m_Start = m_Pos = m_End = m_Buffer.get();
     x_ReadBuffer();
 }
 
 
+bool CBufferedLineReader::x_MapFile(const string& filename)
+{
+    try {
+        CFile file(filename);
+        if ( !file.IsFile()  ||  file.GetLength() <= 0 ) {
+            return false;
+        }
+        m_MemFile.reset(new CMemoryFile(filename));
+    }
+    catch (exception& e) { // CFileException is the main concern
+        ERR_POST_X(1, Info << "CBufferedLineReader: falling back from"
+                   " memory mapping to reading for "
+                   << filename << " due to exception: " << e.what());
+        m_MemFile.reset();
+        return false;
+    }
+    m_MemFile->MemMapAdvise(CMemoryFile::eMMA_Sequential);
+    m_Start = m_Pos = static_cast<const char*>(m_MemFile->GetPtr());
+    m_End = m_Start + m_MemFile->GetSize();
+    return true;
+}
+
+
 CBufferedLineReader::~CBufferedLineReader()
 {
 }
@@ -519,10 +579,15 @@ CBufferedLineReader& CBufferedLineReader::operator++(void)
         m_UngetLine = false;
         return *this;
     }
+    if ( m_MemFile ) {
+        x_NextMappedLine();
+        return *this;
+    }
     // check if we are at the buffer end
     const char* start = m_Pos;
     const char* end = m_End;
-    for ( const char* p = start; p < end; ++p ) {
+    const char* p = s_FindEOL(start, end);
+    if ( p < end ) {
         if ( *p == '\n' ) {
             m_Line = CTempString(start, p - start);
             m_LastReadSize = p + 1 - start;
@@ -534,7 +599,7 @@ CBufferedLineReader& CBufferedLineReader::operator++(void)
             }
             return *this;
         }
-        else if ( *p == '\r' ) {
+        else {
             m_Line = CTempString(start, p - start);
             m_LastReadSize = p + 1 - start;
             m_Pos = ++p;
@@ -568,6 +633,26 @@ CBufferedLineReader& CBufferedLineReader::operator++(void)
 }
 
 
+void CBufferedLineReader::x_NextMappedLine(void)
+{
+    // the whole file is in memory, no copying is needed
+    const char* start = m_Pos;
+    const char* p = s_FindEOL(start, m_End);
+    m_Line = CTempString(start, p - start);
+    if ( p < m_End ) {
+        if ( *p == '\r'  &&  p + 1 < m_End  &&  p[1] == '\n' ) {
+            ++p;
+        }
+        ++p;
+    }
+    m_LastReadSize = p - start;
+    m_Pos = p;
+    if ( p == m_End ) {
+        m_Eof = true;
+    }
+}
+
+
 void CBufferedLineReader::x_LoadLong(void)
 {
     const char* start = m_Pos;
@@ -576,37 +661,36 @@ void CBufferedLineReader::x_LoadLong(void)
     while ( x_ReadBuffer() ) {
         start = m_Pos;
         end = m_End;
-        for ( const char* p = start; p < end; ++p ) {
+        const char* p = s_FindEOL(start, end);
+        if ( p < end ) {
             char c = *p;
-            if ( c == '\r' || c == '\n' ) {
-                m_String.append(start, p - start);
+            m_String.append(start, p - start);
+            m_Line = m_String;
+            m_LastReadSize = m_Line.size() + 1;
+            if ( ++p == end ) {
+                m_String = m_Line;
                 m_Line = m_String;
-                m_LastReadSize = m_Line.size() + 1;
-                if ( ++p == end ) {
-                    m_String = m_Line;
-                    m_Line = m_String;
-                    if ( x_ReadBuffer() ) {
-                        p = m_Pos;
-                        end = m_End;
-                        if ( p < end && c == '\r' && *p == '\n' ) {
-                            ++p;
-                            m_Pos = p;
-                            ++m_LastReadSize;
-                        }
+                if ( x_ReadBuffer() ) {
+                    p = m_Pos;
+                    end = m_End;
+                    if ( p < end && c == '\r' && *p == '\n' ) {
+                        ++p;
+                        m_Pos = p;
+                        ++m_LastReadSize;
                     }
                 }
-                else {
-                    if ( c == '\r' && *p == '\n' ) {
-                        if ( ++p == end ) {
-                            x_ReadBuffer();
-                            p = m_Pos;
-                            ++m_LastReadSize;
-                        }
+            }
+            else {
+                if ( c == '\r' && *p == '\n' ) {
+                    if ( ++p == end ) {
+                        x_ReadBuffer();
+                        p = m_Pos;
+                        ++m_LastReadSize;
                     }
-                    m_Pos = p;
                 }
-                return;
+                m_Pos = p;
             }
+            return;
         }
         m_String.append(start, end - start);
     }
@@ -624,8 +708,8 @@ bool CBufferedLineReader::x_ReadBuffer()
         return false;
     }
 
-    m_InputPos += CT_OFF_TYPE(m_End - m_Buffer.get());
-    m_Pos = m_End = m_Buffer.get();
+    m_InputPos += CT_OFF_TYPE(m_End - m_Start);
+    m_Pos = m_End = m_Start;
     for (bool flag = true; flag; ) {
         size_t size;
         ERW_Result result =
@@ -671,7 +755,7 @@ CTempString CBufferedLineReader::operator*(void) const
 
 CT_POS_TYPE CBufferedLineReader::GetPosition(void) const
 {
-    CT_OFF_TYPE offset = m_Pos - m_Buffer.get();
+    CT_OFF_TYPE offset = m_Pos - m_Start;
     if (m_UngetLine) {
         offset -= m_LastReadSize;
     }
@@ -34,6 +34,7 @@
 
 #include <util/sequtil/sequtil.hpp>
 #include <util/sequtil/sequtil_expt.hpp>
+#include "sequtil_simd.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -67,5 +68,17 @@ CSeqUtil::ECodingType CSeqUtil::GetCodingType(TCoding coding)
 }
 
 
+CSeqUtil::ESimdLevel CSeqUtil::SetSimdLevel(ESimdLevel level)
+{
+    return CSeqUtil_simd::SetLevel(level);
+}
+
+
+CSeqUtil::ESimdLevel CSeqUtil::GetSimdLevel(void)
+{
+    return CSeqUtil_simd::GetLevel();
+}
+
+
 
 END_NCBI_SCOPE
@@ -36,6 +36,7 @@
 
 #include "sequtil_convert_imp.hpp"
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 #include "sequtil_tables.hpp"
 
 #include <stdlib.h>
@@ -56,6 +57,10 @@ BEGIN_NCBI_SCOPE
 // length - number of residues to convert
 // dst - an output container
 
+// For the hottest pairs the bulk of an aligned request is first handed to
+// the vectorized kernels (see sequtil_simd.hpp); the code below then
+// converts whatever they left over.
+
 
 SIZE_TYPE CSeqConvert_imp::Convert
 (const char* src,
@@ -260,6 +265,15 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo2na
  TSeqPos length,
  char* dst)
 {
+    if ( TSeqPos done =
+         CSeqUtil_simd::ConvertIupacnaTo2na(src + pos, length, dst) ) {
+        if ( done < length ) {
+            x_ConvertIupacnaTo2na(src, pos + done, length - done,
+                                  dst + done / 4);
+        }
+        return length;
+    }
+
     // The iupacna to ncbi2na table is constructed such that each row
     // correspond to an iupacna letter and each column corresponds to
     // that letter being in one of the 4 possible offsets within the 
@@ -316,6 +330,15 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo4na
  TSeqPos length,
  char* dst)
 {
+    if ( TSeqPos done =
+         CSeqUtil_simd::ConvertIupacnaTo4na(src + pos, length, dst) ) {
+        if ( done < length ) {
+            x_ConvertIupacnaTo4na(src, pos + done, length - done,
+                                  dst + done / 2);
+        }
+        return length;
+    }
+
 
     // The iupacna to ncbi4na table is constructed such that each row
     // correspond to an iupacna letter and each column corresponds to
@@ -370,6 +393,17 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naToIupacna
  TSeqPos length,
  char* dst)
 {
+    if ( pos % 4 == 0 ) {
+        if ( TSeqPos done =
+             CSeqUtil_simd::Convert2naToIupacna(src + pos / 4, length, dst) ) {
+            if ( done < length ) {
+                x_Convert2naToIupacna(src, pos + done, length - done,
+                                      dst + done);
+            }
+            return length;
+        }
+    }
+
     return convert_1_to_4(src, pos, length, dst, C2naToIupacna::GetTable());
 }
 
@@ -396,6 +430,17 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naTo4na
  TSeqPos length,
  char* dst)
 {
+    if ( pos % 4 == 0 ) {
+        if ( TSeqPos done =
+             CSeqUtil_simd::Convert2naTo4na(src + pos / 4, length, dst) ) {
+            if ( done < length ) {
+                x_Convert2naTo4na(src, pos + done, length - done,
+                                  dst + done / 2);
+            }
+            return length;
+        }
+    }
+
     const Uint1* table = C2naTo4na::GetTable(pos % 2 == 0);
     const Uint2* table2 = reinterpret_cast<const Uint2*>(table);
 
@@ -654,6 +699,17 @@ SIZE_TYPE CSeqConvert_imp::x_Convert4naToIupacna
  TSeqPos length,
  char* dst)
 {
+    if ( pos % 2 == 0 ) {
+        if ( TSeqPos done =
+             CSeqUtil_simd::Convert4naToIupacna(src + pos / 2, length, dst) ) {
+            if ( done < length ) {
+                x_Convert4naToIupacna(src, pos + done, length - done,
+                                      dst + done);
+            }
+            return length;
+        }
+    }
+
     return convert_1_to_2(src, pos, length, dst, C4naToIupacna::GetTable());
 }
 
@@ -666,6 +722,17 @@ SIZE_TYPE CSeqConvert_imp::x_Convert4naTo2na
  TSeqPos length,
  char* dst)
 {
+    if ( pos % 2 == 0 ) {
+        if ( TSeqPos done =
+             CSeqUtil_simd::Convert4naTo2na(src + pos / 2, length, dst) ) {
+            if ( done < length ) {
+                x_Convert4naTo2na(src, pos + done, length - done,
+                                  dst + done / 4);
+            }
+            return length;
+        }
+    }
+
     Uint1 offset = pos % 2;
     const Uint1* table = C4naTo2na::GetTable(offset);
     
@@ -39,6 +39,7 @@
 #include <util/sequtil/sequtil_manip.hpp>
 #include <util/sequtil/sequtil_convert.hpp>
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 #include "sequtil_tables.hpp"
 
 
@@ -459,6 +460,19 @@ static SIZE_TYPE s_Ncbi2naRevCmp
  TSeqPos length,
  char* dst)
 {
+    // the vectorized kernel works from the end of the interval backwards
+    // when it falls on a byte boundary, leaving the head to the tables.
+    if ( (pos + length) % 4 == 0 ) {
+        if ( TSeqPos done = CSeqUtil_simd::RevCmp2na(
+                 src + (pos + length) / 4, length, dst) ) {
+            if ( done < length ) {
+                s_Ncbi2naRevCmp(src, pos, length - done, dst + done / 4);
+            }
+            return length;
+        }
+    }
+
+    char* const first = dst;
     size_t offset = (pos + length - 1) % 4;
     const Uint1* table = C2naRevCmp::GetTable(offset);
 
@@ -493,8 +507,10 @@ static SIZE_TYPE s_Ncbi2naRevCmp
         break;
     }
 
-    // zero redundent bits
-    *dst &= char(0xFF << ((4 - (length % 4)) % 4) * 2);
+    // zero redundent bits of the last byte
+    if ( length % 4 != 0 ) {
+        first[length / 4] &= char(0xFF << (4 - (length % 4)) * 2);
+    }
 
     return length;
 }
@@ -523,9 +539,20 @@ static SIZE_TYPE s_Ncbi4naRevCmp
  TSeqPos length,
  char* dst)
 {
+    if ( (pos + length) % 2 == 0 ) {
+        if ( TSeqPos done = CSeqUtil_simd::RevCmp4na(
+                 src + (pos + length) / 2, length, dst) ) {
+            if ( done < length ) {
+                s_Ncbi4naRevCmp(src, pos, length - done, dst + done / 2);
+            }
+            return length;
+        }
+    }
+
     const char* begin = src + (pos / 2);
     const char* iter  = src + ((pos + length - 1) / 2) + 1;
 
+    char* const first = dst;
     size_t offset = (pos + length - 1) % 2;
     const Uint1* table = C4naRevCmp::GetTable(offset);
 
@@ -552,7 +579,7 @@ static SIZE_TYPE s_Ncbi4naRevCmp
             }
 
             if ( length % 2 != 0 ) {
-                *dst &= char(0xF0);
+                first[length / 2] &= char(0xF0);
             }
         }}
         break;
@@ -562,6 +589,18 @@ static SIZE_TYPE s_Ncbi4naRevCmp
 }
 
 
+static SIZE_TYPE s_IupacnaRevCmp
+(const char* src,
+ TSeqPos pos,
+ TSeqPos length,
+ char* dst)
+{
+    TSeqPos done = CSeqUtil_simd::RevCmpIupacna(src + pos + length, length, dst);
+    return done + copy_1_to_1_reverse(src, pos, length - done, dst + done,
+                                      CIupacnaCmp::GetTable());
+}
+
+
 SIZE_TYPE CSeqManip::ReverseComplement
 (const char* src,
  TCoding src_coding,
@@ -573,8 +612,7 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
-        return copy_1_to_1_reverse(src, pos, length, dst, 
-                                   CIupacnaCmp::GetTable());
+        return s_IupacnaRevCmp(src, pos, length, dst);
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naRevCmp(src, pos, length, dst);
@@ -664,18 +702,20 @@ static SIZE_TYPE s_Ncbi2naExpandRevCmp
 }
 
 
+// The packed codings are reverse complemented into a temporary buffer
+// which is then copied back; the result starts at the beginning of src.
+
 static SIZE_TYPE s_Ncbi2naRevCmp
 (char* src,
  TSeqPos pos,
  TSeqPos length)
 {
-    char* buf = new char[length];
-    CSeqConvert::Convert(src, CSeqUtil::e_Ncbi2na, pos, length, 
-        buf, CSeqUtil::e_Ncbi8na);
-    revcmp(buf, pos, length, C8naCmp::GetTable());
-    CSeqConvert::Convert(buf, CSeqUtil::e_Ncbi8na, 0, length, 
-        src, CSeqUtil::e_Ncbi2na);
-    delete[] buf;
+    if ( length == 0 ) {
+        return 0;
+    }
+    vector<char> buf((length + 3) / 4);
+    s_Ncbi2naRevCmp(src, pos, length, &buf[0]);
+    copy(buf.begin(), buf.end(), src);
 
     return length;
 }
@@ -686,13 +726,27 @@ static SIZE_TYPE s_Ncbi4naRevCmp
  TSeqPos pos,
  TSeqPos length)
 {
-    char* buf = new char[length];
-    CSeqConvert::Convert(src, CSeqUtil::e_Ncbi4na, pos, length, 
-        buf, CSeqUtil::e_Ncbi8na);
-    revcmp(buf, pos, length, C8naCmp::GetTable());
-    CSeqConvert::Convert(buf, CSeqUtil::e_Ncbi8na, 0, length, 
-        src, CSeqUtil::e_Ncbi4na);
-    delete[] buf;
+    if ( length == 0 ) {
+        return 0;
+    }
+    vector<char> buf((length + 1) / 2);
+    s_Ncbi4naRevCmp(src, pos, length, &buf[0]);
+    copy(buf.begin(), buf.end(), src);
+
+    return length;
+}
+
+
+static SIZE_TYPE s_IupacnaRevCmp
+(char* src,
+ TSeqPos pos,
+ TSeqPos length)
+{
+    TSeqPos done = CSeqUtil_simd::RevCmpIupacnaInPlace(src + pos, length);
+    revcmp(src + pos + done, 0, length - 2 * done, CIupacnaCmp::GetTable());
+    if ( pos != 0 ) {
+        copy(src + pos, src + pos + length, src);
+    }
 
     return length;
 }
@@ -708,7 +762,7 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
-        return revcmp(src, pos, length, CIupacnaCmp::GetTable());
+        return s_IupacnaRevCmp(src, pos, length);
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naRevCmp(src, pos, length);
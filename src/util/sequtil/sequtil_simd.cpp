@@ -0,0 +1,945 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   SSE/AVX2 kernels for bulk nucleotide conversion and reverse complement.
+ */
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbi_system.hpp>
+
+#include "sequtil_simd.hpp"
+#include "sequtil_tables.hpp"
+
+#include <atomic>
+
+// SSSE3 shuffles and SSE4.1 blends are required for the 128-bit kernels.
+// The AVX2 kernels are compiled with a per-function target attribute and
+// are only entered if the running CPU reports AVX2 support.
+#if NCBI_SSE > 40
+#  include <immintrin.h>
+#  define NCBI_SEQUTIL_SSE
+#  if defined(NCBI_COMPILER_GCC)  ||  defined(NCBI_COMPILER_ANY_CLANG)
+#    define NCBI_SEQUTIL_AVX2
+#    define NCBI_AVX2_TARGET __attribute__((target("avx2")))
+#  endif
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+#if defined(NCBI_SEQUTIL_SSE)
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Lookup vectors, derived from the conversion tables
+
+struct SSeqUtilSimdTables
+{
+    SSeqUtilSimdTables(void);
+
+    Uint1 m_2naTo4na[16];      // ncbi2na nibble (2 bases) -> ncbi4na byte
+    Uint1 m_2naToIupacna[16];  // ncbi2na base -> iupacna (4 entries used)
+    Uint1 m_4naTo2naHi[16];    // ncbi4na base -> ncbi2na << 2
+    Uint1 m_4naTo2naLo[16];    // ncbi4na base -> ncbi2na
+    Uint1 m_4naToIupacna[16];  // ncbi4na base -> iupacna
+    Uint1 m_IupacnaTo2na[32];  // (iupacna & 0x1f) -> ncbi2na
+    Uint1 m_IupacnaTo4na[32];  // (iupacna & 0x1f) -> ncbi4na
+    Uint1 m_IupacnaCmp[32];    // (iupacna & 0x1f) -> (complement & 0x1f)
+    Uint1 m_2naRevCmpHi[16];   // low nibble -> high nibble of the result
+    Uint1 m_2naRevCmpLo[16];   // high nibble -> low nibble of the result
+    Uint1 m_4naRevCmpHi[16];
+    Uint1 m_4naRevCmpLo[16];
+
+    // iupacna kernels handle blocks of letters (0x40-0x7f) only, and
+    // rely on upper and lower case letters being mapped the same way.
+    bool  m_IupacnaTo2naOK;
+    bool  m_IupacnaTo4naOK;
+    bool  m_IupacnaCmpOK;
+};
+
+
+SSeqUtilSimdTables::SSeqUtilSimdTables(void)
+    : m_IupacnaTo2naOK(true),
+      m_IupacnaTo4naOK(true),
+      m_IupacnaCmpOK(true)
+{
+    const Uint1* t2to4 = C2naTo4na::GetTable(true);
+    const Uint1* t2toi = C2naToIupacna::GetTable();
+    const Uint1* t4to2 = C4naTo2na::GetTable(0);
+    const Uint1* t4toi = C4naToIupacna::GetTable();
+    const Uint1* t2rc  = C2naRevCmp::GetTable(3);
+    const Uint1* t4rc  = C4naRevCmp::GetTable(1);
+
+    for ( int n = 0; n < 16; ++n ) {
+        m_2naTo4na[n]     = t2to4[(n << 4) * 2];
+        m_2naToIupacna[n] = n < 4 ? t2toi[(n << 6) * 4] : 0;
+        m_4naTo2naLo[n]   = Uint1(t4to2[(n << 4) * 2] >> 6);
+        m_4naTo2naHi[n]   = Uint1(m_4naTo2naLo[n] << 2);
+        m_4naToIupacna[n] = t4toi[(n << 4) * 2];
+        m_2naRevCmpHi[n]  = t2rc[n] & 0xf0;
+        m_2naRevCmpLo[n]  = t2rc[n << 4] & 0x0f;
+        m_4naRevCmpHi[n]  = t4rc[n] & 0xf0;
+        m_4naRevCmpLo[n]  = t4rc[n << 4] & 0x0f;
+    }
+
+    const Uint1* ti2 = CIupacnaTo2na::GetTable();
+    const Uint1* ti4 = CIupacnaTo4na::GetTable();
+    const Uint1* tic = CIupacnaCmp::GetTable();
+
+    for ( int i = 0; i < 32; ++i ) {
+        m_IupacnaTo2na[i] = ti2[(0x40 + i) * 4 + 3];
+        m_IupacnaTo4na[i] = ti4[(0x40 + i) * 2 + 1];
+        m_IupacnaCmp[i]   = tic[0x40 + i] & 0x1f;
+        if ( ti2[(0x60 + i) * 4 + 3] != m_IupacnaTo2na[i] ) {
+            m_IupacnaTo2naOK = false;
+        }
+        if ( ti4[(0x60 + i) * 2 + 1] != m_IupacnaTo4na[i] ) {
+            m_IupacnaTo4naOK = false;
+        }
+        if ( (tic[0x40 + i] & 0xe0) != 0x40  ||
+             tic[0x60 + i] != (tic[0x40 + i] | 0x20) ) {
+            m_IupacnaCmpOK = false;
+        }
+    }
+}
+
+
+static const SSeqUtilSimdTables& s_GetTables(void)
+{
+    static const SSeqUtilSimdTables s_Tables;
+    return s_Tables;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Table-driven fallback for blocks containing non-letters
+
+static void s_IupacnaTo2naBlock(const char* src, size_t count, char* dst)
+{
+    const Uint1* table = CIupacnaTo2na::GetTable();
+    for ( ; count;  count -= 4, src += 4, ++dst ) {
+        *dst = char(table[Uint1(src[0]) * 4    ] |
+                    table[Uint1(src[1]) * 4 + 1] |
+                    table[Uint1(src[2]) * 4 + 2] |
+                    table[Uint1(src[3]) * 4 + 3]);
+    }
+}
+
+
+static void s_IupacnaTo4naBlock(const char* src, size_t count, char* dst)
+{
+    const Uint1* table = CIupacnaTo4na::GetTable();
+    for ( ; count;  count -= 2, src += 2, ++dst ) {
+        *dst = char(table[Uint1(src[0]) * 2] | table[Uint1(src[1]) * 2 + 1]);
+    }
+}
+
+
+// 'end' points past the block
+static void s_IupacnaRevCmpBlock(const char* end, size_t count, char* dst)
+{
+    const Uint1* table = CIupacnaCmp::GetTable();
+    for ( ; count;  --count, ++dst ) {
+        *dst = char(table[Uint1(*--end)]);
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// 128-bit kernels
+
+static inline __m128i s_sse_Load(const void* src)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+
+static inline void s_sse_Store(void* dst, __m128i value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+}
+
+
+// true if all bytes are in the 0x40-0x7f range
+static inline bool s_sse_IsLetters(__m128i v)
+{
+    __m128i m = _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(char(0xc0))),
+                               _mm_set1_epi8(0x40));
+    return _mm_movemask_epi8(m) == 0xffff;
+}
+
+
+// 32-entry lookup indexed by the low 5 bits
+static inline __m128i s_sse_Lookup32(__m128i v, __m128i lo, __m128i hi)
+{
+    __m128i idx = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+    __m128i sel = _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(0x10)),
+                                 _mm_set1_epi8(0x10));
+    return _mm_blendv_epi8(_mm_shuffle_epi8(lo, idx),
+                           _mm_shuffle_epi8(hi, idx), sel);
+}
+
+
+// one packed byte to two output bytes, by high and low nibbles
+static TSeqPos s_sse_Expand2(const char* src, TSeqPos length, char* dst,
+                             const Uint1* lut, TSeqPos per_byte)
+{
+    const TSeqPos kBlock = 16 * per_byte;
+    const __m128i table = s_sse_Load(lut);
+    const __m128i mask  = _mm_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= kBlock;  done += kBlock, src += 16, dst += 32 ) {
+        __m128i v  = s_sse_Load(src);
+        __m128i hi = _mm_shuffle_epi8(table,
+            _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+        s_sse_Store(dst,      _mm_unpacklo_epi8(hi, lo));
+        s_sse_Store(dst + 16, _mm_unpackhi_epi8(hi, lo));
+    }
+    return done;
+}
+
+
+static TSeqPos s_sse_2naToIupacna(const char* src, TSeqPos length, char* dst)
+{
+    const __m128i table = s_sse_Load(s_GetTables().m_2naToIupacna);
+    const __m128i mask  = _mm_set1_epi8(0x03);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 16, dst += 64 ) {
+        __m128i v  = s_sse_Load(src);
+        __m128i c0 = _mm_shuffle_epi8(table,
+            _mm_and_si128(_mm_srli_epi16(v, 6), mask));
+        __m128i c1 = _mm_shuffle_epi8(table,
+            _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i c2 = _mm_shuffle_epi8(table,
+            _mm_and_si128(_mm_srli_epi16(v, 2), mask));
+        __m128i c3 = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+        __m128i t0 = _mm_unpacklo_epi8(c0, c1);
+        __m128i t1 = _mm_unpackhi_epi8(c0, c1);
+        __m128i t2 = _mm_unpacklo_epi8(c2, c3);
+        __m128i t3 = _mm_unpackhi_epi8(c2, c3);
+        s_sse_Store(dst,      _mm_unpacklo_epi16(t0, t2));
+        s_sse_Store(dst + 16, _mm_unpackhi_epi16(t0, t2));
+        s_sse_Store(dst + 32, _mm_unpacklo_epi16(t1, t3));
+        s_sse_Store(dst + 48, _mm_unpackhi_epi16(t1, t3));
+    }
+    return done;
+}
+
+
+// pairs of 4-bit values into bytes: (v[2i] << 4) | v[2i+1]
+static inline __m128i s_sse_Pack2(__m128i v0, __m128i v1)
+{
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    return _mm_packus_epi16(_mm_maddubs_epi16(v0, weights),
+                            _mm_maddubs_epi16(v1, weights));
+}
+
+
+// quads of 2-bit values into bytes
+static inline __m128i s_sse_Pack4(__m128i v0, __m128i v1,
+                                  __m128i v2, __m128i v3)
+{
+    const __m128i w1 = _mm_set1_epi16(0x0104);
+    const __m128i w2 = _mm_set1_epi32(0x00010010);
+    __m128i q0 = _mm_madd_epi16(_mm_maddubs_epi16(v0, w1), w2);
+    __m128i q1 = _mm_madd_epi16(_mm_maddubs_epi16(v1, w1), w2);
+    __m128i q2 = _mm_madd_epi16(_mm_maddubs_epi16(v2, w1), w2);
+    __m128i q3 = _mm_madd_epi16(_mm_maddubs_epi16(v3, w1), w2);
+    return _mm_packus_epi16(_mm_packs_epi32(q0, q1), _mm_packs_epi32(q2, q3));
+}
+
+
+static TSeqPos s_sse_4naTo2na(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    const __m128i hi   = s_sse_Load(tables.m_4naTo2naHi);
+    const __m128i lo   = s_sse_Load(tables.m_4naTo2naLo);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 32, dst += 16 ) {
+        __m128i v0 = s_sse_Load(src);
+        __m128i v1 = s_sse_Load(src + 16);
+        __m128i x0 = _mm_or_si128(
+            _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v0, 4), mask)),
+            _mm_shuffle_epi8(lo, _mm_and_si128(v0, mask)));
+        __m128i x1 = _mm_or_si128(
+            _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v1, 4), mask)),
+            _mm_shuffle_epi8(lo, _mm_and_si128(v1, mask)));
+        s_sse_Store(dst, s_sse_Pack2(x0, x1));
+    }
+    return done;
+}
+
+
+static TSeqPos s_sse_IupacnaTo2na(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaTo2naOK ) {
+        return 0;
+    }
+    const __m128i lo = s_sse_Load(tables.m_IupacnaTo2na);
+    const __m128i hi = s_sse_Load(tables.m_IupacnaTo2na + 16);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 64, dst += 16 ) {
+        __m128i v0 = s_sse_Load(src);
+        __m128i v1 = s_sse_Load(src + 16);
+        __m128i v2 = s_sse_Load(src + 32);
+        __m128i v3 = s_sse_Load(src + 48);
+        if ( !s_sse_IsLetters(v0)  ||  !s_sse_IsLetters(v1)  ||
+             !s_sse_IsLetters(v2)  ||  !s_sse_IsLetters(v3) ) {
+            s_IupacnaTo2naBlock(src, 64, dst);
+            continue;
+        }
+        s_sse_Store(dst, s_sse_Pack4(s_sse_Lookup32(v0, lo, hi),
+                                     s_sse_Lookup32(v1, lo, hi),
+                                     s_sse_Lookup32(v2, lo, hi),
+                                     s_sse_Lookup32(v3, lo, hi)));
+    }
+    return done;
+}
+
+
+static TSeqPos s_sse_IupacnaTo4na(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaTo4naOK ) {
+        return 0;
+    }
+    const __m128i lo = s_sse_Load(tables.m_IupacnaTo4na);
+    const __m128i hi = s_sse_Load(tables.m_IupacnaTo4na + 16);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 32;  done += 32, src += 32, dst += 16 ) {
+        __m128i v0 = s_sse_Load(src);
+        __m128i v1 = s_sse_Load(src + 16);
+        if ( !s_sse_IsLetters(v0)  ||  !s_sse_IsLetters(v1) ) {
+            s_IupacnaTo4naBlock(src, 32, dst);
+            continue;
+        }
+        s_sse_Store(dst, s_sse_Pack2(s_sse_Lookup32(v0, lo, hi),
+                                     s_sse_Lookup32(v1, lo, hi)));
+    }
+    return done;
+}
+
+
+static inline __m128i s_sse_ReverseBytes(__m128i v)
+{
+    return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                            8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+
+// reverse complement of packed codings; 'lut_hi' maps the low nibble
+// of a source byte to the high nibble of the result, and 'lut_lo'
+// the high nibble to the low one.
+static TSeqPos s_sse_RevCmpPacked(const char* end, TSeqPos length, char* dst,
+                                  const Uint1* lut_hi, const Uint1* lut_lo,
+                                  TSeqPos per_byte)
+{
+    const TSeqPos kBlock = 16 * per_byte;
+    const __m128i hi   = s_sse_Load(lut_hi);
+    const __m128i lo   = s_sse_Load(lut_lo);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= kBlock;  done += kBlock, dst += 16 ) {
+        end -= 16;
+        __m128i v = s_sse_Load(end);
+        __m128i r = _mm_or_si128(
+            _mm_shuffle_epi8(hi, _mm_and_si128(v, mask)),
+            _mm_shuffle_epi8(lo, _mm_and_si128(_mm_srli_epi16(v, 4), mask)));
+        s_sse_Store(dst, s_sse_ReverseBytes(r));
+    }
+    return done;
+}
+
+
+// reverse complement of the 16 iupacna residues ending at 'end'
+static inline __m128i s_sse_RevCmpIupacna16(const char* end,
+                                            __m128i lo, __m128i hi)
+{
+    __m128i v = s_sse_Load(end - 16);
+    if ( !s_sse_IsLetters(v) ) {
+        char buf[16];
+        s_IupacnaRevCmpBlock(end, 16, buf);
+        return s_sse_Load(buf);
+    }
+    __m128i r = _mm_or_si128(s_sse_Lookup32(v, lo, hi),
+                             _mm_and_si128(v, _mm_set1_epi8(char(0xe0))));
+    return s_sse_ReverseBytes(r);
+}
+
+
+static TSeqPos s_sse_RevCmpIupacna(const char* end, TSeqPos length,
+                                   char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaCmpOK ) {
+        return 0;
+    }
+    const __m128i lo = s_sse_Load(tables.m_IupacnaCmp);
+    const __m128i hi = s_sse_Load(tables.m_IupacnaCmp + 16);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 16;  done += 16, end -= 16, dst += 16 ) {
+        s_sse_Store(dst, s_sse_RevCmpIupacna16(end, lo, hi));
+    }
+    return done;
+}
+
+
+static TSeqPos s_sse_RevCmpIupacnaInPlace(char* first, TSeqPos length)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaCmpOK ) {
+        return 0;
+    }
+    const __m128i lo = s_sse_Load(tables.m_IupacnaCmp);
+    const __m128i hi = s_sse_Load(tables.m_IupacnaCmp + 16);
+
+    char* last = first + length;
+    TSeqPos done = 0;
+    for ( ;  length - 2 * done >= 32;  done += 16, first += 16, last -= 16 ) {
+        __m128i f = s_sse_RevCmpIupacna16(first + 16, lo, hi);
+        __m128i b = s_sse_RevCmpIupacna16(last, lo, hi);
+        s_sse_Store(first, b);
+        s_sse_Store(last - 16, f);
+    }
+    return done;
+}
+
+#endif // NCBI_SEQUTIL_SSE
+
+
+#if defined(NCBI_SEQUTIL_AVX2)
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// 256-bit kernels
+//
+// Shuffles, unpacks and packs operate within 128-bit lanes, so results
+// are put back in order with cross-lane permutations before storing.
+
+static inline NCBI_AVX2_TARGET
+__m256i s_avx2_Load(const void* src)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+
+static inline NCBI_AVX2_TARGET
+void s_avx2_Store(void* dst, __m256i value)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), value);
+}
+
+
+static inline NCBI_AVX2_TARGET
+__m256i s_avx2_Table(const Uint1* lut)
+{
+    return _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(lut)));
+}
+
+
+static inline NCBI_AVX2_TARGET
+bool s_avx2_IsLetters(__m256i v)
+{
+    __m256i m = _mm256_cmpeq_epi8(
+        _mm256_and_si256(v, _mm256_set1_epi8(char(0xc0))),
+        _mm256_set1_epi8(0x40));
+    return _mm256_movemask_epi8(m) == -1;
+}
+
+
+static inline NCBI_AVX2_TARGET
+__m256i s_avx2_Lookup32(__m256i v, __m256i lo, __m256i hi)
+{
+    __m256i idx = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+    __m256i sel = _mm256_cmpeq_epi8(
+        _mm256_and_si256(v, _mm256_set1_epi8(0x10)), _mm256_set1_epi8(0x10));
+    return _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, idx),
+                              _mm256_shuffle_epi8(hi, idx), sel);
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_Expand2(const char* src, TSeqPos length, char* dst,
+                       const Uint1* lut, TSeqPos per_byte)
+{
+    const TSeqPos kBlock = 32 * per_byte;
+    const __m256i table = s_avx2_Table(lut);
+    const __m256i mask  = _mm256_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= kBlock;  done += kBlock, src += 32, dst += 64 ) {
+        __m256i v  = s_avx2_Load(src);
+        __m256i hi = _mm256_shuffle_epi8(table,
+            _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, mask));
+        __m256i a  = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b  = _mm256_unpackhi_epi8(hi, lo);
+        s_avx2_Store(dst,      _mm256_permute2x128_si256(a, b, 0x20));
+        s_avx2_Store(dst + 32, _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return done;
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_2naToIupacna(const char* src, TSeqPos length, char* dst)
+{
+    const __m256i table = s_avx2_Table(s_GetTables().m_2naToIupacna);
+    const __m256i mask  = _mm256_set1_epi8(0x03);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 128;  done += 128, src += 32, dst += 128 ) {
+        __m256i v  = s_avx2_Load(src);
+        __m256i c0 = _mm256_shuffle_epi8(table,
+            _mm256_and_si256(_mm256_srli_epi16(v, 6), mask));
+        __m256i c1 = _mm256_shuffle_epi8(table,
+            _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i c2 = _mm256_shuffle_epi8(table,
+            _mm256_and_si256(_mm256_srli_epi16(v, 2), mask));
+        __m256i c3 = _mm256_shuffle_epi8(table, _mm256_and_si256(v, mask));
+        __m256i t0 = _mm256_unpacklo_epi8(c0, c1);
+        __m256i t1 = _mm256_unpackhi_epi8(c0, c1);
+        __m256i t2 = _mm256_unpacklo_epi8(c2, c3);
+        __m256i t3 = _mm256_unpackhi_epi8(c2, c3);
+        __m256i r0 = _mm256_unpacklo_epi16(t0, t2);
+        __m256i r1 = _mm256_unpackhi_epi16(t0, t2);
+        __m256i r2 = _mm256_unpacklo_epi16(t1, t3);
+        __m256i r3 = _mm256_unpackhi_epi16(t1, t3);
+        s_avx2_Store(dst,      _mm256_permute2x128_si256(r0, r1, 0x20));
+        s_avx2_Store(dst + 32, _mm256_permute2x128_si256(r2, r3, 0x20));
+        s_avx2_Store(dst + 64, _mm256_permute2x128_si256(r0, r1, 0x31));
+        s_avx2_Store(dst + 96, _mm256_permute2x128_si256(r2, r3, 0x31));
+    }
+    return done;
+}
+
+
+static inline NCBI_AVX2_TARGET
+__m256i s_avx2_Pack2(__m256i v0, __m256i v1)
+{
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i r = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights),
+                                    _mm256_maddubs_epi16(v1, weights));
+    return _mm256_permute4x64_epi64(r, 0xd8);
+}
+
+
+static inline NCBI_AVX2_TARGET
+__m256i s_avx2_Pack4(__m256i v0, __m256i v1, __m256i v2, __m256i v3)
+{
+    const __m256i w1 = _mm256_set1_epi16(0x0104);
+    const __m256i w2 = _mm256_set1_epi32(0x00010010);
+    __m256i q0 = _mm256_madd_epi16(_mm256_maddubs_epi16(v0, w1), w2);
+    __m256i q1 = _mm256_madd_epi16(_mm256_maddubs_epi16(v1, w1), w2);
+    __m256i q2 = _mm256_madd_epi16(_mm256_maddubs_epi16(v2, w1), w2);
+    __m256i q3 = _mm256_madd_epi16(_mm256_maddubs_epi16(v3, w1), w2);
+    __m256i r  = _mm256_packus_epi16(_mm256_packs_epi32(q0, q1),
+                                     _mm256_packs_epi32(q2, q3));
+    return _mm256_permutevar8x32_epi32(
+        r, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_4naTo2na(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    const __m256i hi   = s_avx2_Table(tables.m_4naTo2naHi);
+    const __m256i lo   = s_avx2_Table(tables.m_4naTo2naLo);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 128;  done += 128, src += 64, dst += 32 ) {
+        __m256i v0 = s_avx2_Load(src);
+        __m256i v1 = s_avx2_Load(src + 32);
+        __m256i x0 = _mm256_or_si256(
+            _mm256_shuffle_epi8(hi,
+                _mm256_and_si256(_mm256_srli_epi16(v0, 4), mask)),
+            _mm256_shuffle_epi8(lo, _mm256_and_si256(v0, mask)));
+        __m256i x1 = _mm256_or_si256(
+            _mm256_shuffle_epi8(hi,
+                _mm256_and_si256(_mm256_srli_epi16(v1, 4), mask)),
+            _mm256_shuffle_epi8(lo, _mm256_and_si256(v1, mask)));
+        s_avx2_Store(dst, s_avx2_Pack2(x0, x1));
+    }
+    return done;
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_IupacnaTo2na(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaTo2naOK ) {
+        return 0;
+    }
+    const __m256i lo = s_avx2_Table(tables.m_IupacnaTo2na);
+    const __m256i hi = s_avx2_Table(tables.m_IupacnaTo2na + 16);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 128;  done += 128, src += 128, dst += 32 ) {
+        __m256i v0 = s_avx2_Load(src);
+        __m256i v1 = s_avx2_Load(src + 32);
+        __m256i v2 = s_avx2_Load(src + 64);
+        __m256i v3 = s_avx2_Load(src + 96);
+        if ( !s_avx2_IsLetters(v0)  ||  !s_avx2_IsLetters(v1)  ||
+             !s_avx2_IsLetters(v2)  ||  !s_avx2_IsLetters(v3) ) {
+            s_IupacnaTo2naBlock(src, 128, dst);
+            continue;
+        }
+        s_avx2_Store(dst, s_avx2_Pack4(s_avx2_Lookup32(v0, lo, hi),
+                                       s_avx2_Lookup32(v1, lo, hi),
+                                       s_avx2_Lookup32(v2, lo, hi),
+                                       s_avx2_Lookup32(v3, lo, hi)));
+    }
+    return done;
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_IupacnaTo4na(const char* src, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaTo4naOK ) {
+        return 0;
+    }
+    const __m256i lo = s_avx2_Table(tables.m_IupacnaTo4na);
+    const __m256i hi = s_avx2_Table(tables.m_IupacnaTo4na + 16);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 64;  done += 64, src += 64, dst += 32 ) {
+        __m256i v0 = s_avx2_Load(src);
+        __m256i v1 = s_avx2_Load(src + 32);
+        if ( !s_avx2_IsLetters(v0)  ||  !s_avx2_IsLetters(v1) ) {
+            s_IupacnaTo4naBlock(src, 64, dst);
+            continue;
+        }
+        s_avx2_Store(dst, s_avx2_Pack2(s_avx2_Lookup32(v0, lo, hi),
+                                       s_avx2_Lookup32(v1, lo, hi)));
+    }
+    return done;
+}
+
+
+static inline NCBI_AVX2_TARGET
+__m256i s_avx2_ReverseBytes(__m256i v)
+{
+    __m256i r = _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    return _mm256_permute4x64_epi64(r, 0x4e);
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_RevCmpPacked(const char* end, TSeqPos length, char* dst,
+                            const Uint1* lut_hi, const Uint1* lut_lo,
+                            TSeqPos per_byte)
+{
+    const TSeqPos kBlock = 32 * per_byte;
+    const __m256i hi   = s_avx2_Table(lut_hi);
+    const __m256i lo   = s_avx2_Table(lut_lo);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= kBlock;  done += kBlock, dst += 32 ) {
+        end -= 32;
+        __m256i v = s_avx2_Load(end);
+        __m256i r = _mm256_or_si256(
+            _mm256_shuffle_epi8(hi, _mm256_and_si256(v, mask)),
+            _mm256_shuffle_epi8(lo,
+                _mm256_and_si256(_mm256_srli_epi16(v, 4), mask)));
+        s_avx2_Store(dst, s_avx2_ReverseBytes(r));
+    }
+    return done;
+}
+
+
+static NCBI_AVX2_TARGET
+TSeqPos s_avx2_RevCmpIupacna(const char* end, TSeqPos length, char* dst)
+{
+    const SSeqUtilSimdTables& tables = s_GetTables();
+    if ( !tables.m_IupacnaCmpOK ) {
+        return 0;
+    }
+    const __m256i lo   = s_avx2_Table(tables.m_IupacnaCmp);
+    const __m256i hi   = s_avx2_Table(tables.m_IupacnaCmp + 16);
+    const __m256i case_mask = _mm256_set1_epi8(char(0xe0));
+
+    TSeqPos done = 0;
+    for ( ;  length - done >= 32;  done += 32, dst += 32 ) {
+        end -= 32;
+        __m256i v = s_avx2_Load(end);
+        if ( !s_avx2_IsLetters(v) ) {
+            s_IupacnaRevCmpBlock(end + 32, 32, dst);
+            continue;
+        }
+        __m256i r = _mm256_or_si256(s_avx2_Lookup32(v, lo, hi),
+                                    _mm256_and_si256(v, case_mask));
+        s_avx2_Store(dst, s_avx2_ReverseBytes(r));
+    }
+    return done;
+}
+
+#endif // NCBI_SEQUTIL_AVX2
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// Dispatch
+
+static std::atomic<int> s_SimdLevel(-1);
+
+
+static CSeqUtil::ESimdLevel s_GetBestLevel(void)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( CCpuFeatures::AVX2()  &&  CCpuFeatures::OSXSAVE() ) {
+        return CSeqUtil::eSimd_AVX2;
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    return CSeqUtil::eSimd_SSE;
+#else
+    return CSeqUtil::eSimd_None;
+#endif
+}
+
+
+CSeqUtil::ESimdLevel CSeqUtil_simd::GetLevel(void)
+{
+    int level = s_SimdLevel.load(std::memory_order_relaxed);
+    if ( level < 0 ) {
+        level = s_GetBestLevel();
+        s_SimdLevel.store(level, std::memory_order_relaxed);
+    }
+    return CSeqUtil::ESimdLevel(level);
+}
+
+
+CSeqUtil::ESimdLevel CSeqUtil_simd::SetLevel(CSeqUtil::ESimdLevel level)
+{
+    CSeqUtil::ESimdLevel best = s_GetBestLevel();
+    if ( level > best ) {
+        level = best;
+    }
+    s_SimdLevel.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+
+TSeqPos CSeqUtil_simd::Convert2naTo4na(const char* src, TSeqPos length,
+                                       char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_Expand2(src, length, dst, s_GetTables().m_2naTo4na, 4);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_Expand2(src, length, dst, s_GetTables().m_2naTo4na, 4);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::Convert2naToIupacna(const char* src, TSeqPos length,
+                                           char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_2naToIupacna(src, length, dst);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_2naToIupacna(src, length, dst);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::Convert4naTo2na(const char* src, TSeqPos length,
+                                       char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_4naTo2na(src, length, dst);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_4naTo2na(src, length, dst);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::Convert4naToIupacna(const char* src, TSeqPos length,
+                                           char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_Expand2(src, length, dst,
+                              s_GetTables().m_4naToIupacna, 2);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_Expand2(src, length, dst,
+                             s_GetTables().m_4naToIupacna, 2);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::ConvertIupacnaTo2na(const char* src, TSeqPos length,
+                                           char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_IupacnaTo2na(src, length, dst);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_IupacnaTo2na(src, length, dst);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::ConvertIupacnaTo4na(const char* src, TSeqPos length,
+                                           char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_IupacnaTo4na(src, length, dst);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_IupacnaTo4na(src, length, dst);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::RevCmp2na(const char* end, TSeqPos length, char* dst)
+{
+#if defined(NCBI_SEQUTIL_SSE)
+    const SSeqUtilSimdTables& tables = s_GetTables();
+#endif
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_RevCmpPacked(end, length, dst, tables.m_2naRevCmpHi,
+                                   tables.m_2naRevCmpLo, 4);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_RevCmpPacked(end, length, dst, tables.m_2naRevCmpHi,
+                                  tables.m_2naRevCmpLo, 4);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::RevCmp4na(const char* end, TSeqPos length, char* dst)
+{
+#if defined(NCBI_SEQUTIL_SSE)
+    const SSeqUtilSimdTables& tables = s_GetTables();
+#endif
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_RevCmpPacked(end, length, dst, tables.m_4naRevCmpHi,
+                                   tables.m_4naRevCmpLo, 2);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_RevCmpPacked(end, length, dst, tables.m_4naRevCmpHi,
+                                  tables.m_4naRevCmpLo, 2);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::RevCmpIupacna(const char* end, TSeqPos length,
+                                     char* dst)
+{
+#if defined(NCBI_SEQUTIL_AVX2)
+    if ( GetLevel() >= CSeqUtil::eSimd_AVX2 ) {
+        return s_avx2_RevCmpIupacna(end, length, dst);
+    }
+#endif
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_RevCmpIupacna(end, length, dst);
+    }
+#endif
+    return 0;
+}
+
+
+TSeqPos CSeqUtil_simd::RevCmpIupacnaInPlace(char* first, TSeqPos length)
+{
+    // swapping is bound by memory traffic, so 128-bit vectors suffice here
+#if defined(NCBI_SEQUTIL_SSE)
+    if ( GetLevel() >= CSeqUtil::eSimd_SSE ) {
+        return s_sse_RevCmpIupacnaInPlace(first, length);
+    }
+#endif
+    return 0;
+}
+
+
+END_NCBI_SCOPE
@@ -0,0 +1,86 @@
+#ifndef UTIL_SEQUTIL___SEQUTIL_SIMD__HPP
+#define UTIL_SEQUTIL___SEQUTIL_SIMD__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   SSE/AVX2 kernels for bulk nucleotide conversion and reverse complement.
+ */
+#include <corelib/ncbistd.hpp>
+
+#include <util/sequtil/sequtil.hpp>
+
+
+BEGIN_NCBI_SCOPE
+
+
+// All kernels process the longest prefix of the request they can handle
+// in whole vector blocks and return the number of residues done; the
+// caller completes the remainder with the table-driven code.
+// Zero is returned if the kernels are disabled or the request is too short.
+// The lookup vectors are derived from the conversion tables, so both paths
+// produce identical results.
+
+class CSeqUtil_simd
+{
+public:
+    // 'src' points to a byte boundary of the packed input.
+    static TSeqPos Convert2naTo4na     (const char* src, TSeqPos length,
+                                        char* dst);
+    static TSeqPos Convert2naToIupacna (const char* src, TSeqPos length,
+                                        char* dst);
+    static TSeqPos Convert4naTo2na     (const char* src, TSeqPos length,
+                                        char* dst);
+    static TSeqPos Convert4naToIupacna (const char* src, TSeqPos length,
+                                        char* dst);
+    static TSeqPos ConvertIupacnaTo2na (const char* src, TSeqPos length,
+                                        char* dst);
+    static TSeqPos ConvertIupacnaTo4na (const char* src, TSeqPos length,
+                                        char* dst);
+
+    // Reverse complement into a separate buffer. 'end' points past the
+    // last input byte, which must end at a byte boundary; residues are
+    // consumed from the end, and written to 'dst' from the beginning.
+    static TSeqPos RevCmp2na    (const char* end, TSeqPos length, char* dst);
+    static TSeqPos RevCmp4na    (const char* end, TSeqPos length, char* dst);
+    static TSeqPos RevCmpIupacna(const char* end, TSeqPos length, char* dst);
+
+    // In-place iupacna reverse complement of [first, first + length).
+    // Returns the number of residues swapped at EACH end of the range;
+    // the middle part is left for the caller.
+    static TSeqPos RevCmpIupacnaInPlace(char* first, TSeqPos length);
+
+    static CSeqUtil::ESimdLevel GetLevel(void);
+    static CSeqUtil::ESimdLevel SetLevel(CSeqUtil::ESimdLevel level);
+};
+
+
+END_NCBI_SCOPE
+
+
+#endif  /* UTIL_SEQUTIL___SEQUTIL_SIMD__HPP */
@@ -37,6 +37,12 @@
 #include <util/error_codes.hpp>
 #include <algorithm>
 
+#if NCBI_SSE >= 20  &&  \
+    (defined(NCBI_COMPILER_GCC)  ||  defined(NCBI_COMPILER_ANY_CLANG))
+#  include <emmintrin.h>
+#  define NCBI_STRBUFFER_SSE
+#endif
+
 
 #define NCBI_USE_ERRCODE_X   Util_Stream
 
@@ -229,6 +235,25 @@ char CIStreamBuffer::SkipSpaces(void)
     //     end == m_DataEndPos
     //     pos < end
     for (;;) {
+#if defined(NCBI_STRBUFFER_SSE)
+        // indentation comes in long runs, check 16 chars at once
+        const __m128i space = _mm_set1_epi8(' ');
+        for ( ; end - pos >= 16; pos += 16 ) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, space)) ^ 0xFFFF;
+            if ( mask ) {
+                pos += __builtin_ctz(mask);
+                m_CurrentPos = pos;
+                return *pos;
+            }
+        }
+        if ( pos == end ) {
+            m_CurrentPos = pos;
+            pos = FillBuffer(pos);
+            end = m_DataEndPos;
+            continue;
+        }
+#endif
         // we use do{}while() cycle because
         // condition is true at the beginning ( pos < end )
         do {
@@ -288,6 +313,82 @@ void CIStreamBuffer::FindChar(char c)
 }
 
 
+// Find the first char in [pos, end) which is one of 'count' chars,
+// or has the high bit set if 'stop8bit' is true; return end if none.
+static inline
+const char* s_FindAnyChar(const char* pos, const char* end,
+                          const char* chars, size_t count, bool stop8bit)
+{
+#if defined(NCBI_STRBUFFER_SSE)
+    if ( end - pos >= 16 ) {
+        __m128i stop[8];
+        for ( size_t i = 0; i < count; ++i ) {
+            stop[i] = _mm_set1_epi8(chars[i]);
+        }
+        for ( ; end - pos >= 16; pos += 16 ) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+            __m128i eq = _mm_cmpeq_epi8(v, stop[0]);
+            for ( size_t i = 1; i < count; ++i ) {
+                eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, stop[i]));
+            }
+            int mask = _mm_movemask_epi8(eq);
+            if ( stop8bit ) {
+                mask |= _mm_movemask_epi8(v);
+            }
+            if ( mask ) {
+                return pos + __builtin_ctz(mask);
+            }
+        }
+    }
+#endif
+    for ( ; pos < end; ++pos ) {
+        char c = *pos;
+        if ( stop8bit  &&  (c & 0x80) ) {
+            return pos;
+        }
+        for ( size_t i = 0; i < count; ++i ) {
+            if ( c == chars[i] ) {
+                return pos;
+            }
+        }
+    }
+    return end;
+}
+
+
+// this method is highly optimized
+char CIStreamBuffer::FindAnyChar(const char* chars, size_t count,
+                                 string* str, bool stop8bit)
+    THROWS1((CIOException))
+{
+    _ASSERT(count > 0  &&  count <= 8);
+    // cache pointers
+    const char* pos = m_CurrentPos;
+    const char* end = m_DataEndPos;
+    // make sure thire is at least one char in buffer
+    if ( pos == end ) {
+        pos = FillBuffer(pos);
+        end = m_DataEndPos;
+    }
+    for (;;) {
+        const char* found = s_FindAnyChar(pos, end, chars, count, stop8bit);
+        if ( str ) {
+            str->append(pos, found - pos);
+        }
+        if ( found != end ) {
+            m_CurrentPos = found;
+            return *found;
+        }
+        // point m_CurrentPos to end of buffer
+        m_CurrentPos = end;
+        // fill next portion
+        pos = FillBuffer(end);
+        // cache m_DataEndPos
+        end = m_DataEndPos;
+    }
+}
+
+
 // this method is highly optimized
 size_t CIStreamBuffer::PeekFindChar(char c, size_t limit)
     THROWS1((CIOException))
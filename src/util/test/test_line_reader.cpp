@@ -248,7 +248,11 @@ static string s_CreateTestFile(vector<string>& lines,
 /** Get one of ILineReader implementations:
  *  1. CMemoryLineReader
  *  2. CStreamLineReader
- *  3. CBufferedLineReader */
+ *  3. ILineReader::New()
+ *  4. CBufferedLineReader over a memory-mapped file
+ *  5. CBufferedLineReader over a stream */
+static const int kReaderTypes = 5;
+
 static CRef<ILineReader> s_GetLineReader(string filename, int type)
 {
     CRef<ILineReader> rdr;
@@ -269,6 +273,20 @@ static CRef<ILineReader> s_GetLineReader(string filename, int type)
         LOG_POST(Error << "CBufferedLineReader");
         rdr = CBufferedLineReader::New(filename);
         break;
+    case 3:
+    {
+        LOG_POST(Error << "CBufferedLineReader (mapped)");
+        CRef<CBufferedLineReader> buffered(new CBufferedLineReader(filename));
+        BOOST_CHECK(buffered->IsMemoryMapped());
+        rdr = buffered;
+        break;
+    }
+    case 4:
+        LOG_POST(Error << "CBufferedLineReader (stream)");
+        rdr = new CBufferedLineReader(
+                        *new CNcbiIfstream(filename.c_str(), ios::binary),
+                        eTakeOwnership);
+        break;
     }
     return rdr;
 }
@@ -281,7 +299,7 @@ BOOST_AUTO_TEST_CASE( RunSelfTest )
     vector<string> lines;
     string filename = s_CreateTestFile(lines,
                                        positions);
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
         /* Test itself. For each reader the following behavior is tested:
@@ -325,7 +343,7 @@ BOOST_AUTO_TEST_CASE( PeekCharAfterUnget__ReturnFirstSymbolCurrentLine )
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -371,7 +389,7 @@ BOOST_AUTO_TEST_CASE(PeekCharAfterPlusPlus__FirstCharNextString)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -403,7 +421,7 @@ BOOST_AUTO_TEST_CASE(PeekCharAfterTwicePlusPlus__FirstCharNextNextString)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -440,7 +458,7 @@ BOOST_AUTO_TEST_CASE(PeekCharAfterConstructor__FirstCharFirstString)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -464,7 +482,7 @@ BOOST_AUTO_TEST_CASE(PeekCharEmptyString__ReturnsZero)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
         /* 1. PeekChar
@@ -498,7 +516,7 @@ BOOST_AUTO_TEST_CASE(GetCurrentLineAfterConstructor__NULL)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -522,7 +540,7 @@ BOOST_AUTO_TEST_CASE(GetCurrentLineAfterPlusPlus__FirstLine)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -564,7 +582,7 @@ BOOST_AUTO_TEST_CASE(GetCurrentLineAfterTwicePlusPlus__SecondLine)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -591,7 +609,7 @@ BOOST_AUTO_TEST_CASE(GetCurrentLineAtEOF__NULL)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -620,7 +638,7 @@ BOOST_AUTO_TEST_CASE(GetCurrentLineAfterPlusPlusAtEOF__NULL)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -651,7 +669,7 @@ BOOST_AUTO_TEST_CASE(GetLineNumberAfterConstructor__0)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -674,7 +692,7 @@ BOOST_AUTO_TEST_CASE(GetLineNumberAfterPlusPlus__1)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -711,7 +729,7 @@ BOOST_AUTO_TEST_CASE(GetLineNumberAfterTwicePlusPlus__2)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -737,7 +755,7 @@ BOOST_AUTO_TEST_CASE(GetLineNumberAtEOF__LastNumber)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
@@ -765,7 +783,7 @@ BOOST_AUTO_TEST_CASE(GetLineNumberAfterPlusPlusAtEOF__LastNumber)
     string filename = s_CreateTestFile(lines,
                                        positions);
 
-    for ( int type = 0; type < 3; ++type ) {
+    for ( int type = 0; type < kReaderTypes; ++type ) {
         CRef<ILineReader> rdr;
         rdr = s_GetLineReader(filename, type);
 
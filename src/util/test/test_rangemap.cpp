@@ -36,6 +36,7 @@
 #include <corelib/ncbiargs.hpp>
 #include <corelib/ncbiutil.hpp>
 #include <util/rangemap.hpp>
+#include <util/static_rangemap.hpp>
 #include <util/itree.hpp>
 #include <util/random_gen.hpp>
 #include <stdlib.h>
@@ -54,6 +55,7 @@ public:
 
     void TestRangeMap(void) const;
     void TestIntervalTree(void) const;
+    void TestStaticRangeMap(void) const;
 
     void Filling(const char* type) const;
     void Filled(size_t size) const;
@@ -287,6 +289,101 @@ void CTestRangeMap::TestRangeMap(void) const
     End();
 }
 
+void CTestRangeMap::TestStaticRangeMap(void) const
+{
+    Filling("CStaticRangeMap");
+
+    typedef CRangeMultimap<int> TMap;
+    typedef CStaticRangeMultimap<int> TStaticMap;
+    typedef TStaticMap::const_iterator TStaticMapCI;
+
+    TMap m;
+
+    CStopWatch sw;
+    // fill
+    for ( int count = 0; count < m_RangeNumber; ) {
+        TRange range = RandomRange();
+        m.insert(TMap::value_type(range, count));
+        ++count;
+        Added(range);
+    }
+    sw.Restart();
+    TStaticMap sm(m.begin(), m.end());
+    cout << "Build time: "<<sw.Elapsed()<<endl;
+    
+    if ( m_PrintSize ) {
+        Filled(sm.size());
+    }
+    if ( sm.size() != m.size() ) {
+        ERR_FATAL("CStaticRangeMultimap: wrong size");
+    }
+
+    sw.Restart();
+    for ( TStaticMapCI i = sm.begin(); i; ++i ) {
+        FromAll(i.GetInterval());
+    }
+    cout << "Full scan time: "<<sw.Elapsed()<<endl;
+
+    size_t scannedCount = 0;
+    for ( int count = 0; count < m_ScanCount; ++count ) {
+        sw.Restart();
+        for ( int pos = 0; pos <= m_Length + 2*m_RangeLength;
+              pos += m_ScanStep ) {
+            TRange range;
+            range.Set(pos, pos + m_ScanLength - 1);
+            
+            StartFrom(range);
+            
+            for ( TStaticMapCI i = sm.begin(range); i; ++i ) {
+                From(range, i.GetInterval());
+                ++scannedCount;
+            }
+        }
+        cout << "Lookup time: "<<sw.Elapsed()<<endl;
+    }
+    PrintTotalScannedNumber(scannedCount);
+
+    // compare with CRangeMultimap<>
+    for ( int pos = -m_ScanLength; pos <= m_Length + 2*m_RangeLength;
+          pos += m_ScanStep ) {
+        TRange range;
+        range.Set(pos, pos + m_ScanLength - 1);
+        vector<int> expected, found;
+        for ( TMap::const_iterator i = m.begin(range); i; ++i ) {
+            expected.push_back(i->second);
+        }
+        TRange prev = TRange::GetEmpty();
+        for ( TStaticMapCI i = sm.begin(range); i; ++i ) {
+            if ( !prev.Empty() && i.GetInterval().GetFrom() < prev.GetFrom() ) {
+                ERR_FATAL("CStaticRangeMultimap: wrong order of "<<
+                          ToString(i.GetInterval()));
+            }
+            if ( !i.GetInterval().IntersectingWith(range) ) {
+                ERR_FATAL("CStaticRangeMultimap: "<<
+                          ToString(i.GetInterval())<<
+                          " doesn't intersect with "<<ToString(range));
+            }
+            prev = i.GetInterval();
+            found.push_back(i->second);
+        }
+        sort(expected.begin(), expected.end());
+        sort(found.begin(), found.end());
+        if ( found != expected ) {
+            ERR_FATAL("CStaticRangeMultimap: wrong intervals in "<<
+                      ToString(range));
+        }
+    }
+    for ( TMap::const_iterator i = m.begin(); i; ++i ) {
+        TStaticMapCI j = sm.find(i.GetInterval());
+        if ( !j || j.GetInterval() != i.GetInterval() ) {
+            ERR_FATAL("CStaticRangeMultimap: not found "<<
+                      ToString(i.GetInterval()));
+        }
+    }
+
+    End();
+}
+
 void CTestRangeMap::Init(void)
 {
     SetDiagPostLevel(eDiag_Warning);
@@ -301,7 +398,8 @@ void CTestRangeMap::Init(void)
                      CArgDescriptions::eString, "CIntervalTree");
     d->SetConstraint("t", (new CArgAllow_Strings)->
                      Allow("CIntervalTree")->Allow("i")->
-                     Allow("CRangeMap")->Allow("r"));
+                     Allow("CRangeMap")->Allow("r")->
+                     Allow("CStaticRangeMap")->Allow("s"));
 
     d->AddDefaultKey("c", "count",
                      "how may times to run whole test",
@@ -355,10 +453,15 @@ int CTestRangeMap::Run(void)
     bool intervalTree =
         args["t"].AsString() == "CIntervalTree" ||
         args["t"].AsString() == "i";
+    bool staticRangeMap =
+        args["t"].AsString() == "CStaticRangeMap" ||
+        args["t"].AsString() == "s";
 
     for ( int count = 0; count < m_Count; ++count ) {
         if ( intervalTree )
             TestIntervalTree();
+        else if ( staticRangeMap )
+            TestStaticRangeMap();
         else
             TestRangeMap();
     }
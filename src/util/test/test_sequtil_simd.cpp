@@ -0,0 +1,245 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Check vectorized sequence conversions against the table-driven code,
+ *   and report their throughput.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/random_gen.hpp>
+#include <util/sequtil/sequtil.hpp>
+#include <util/sequtil/sequtil_convert.hpp>
+#include <util/sequtil/sequtil_manip.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+struct SPair
+{
+    const char*       name;
+    CSeqUtil::ECoding src;
+    CSeqUtil::ECoding dst;   // e_not_set for reverse complement
+};
+
+
+static const SPair s_Pairs[] = {
+    { "ncbi2na -> ncbi4na",  CSeqUtil::e_Ncbi2na, CSeqUtil::e_Ncbi4na },
+    { "ncbi4na -> ncbi2na",  CSeqUtil::e_Ncbi4na, CSeqUtil::e_Ncbi2na },
+    { "ncbi2na -> iupacna",  CSeqUtil::e_Ncbi2na, CSeqUtil::e_Iupacna },
+    { "iupacna -> ncbi2na",  CSeqUtil::e_Iupacna, CSeqUtil::e_Ncbi2na },
+    { "ncbi4na -> iupacna",  CSeqUtil::e_Ncbi4na, CSeqUtil::e_Iupacna },
+    { "iupacna -> ncbi4na",  CSeqUtil::e_Iupacna, CSeqUtil::e_Ncbi4na },
+    { "revcomp ncbi2na",     CSeqUtil::e_Ncbi2na, CSeqUtil::e_not_set },
+    { "revcomp ncbi4na",     CSeqUtil::e_Ncbi4na, CSeqUtil::e_not_set },
+    { "revcomp iupacna",     CSeqUtil::e_Iupacna, CSeqUtil::e_not_set }
+};
+
+
+static const char* s_LevelName(CSeqUtil::ESimdLevel level)
+{
+    switch ( level ) {
+    case CSeqUtil::eSimd_None: return "table";
+    case CSeqUtil::eSimd_SSE:  return "SSE";
+    case CSeqUtil::eSimd_AVX2: return "AVX2";
+    default:                   return "best";
+    }
+}
+
+
+class CTestSeqUtilSimd : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+private:
+    void x_Apply(const SPair& pair, TSeqPos pos, TSeqPos length,
+                 string& dst);
+    bool x_Check(const SPair& pair, CSeqUtil::ESimdLevel level,
+                 CRandom& rnd, int count);
+    void x_Time(const SPair& pair, CSeqUtil::ESimdLevel level,
+                int iterations);
+
+    string m_Data[CSeqUtil::e_Ncbi4na + 1];
+    TSeqPos m_Length;
+};
+
+
+void CTestSeqUtilSimd::Init(void)
+{
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+    d->SetUsageContext(GetArguments().GetProgramBasename(),
+                       "Vectorized sequence conversion test");
+    d->AddDefaultKey("size", "residues",
+                     "length of the generated sequence",
+                     CArgDescriptions::eInteger, "16000000");
+    d->AddDefaultKey("iterations", "count",
+                     "number of timed passes per conversion",
+                     CArgDescriptions::eInteger, "5");
+    d->AddDefaultKey("checks", "count",
+                     "number of random intervals compared per conversion",
+                     CArgDescriptions::eInteger, "2000");
+    d->AddFlag("nobench", "only compare results, do not report timings");
+    SetupArgDescriptions(d.release());
+}
+
+
+void CTestSeqUtilSimd::x_Apply(const SPair& pair, TSeqPos pos,
+                               TSeqPos length, string& dst)
+{
+    const string& src = m_Data[pair.src];
+    dst.erase();
+    if ( pair.dst != CSeqUtil::e_not_set ) {
+        CSeqConvert::Convert(src, pair.src, pos, length, dst, pair.dst);
+    } else if ( pos % 2 == 0 ) {
+        CSeqManip::ReverseComplement(src, pair.src, pos, length, dst);
+    } else {
+        // in place variant; the result is moved to the beginning
+        dst = src;
+        CSeqManip::ReverseComplement(dst, pair.src, pos, length);
+    }
+}
+
+
+bool CTestSeqUtilSimd::x_Check(const SPair& pair, CSeqUtil::ESimdLevel level,
+                               CRandom& rnd, int count)
+{
+    string expected, actual;
+    for ( int i = 0; i < count; ++i ) {
+        TSeqPos pos = rnd.GetRand(0, 300);
+        TSeqPos length = rnd.GetRand(1, 3000);
+        if ( i % 16 == 0 ) {
+            length = m_Length - pos;
+        }
+        CSeqUtil::SetSimdLevel(CSeqUtil::eSimd_None);
+        x_Apply(pair, pos, length, expected);
+        CSeqUtil::SetSimdLevel(level);
+        x_Apply(pair, pos, length, actual);
+        if ( expected != actual ) {
+            ERR_POST(Error << pair.name << " (" << s_LevelName(level)
+                     << "): mismatch at pos " << pos
+                     << ", length " << length);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void CTestSeqUtilSimd::x_Time(const SPair& pair, CSeqUtil::ESimdLevel level,
+                              int iterations)
+{
+    CSeqUtil::SetSimdLevel(level);
+    string dst;
+    x_Apply(pair, 0, m_Length, dst);
+
+    CStopWatch sw(CStopWatch::eStart);
+    for ( int i = 0; i < iterations; ++i ) {
+        x_Apply(pair, 0, m_Length, dst);
+    }
+    double seconds = sw.Elapsed();
+
+    double bytes = double(m_Data[pair.src].size()) * iterations;
+    double bases = double(m_Length) * iterations;
+    NcbiCout << setw(20) << left << pair.name
+             << setw(6) << s_LevelName(level) << right << fixed
+             << setprecision(2)
+             << setw(9) << bytes / seconds / 1e9 << " GB/s"
+             << setw(9) << bases / seconds / 1e9 << " Gbases/s" << NcbiEndl;
+}
+
+
+int CTestSeqUtilSimd::Run(void)
+{
+    const CArgs& args = GetArgs();
+    m_Length = TSeqPos(args["size"].AsInteger());
+
+    CRandom rnd(1);
+    static const char kBases[] = "ACGTACGTACGTACGTacgtNnRYKMSWBDHV-U";
+    string& iupacna = m_Data[CSeqUtil::e_Iupacna];
+    iupacna.resize(m_Length);
+    for ( TSeqPos i = 0; i < m_Length; ++i ) {
+        // mostly plain bases, with occasional runs of ambiguities
+        // so that both the vector and the fallback paths are used
+        iupacna[i] = kBases[rnd.GetRand(0, i % 4096 < 64 ? 33 : 3)];
+    }
+    CSeqUtil::SetSimdLevel(CSeqUtil::eSimd_None);
+    CSeqConvert::Convert(iupacna, CSeqUtil::e_Iupacna, 0, m_Length,
+                         m_Data[CSeqUtil::e_Ncbi2na], CSeqUtil::e_Ncbi2na);
+    CSeqConvert::Convert(iupacna, CSeqUtil::e_Iupacna, 0, m_Length,
+                         m_Data[CSeqUtil::e_Ncbi4na], CSeqUtil::e_Ncbi4na);
+
+    vector<CSeqUtil::ESimdLevel> levels;
+    for ( int l = CSeqUtil::eSimd_SSE;  l <= CSeqUtil::eSimd_AVX2;  ++l ) {
+        CSeqUtil::ESimdLevel level = CSeqUtil::ESimdLevel(l);
+        if ( CSeqUtil::SetSimdLevel(level) == level ) {
+            levels.push_back(level);
+        }
+    }
+    if ( levels.empty() ) {
+        NcbiCout << "No vectorized kernels in this build" << NcbiEndl;
+    }
+
+    int errors = 0;
+    for ( const SPair& pair : s_Pairs ) {
+        for ( CSeqUtil::ESimdLevel level : levels ) {
+            if ( !x_Check(pair, level, rnd, args["checks"].AsInteger()) ) {
+                ++errors;
+            }
+        }
+    }
+
+    if ( !args["nobench"] ) {
+        levels.insert(levels.begin(), CSeqUtil::eSimd_None);
+        for ( const SPair& pair : s_Pairs ) {
+            for ( CSeqUtil::ESimdLevel level : levels ) {
+                x_Time(pair, level, args["iterations"].AsInteger());
+            }
+        }
+    }
+    CSeqUtil::SetSimdLevel(CSeqUtil::eSimd_Best);
+
+    if ( errors ) {
+        ERR_POST(Error << errors << " conversion(s) failed");
+        return 1;
+    }
+    NcbiCout << "All conversions match the table-driven results" << NcbiEndl;
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CTestSeqUtilSimd().AppMain(argc, argv);
+}
@@ -98,6 +98,7 @@ static bool                              s_ZeroSleep = false;
 class CThreadPoolTester : public CThreadedApp
 {
 protected:
+    virtual bool TestApp_Args(CArgDescriptions& args);
     virtual bool TestApp_Init(void);
     virtual bool TestApp_Exit(void);
     virtual bool Thread_Run(int idx);
@@ -179,6 +180,17 @@ void CThreadPoolTester::GetMinMaxThreads
 }
 
 
+bool CThreadPoolTester::TestApp_Args(CArgDescriptions& args)
+{
+    args.AddDefaultKey("queue_mode", "QueueMode",
+        "Queue mode of the pool used by the main test",
+        CArgDescriptions::eString, "single");
+    args.SetConstraint("queue_mode",
+        &(*new CArgAllow_Strings, "single", "sharded"));
+    return true;
+}
+
+
 bool CThreadPoolTester::TestApp_Init(void)
 {
     s_Timer.Start();
@@ -195,9 +207,13 @@ bool CThreadPoolTester::TestApp_Init(void)
     for (unsigned j = 0; j < 300; j++) {
         unsigned min_threads, max_threads;
         GetMinMaxThreads(&min_threads, &max_threads);
+        CThreadPool::EQueueMode queue_mode = (j % 2 == 0)
+            ? CThreadPool::eSingleQueue: CThreadPool::eShardedQueues;
         MSG_POST("Terminator task test. Round: " << j <<
-                 ", min/max threads: " << min_threads << "/" << max_threads);
-        CThreadPool tp(100, max_threads, min_threads);
+                 ", min/max threads: " << min_threads << "/" << max_threads <<
+                 ", sharded queues: " << (queue_mode != CThreadPool::eSingleQueue));
+        CThreadPool tp(100, max_threads, min_threads, CThread::fRunDefault,
+                       queue_mode);
         _ASSERT(s_TaskCounter.Get() == 0);
         for (unsigned i = 0;  i < 98;  i++) {
             tp.AddTask(new CSentinelThreadPool_Task(i));
@@ -243,7 +259,13 @@ bool CThreadPoolTester::TestApp_Init(void)
 
 
     //
-    s_Pool = new CThreadPool(kQueueSize, kMaxThreads);
+    CThreadPool::EQueueMode queue_mode =
+        GetArgs()["queue_mode"].AsString() == "sharded"
+        ? CThreadPool::eShardedQueues: CThreadPool::eSingleQueue;
+    MSG_POST("Main test sharded queues: "
+             << (queue_mode != CThreadPool::eSingleQueue));
+    s_Pool = new CThreadPool(kQueueSize, kMaxThreads, 2, CThread::fRunDefault,
+                             queue_mode);
 
     if (s_NumThreads > kQueueSize) {
         s_NumThreads = kQueueSize;
@@ -0,0 +1,209 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *   This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * Author:  agent
+ *
+ * File Description:
+ *   Test program to collect throughput of CThreadPool depending on the
+ *   task size, the number of threads and the queue mode
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/thread_pool.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+/// Task doing the given amount of busy work
+class CWorkTask : public CThreadPool_Task
+{
+public:
+    CWorkTask(unsigned int work, atomic<Uint8>& left, CSemaphore& done)
+        : m_Work(work), m_Left(left), m_Done(done) {}
+
+    virtual EStatus Execute(void)
+    {
+        Uint8 sum = 0;
+        for (unsigned int i = 0;  i < m_Work;  ++i) {
+            sum = sum * 31 + i;
+        }
+        sm_Sink.fetch_add(sum, memory_order_relaxed);
+        if (m_Left.fetch_sub(1) == 1) {
+            m_Done.Post();
+        }
+        return eCompleted;
+    }
+
+private:
+    unsigned int   m_Work;
+    atomic<Uint8>& m_Left;
+    CSemaphore&    m_Done;
+
+    static atomic<Uint8> sm_Sink;
+};
+
+atomic<Uint8> CWorkTask::sm_Sink(0);
+
+
+/// Task adding a batch of work tasks from inside the pool
+class CSpawnTask : public CThreadPool_Task
+{
+public:
+    CSpawnTask(unsigned int count, unsigned int work,
+               atomic<Uint8>& left, CSemaphore& done)
+        : m_Count(count), m_Work(work), m_Left(left), m_Done(done) {}
+
+    virtual EStatus Execute(void)
+    {
+        for (unsigned int i = 0;  i < m_Count;  ++i) {
+            GetPool()->AddTask(new CWorkTask(m_Work, m_Left, m_Done));
+        }
+        return eCompleted;
+    }
+
+private:
+    unsigned int   m_Count;
+    unsigned int   m_Work;
+    atomic<Uint8>& m_Left;
+    CSemaphore&    m_Done;
+};
+
+
+
+class CThreadPoolPerfTest : public CNcbiApplication
+{
+public:
+    void Init(void);
+    int Run(void);
+
+private:
+    double x_Measure(CThreadPool::EQueueMode queue_mode,
+                     unsigned int threads, unsigned int work);
+
+    unsigned int m_Tasks;
+    unsigned int m_Batch;
+};
+
+
+void CThreadPoolPerfTest::Init(void)
+{
+    SetDiagPostLevel(eDiag_Error);
+
+    unique_ptr<CArgDescriptions> d(new CArgDescriptions);
+
+    d->AddDefaultKey("t", "threads",
+                     "maximum number of threads, tested are the powers "
+                     "of 2 up to this value",
+                     CArgDescriptions::eInteger, "128");
+    d->AddDefaultKey("n", "tasks",
+                     "number of tasks executed in each measurement",
+                     CArgDescriptions::eInteger, "200000");
+    d->AddDefaultKey("w", "work",
+                     "comma separated sizes of the tasks "
+                     "(iterations of the busy loop)",
+                     CArgDescriptions::eString, "0,100,1000,10000");
+    d->AddDefaultKey("b", "batch",
+                     "number of tasks added by each task running in the "
+                     "pool; 0 means that all tasks are added by the main "
+                     "thread",
+                     CArgDescriptions::eInteger, "0");
+    SetupArgDescriptions(d.release());
+}
+
+
+double CThreadPoolPerfTest::x_Measure(CThreadPool::EQueueMode queue_mode,
+                                      unsigned int threads, unsigned int work)
+{
+    CThreadPool pool(m_Tasks + 1, threads, threads, CThread::fRunDefault,
+                     queue_mode);
+    atomic<Uint8> left(m_Tasks);
+    CSemaphore    done(0, 1);
+
+    CStopWatch timer(CStopWatch::eStart);
+    if (m_Batch == 0) {
+        for (unsigned int i = 0;  i < m_Tasks;  ++i) {
+            pool.AddTask(new CWorkTask(work, left, done));
+        }
+    }
+    else {
+        for (unsigned int i = 0;  i < m_Tasks;  i += m_Batch) {
+            pool.AddTask(new CSpawnTask(min(m_Batch, m_Tasks - i),
+                                        work, left, done));
+        }
+    }
+    done.Wait();
+    double elapsed = timer.Elapsed();
+
+    pool.Abort();
+    return m_Tasks / elapsed;
+}
+
+
+int CThreadPoolPerfTest::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    unsigned int max_threads = (unsigned int)args["t"].AsInteger();
+    m_Tasks = (unsigned int)args["n"].AsInteger();
+    m_Batch = (unsigned int)args["b"].AsInteger();
+
+    vector<unsigned int> works;
+    vector<string> work_strs;
+    NStr::Split(args["w"].AsString(), ",", work_strs,
+                NStr::fSplit_Tokenize);
+    for (const string& s : work_strs) {
+        works.push_back(NStr::StringToUInt(s));
+    }
+
+    cout << "work\tthreads\tsingle queue, tasks/s\tsharded queues, tasks/s"
+         << endl;
+    for (unsigned int work : works) {
+        for (unsigned int threads = 1;  threads <= max_threads;
+                                        threads *= 2)
+        {
+            double single = x_Measure(CThreadPool::eSingleQueue,
+                                      threads, work);
+            double sharded = x_Measure(CThreadPool::eShardedQueues,
+                                        threads, work);
+            cout << work << "\t" << threads << "\t"
+                 << NStr::DoubleToString(single, 0) << "\t"
+                 << NStr::DoubleToString(sharded, 0) << endl;
+        }
+    }
+
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CThreadPoolPerfTest().AppMain(argc, argv);
+}
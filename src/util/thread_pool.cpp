@@ -54,6 +54,34 @@ struct SThreadPool_TaskCompare {
 };
 
 
+/// One of the task queues of the pool in CThreadPool::eShardedQueues mode
+struct alignas(64) SThreadPool_QueueShard {
+    /// Value of m_TopPriority for an empty queue
+    static const Uint8 kEmpty = kMax_UI8;
+
+    /// Mutex guarding the tasks
+    CFastMutex  m_Mutex;
+    /// Type of the tasks container
+    typedef multiset< CRef<CThreadPool_Task>,
+                      SThreadPool_TaskCompare >  TTasks;
+
+    /// Tasks waiting for execution, sorted by priority
+    TTasks         m_Tasks;
+    /// Priority of the first task or kEmpty. It's read without mutex to find
+    /// out which queue to take the next task from.
+    atomic<Uint8>  m_TopPriority{kEmpty};
+
+    /// Refresh m_TopPriority after change of the tasks.
+    /// Must be called with m_Mutex locked.
+    void UpdateTopPriority(void)
+    {
+        m_TopPriority.store(m_Tasks.empty()
+                            ? kEmpty: (*m_Tasks.begin())->GetPriority(),
+                            memory_order_release);
+    }
+};
+
+
 /// Real implementation of all ThreadPool functions
 class CThreadPool_Impl : public CObject
 {
@@ -90,7 +118,9 @@ public:
                      unsigned int      queue_size,
                      unsigned int      max_threads,
                      unsigned int      min_threads,
-                     CThread::TRunMode threads_mode = CThread::fRunDefault);
+                     CThread::TRunMode threads_mode = CThread::fRunDefault,
+                     CThreadPool::EQueueMode queue_mode
+                                       = CThreadPool::eSingleQueue);
 
     /// Constructor with explicitly given controller
     /// @param pool_intf
@@ -100,7 +130,9 @@ public:
     CThreadPool_Impl(CThreadPool*        pool_intf,
                      unsigned int        queue_size,
                      CThreadPool_Controller* controller,
-                     CThread::TRunMode   threads_mode = CThread::fRunDefault);
+                     CThread::TRunMode   threads_mode = CThread::fRunDefault,
+                     CThreadPool::EQueueMode queue_mode
+                                         = CThreadPool::eSingleQueue);
 
     /// Get pointer to ThreadPool interface object
     CThreadPool* GetPoolInterface(void) const;
@@ -178,7 +210,13 @@ public:
 
     /// Get next task from queue if there is one
     /// If the queue is empty then return NULL.
-    CRef<CThreadPool_Task> TryGetNextTask(void);
+    /// @param queue_index
+    ///   Index of the queue preferred by the calling thread
+    ///   (used only in CThreadPool::eShardedQueues mode)
+    CRef<CThreadPool_Task> TryGetNextTask(unsigned int queue_index);
+
+    /// Get index of the queue to be preferred by a new thread
+    unsigned int GetNextQueueIndex(void);
 
     /// Callback from thread when it is starting to execute task
     void TaskStarting(void);
@@ -278,7 +316,8 @@ private:
     ///   Controller for the pool
     void x_Init(CThreadPool*            pool_intf,
                 CThreadPool_Controller* controller,
-                CThread::TRunMode       threads_mode);
+                CThread::TRunMode       threads_mode,
+                CThreadPool::EQueueMode queue_mode);
 
     /// Destructor. Will be called from CRef
     ~CThreadPool_Impl(void);
@@ -290,6 +329,20 @@ private:
     /// Cancel all tasks waiting in the queue
     void x_CancelQueuedTasks(void);
 
+    /// Add task to one of the queues in CThreadPool::eShardedQueues mode
+    /// waiting for the room in them if necessary
+    void x_PushShardedTask(CThreadPool_Task* task, const CTimeSpan* timeout);
+
+    /// Take the task with the smallest priority from the queues
+    /// in CThreadPool::eShardedQueues mode
+    /// @param queue_index
+    ///   Queue to take the task from if there are several candidates
+    CRef<CThreadPool_Task> x_PopShardedTask(unsigned int queue_index);
+
+    /// Account for tasks removed from the queues
+    /// in CThreadPool::eShardedQueues mode
+    void x_ShardedTasksRemoved(unsigned int count);
+
     /// Cancel all currently executing tasks
     void x_CancelExecutingTasks(void);
 
@@ -338,6 +391,21 @@ private:
     CTimeSpan                        m_DestroyTimeout;
     /// Queue for storing tasks
     TQueue                           m_Queue;
+    /// If tasks are stored in m_Shards instead of m_Queue
+    bool                             m_Sharded;
+    /// Queues for storing tasks in CThreadPool::eShardedQueues mode
+    unique_ptr<SThreadPool_QueueShard[]> m_Shards;
+    /// Number of elements in m_Shards
+    unsigned int                     m_ShardsCount;
+    /// Total number of tasks in m_Shards. It's incremented before
+    /// the task is actually added, thus it limits the queues size.
+    atomic<unsigned int>             m_ShardedSize;
+    /// Counter for spreading tasks and threads over m_Shards
+    atomic<unsigned int>             m_NextShard;
+    /// Number of threads waiting for room in m_Shards
+    atomic<int>                      m_ShardedRoomWaiters;
+    /// Semaphore for waiting for room in m_Shards
+    CSemaphore                       m_ShardedRoomWait;
     /// Mutex for guarding all changes in the pool, its threads and controller
     CMutex                           m_MainPoolMutex;
     /// Semaphore for waiting for available threads to process task when
@@ -347,6 +415,9 @@ private:
     CRef<CThreadPool_Controller>     m_Controller;
     /// List of all idle threads
     TThreadsList                     m_IdleThreads;
+    /// Size of m_IdleThreads which can be checked without locking the main
+    /// pool mutex
+    atomic<size_t>                   m_IdleThreadsCount;
     /// List of all threads currently executing some tasks
     TThreadsList                     m_WorkingThreads;
     /// Running mode of all threads
@@ -428,6 +499,13 @@ public:
     /// @sa CThreadPool_Thread::GetPool()
     CThreadPool* GetPool(void) const;
 
+    /// Get pool implementation running this thread
+    CThreadPool_Impl* GetPoolImpl(void) const;
+
+    /// Get index of the queue preferred by this thread
+    /// in CThreadPool::eShardedQueues mode
+    unsigned int GetQueueIndex(void) const;
+
     /// Request this thread to finish its operation.
     /// It renders the thread unusable and eventually ready for destruction
     /// (as soon as its current task is finished and there are no CRefs to
@@ -497,6 +575,8 @@ private:
     CSemaphore                   m_IdleTrigger;
     /// General-use mutex for very (very!) trivial ops
     mutable CFastMutex           m_FastMutex;
+    /// Index of the queue preferred by the thread
+    unsigned int                 m_QueueIndex;
 };
 
 
@@ -625,6 +705,12 @@ s_ConvertTaskResult(CThreadPool_Task::EStatus status)
 
 const CAtomicCounter::TValue kNeedCallController_Shift = 0x0FFFFFFF;
 
+/// Maximum number of queues in CThreadPool::eShardedQueues mode
+const unsigned int kMaxShards = 64;
+
+/// Pool thread running in the current thread (if any)
+static thread_local CThreadPool_ThreadImpl* s_CurrentPoolThread = NULL;
+
 
 inline void
 CThreadPool_ServiceThread::WakeUp(void)
@@ -731,9 +817,22 @@ CThreadPool_Impl::GetThreadsCount(void) const
 inline unsigned int
 CThreadPool_Impl::GetQueuedTasksCount(void) const
 {
+    if (m_Sharded) {
+        return m_ShardedSize.load();
+    }
     return (unsigned int)m_Queue.GetSize();
 }
 
+inline unsigned int
+CThreadPool_Impl::GetNextQueueIndex(void)
+{
+    if ( !m_Sharded ) {
+        return 0;
+    }
+    return m_NextShard.fetch_add(1, memory_order_relaxed)
+           % m_ShardsCount;
+}
+
 inline unsigned int
 CThreadPool_Impl::GetExecutingTasksCount(void) const
 {
@@ -832,6 +931,7 @@ CThreadPool_Impl::ThreadStopped(CThreadPool_ThreadImpl* thread)
 
     m_IdleThreads.erase(thread);
     m_WorkingThreads.erase(thread);
+    m_IdleThreadsCount.store(m_IdleThreads.size());
 
     CallControllerOther();
 
@@ -839,9 +939,13 @@ CThreadPool_Impl::ThreadStopped(CThreadPool_ThreadImpl* thread)
 }
 
 inline CRef<CThreadPool_Task>
-CThreadPool_Impl::TryGetNextTask(void)
+CThreadPool_Impl::TryGetNextTask(unsigned int queue_index)
 {
     if ( !IsSuspended() ) {
+        if (m_Sharded) {
+            return x_PopShardedTask(queue_index);
+        }
+
         TQueue::TAccessGuard guard(m_Queue);
 
         if (m_Queue.GetSize() != 0) {
@@ -1221,7 +1325,8 @@ CThreadPool_ThreadImpl::CThreadPool_ThreadImpl
     m_Finishing(false),
     m_CancelRequested(false),
     m_IsIdle(true),
-    m_IdleTrigger(0, kMax_Int)
+    m_IdleTrigger(0, kMax_Int),
+    m_QueueIndex(pool->GetNextQueueIndex())
 {}
 
 inline
@@ -1234,6 +1339,18 @@ CThreadPool_ThreadImpl::GetPool(void) const
     return m_Pool->GetPoolInterface();
 }
 
+inline CThreadPool_Impl*
+CThreadPool_ThreadImpl::GetPoolImpl(void) const
+{
+    return m_Pool.GetNCPointer();
+}
+
+inline unsigned int
+CThreadPool_ThreadImpl::GetQueueIndex(void) const
+{
+    return m_QueueIndex;
+}
+
 inline bool
 CThreadPool_ThreadImpl::IsFinishing(void) const
 {
@@ -1310,6 +1427,7 @@ inline void
 CThreadPool_ThreadImpl::Main(void)
 {
     m_Interface->Initialize();
+    s_CurrentPoolThread = this;
 
     while (!m_Finishing) {
         // We have to heed call to CancelCurrentTask() only after this point.
@@ -1321,7 +1439,7 @@ CThreadPool_ThreadImpl::Main(void)
         m_CancelRequested = false;
 
         {{
-            CRef<CThreadPool_Task> task = m_Pool->TryGetNextTask();
+            CRef<CThreadPool_Task> task = m_Pool->TryGetNextTask(m_QueueIndex);
             CFastMutexGuard fast_guard(m_FastMutex);
             m_CurrentTask = task;
         }}
@@ -1379,6 +1497,8 @@ CThreadPool_ThreadImpl::Main(void)
             }
         }
     }
+
+    s_CurrentPoolThread = NULL;
 }
 
 inline void
@@ -1420,32 +1540,37 @@ CThreadPool_Impl::CThreadPool_Impl(CThreadPool*      pool_intf,
                                    unsigned int      queue_size,
                                    unsigned int      max_threads,
                                    unsigned int      min_threads,
-                                   CThread::TRunMode threads_mode)
+                                   CThread::TRunMode threads_mode,
+                                   CThreadPool::EQueueMode queue_mode)
     : m_Queue(x_GetQueueSize(queue_size)),
+      m_ShardedRoomWait(0, kMax_Int),
       m_RoomWait(0, kMax_Int),
       m_AbortWait(0, kMax_Int)
 {
     x_Init(pool_intf,
            new CThreadPool_Controller_PID(max_threads, min_threads),
-           threads_mode);
+           threads_mode, queue_mode);
 }
 
 inline
 CThreadPool_Impl::CThreadPool_Impl(CThreadPool*            pool_intf,
                                    unsigned int            queue_size,
                                    CThreadPool_Controller* controller,
-                                   CThread::TRunMode       threads_mode)
+                                   CThread::TRunMode       threads_mode,
+                                   CThreadPool::EQueueMode queue_mode)
     : m_Queue(x_GetQueueSize(queue_size)),
+      m_ShardedRoomWait(0, kMax_Int),
       m_RoomWait(0, kMax_Int),
       m_AbortWait(0, kMax_Int)
 {
-    x_Init(pool_intf, controller, threads_mode);
+    x_Init(pool_intf, controller, threads_mode, queue_mode);
 }
 
 void
 CThreadPool_Impl::x_Init(CThreadPool*             pool_intf,
                          CThreadPool_Controller*  controller,
-                         CThread::TRunMode        threads_mode)
+                         CThread::TRunMode        threads_mode,
+                         CThreadPool::EQueueMode  queue_mode)
 {
     m_Interface = pool_intf;
     m_SelfRef = this;
@@ -1458,6 +1583,21 @@ CThreadPool_Impl::x_Init(CThreadPool*             pool_intf,
     m_FlushRequested = false;
     m_ThreadsMode = (threads_mode | CThread::fRunDetached)
                      & ~CThread::fRunAllowST;
+    m_IdleThreadsCount.store(0);
+
+    m_Sharded = queue_mode == CThreadPool::eShardedQueues;
+    m_ShardsCount = 0;
+    m_ShardedSize.store(0);
+    m_NextShard.store(0);
+    m_ShardedRoomWaiters.store(0);
+    if (m_Sharded) {
+        // There is no point in having more queues than threads, while
+        // the number of threads can change later
+        m_ShardsCount = min(max(controller->GetMaxThreads(), 1u),
+                                    kMaxShards);
+        m_Shards.reset(
+                    new SThreadPool_QueueShard[m_ShardsCount]);
+    }
 
     controller->x_AttachToPool(this);
     m_Controller = controller;
@@ -1509,6 +1649,7 @@ CThreadPool_Impl::LaunchThreads(unsigned int count)
                         CThreadPool_ThreadImpl::s_GetImplPointer(thread));
         thread->Run(m_ThreadsMode);
     }
+    m_IdleThreadsCount.store(m_IdleThreads.size());
 
     m_ThreadsCount.Add(count);
     CallControllerOther();
@@ -1556,9 +1697,16 @@ CThreadPool_Impl::SetThreadIdle(CThreadPool_ThreadImpl* thread, bool is_idle)
 {
     CThreadPool_Guard guard(this);
 
-    if (is_idle  &&  !IsSuspended()  &&  m_Queue.GetSize() != 0) {
-        thread->WakeUp();
-        return false;
+    if (is_idle) {
+        // AddTask() in CThreadPool::eShardedQueues mode checks the number
+        // of idle threads after adding the task without locking the mutex,
+        // so the thread must be counted before looking at the queue
+        m_IdleThreadsCount.fetch_add(1);
+        if ( !IsSuspended()  &&  GetQueuedTasksCount() != 0 ) {
+            m_IdleThreadsCount.fetch_sub(1);
+            thread->WakeUp();
+            return false;
+        }
     }
 
     TThreadsList* to_del;
@@ -1577,6 +1725,7 @@ CThreadPool_Impl::SetThreadIdle(CThreadPool_ThreadImpl* thread, bool is_idle)
         to_del->erase(it);
     }
     to_ins->insert(thread);
+    m_IdleThreadsCount.store(m_IdleThreads.size());
 
     if (is_idle  &&  IsSuspended()
         &&  (m_SuspendFlags & CThreadPool::fFlushThreads))
@@ -1708,7 +1857,12 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
     try {
         // Pushing to queue must be out of mutex to be able to wait
         // for available space.
-        m_Queue.Push(Ref(task), timeout);
+        if (m_Sharded) {
+            x_PushShardedTask(task, timeout);
+        }
+        else {
+            m_Queue.Push(Ref(task), timeout);
+        }
     }
     catch (...) {
         task->x_SetStatus(CThreadPool_Task::eIdle);
@@ -1716,8 +1870,12 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
         throw;
     }
 
-    if (m_IsQueueAllowed) {
+    // With sharded queues the mutex is locked below only if there are
+    // idle threads to wake up
+    bool guarded = !m_IsQueueAllowed;
+    if (m_IsQueueAllowed  &&  !m_Sharded) {
         guard.Guard();
+        guarded = true;
     }
 
     // Check if someone aborted the pool or suspended it with cancelation of
@@ -1728,7 +1886,7 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
     if (m_Aborted  ||  (IsSuspended()
                         &&  (m_SuspendFlags & check_flags)  == check_flags))
     {
-        if (m_Queue.GetSize() != 0) {
+        if (GetQueuedTasksCount() != 0) {
             x_CancelQueuedTasks();
         }
         return;
@@ -1740,7 +1898,10 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
         LaunchThreads(cnt_req - GetThreadsCount());
     }
 
-    if (! IsSuspended()) {
+    if (! IsSuspended()  &&  (guarded  ||  m_IdleThreadsCount.load() != 0)) {
+        if ( !guarded ) {
+            guard.Guard();
+        }
         int count = GetQueuedTasksCount();
         ITERATE(TThreadsList, it, m_IdleThreads) {
             if (! (*it)->IsFinishing()) {
@@ -1755,9 +1916,136 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
     CallControllerOther();
 }
 
+void
+CThreadPool_Impl::x_PushShardedTask(CThreadPool_Task*  task,
+                                     const CTimeSpan*   timeout)
+{
+    // Reserve the room first
+    unique_ptr<CStopWatch> timer;
+    unsigned int size = m_ShardedSize.load();
+    for (;;) {
+        if (size < m_Queue.GetMaxSize()) {
+            if (m_ShardedSize.compare_exchange_weak(size, size + 1)) {
+                break;
+            }
+            continue;
+        }
+
+        if (timeout  &&  !timer) {
+            timer.reset(new CStopWatch(CStopWatch::eStart));
+        }
+        m_ShardedRoomWaiters.fetch_add(1);
+        bool has_room = true;
+        if (m_ShardedSize.load() >= m_Queue.GetMaxSize()) {
+            if (timeout) {
+                CTimeSpan next_tm(timeout->GetAsDouble() - timer->Elapsed());
+                has_room = next_tm.GetSign() != eNegative
+                           &&  m_ShardedRoomWait.TryWait(CTimeout(next_tm));
+            }
+            else {
+                m_ShardedRoomWait.Wait();
+            }
+        }
+        m_ShardedRoomWaiters.fetch_sub(1);
+        if ( !has_room ) {
+            ThrowSyncQueueNoRoom();
+        }
+        size = m_ShardedSize.load();
+    }
+
+    // Tasks added from the pool's own thread are kept close to it
+    CThreadPool_ThreadImpl* thread = s_CurrentPoolThread;
+    unsigned int index = thread  &&  thread->GetPoolImpl() == this
+                         ? thread->GetQueueIndex() % m_ShardsCount
+                         : GetNextQueueIndex();
+
+    SThreadPool_QueueShard& queue = m_Shards[index];
+    CFastMutexGuard q_guard(queue.m_Mutex);
+    queue.m_Tasks.insert(Ref(task));
+    queue.UpdateTopPriority();
+}
+
+CRef<CThreadPool_Task>
+CThreadPool_Impl::x_PopShardedTask(unsigned int queue_index)
+{
+    queue_index %= m_ShardsCount;
+
+    // Another thread can take the task between looking at the priorities
+    // and locking the queue, so make several attempts
+    for (unsigned int attempt = 0;  attempt <= m_ShardsCount;
+                                    ++attempt)
+    {
+        unsigned int best = queue_index;
+        Uint8 best_priority = m_Shards[best].m_TopPriority.load(
+                                                        memory_order_acquire);
+        for (unsigned int i = 1;  i < m_ShardsCount;  ++i) {
+            unsigned int index = (queue_index + i) % m_ShardsCount;
+            Uint8 priority = m_Shards[index].m_TopPriority.load(
+                                                        memory_order_acquire);
+            if (priority < best_priority) {
+                best = index;
+                best_priority = priority;
+            }
+        }
+        if (best_priority == SThreadPool_QueueShard::kEmpty) {
+            break;
+        }
+
+        CRef<CThreadPool_Task> task;
+        {{
+            SThreadPool_QueueShard& queue = m_Shards[best];
+            CFastMutexGuard q_guard(queue.m_Mutex);
+            if (queue.m_Tasks.empty()) {
+                continue;
+            }
+            task = *queue.m_Tasks.begin();
+            queue.m_Tasks.erase(queue.m_Tasks.begin());
+            queue.UpdateTopPriority();
+        }}
+        x_ShardedTasksRemoved(1);
+        return task;
+    }
+
+    return CRef<CThreadPool_Task>();
+}
+
+void
+CThreadPool_Impl::x_ShardedTasksRemoved(unsigned int count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    m_ShardedSize.fetch_sub(count);
+    int waiters = m_ShardedRoomWaiters.load();
+    for (int i = 0;  i < waiters  &&  i < int(count);  ++i) {
+        m_ShardedRoomWait.Post();
+    }
+}
+
 inline void
 CThreadPool_Impl::x_RemoveTaskFromQueue(const CThreadPool_Task* task)
 {
+    if (m_Sharded) {
+        for (unsigned int i = 0;  i < m_ShardsCount;  ++i) {
+            SThreadPool_QueueShard& queue = m_Shards[i];
+            CFastMutexGuard q_guard(queue.m_Mutex);
+
+            auto it = queue.m_Tasks.begin();
+            while (it != queue.m_Tasks.end()  &&  *it != task) {
+                ++it;
+            }
+            if (it != queue.m_Tasks.end()) {
+                queue.m_Tasks.erase(it);
+                queue.UpdateTopPriority();
+                q_guard.Release();
+                x_ShardedTasksRemoved(1);
+                return;
+            }
+        }
+        return;
+    }
+
     TQueue::TAccessGuard q_guard(m_Queue);
 
     TQueue::TAccessGuard::TIterator it = q_guard.Begin();
@@ -1865,6 +2153,24 @@ CThreadPool_Impl::x_CancelExecutingTasks(void)
 void
 CThreadPool_Impl::x_CancelQueuedTasks(void)
 {
+    if (m_Sharded) {
+        for (unsigned int i = 0;  i < m_ShardsCount;  ++i) {
+            SThreadPool_QueueShard& queue = m_Shards[i];
+            unsigned int count;
+            {{
+                CFastMutexGuard q_guard(queue.m_Mutex);
+                ITERATE(SThreadPool_QueueShard::TTasks, it, queue.m_Tasks) {
+                    it->GetNCPointer()->x_RequestToCancel();
+                }
+                count = (unsigned int)queue.m_Tasks.size();
+                queue.m_Tasks.clear();
+                queue.UpdateTopPriority();
+            }}
+            x_ShardedTasksRemoved(count);
+        }
+        return;
+    }
+
     TQueue::TAccessGuard q_guard(m_Queue);
 
     for (TQueue::TAccessGuard::TIterator it = q_guard.Begin();
@@ -2177,18 +2483,21 @@ CThreadPool_Thread::OnExit(void)
 CThreadPool::CThreadPool(unsigned int      queue_size,
                          unsigned int      max_threads,
                          unsigned int      min_threads,
-                         CThread::TRunMode threads_mode)
+                         CThread::TRunMode threads_mode,
+                         EQueueMode        queue_mode)
 {
     m_Impl = new CThreadPool_Impl(this, queue_size, max_threads, min_threads,
-                                  threads_mode);
+                                  threads_mode, queue_mode);
     m_Impl->SetInterfaceStarted();
 }
 
 CThreadPool::CThreadPool(unsigned int            queue_size,
                          CThreadPool_Controller* controller,
-                         CThread::TRunMode       threads_mode)
+                         CThread::TRunMode       threads_mode,
+                         EQueueMode              queue_mode)
 {
-    m_Impl = new CThreadPool_Impl(this, queue_size, controller, threads_mode);
+    m_Impl = new CThreadPool_Impl(this, queue_size, controller, threads_mode,
+                                  queue_mode);
     m_Impl->SetInterfaceStarted();
 }
 